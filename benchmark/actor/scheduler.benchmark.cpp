@@ -0,0 +1,114 @@
+#include <benchmark/benchmark.h>
+
+#include <mbgl/actor/actor.hpp>
+#include <mbgl/util/thread_pool.hpp>
+#include <mbgl/util/work_stealing_thread_pool.hpp>
+
+#include <atomic>
+#include <future>
+#include <memory>
+#include <vector>
+
+using namespace mbgl;
+
+namespace {
+
+constexpr std::size_t threadCount = 4;
+constexpr std::size_t messageCount = 1000;
+
+class Worker {
+public:
+    Worker(ActorRef<Worker> self_, std::atomic<std::size_t>& remaining_, std::promise<void>& done_)
+        : self(std::move(self_)), remaining(remaining_), done(done_) {}
+
+    void receive() {
+        if (--remaining == 0) {
+            done.set_value();
+        }
+    }
+
+    // Models a tile worker that keeps posting follow-up work to itself, as
+    // GeometryTileWorker does between parsing and layout.
+    void relay(std::size_t hops) {
+        if (hops > 0) {
+            self.invoke(&Worker::relay, hops - 1);
+        } else {
+            receive();
+        }
+    }
+
+private:
+    ActorRef<Worker> self;
+    std::atomic<std::size_t>& remaining;
+    std::promise<void>& done;
+};
+
+template <class Pool>
+void runFanOut(benchmark::State& state) {
+    Pool pool(threadCount);
+    const auto actorCount = static_cast<std::size_t>(state.range(0));
+
+    while (state.KeepRunning()) {
+        std::atomic<std::size_t> remaining(actorCount * messageCount);
+        std::promise<void> done;
+
+        std::vector<std::unique_ptr<Actor<Worker>>> actors;
+        for (std::size_t i = 0; i < actorCount; ++i) {
+            actors.emplace_back(std::make_unique<Actor<Worker>>(pool, std::ref(remaining), std::ref(done)));
+        }
+
+        for (std::size_t message = 0; message < messageCount; ++message) {
+            for (auto& actor : actors) {
+                actor->self().invoke(&Worker::receive);
+            }
+        }
+
+        done.get_future().get();
+    }
+
+    state.SetItemsProcessed(state.iterations() * actorCount * messageCount);
+}
+
+template <class Pool>
+void runRelay(benchmark::State& state) {
+    Pool pool(threadCount);
+    const auto actorCount = static_cast<std::size_t>(state.range(0));
+
+    while (state.KeepRunning()) {
+        std::atomic<std::size_t> remaining(actorCount);
+        std::promise<void> done;
+
+        std::vector<std::unique_ptr<Actor<Worker>>> actors;
+        for (std::size_t i = 0; i < actorCount; ++i) {
+            actors.emplace_back(std::make_unique<Actor<Worker>>(pool, std::ref(remaining), std::ref(done)));
+            actors.back()->self().invoke(&Worker::relay, messageCount);
+        }
+
+        done.get_future().get();
+    }
+
+    state.SetItemsProcessed(state.iterations() * actorCount * messageCount);
+}
+
+} // namespace
+
+static void Scheduler_FanOut_ThreadPool(benchmark::State& state) {
+    runFanOut<ThreadPool>(state);
+}
+
+static void Scheduler_FanOut_WorkStealing(benchmark::State& state) {
+    runFanOut<WorkStealingThreadPool>(state);
+}
+
+static void Scheduler_Relay_ThreadPool(benchmark::State& state) {
+    runRelay<ThreadPool>(state);
+}
+
+static void Scheduler_Relay_WorkStealing(benchmark::State& state) {
+    runRelay<WorkStealingThreadPool>(state);
+}
+
+BENCHMARK(Scheduler_FanOut_ThreadPool)->Arg(4)->Arg(16)->Arg(64);
+BENCHMARK(Scheduler_FanOut_WorkStealing)->Arg(4)->Arg(16)->Arg(64);
+BENCHMARK(Scheduler_Relay_ThreadPool)->Arg(4)->Arg(16)->Arg(64);
+BENCHMARK(Scheduler_Relay_WorkStealing)->Arg(4)->Arg(16)->Arg(64);
@@ -4,13 +4,17 @@
 #include <mbgl/map/map_options.hpp>
 #include <mbgl/gfx/headless_frontend.hpp>
 #include <mbgl/renderer/renderer.hpp>
+#include <mbgl/renderer/tile_pyramid.hpp>
 #include <mbgl/style/style.hpp>
 #include <mbgl/style/image.hpp>
 #include <mbgl/storage/network_status.hpp>
+#include <mbgl/tile/tile_id.hpp>
 #include <mbgl/util/image.hpp>
 #include <mbgl/util/io.hpp>
 #include <mbgl/util/run_loop.hpp>
 
+#include <limits>
+
 using namespace mbgl;
 
 namespace {
@@ -62,6 +66,36 @@ static void API_queryRenderedFeaturesLayerFromHighDensity(::benchmark::State& st
     }
 }
 
+// Queries all tiles in view one after another (0) or concurrently (1).
+static void API_queryRenderedFeaturesAllTiles(::benchmark::State& state) {
+    TilePyramid::setParallelQueryThreshold(state.range(0) ? 2 : std::numeric_limits<std::size_t>::max());
+    QueryBenchmark bench;
+
+    while (state.KeepRunning()) {
+        bench.frontend.getRenderer()->queryRenderedFeatures(bench.box, {});
+    }
+
+    TilePyramid::setParallelQueryThreshold(TilePyramid::defaultParallelQueryThreshold);
+}
+
+// Queries a hover-sized box around a tile corner one after another (0) or concurrently (1). The
+// corner of the four tiles in view is moved to the center, so the box touches all four of them.
+static void API_queryRenderedFeaturesHover(::benchmark::State& state) {
+    TilePyramid::setParallelQueryThreshold(state.range(0) ? 2 : std::numeric_limits<std::size_t>::max());
+    QueryBenchmark bench;
+    bench.map.jumpTo(CameraOptions().withCenter(LatLng { CanonicalTileID(14, 4825, 6159) }));
+    bench.frontend.render(bench.map);
+    const ScreenBox hover {{ 495, 495 }, { 505, 505 }};
+
+    while (state.KeepRunning()) {
+        bench.frontend.getRenderer()->queryRenderedFeatures(hover, {});
+    }
+
+    TilePyramid::setParallelQueryThreshold(TilePyramid::defaultParallelQueryThreshold);
+}
+
 BENCHMARK(API_queryRenderedFeaturesAll);
 BENCHMARK(API_queryRenderedFeaturesLayerFromLowDensity);
 BENCHMARK(API_queryRenderedFeaturesLayerFromHighDensity);
+BENCHMARK(API_queryRenderedFeaturesAllTiles)->Arg(0)->Arg(1)->UseRealTime();
+BENCHMARK(API_queryRenderedFeaturesHover)->Arg(0)->Arg(1)->UseRealTime();
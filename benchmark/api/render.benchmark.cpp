@@ -13,6 +13,8 @@
 #include <mbgl/util/io.hpp>
 #include <mbgl/util/run_loop.hpp>
 
+#include <vector>
+
 using namespace mbgl;
 
 namespace {
@@ -66,6 +68,67 @@ static void API_renderStill_reuse_map_formatted_labels(::benchmark::State& state
     }
 }
 
+// Reports the commands a frame issues, as counters, with and without draws being regrouped by
+// program.
+static void API_renderStill_gl_calls(::benchmark::State& state) {
+    RenderBenchmark bench;
+    HeadlessFrontend frontend { size, pixelRatio };
+    Map map { frontend, MapObserver::nullObserver(),
+              MapOptions().withMapMode(MapMode::Static).withSize(size).withPixelRatio(pixelRatio),
+              ResourceOptions().withCachePath(cachePath).withAccessToken("foobar") };
+    prepare(map);
+    frontend.getRenderer()->setDrawReordering(state.range(0));
+
+    gfx::RenderingStats stats;
+    while (state.KeepRunning()) {
+        frontend.render(map);
+        stats = frontend.getRenderer()->getRenderingStats();
+    }
+
+    state.counters["drawCalls"] = stats.numDrawCalls;
+    state.counters["programBinds"] = stats.numProgramBinds;
+    state.counters["vertexArrayBinds"] = stats.numVertexArrayBinds;
+}
+
+// Renders and encodes a stream of frames at a few camera positions with one map, like
+// mbgl-render --batch does, either reading each frame back before rendering the next one or
+// overlapping the two.
+static std::vector<CameraOptions> batchCameras() {
+    std::vector<CameraOptions> cameras;
+    for (double bearing : { 0.0, 90.0, 180.0, 270.0 }) {
+        cameras.push_back(CameraOptions().withCenter(LatLng { 40.726989, -73.992857 }).withZoom(15.0).withBearing(bearing));
+    }
+    return cameras;
+}
+
+static void API_renderStill_batch(::benchmark::State& state) {
+    RenderBenchmark bench;
+    HeadlessFrontend frontend { size, pixelRatio };
+    Map map { frontend, MapObserver::nullObserver(),
+              MapOptions().withMapMode(MapMode::Static).withSize(size).withPixelRatio(pixelRatio),
+              ResourceOptions().withCachePath(cachePath).withAccessToken("foobar") };
+    prepare(map);
+    const auto cameras = batchCameras();
+
+    const bool async = state.range(0);
+    std::size_t frames = 0;
+    std::size_t bytes = 0;
+    auto encode = [&](PremultipliedImage image) { bytes += encodePNG(image).size(); };
+
+    while (state.KeepRunning()) {
+        map.jumpTo(cameras[frames++ % cameras.size()]);
+        if (async) {
+            frontend.renderAsync(map, encode);
+        } else {
+            encode(frontend.render(map));
+        }
+    }
+    frontend.finishRendering();
+
+    state.SetItemsProcessed(frames);
+    state.SetBytesProcessed(bytes);
+}
+
 static void API_renderStill_reuse_map_switch_styles(::benchmark::State& state) {
     RenderBenchmark bench;
     HeadlessFrontend frontend { size, pixelRatio };
@@ -96,5 +159,7 @@ static void API_renderStill_recreate_map(::benchmark::State& state) {
 
 BENCHMARK(API_renderStill_reuse_map);
 BENCHMARK(API_renderStill_reuse_map_formatted_labels);
+BENCHMARK(API_renderStill_gl_calls)->Arg(false)->Arg(true);
+BENCHMARK(API_renderStill_batch)->Arg(false)->Arg(true);
 BENCHMARK(API_renderStill_reuse_map_switch_styles);
 BENCHMARK(API_renderStill_recreate_map);
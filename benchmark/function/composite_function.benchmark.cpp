@@ -6,6 +6,8 @@
 #include <mbgl/style/conversion/function.hpp>
 #include <mbgl/style/conversion/property_value.hpp>
 #include <mbgl/style/conversion_impl.hpp>
+#include <mbgl/tile/vector_tile_data.hpp>
+#include <mbgl/util/io.hpp>
 
 using namespace mbgl;
 using namespace mbgl::style;
@@ -58,10 +60,36 @@ static void Evaluate_CompositeFunction(benchmark::State& state) {
     state.SetLabel(std::to_string(stopCount).c_str());
 }
 
+// Evaluates a composite expression for every feature of a vector tile layer, the way buckets
+// evaluate data-driven paint properties.
+static void Evaluate_CompositeFunction_VectorTile(benchmark::State& state) {
+    conversion::Error error;
+    optional<PropertyValue<float>> function = conversion::convertJSON<PropertyValue<float>>(R"JSON([
+        "interpolate", ["linear"], ["zoom"],
+        0, ["match", ["get", "class"], "wood", 1, "scrub", 2, 3],
+        20, ["match", ["get", "class"], "wood", 10, "scrub", 20, 30]
+    ])JSON", error, true, false);
+    if (!function) {
+        state.SkipWithError(error.message.c_str());
+    }
+
+    VectorTileData tile(std::make_shared<std::string>(util::read_file("test/fixtures/api/assets/streets/10-163-395.vector.pbf")));
+    const std::unique_ptr<GeometryTileLayer> layer = tile.getLayer("landcover");
+
+    while (state.KeepRunning()) {
+        float sum = 0;
+        layer->forEachFeature([&](std::size_t, const GeometryTileFeature& feature) {
+            sum += function->asExpression().evaluate(10, feature, -1.0f);
+            return true;
+        });
+        benchmark::DoNotOptimize(sum);
+    }
+}
+
 BENCHMARK(Parse_CompositeFunction)
     ->Arg(1)->Arg(2)->Arg(4)->Arg(6)->Arg(8)->Arg(10)->Arg(12);
 
 BENCHMARK(Evaluate_CompositeFunction)
     ->Arg(1)->Arg(2)->Arg(4)->Arg(6)->Arg(8)->Arg(10)->Arg(12);
 
-
+BENCHMARK(Evaluate_CompositeFunction_VectorTile);
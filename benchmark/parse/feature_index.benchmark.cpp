@@ -0,0 +1,50 @@
+#include <benchmark/benchmark.h>
+
+#include <mbgl/benchmark/allocation_counter.hpp>
+#include <mbgl/geometry/feature_index.hpp>
+#include <mbgl/tile/vector_tile_data.hpp>
+#include <mbgl/util/io.hpp>
+
+using namespace mbgl;
+
+// Indexes every feature of a tile, the way GeometryTileWorker::parse() does for the features of
+// non-symbol layers, with one bucket per source layer.
+static void Parse_FeatureIndex(benchmark::State& state) {
+    auto data = std::make_shared<std::string>(util::read_file("test/fixtures/api/assets/streets/10-163-395.vector.pbf"));
+    VectorTileData tile(data);
+
+    std::vector<std::pair<std::string, std::vector<GeometryCollection>>> layers;
+    std::size_t rings = 0;
+    for (const auto& name : tile.layerNames()) {
+        if (auto layer = tile.getLayer(name)) {
+            std::vector<GeometryCollection> geometries;
+            for (std::size_t i = 0; i < layer->featureCount(); i++) {
+                geometries.push_back(layer->getFeature(i)->getGeometries());
+                rings += geometries.back().size();
+            }
+            layers.emplace_back(name, std::move(geometries));
+        }
+    }
+
+    const std::size_t allocations = allocationCount();
+    std::size_t bytes = 0;
+
+    while (state.KeepRunning()) {
+        FeatureIndex featureIndex(tile.clone());
+        for (const auto& layer : layers) {
+            const StringIdentity nameId = featureIndex.intern(layer.first);
+            featureIndex.setBucketLayerIDs(nameId, { layer.first });
+            for (std::size_t i = 0; i < layer.second.size(); i++) {
+                featureIndex.insert(layer.second[i], i, nameId, nameId);
+            }
+        }
+        featureIndex.compact();
+        bytes = featureIndex.bytes() - data->size();
+    }
+
+    state.counters["rings"] = rings;
+    state.counters["indexBytes"] = bytes;
+    state.counters["allocs/tile"] = double(allocationCount() - allocations) / state.iterations();
+}
+
+BENCHMARK(Parse_FeatureIndex);
@@ -5,6 +5,8 @@
 #include <mbgl/style/conversion/filter.hpp>
 #include <mbgl/style/conversion_impl.hpp>
 #include <mbgl/tile/geometry_tile_data.hpp>
+#include <mbgl/tile/vector_tile_data.hpp>
+#include <mbgl/util/io.hpp>
 #include <mbgl/benchmark/stub_geometry_tile_feature.hpp>
 
 using namespace mbgl;
@@ -30,5 +32,42 @@ static void Parse_EvaluateFilter(benchmark::State& state) {
     }
 }
 
+// Evaluates the same filter through the expression tree, bypassing its compiled form.
+static void Parse_EvaluateFilter_Tree(benchmark::State& state) {
+    const style::Filter filter = parse(R"FILTER(["==", "foo", "bar"])FILTER");
+    const StubGeometryTileFeature feature = { {}, FeatureType::Unknown , {},  {{ "foo", std::string("bar") }} };
+    const style::expression::EvaluationContext context(&feature);
+
+    while (state.KeepRunning()) {
+        (**filter.expression).evaluate(context);
+    }
+}
+
+// Evaluates a filter for every feature of a vector tile layer, through the expression tree (0)
+// or its compiled form (1).
+static void Parse_EvaluateFilter_VectorTile(benchmark::State& state) {
+    const style::Filter filter = parse(R"FILTER(["in", "class", "wood", "scrub", "grass"])FILTER");
+    VectorTileData tile(std::make_shared<std::string>(util::read_file("test/fixtures/api/assets/streets/10-163-395.vector.pbf")));
+    const std::unique_ptr<GeometryTileLayer> layer = tile.getLayer("landcover");
+    const bool compiled = state.range(0);
+
+    while (state.KeepRunning()) {
+        std::size_t matches = 0;
+        layer->forEachFeature([&](std::size_t, const GeometryTileFeature& feature) {
+            const style::expression::EvaluationContext context(&feature);
+            if (compiled) {
+                matches += filter(context);
+            } else {
+                const auto result = (**filter.expression).evaluate(context);
+                matches += result && result->is<bool>() && result->get<bool>();
+            }
+            return true;
+        });
+        benchmark::DoNotOptimize(matches);
+    }
+}
+
 BENCHMARK(Parse_Filter);
 BENCHMARK(Parse_EvaluateFilter);
+BENCHMARK(Parse_EvaluateFilter_Tree);
+BENCHMARK(Parse_EvaluateFilter_VectorTile)->Arg(0)->Arg(1);
@@ -1,5 +1,6 @@
 #include <benchmark/benchmark.h>
 
+#include <mbgl/benchmark/allocation_counter.hpp>
 #include <mbgl/tile/vector_tile_data.hpp>
 #include <mbgl/util/io.hpp>
 
@@ -7,6 +8,7 @@ using namespace mbgl;
 
 static void Parse_VectorTile(benchmark::State& state) {
     auto data = std::make_shared<std::string>(util::read_file("test/fixtures/api/assets/streets/10-163-395.vector.pbf"));
+    const std::size_t allocations = allocationCount();
 
     while (state.KeepRunning()) {
         std::size_t length = 0;
@@ -23,6 +25,80 @@ static void Parse_VectorTile(benchmark::State& state) {
             }
         }
     }
+
+    state.counters["allocs/tile"] = double(allocationCount() - allocations) / state.iterations();
+}
+
+static void Parse_VectorTile_Geometries(benchmark::State& state) {
+    auto data = std::make_shared<std::string>(util::read_file("test/fixtures/api/assets/streets/10-163-395.vector.pbf"));
+    const std::size_t allocations = allocationCount();
+
+    while (state.KeepRunning()) {
+        std::size_t length = 0;
+        VectorTileData tile(data);
+        for (const auto& name : tile.layerNames()) {
+            if (auto layer = tile.getLayer(name)) {
+                const std::size_t count = layer->featureCount();
+                for (std::size_t i = 0; i < count; i++) {
+                    length += layer->getFeature(i)->getGeometries().size();
+                }
+            }
+        }
+    }
+
+    state.counters["allocs/tile"] = double(allocationCount() - allocations) / state.iterations();
+}
+
+static void Parse_VectorTile_ForEachFeature(benchmark::State& state) {
+    auto data = std::make_shared<std::string>(util::read_file("test/fixtures/api/assets/streets/10-163-395.vector.pbf"));
+    const std::size_t allocations = allocationCount();
+
+    GeometryCollection geometries;
+    while (state.KeepRunning()) {
+        std::size_t length = 0;
+        VectorTileData tile(data);
+        for (const auto& name : tile.layerNames()) {
+            if (auto layer = tile.getLayer(name)) {
+                layer->forEachFeature([&](std::size_t, const GeometryTileFeature& feature) {
+                    feature.decodeGeometries(geometries);
+                    length += geometries.size();
+                    return true;
+                });
+            }
+        }
+    }
+
+    state.counters["allocs/tile"] = double(allocationCount() - allocations) / state.iterations();
+}
+
+// Looks up a property of every feature of a layer through the vector tile library (0), which
+// finds the key by name for every feature, or through VectorTileFeature (1), which resolves
+// it once per layer.
+static void Parse_VectorTile_GetValue(benchmark::State& state) {
+    auto data = std::make_shared<std::string>(util::read_file("test/fixtures/api/assets/streets/10-163-395.vector.pbf"));
+    const mapbox::vector_tile::layer libraryLayer(mapbox::vector_tile::buffer(*data).getLayers().at("landcover"));
+    VectorTileData tile(data);
+    const std::unique_ptr<GeometryTileLayer> layer = tile.getLayer("landcover");
+    const bool indexed = state.range(0);
+
+    while (state.KeepRunning()) {
+        std::size_t found = 0;
+        if (indexed) {
+            layer->forEachFeature([&](std::size_t, const GeometryTileFeature& feature) {
+                found += bool(feature.getValue("class"));
+                return true;
+            });
+        } else {
+            for (std::size_t i = 0; i < libraryLayer.featureCount(); i++) {
+                const mapbox::vector_tile::feature feature(libraryLayer.getFeature(i), libraryLayer);
+                found += !feature.getValue("class").is<NullValue>();
+            }
+        }
+        benchmark::DoNotOptimize(found);
+    }
 }
 
 BENCHMARK(Parse_VectorTile);
+BENCHMARK(Parse_VectorTile_Geometries);
+BENCHMARK(Parse_VectorTile_ForEachFeature);
+BENCHMARK(Parse_VectorTile_GetValue)->Arg(0)->Arg(1);
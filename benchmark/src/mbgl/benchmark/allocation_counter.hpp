@@ -0,0 +1,12 @@
+#pragma once
+
+#include <cstddef>
+
+namespace mbgl {
+
+// Returns the number of calls to the global operator new made so far by any
+// thread. Benchmarks can compare it before and after a run to report
+// allocations per iteration.
+std::size_t allocationCount();
+
+} // namespace mbgl
@@ -4,8 +4,13 @@
 #include <mbgl/storage/resource.hpp>
 #include <mbgl/storage/response.hpp>
 #include <mbgl/storage/sqlite3.hpp>
+#include <mbgl/util/io.hpp>
 #include <mbgl/util/string.hpp>
 
+#include <atomic>
+#include <mutex>
+#include <thread>
+
 class OfflineDatabase : public benchmark::Fixture {
 public:
     void SetUp(const ::benchmark::State&) override {
@@ -35,10 +40,26 @@ public:
             const Resource offline = Resource::tile("mapbox://tile_offline_region" + util::toString(i), 1.0, 0, 0, 0, Tileset::Scheme::XYZ);
             db.putRegionResource(regionID, offline, response);
         }
+
+        Response cached;
+        cached.data = std::make_shared<std::string>(1024, 'x');
+        cached.expires = util::now() + 1h;
+
+        cover.clear();
+        for (int32_t x = 0; x < coverSize; ++x) {
+            for (int32_t y = 0; y < coverSize; ++y) {
+                const Resource resource = Resource::tile("mapbox://tile_cover", 1.0, x, y, 4, Tileset::Scheme::XYZ);
+                db.put(resource, cached);
+                cover.push_back(resource);
+            }
+        }
     }
 
+    static constexpr int32_t coverSize = 16;
+
     mbgl::OfflineDatabase db{":memory:"};
     int64_t regionID;
+    std::vector<mbgl::Resource> cover;
 };
 
 BENCHMARK_F(OfflineDatabase, InvalidateRegion)(benchmark::State& state) {
@@ -52,3 +73,92 @@ BENCHMARK_F(OfflineDatabase, InvalidateTileCache)(benchmark::State& state) {
         db.invalidateTileCache();
     }
 }
+
+BENCHMARK_F(OfflineDatabase, GetTile)(benchmark::State& state) {
+    for (auto _ : state) {
+        for (const auto& resource : cover) {
+            benchmark::DoNotOptimize(db.get(resource));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * int64_t(cover.size()));
+}
+
+BENCHMARK_F(OfflineDatabase, GetTiles)(benchmark::State& state) {
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(db.getTiles(cover));
+    }
+    state.SetItemsProcessed(state.iterations() * int64_t(cover.size()));
+}
+
+static void deleteDatabaseFiles(const std::string& path) {
+    mbgl::util::deleteFile(path);
+    mbgl::util::deleteFile(path + "-wal");
+    mbgl::util::deleteFile(path + "-shm");
+    mbgl::util::deleteFile(path + "-journal");
+}
+
+// Looks up cached tiles while another thread downloads an offline region. With Arg(0), both
+// share one connection, like they do on the DefaultFileSource thread. With Arg(1), lookups
+// use a ReadOnly connection to the database in WAL mode, like DefaultFileSource's cache readers.
+static void OfflineDatabase_GetDuringDownload(benchmark::State& state) {
+    using namespace mbgl;
+    using namespace std::chrono_literals;
+
+    const std::string path = "benchmark/fixtures/offline_readers.db";
+    const bool readers = state.range(0);
+    deleteDatabaseFiles(path);
+
+    {
+        mbgl::OfflineDatabase writer(path);
+        writer.setConcurrentReads(readers);
+
+        Response response;
+        response.data = std::make_shared<std::string>(4096, 'x');
+        response.expires = util::now() + 1h;
+
+        for (int32_t i = 0; i < 1024; ++i) {
+            writer.put(Resource::tile("mapbox://tile_cached", 1.0, i % 32, i / 32, 5, Tileset::Scheme::XYZ), response);
+        }
+
+        OfflineTilePyramidRegionDefinition definition{ "mapbox://style", LatLngBounds::world(), 0, 22, 1.0, true };
+        const int64_t regionID = writer.createRegion(definition, {})->getID();
+
+        std::mutex mutex;
+        std::atomic<bool> done { false };
+        std::thread download([&] {
+            for (int32_t batch = 0; !done; ++batch) {
+                std::list<std::tuple<Resource, Response>> resources;
+                for (int32_t i = 0; i < 64; ++i) {
+                    resources.emplace_back(Resource::tile("mapbox://tile_download", 1.0, i, batch, 10, Tileset::Scheme::XYZ), response);
+                }
+                OfflineRegionStatus status;
+                std::lock_guard<std::mutex> lock(mutex);
+                writer.putRegionResources(regionID, resources, status);
+            }
+        });
+
+        std::unique_ptr<mbgl::OfflineDatabase> reader;
+        if (readers) {
+            reader = std::make_unique<mbgl::OfflineDatabase>(path, 0, mbgl::OfflineDatabase::Mode::ReadOnly);
+        }
+
+        int32_t i = 0;
+        for (auto _ : state) {
+            const Resource resource = Resource::tile("mapbox://tile_cached", 1.0, i % 32, (i / 32) % 32, 5, Tileset::Scheme::XYZ);
+            if (reader) {
+                benchmark::DoNotOptimize(reader->get(resource));
+            } else {
+                std::lock_guard<std::mutex> lock(mutex);
+                benchmark::DoNotOptimize(writer.get(resource));
+            }
+            ++i;
+        }
+
+        done = true;
+        download.join();
+    }
+
+    deleteDatabaseFiles(path);
+}
+
+BENCHMARK(OfflineDatabase_GetDuringDownload)->Arg(0)->Arg(1)->UseRealTime();
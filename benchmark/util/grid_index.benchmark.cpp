@@ -0,0 +1,98 @@
+#include <benchmark/benchmark.h>
+
+#include <mbgl/geometry/feature_index.hpp>
+#include <mbgl/util/grid_index.hpp>
+
+#include <random>
+#include <vector>
+
+using namespace mbgl;
+
+namespace {
+
+using Grid = GridIndex<IndexedSubfeature>;
+
+// A screen-sized grid with the cell size used by the collision index.
+const float width = 1024;
+const float height = 768;
+const int16_t cellSize = 25;
+
+// Label-sized boxes, scattered over the grid.
+std::vector<Grid::BBox> makeBoxes(std::size_t count) {
+    std::mt19937 generator(1);
+    std::uniform_real_distribution<float> x(0, width);
+    std::uniform_real_distribution<float> y(0, height);
+    std::uniform_real_distribution<float> size(10, 80);
+
+    std::vector<Grid::BBox> boxes;
+    boxes.reserve(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        const float x1 = x(generator);
+        const float y1 = y(generator);
+        const float w = size(generator);
+        boxes.push_back({ { x1, y1 }, { x1 + w, y1 + w / 4 } });
+    }
+    return boxes;
+}
+
+IndexedSubfeature makeFeature(std::size_t index) {
+    return IndexedSubfeature(index, 0, 0, index);
+}
+
+} // namespace
+
+static void GridIndex_insert(::benchmark::State& state) {
+    const auto boxes = makeBoxes(state.range(0));
+    while (state.KeepRunning()) {
+        Grid grid(width, height, cellSize);
+        for (std::size_t i = 0; i < boxes.size(); ++i) {
+            grid.insert(makeFeature(i), boxes[i]);
+        }
+        ::benchmark::DoNotOptimize(grid);
+    }
+    state.SetItemsProcessed(state.iterations() * boxes.size());
+}
+
+// Inserts each box that doesn't collide with the ones inserted before, like symbol placement.
+static void GridIndex_hitTest(::benchmark::State& state) {
+    const auto boxes = makeBoxes(state.range(0));
+    const uint16_t collisionGroupId = 0;
+    std::size_t placed = 0;
+    while (state.KeepRunning()) {
+        Grid grid(width, height, cellSize);
+        for (std::size_t i = 0; i < boxes.size(); ++i) {
+            const bool hit = grid.hitTest(boxes[i], [&](const IndexedSubfeature& feature) {
+                return feature.collisionGroupId == collisionGroupId;
+            });
+            if (!hit) {
+                grid.insert(makeFeature(i), boxes[i]);
+                placed++;
+            }
+        }
+    }
+    ::benchmark::DoNotOptimize(placed);
+    state.SetItemsProcessed(state.iterations() * boxes.size());
+}
+
+static void GridIndex_query(::benchmark::State& state) {
+    const auto boxes = makeBoxes(state.range(0));
+    Grid grid(width, height, cellSize);
+    for (std::size_t i = 0; i < boxes.size(); ++i) {
+        grid.insert(makeFeature(i), boxes[i]);
+    }
+    grid.compact();
+
+    const auto queries = makeBoxes(100);
+    std::size_t found = 0;
+    while (state.KeepRunning()) {
+        for (const auto& query : queries) {
+            found += grid.query(query).size();
+        }
+    }
+    ::benchmark::DoNotOptimize(found);
+    state.SetItemsProcessed(state.iterations() * queries.size());
+}
+
+BENCHMARK(GridIndex_insert)->Arg(1000)->Arg(10000);
+BENCHMARK(GridIndex_hitTest)->Arg(1000)->Arg(10000);
+BENCHMARK(GridIndex_query)->Arg(1000)->Arg(10000);
@@ -0,0 +1,65 @@
+#include <benchmark/benchmark.h>
+
+#include <mbgl/util/image.hpp>
+
+using namespace mbgl;
+
+namespace {
+
+// An opaque image with smooth gradients and repeating detail, which compresses roughly like a
+// rendered map does.
+PremultipliedImage makeImage(uint32_t dimension) {
+    PremultipliedImage image({ dimension, dimension });
+    for (uint32_t y = 0; y < dimension; ++y) {
+        for (uint32_t x = 0; x < dimension; ++x) {
+            uint8_t* pixel = image.data.get() + (y * dimension + x) * 4;
+            pixel[0] = (x * 255) / dimension;
+            pixel[1] = (y * 255) / dimension;
+            pixel[2] = ((x / 16) % 2 == (y / 16) % 2) ? 200 : 40;
+            pixel[3] = 255;
+        }
+    }
+    return image;
+}
+
+} // namespace
+
+// Arguments: image width and height, and the band size in KiB (0 encodes a single band).
+static void Util_encodePNG(::benchmark::State& state) {
+    const auto image = makeImage(static_cast<uint32_t>(state.range(0)));
+    PNGEncodeOptions options;
+    options.bandSize = static_cast<std::size_t>(state.range(1)) * 1024;
+
+    std::size_t encoded = 0;
+    while (state.KeepRunning()) {
+        encoded = encodePNG(image, options).size();
+    }
+
+    state.SetBytesProcessed(state.iterations() * image.bytes());
+    state.counters["encodedBytes"] = encoded;
+}
+
+static void Util_encodePNG_filter(::benchmark::State& state) {
+    const auto image = makeImage(1024);
+    PNGEncodeOptions options;
+    options.filter = static_cast<PNGEncodeOptions::Filter>(state.range(0));
+
+    std::size_t encoded = 0;
+    while (state.KeepRunning()) {
+        encoded = encodePNG(image, options).size();
+    }
+
+    state.SetBytesProcessed(state.iterations() * image.bytes());
+    state.counters["encodedBytes"] = encoded;
+}
+
+static void encodePNGArguments(::benchmark::internal::Benchmark* benchmark) {
+    for (int dimension : { 256, 512, 1024, 2048 }) {
+        for (int bandSize : { 0, 128 }) {
+            benchmark->Args({ dimension, bandSize });
+        }
+    }
+}
+
+BENCHMARK(Util_encodePNG)->Apply(encodePNGArguments);
+BENCHMARK(Util_encodePNG_filter)->DenseRange(0, 5);
@@ -0,0 +1,75 @@
+#include <benchmark/benchmark.h>
+
+#include <mbgl/util/pixel_kernels.hpp>
+
+#include <vector>
+
+using namespace mbgl::util;
+
+namespace {
+
+using Kernel = void (*)(const PixelKernels&, std::vector<uint8_t>&, const std::vector<uint8_t>&);
+
+// Arguments: the instruction set, and the image width and height.
+void runKernel(::benchmark::State& state, Kernel kernel) {
+    const PixelKernels* kernels = PixelKernels::get(static_cast<PixelKernels::ISA>(state.range(0)));
+    if (!kernels) {
+        state.SkipWithError("instruction set not supported");
+        return;
+    }
+
+    const auto pixels = static_cast<std::size_t>(state.range(1) * state.range(1));
+    std::vector<uint8_t> rgba(pixels * 4);
+    std::vector<uint8_t> alpha(pixels);
+    for (std::size_t i = 0; i < rgba.size(); ++i) {
+        rgba[i] = static_cast<uint8_t>(i * 131);
+    }
+    for (std::size_t i = 0; i < alpha.size(); ++i) {
+        alpha[i] = static_cast<uint8_t>(i * 17);
+    }
+
+    while (state.KeepRunning()) {
+        kernel(*kernels, rgba, alpha);
+    }
+
+    state.SetItemsProcessed(state.iterations() * pixels);
+}
+
+void kernelArguments(::benchmark::internal::Benchmark* benchmark) {
+    for (const auto isa : { PixelKernels::ISA::Scalar, PixelKernels::ISA::SSE2, PixelKernels::ISA::AVX2, PixelKernels::ISA::NEON }) {
+        for (int dimension : { 256, 512, 4096 }) {
+            benchmark->Args({ static_cast<int>(isa), dimension });
+        }
+    }
+}
+
+} // namespace
+
+static void Util_premultiply(::benchmark::State& state) {
+    runKernel(state, [](const PixelKernels& kernels, std::vector<uint8_t>& rgba, const std::vector<uint8_t>&) {
+        kernels.premultiply(rgba.data(), rgba.size() / 4);
+    });
+}
+
+static void Util_unpremultiply(::benchmark::State& state) {
+    runKernel(state, [](const PixelKernels& kernels, std::vector<uint8_t>& rgba, const std::vector<uint8_t>&) {
+        kernels.unpremultiply(rgba.data(), rgba.size() / 4);
+    });
+}
+
+static void Util_swapRedBlue(::benchmark::State& state) {
+    runKernel(state, [](const PixelKernels& kernels, std::vector<uint8_t>& rgba, const std::vector<uint8_t>&) {
+        kernels.swapRedBlue(rgba.data(), rgba.size() / 4);
+    });
+}
+
+static void Util_expandAlpha(::benchmark::State& state) {
+    runKernel(state, [](const PixelKernels& kernels, std::vector<uint8_t>& rgba, const std::vector<uint8_t>& alpha) {
+        kernels.expandAlpha(alpha.data(), rgba.data(), alpha.size());
+    });
+}
+
+BENCHMARK(Util_premultiply)->Apply(kernelArguments);
+BENCHMARK(Util_unpremultiply)->Apply(kernelArguments);
+BENCHMARK(Util_swapRedBlue)->Apply(kernelArguments);
+BENCHMARK(Util_expandAlpha)->Apply(kernelArguments);
@@ -3,15 +3,124 @@
 #include <mbgl/util/image.hpp>
 #include <mbgl/util/run_loop.hpp>
 #include <mbgl/util/default_styles.hpp>
+#include <mbgl/util/thread.hpp>
 
 #include <mbgl/gfx/headless_frontend.hpp>
 #include <mbgl/style/style.hpp>
 
 #include <args.hxx>
+#include <rapidjson/document.h>
+#include <rapidjson/error/en.h>
 
 #include <cstdlib>
 #include <iostream>
 #include <fstream>
+#include <functional>
+#include <future>
+#include <stdexcept>
+#include <string>
+
+namespace {
+
+// Encodes and writes the images of the batch mode on a thread of its own, in the order they
+// were rendered, so that the render thread can go on with the next request.
+class ImageWriter {
+public:
+    ImageWriter(std::ostream& stream_, mbgl::PNGEncodeOptions options_)
+        : stream(stream_), options(std::move(options_)) {
+    }
+
+    // Writes to `file`, or to the stream if it is empty. Reports images that couldn't be
+    // encoded or written on stderr, and in the status returned by flush().
+    void write(mbgl::PremultipliedImage image, std::string file) {
+        try {
+            const std::string png = mbgl::encodePNG(image, options);
+            if (file.empty()) {
+                stream.write(png.data(), png.size());
+            } else {
+                std::ofstream out(file, std::ios::binary);
+                out << png;
+                out.close();
+                if (!out) {
+                    throw std::runtime_error("could not write file");
+                }
+            }
+        } catch (const std::exception& e) {
+            std::cerr << "Error: Cannot write " << (file.empty() ? "image" : file) << ": " << e.what() << std::endl;
+            failed = true;
+        }
+    }
+
+    // Returns false if any image couldn't be written.
+    bool flush() {
+        stream.flush();
+        return !failed && stream.good();
+    }
+
+private:
+    std::ostream& stream;
+    const mbgl::PNGEncodeOptions options;
+    bool failed = false;
+};
+
+// A request of the batch mode. Fields that a line doesn't set keep the values of the command line.
+struct RenderRequest {
+    double lat;
+    double lon;
+    double zoom;
+    double bearing;
+    double pitch;
+    uint32_t width;
+    uint32_t height;
+    std::string output;
+};
+
+// Reads `line` over `request`, and returns an error message if it isn't a valid request.
+std::string parseRenderRequest(const std::string& line, RenderRequest& request) {
+    rapidjson::Document document;
+    document.Parse<0>(line.c_str());
+    if (document.HasParseError()) {
+        return std::string(rapidjson::GetParseError_En(document.GetParseError())) + " at offset " +
+               std::to_string(document.GetErrorOffset());
+    }
+    if (!document.IsObject()) {
+        return "request must be an object";
+    }
+
+    for (const auto& field : { std::make_pair("lat", &request.lat),
+                               std::make_pair("lon", &request.lon),
+                               std::make_pair("zoom", &request.zoom),
+                               std::make_pair("bearing", &request.bearing),
+                               std::make_pair("pitch", &request.pitch) }) {
+        if (document.HasMember(field.first)) {
+            if (!document[field.first].IsNumber()) {
+                return std::string(field.first) + " must be a number";
+            }
+            *field.second = document[field.first].GetDouble();
+        }
+    }
+
+    for (const auto& field : { std::make_pair("width", &request.width),
+                               std::make_pair("height", &request.height) }) {
+        if (document.HasMember(field.first)) {
+            if (!document[field.first].IsUint() || document[field.first].GetUint() == 0) {
+                return std::string(field.first) + " must be a positive integer";
+            }
+            *field.second = document[field.first].GetUint();
+        }
+    }
+
+    if (document.HasMember("output")) {
+        if (!document["output"].IsString()) {
+            return "output must be a string";
+        }
+        request.output = document["output"].GetString();
+    }
+
+    return {};
+}
+
+} // namespace
 
 int main(int argc, char *argv[]) {
     args::ArgumentParser argumentParser("Mapbox GL render tool");
@@ -22,6 +131,9 @@ int main(int argc, char *argv[]) {
     args::ValueFlag<std::string> outputValue(argumentParser, "file", "Output file name", {'o', "output"});
     args::ValueFlag<std::string> cacheValue(argumentParser, "file", "Cache database file name", {'c', "cache"});
     args::ValueFlag<std::string> assetsValue(argumentParser, "file", "Directory to which asset:// URLs will resolve", {'a', "assets"});
+    args::ValueFlag<std::string> programCacheValue(argumentParser, "dir",
+        "Directory in which to cache compiled shader programs; they are built on a background "
+        "context while the style loads", {"program-cache"});
 
     args::Flag debugFlag(argumentParser, "debug", "Debug mode", {"debug"});
 
@@ -36,6 +148,24 @@ int main(int argc, char *argv[]) {
     args::ValueFlag<uint32_t> widthValue(argumentParser, "pixels", "Image width", {'w', "width"});
     args::ValueFlag<uint32_t> heightValue(argumentParser, "pixels", "Image height", {'h', "height"});
 
+    args::ValueFlag<std::string> batchValue(argumentParser, "file",
+        "Render the requests in a file (- for stdin), one JSON object per line, with a single map. "
+        "Requests may set lat, lon, zoom, bearing, pitch, width, height and output; images of "
+        "requests without an output are written one after another to the output file (- for stdout)",
+        {"batch"});
+
+    args::ValueFlag<int> pngLevelValue(argumentParser, "number", "PNG compression level, from 0 to 9", {"png-level"});
+    args::MapFlag<std::string, mbgl::PNGEncodeOptions::Filter> pngFilterValue(argumentParser, "filter",
+        "PNG scanline filter: none, sub, up, average, paeth or adaptive", {"png-filter"},
+        { { "none", mbgl::PNGEncodeOptions::Filter::None },
+          { "sub", mbgl::PNGEncodeOptions::Filter::Sub },
+          { "up", mbgl::PNGEncodeOptions::Filter::Up },
+          { "average", mbgl::PNGEncodeOptions::Filter::Average },
+          { "paeth", mbgl::PNGEncodeOptions::Filter::Paeth },
+          { "adaptive", mbgl::PNGEncodeOptions::Filter::Adaptive } });
+    args::ValueFlag<std::size_t> pngBandSizeValue(argumentParser, "bytes",
+        "Encode PNGs in parallel, in bands of scanlines of about this size", {"png-band-size"});
+
     try {
         argumentParser.ParseCLI(argc, argv);
     } catch (const args::Help&) {
@@ -73,9 +203,31 @@ int main(int argc, char *argv[]) {
 
     using namespace mbgl;
 
+    PNGEncodeOptions pngOptions;
+    if (pngLevelValue) {
+        pngOptions.compressionLevel = args::get(pngLevelValue);
+    }
+    if (pngFilterValue) {
+        pngOptions.filter = args::get(pngFilterValue);
+    }
+    if (pngBandSizeValue) {
+        pngOptions.bandSize = args::get(pngBandSizeValue);
+    }
+
     util::RunLoop loop;
 
-    HeadlessFrontend frontend({ width, height }, pixelRatio);
+    // Build the programs on a context of their own while the style and tiles load, so that the
+    // renderer finds them in the cache. The future waits for them on destruction.
+    optional<std::string> programCacheDir;
+    std::future<void> precompiledPrograms;
+    if (programCacheValue) {
+        programCacheDir = args::get(programCacheValue);
+        precompiledPrograms = std::async(std::launch::async, [dir = *programCacheDir, pixelRatio] {
+            gfx::HeadlessBackend::precompilePrograms(dir, pixelRatio);
+        });
+    }
+
+    HeadlessFrontend frontend({ width, height }, pixelRatio, programCacheDir);
     Map map(frontend, MapObserver::nullObserver(),
             MapOptions().withMapMode(MapMode::Static).withSize(frontend.getSize()).withPixelRatio(pixelRatio),
             ResourceOptions().withCachePath(cache_file).withAssetPath(asset_root).withAccessToken(std::string(token)));
@@ -95,14 +247,85 @@ int main(int argc, char *argv[]) {
         map.setDebug(debug ? mbgl::MapDebugOptions::TileBorders | mbgl::MapDebugOptions::ParseStatus : mbgl::MapDebugOptions::NoDebug);
     }
 
-    try {
-        std::ofstream out(output, std::ios::binary);
-        out << encodePNG(frontend.render(map));
-        out.close();
-    } catch(std::exception& e) {
-        std::cout << "Error: " << e.what() << std::endl;
-        exit(1);
+    if (!batchValue) {
+        try {
+            std::ofstream out(output, std::ios::binary);
+            out << encodePNG(frontend.render(map), pngOptions);
+            out.close();
+        } catch(std::exception& e) {
+            std::cout << "Error: " << e.what() << std::endl;
+            exit(1);
+        }
+
+        return 0;
+    }
+
+    const std::string batch = args::get(batchValue);
+    std::ifstream batchFile;
+    if (batch != "-") {
+        batchFile.open(batch);
+        if (!batchFile.good()) {
+            std::cerr << "Error: Cannot read file: " << batch << std::endl;
+            exit(1);
+        }
+    }
+    std::istream& requests = batch == "-" ? std::cin : batchFile;
+
+    std::ofstream outputFile;
+    if (output != "-") {
+        outputFile.open(output, std::ios::binary);
+    }
+    std::ostream& stream = output == "-" ? std::cout : outputFile;
+
+    const RenderRequest defaults { lat, lon, zoom, bearing, pitch, width, height, {} };
+    std::size_t lineNumber = 0;
+    int status = 0;
+
+    // Reading back, encoding and writing a frame overlap with rendering the next one.
+    util::Thread<ImageWriter> writer("Image Writer", std::ref(stream), pngOptions);
+    auto write = [&](std::string file) {
+        return [writerRef = writer.actor(), file](PremultipliedImage image) {
+            writerRef.invoke(&ImageWriter::write, std::move(image), file);
+        };
+    };
+
+    std::string line;
+    while (std::getline(requests, line)) {
+        lineNumber++;
+        if (line.find_first_not_of(" \t\r") == std::string::npos) {
+            continue;
+        }
+
+        RenderRequest request = defaults;
+        const std::string error = parseRenderRequest(line, request);
+        if (!error.empty()) {
+            std::cerr << "Error: line " << lineNumber << ": " << error << std::endl;
+            status = 1;
+            continue;
+        }
+
+        try {
+            const Size size { request.width, request.height };
+            if (size != frontend.getSize()) {
+                frontend.setSize(size);
+                map.setSize(size);
+            }
+            map.jumpTo(CameraOptions()
+                           .withCenter(LatLng { request.lat, request.lon })
+                           .withZoom(request.zoom)
+                           .withBearing(request.bearing)
+                           .withPitch(request.pitch));
+            frontend.renderAsync(map, write(request.output));
+        } catch(std::exception& e) {
+            std::cerr << "Error: line " << lineNumber << ": " << e.what() << std::endl;
+            status = 1;
+        }
+    }
+
+    frontend.finishRendering();
+    if (!writer.actor().ask(&ImageWriter::flush).get()) {
+        status = 1;
     }
 
-    return 0;
+    return status;
 }
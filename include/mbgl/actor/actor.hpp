@@ -65,6 +65,11 @@ public:
         return parent.self();
     }
 
+    // See Mailbox::setPriority().
+    void setPriority(MailboxPriority priority) {
+        parent.mailbox->setPriority(priority);
+    }
+
 private:
     std::shared_ptr<Scheduler> retainer;
     AspiringActor<Object> parent;
@@ -56,6 +56,15 @@ public:
         return future;
     }
 
+    // The priority of the actor's mailbox, see Mailbox::setPriority(). An actor that is
+    // gone reports MailboxPriority::Visible.
+    MailboxPriority getPriority() const {
+        if (auto mailbox = weakMailbox.lock()) {
+            return mailbox->getPriority();
+        }
+        return MailboxPriority::Visible;
+    }
+
 private:
     Object* object;
     std::weak_ptr<Mailbox> weakMailbox;
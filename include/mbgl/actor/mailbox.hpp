@@ -2,6 +2,8 @@
 
 #include <mbgl/util/optional.hpp>
 
+#include <atomic>
+#include <cstdint>
 #include <memory>
 #include <mutex>
 #include <queue>
@@ -11,6 +13,17 @@ namespace mbgl {
 class Scheduler;
 class Message;
 
+// Schedulers that support it process mailboxes with a higher priority (a lower
+// value) before those with a lower one. Messages within a mailbox are still
+// processed in order.
+enum class MailboxPriority : uint8_t {
+    Visible,  // Work for content that is currently on screen.
+    Prefetch, // Work for content that is likely to be needed soon.
+    Idle,     // Work that can wait until nothing else is queued.
+};
+
+constexpr std::size_t MailboxPriorityCount = static_cast<std::size_t>(MailboxPriority::Idle) + 1;
+
 class Mailbox : public std::enable_shared_from_this<Mailbox> {
 public:
    
@@ -30,6 +43,11 @@ public:
 
     bool isOpen() const;
 
+    // A new priority takes effect the next time the mailbox is scheduled, which is
+    // at the latest after the message that is currently queued has been processed.
+    void setPriority(MailboxPriority);
+    MailboxPriority getPriority() const;
+
     void push(std::unique_ptr<Message>);
     void receive();
 
@@ -43,6 +61,8 @@ private:
 
     bool closed { false };
 
+    std::atomic<MailboxPriority> priority { MailboxPriority::Visible };
+
     std::mutex queueMutex;
     std::queue<std::unique_ptr<Message>> queue;
 };
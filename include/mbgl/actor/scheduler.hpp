@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstdint>
 #include <memory>
 
 namespace mbgl {
@@ -19,7 +20,13 @@ class Mailbox;
         concurrency within a mailbox
 
       Subject to these constraints, processing can happen on whatever thread in the
-      pool is available.
+      pool is available. Mailboxes with a higher `MailboxPriority` are processed
+      before those with a lower one.
+
+    * `WorkStealingThreadPool` provides the same guarantees as `ThreadPool`, but
+      keeps a separate queue per thread and lets idle threads steal work from
+      busy ones, so that many actors scheduling concurrently don't contend on a
+      single lock.
 
     * `Scheduler::GetCurrent()` is typically used to create a mailbox and `ActorRef`
       for an object that lives on the main thread and is not itself wrapped an
@@ -46,6 +53,16 @@ public:
     // will lazily initialize a shared worker pool when ran
     // from the first time.
     static std::shared_ptr<Scheduler> GetBackground();
+
+    enum class BackgroundType : uint8_t {
+        ThreadPool,
+        WorkStealing,
+    };
+
+    // Select the implementation used for the shared worker pool. This only
+    // affects pools created by GetBackground() after the call; a pool that is
+    // still alive keeps its current implementation.
+    static void SetBackgroundType(BackgroundType);
 };
 
 } // namespace mbgl
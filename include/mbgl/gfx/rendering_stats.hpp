@@ -0,0 +1,17 @@
+#pragma once
+
+#include <cstddef>
+
+namespace mbgl {
+namespace gfx {
+
+// Counts the commands that reached the graphics API while rendering a frame. Changes of state
+// that was already current are skipped, and aren't counted.
+struct RenderingStats {
+    std::size_t numDrawCalls = 0;
+    std::size_t numProgramBinds = 0;
+    std::size_t numVertexArrayBinds = 0;
+};
+
+} // namespace gfx
+} // namespace mbgl
@@ -2,6 +2,9 @@
 
 #include <mbgl/renderer/query.hpp>
 #include <mbgl/annotation/annotation.hpp>
+#include <mbgl/gfx/rendering_stats.hpp>
+#include <mbgl/renderer/tile_cache_stats.hpp>
+#include <mbgl/util/chrono.hpp>
 #include <mbgl/util/geo.hpp>
 #include <mbgl/util/geojson.hpp>
 
@@ -56,6 +59,30 @@ public:
     // Memory
     void reduceMemoryUse();
 
+    // Stats of the last rendered frame
+    const gfx::RenderingStats& getRenderingStats() const;
+
+    // Tiles that are no longer rendered are cached, up to a number of tiles that depends on the
+    // map size. This additionally limits the estimated memory of each source's cached tiles.
+    // Zero, the default, means no byte limit. Takes effect with the next rendered frame.
+    void setTileCacheMaxBytes(std::size_t);
+    TileCacheStats getTileCacheStats() const;
+
+    // Symbol placement in continuous mode stops after this much time per frame and continues in
+    // the next frame, while the previous placement stays visible. Zero places all symbols at once.
+    // Only used when background placement is disabled.
+    void setPlacementTimeBudget(Duration);
+
+    // In continuous mode, symbols are placed on a background thread by default, and the result is
+    // shown in the first frame after placement finished. Disabling it places symbols on the
+    // render thread, within the placement time budget.
+    void setBackgroundPlacement(bool);
+
+    // Layers whose tiles draw inside their own clipping masks, like fill layers, have their
+    // draws grouped by program, so that each program is bound once per layer rather than once
+    // per tile. Enabled by default.
+    void setDrawReordering(bool);
+
 private:
     class Impl;
     std::unique_ptr<Impl> impl;
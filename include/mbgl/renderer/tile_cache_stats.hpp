@@ -0,0 +1,20 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace mbgl {
+
+// Counters of the caches that keep recently used tiles around after they're no longer
+// rendered. Renderer::getTileCacheStats() sums them over all sources.
+struct TileCacheStats {
+    // Tiles that were or weren't found in the cache when they were needed again.
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+    // Tiles dropped to stay within the cache's tile count or byte budget.
+    uint64_t evictions = 0;
+    // Estimated memory held by the cached tiles.
+    std::size_t bytes = 0;
+};
+
+} // namespace mbgl
@@ -49,6 +49,14 @@ public:
 
     void setResourceCachePath(const std::string&);
 
+    /*
+     * Serve cache lookups from the given number of read-only database connections, each
+     * on its own thread, so that they don't wait for writes such as offline downloads.
+     * This switches the database to write-ahead logging. 0, the default, looks resources
+     * up on the database thread.
+     */
+    void setCacheReaderCount(uint32_t);
+
     std::unique_ptr<AsyncRequest> request(const Resource&, Callback) override;
 
     /*
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstdint>
 #include <memory>
 #include <string>
 
@@ -96,6 +97,22 @@ public:
      */
     uint64_t maximumCacheSize() const;
 
+    /**
+     * @brief Sets the number of read-only cache database connections that serve
+     * cache lookups concurrently with writes. 0 disables them.
+     *
+     * @param count Number of reader connections.
+     * @return reference to ResourceOptions for chaining options together.
+     */
+    ResourceOptions& withCacheReaderCount(uint32_t count);
+
+    /**
+     * @brief Gets the previously set (or default) number of cache reader connections.
+     *
+     * @return number of cache reader connections.
+     */
+    uint32_t cacheReaderCount() const;
+
     /**
      * @brief Sets the platform context. A platform context is usually an object
      * that assists the creation of a file source.
@@ -12,19 +12,22 @@
 namespace mbgl {
 namespace style {
 
+namespace expression {
+class CompiledFilter;
+} // namespace expression
+
 class Filter {
 public:
     optional<std::shared_ptr<const expression::Expression>> expression;
 private:
     optional<mbgl::Value> legacyFilter;
+    // A flat form of `expression` for common filter shapes, used instead of the expression
+    // tree where possible. Null if the expression couldn't be compiled.
+    std::shared_ptr<const expression::CompiledFilter> compiled;
 public:
     Filter() : expression() {}
     
-    Filter(expression::ParseResult _expression, optional<mbgl::Value> _filter = {})
-    : expression(std::move(*_expression)),
-     legacyFilter(std::move(_filter)){
-        assert(!expression || *expression != nullptr);
-    }
+    Filter(expression::ParseResult _expression, optional<mbgl::Value> _filter = {});
     
     bool operator()(const expression::EvaluationContext& context) const;
 
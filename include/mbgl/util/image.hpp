@@ -2,8 +2,10 @@
 
 #include <mbgl/util/noncopyable.hpp>
 #include <mbgl/util/geometry.hpp>
+#include <mbgl/util/image_buffer_pool.hpp>
 #include <mbgl/util/size.hpp>
 
+#include <cstdint>
 #include <string>
 #include <cstring>
 #include <memory>
@@ -24,20 +26,20 @@ public:
 
     Image(Size size_)
         : size(std::move(size_)),
-          data(std::make_unique<uint8_t[]>(bytes())) {}
+          data(util::ImageBufferPool::get().allocate(bytes())) {}
 
     Image(Size size_, const uint8_t* srcData, std::size_t srcLength)
         : size(std::move(size_)) {
         if (srcLength != bytes()) {
             throw std::invalid_argument("mismatched image size");
         }
-        data = std::make_unique<uint8_t[]>(bytes());
+        data = util::ImageBufferPool::get().allocate(bytes(), false);
         std::copy(srcData, srcData + srcLength, data.get());
     }
 
     Image(Size size_, std::unique_ptr<uint8_t[]> data_)
         : size(std::move(size_)),
-          data(std::move(data_)) {}
+          data(data_.release()) {}
 
     Image(Image&& o)
         : size(o.size),
@@ -163,15 +165,59 @@ public:
 
     Size size;
     static constexpr size_t channels = Mode == ImageAlphaMode::Exclusive ? 1 : 4;
-    std::unique_ptr<uint8_t[]> data;
+    util::ImageBuffer data;
 };
 
 using UnassociatedImage = Image<ImageAlphaMode::Unassociated>;
 using PremultipliedImage = Image<ImageAlphaMode::Premultiplied>;
 using AlphaImage = Image<ImageAlphaMode::Exclusive>;
 
+struct PNGEncodeOptions {
+    // Filter applied to each scanline before compression. Adaptive picks the filter that is
+    // likely to compress best for each scanline, like libpng does.
+    enum class Filter : uint8_t { None, Sub, Up, Average, Paeth, Adaptive };
+
+    // zlib compression level, from 0 (stored) to 9 (smallest); -1 selects zlib's default.
+    int compressionLevel = -1;
+    Filter filter = Filter::None;
+
+    // When set, images are split into bands of scanlines of about this many bytes, which are
+    // filtered and deflated in parallel on the background scheduler, in the style of pigz. Each
+    // band is primed with the data before it, so the output is only slightly larger than that
+    // of a single stream. Only worth it for large images, like 128 KiB bands for images of a few
+    // megabytes, and only when the background scheduler isn't busy. 0 encodes the image as a
+    // single band on the calling thread.
+    std::size_t bandSize = 0;
+};
+
+// Receives an image while it is being decoded, one row of premultiplied RGBA pixels at a time,
+// from top to bottom. Decoders write each row straight into memory the target provides, so
+// targets that convert the pixels as they arrive never hold the whole RGBA image.
+class ImageDecodeTarget {
+public:
+    virtual ~ImageDecodeTarget() = default;
+
+    // Called once with the size of the image, before any row is decoded.
+    virtual void begin(Size) = 0;
+    // Returns where to decode row `y` to, which must hold `width * 4` bytes.
+    virtual uint8_t* row(uint32_t y) = 0;
+    // Called when row `y` has been written and premultiplied.
+    virtual void endRow(uint32_t) {}
+
+    // Feeds an image that was decoded as a whole, for decoders that can't stream.
+    void write(const PremultipliedImage& image) {
+        begin(image.size);
+        for (uint32_t y = 0; y < image.size.height; ++y) {
+            std::copy(image.data.get() + y * image.stride(), image.data.get() + (y + 1) * image.stride(), row(y));
+            endRow(y);
+        }
+    }
+};
+
 // TODO: don't use std::string for binary data.
 PremultipliedImage decodeImage(const std::string&);
+void decodeImage(const std::string&, ImageDecodeTarget&);
 std::string encodePNG(const PremultipliedImage&);
+std::string encodePNG(const PremultipliedImage&, const PNGEncodeOptions&);
 
 } // namespace mbgl
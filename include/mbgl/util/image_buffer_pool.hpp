@@ -0,0 +1,86 @@
+#pragma once
+
+#include <mbgl/util/noncopyable.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace mbgl {
+namespace util {
+
+class ImageBufferPool;
+
+// Returns a buffer to the pool it came from, or deletes it if it didn't come from a pool.
+// Buffers are always allocated with new[], so a released buffer can still be deleted with
+// delete[] by code that takes over its ownership.
+class ImageBufferDeleter {
+public:
+    ImageBufferDeleter() = default;
+    ImageBufferDeleter(ImageBufferPool* pool_, std::size_t capacity_)
+        : pool(pool_), capacity(capacity_) {}
+
+    void operator()(uint8_t*) const;
+
+private:
+    ImageBufferPool* pool = nullptr;
+    std::size_t capacity = 0;
+};
+
+using ImageBuffer = std::unique_ptr<uint8_t[], ImageBufferDeleter>;
+
+// Keeps the storage of destroyed images around for images of a similar size, so that building
+// tiles and atlases over and over doesn't fragment the heap. Requests are rounded up to one of
+// four size classes per power of two; buffers that are too small or too large to be worth pooling
+// are allocated and deleted directly. The pool is thread-safe and never holds more than its
+// maximum size in unused buffers.
+class ImageBufferPool : private util::noncopyable {
+public:
+    struct Stats {
+        // Allocations served from a pooled buffer.
+        std::size_t hits = 0;
+        // Allocations in a pooled size class that had no buffer available.
+        std::size_t misses = 0;
+        // Buffers deleted on return because the pool was full.
+        std::size_t discards = 0;
+        // Unused buffers held by the pool, and their size.
+        std::size_t pooledBuffers = 0;
+        std::size_t pooledBytes = 0;
+    };
+
+    static constexpr std::size_t DefaultMaximumSize = 32 * 1024 * 1024;
+
+    explicit ImageBufferPool(std::size_t maximumSize = DefaultMaximumSize);
+    ~ImageBufferPool();
+
+    // The pool that images allocate from.
+    static ImageBufferPool& get();
+
+    // Returns a buffer of at least `bytes` bytes. The first `bytes` bytes are zeroed if `zero`
+    // is set.
+    ImageBuffer allocate(std::size_t bytes, bool zero = true);
+
+    // Deletes unused buffers until the pool holds at most `bytes` bytes.
+    void shrink(std::size_t bytes = 0);
+    void setMaximumSize(std::size_t bytes);
+
+    Stats getStats() const;
+
+    // Returns the capacity of the buffers that serve allocations of `bytes` bytes, or 0 if
+    // such allocations aren't pooled.
+    static std::size_t sizeClass(std::size_t bytes);
+
+private:
+    friend class ImageBufferDeleter;
+    void release(uint8_t*, std::size_t capacity);
+
+    mutable std::mutex mutex;
+    std::vector<std::vector<uint8_t*>> classes;
+    std::size_t maximumSize;
+    Stats stats;
+};
+
+} // namespace util
+} // namespace mbgl
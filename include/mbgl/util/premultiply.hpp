@@ -8,5 +8,13 @@ namespace util {
 PremultipliedImage premultiply(UnassociatedImage&&);
 UnassociatedImage unpremultiply(PremultipliedImage&&);
 
+// Swaps the red and blue channels in place, which converts between RGBA and BGRA.
+void swapRedBlue(PremultipliedImage&);
+void swapRedBlue(UnassociatedImage&);
+
+// Returns an image with every channel set to the alpha of the source, i.e. white covered by
+// the alpha image.
+PremultipliedImage expandAlpha(const AlphaImage&);
+
 } // namespace util
 } // namespace mbgl
@@ -17,6 +17,9 @@ std::shared_ptr<FileSource> FileSource::createPlatformFileSource(const ResourceO
     auto* assetFileSource = reinterpret_cast<AssetManagerFileSource*>(options.platformContext());
     auto fileSource = std::make_shared<DefaultFileSource>(options.cachePath(), std::unique_ptr<AssetManagerFileSource>(assetFileSource));
     fileSource->setAccessToken(options.accessToken());
+    if (options.cacheReaderCount() > 0) {
+        fileSource->setCacheReaderCount(options.cacheReaderCount());
+    }
     return fileSource;
 }
 
@@ -18,4 +18,9 @@ PremultipliedImage decodeImage(const std::string& string) {
     return android::Bitmap::GetImage(*env, android::BitmapFactory::DecodeByteArray(*env, array, 0, string.size()));
 }
 
+// BitmapFactory decodes whole images, so the rows are handed to the target once decoding is done.
+void decodeImage(const std::string& string, ImageDecodeTarget& target) {
+    target.write(decodeImage(string));
+}
+
 } // namespace mbgl
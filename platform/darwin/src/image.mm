@@ -92,4 +92,9 @@ PremultipliedImage decodeImage(const std::string& source) {
     return MGLPremultipliedImageFromCGImage(*image);
 }
 
+// ImageIO decodes whole images, so the rows are handed to the target once decoding is done.
+void decodeImage(const std::string& string, ImageDecodeTarget& target) {
+    target.write(decodeImage(string));
+}
+
 } // namespace mbgl
@@ -4,7 +4,9 @@
 #include <mbgl/gfx/renderer_backend.hpp>
 #include <mbgl/util/image.hpp>
 
+#include <deque>
 #include <memory>
+#include <string>
 
 namespace mbgl {
 namespace gfx {
@@ -16,13 +18,32 @@ class HeadlessBackend : public gfx::Renderable {
 public:
     // Factory.
     static std::unique_ptr<HeadlessBackend> make(Size = { 256, 256 }, gfx::ContextMode = gfx::ContextMode::Unique);
+
+    // Builds all programs on a context of its own and stores their binaries in `programCacheDir`,
+    // so that renderers that use the same directory and pixel ratio load them instead of
+    // compiling. Program binaries only depend on the driver, so the context doesn't need to share
+    // objects with the renderers' contexts. Blocks until all programs are built; call it on a
+    // background thread at startup.
+    static void precompilePrograms(const std::string& programCacheDir, float pixelRatio);
     
     virtual PremultipliedImage readStillImage() = 0;
+
+    // Asynchronous reads: startReadStillImage() begins reading the current image back, and
+    // finishReadStillImage() returns the image of the oldest read that hasn't been finished yet.
+    // Rendering the next frame in between lets the GPU copy out the pixels in the meantime.
+    // Backends that can't read asynchronously read the image right away.
+    virtual void startReadStillImage();
+    virtual PremultipliedImage finishReadStillImage();
+    virtual std::size_t pendingReadCount() const;
+
     virtual RendererBackend* getRendererBackend() = 0;
     void setSize(Size);
 
 protected:
     HeadlessBackend(Size);
+
+private:
+    std::deque<PremultipliedImage> pendingImages;
 };
 
 } // namespace gfx
@@ -6,6 +6,8 @@
 #include <mbgl/util/async_task.hpp>
 #include <mbgl/util/optional.hpp>
 
+#include <deque>
+#include <functional>
 #include <memory>
 
 namespace mbgl {
@@ -48,6 +50,14 @@ public:
     PremultipliedImage readStillImage();
     PremultipliedImage render(Map&);
 
+    // Renders a frame and hands its image to the callback once it has been read back. The read
+    // runs asynchronously where the backend supports it: the image of a frame is handed over
+    // after the next frame was rendered, so that the GPU copies out one frame while rendering
+    // the next. Call finishRendering() to receive the images of the last frames.
+    using ImageCallback = std::function<void (PremultipliedImage)>;
+    void renderAsync(Map&, ImageCallback);
+    void finishRendering();
+
     optional<TransformState> getTransformState() const;
 
 private:
@@ -59,6 +69,9 @@ private:
 
     std::unique_ptr<Renderer> renderer;
     std::shared_ptr<UpdateParameters> updateParameters;
+
+    // Callbacks of the frames whose reads haven't finished, oldest first.
+    std::deque<ImageCallback> pendingCallbacks;
 };
 
 } // namespace mbgl
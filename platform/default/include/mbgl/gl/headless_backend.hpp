@@ -2,8 +2,10 @@
 
 #include <mbgl/gfx/headless_backend.hpp>
 #include <mbgl/gl/renderer_backend.hpp>
+#include <mbgl/gl/object.hpp>
 #include <memory>
 #include <functional>
+#include <list>
 
 namespace mbgl {
 namespace gl {
@@ -15,8 +17,14 @@ public:
     void updateAssumedState() override;
     gfx::Renderable& getDefaultRenderable() override;
     PremultipliedImage readStillImage() override;
+    void startReadStillImage() override;
+    PremultipliedImage finishReadStillImage() override;
+    std::size_t pendingReadCount() const override;
     RendererBackend* getRendererBackend() override;
 
+    // The number of pending reads that go through pixel buffer objects.
+    std::size_t pendingPixelBufferReadCount() const { return pendingReads.size(); }
+
     class Impl {
     public:
         virtual ~Impl() = default;
@@ -37,6 +45,16 @@ private:
 private:
     std::unique_ptr<Impl> impl;
     bool active = false;
+
+    struct PixelBuffer {
+        UniqueBuffer buffer;
+        Size size;
+    };
+
+    // Pixel buffers that reads were started into, oldest first, and the ones whose reads were
+    // finished, kept around for reuse.
+    std::list<PixelBuffer> pendingReads;
+    std::list<PixelBuffer> unusedPixelBuffers;
 };
 
 } // namespace gl
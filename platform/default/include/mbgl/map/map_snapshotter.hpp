@@ -58,6 +58,11 @@ public:
     using Callback = std::function<void (std::exception_ptr, PremultipliedImage, Attributions, PointForFn, LatLngForFn)>;
     void snapshot(ActorRef<Callback>);
 
+    // Like snapshot(), but hands over the image encoded as a PNG. Encoding runs on the background
+    // scheduler, so the snapshotter can render the next snapshot in the meantime.
+    using PNGCallback = std::function<void (std::exception_ptr, std::string, Attributions, PointForFn, LatLngForFn)>;
+    void snapshotPNG(ActorRef<PNGCallback>, PNGEncodeOptions = {});
+
 private:
     class Impl;
     std::unique_ptr<util::Thread<Impl>> impl;
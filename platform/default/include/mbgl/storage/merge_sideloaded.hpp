@@ -16,7 +16,7 @@ static constexpr const char* mergeSideloadedDatabaseSQL =
 "      r.id AS main_region_id\n"
 "    FROM side.regions sr\n"
 "    JOIN regions r ON sr.definition = r.definition  AND sr.description IS r.description;\n"
-"REPLACE INTO tiles\n"
+"REPLACE INTO tiles (id, url_template, pixel_ratio, z, x, y, expires, modified, etag, data, compressed, accessed, must_revalidate)\n"
 "    SELECT t.id,\n"
 "        st.url_template, st.pixel_ratio, st.z, st.x, st.y,\n"
 "        st.expires, st.modified, st.etag, st.data, st.compressed, st.accessed, st.must_revalidate\n"
@@ -32,7 +32,7 @@ static constexpr const char* mergeSideloadedDatabaseSQL =
 "    JOIN (SELECT t.id, st.id AS side_tile_id FROM side.tiles st\n"
 "            JOIN tiles t ON st.url_template = t.url_template AND st.pixel_ratio = t.pixel_ratio AND st.z = t.z AND st.x = t.x AND st.y = t.y\n"
 "    ) AS sti ON srt.tile_id = sti.side_tile_id;\n"
-"REPLACE INTO resources\n"
+"REPLACE INTO resources (id, url, kind, expires, modified, etag, data, compressed, accessed, must_revalidate)\n"
 "    SELECT r.id, \n"
 "        sr.url, sr.kind, sr.expires, sr.modified, sr.etag,\n"
 "        sr.data, sr.compressed, sr.accessed, sr.must_revalidate\n"
@@ -48,6 +48,11 @@ static constexpr const char* mergeSideloadedDatabaseSQL =
 "          JOIN resources r ON sr.url = r.url) AS sri  ON srr.resource_id = sri.side_resource_id;\n"
 " \n"
 "DROP TABLE region_mapping;\n"
+"UPDATE tiles SET evictable = 0 WHERE evictable = 1 AND id IN (SELECT tile_id FROM region_tiles);\n"
+"UPDATE resources SET evictable = 0 WHERE evictable = 1 AND id IN (SELECT resource_id FROM region_resources);\n"
+"UPDATE metadata\n"
+"    SET value = (SELECT ifnull(sum(length(data)), 0) FROM resources) + (SELECT ifnull(sum(length(data)), 0) FROM tiles)\n"
+"    WHERE key = 'data_size';\n"
 ;
 
 } // namespace mbgl
@@ -11,7 +11,7 @@ CREATE TEMPORARY TABLE region_mapping AS
     JOIN regions r ON sr.definition = r.definition  AND sr.description IS r.description;
 
 --Insert /Update tiles
-REPLACE INTO tiles
+REPLACE INTO tiles (id, url_template, pixel_ratio, z, x, y, expires, modified, etag, data, compressed, accessed, must_revalidate)
     SELECT t.id, -- use the old ID in case we run a REPLACE. If it doesn't exist yet, it'll be NULL which will auto-assign a new ID.
         st.url_template, st.pixel_ratio, st.z, st.x, st.y,
         st.expires, st.modified, st.etag, st.data, st.compressed, st.accessed, st.must_revalidate
@@ -31,7 +31,7 @@ INSERT OR IGNORE INTO region_tiles
     ) AS sti ON srt.tile_id = sti.side_tile_id;
 
 -- copy over resources
-REPLACE INTO resources
+REPLACE INTO resources (id, url, kind, expires, modified, etag, data, compressed, accessed, must_revalidate)
     SELECT r.id, 
         sr.url, sr.kind, sr.expires, sr.modified, sr.etag,
         sr.data, sr.compressed, sr.accessed, sr.must_revalidate
@@ -48,4 +48,12 @@ INSERT OR IGNORE INTO region_resources
   JOIN (SELECT r.id, sr.id AS side_resource_id FROM side.resources sr
           JOIN resources r ON sr.url = r.url) AS sri  ON srr.resource_id = sri.side_resource_id;
  
-DROP TABLE region_mapping;
\ No newline at end of file
+DROP TABLE region_mapping;
+
+-- REPLACE doesn't fire the delete triggers, and reinserts replaced rows as evictable.
+UPDATE tiles SET evictable = 0 WHERE evictable = 1 AND id IN (SELECT tile_id FROM region_tiles);
+UPDATE resources SET evictable = 0 WHERE evictable = 1 AND id IN (SELECT resource_id FROM region_resources);
+-- Nor does it fire the data size triggers for the replaced rows, so recompute the total.
+UPDATE metadata
+    SET value = (SELECT ifnull(sum(length(data)), 0) FROM resources) + (SELECT ifnull(sum(length(data)), 0) FROM tiles)
+    WHERE key = 'data_size';
\ No newline at end of file
@@ -8,11 +8,13 @@
 #include <mbgl/util/constants.hpp>
 #include <mbgl/util/mapbox.hpp>
 #include <mbgl/util/expected.hpp>
+#include <mbgl/util/chrono.hpp>
 
 #include <unordered_map>
 #include <memory>
 #include <string>
 #include <list>
+#include <vector>
 
 namespace mapbox {
 namespace sqlite {
@@ -38,16 +40,61 @@ struct MapboxTileLimitExceededException :  util::Exception {
 
 class OfflineDatabase : private util::noncopyable {
 public:
+    // A ReadOnly database serves get(), getTiles() and has() from a database that a ReadWrite
+    // one has created. It never changes the database: it doesn't create or migrate the schema,
+    // doesn't record access timestamps, and doesn't delete the file when it's corrupt.
+    enum class Mode : bool { ReadWrite, ReadOnly };
+
     // Limits affect ambient caching (put) only; resources required by offline
     // regions are exempt.
-    OfflineDatabase(std::string path, uint64_t maximumCacheSize = util::DEFAULT_MAX_CACHE_SIZE);
+    OfflineDatabase(std::string path,
+                    uint64_t maximumCacheSize = util::DEFAULT_MAX_CACHE_SIZE,
+                    Mode = Mode::ReadWrite);
     ~OfflineDatabase();
 
     void changePath(const std::string&);
+
+    // Switches the database to write-ahead logging, so that ReadOnly databases on other
+    // threads can read while this one writes.
+    void setConcurrentReads(bool);
     std::exception_ptr resetCache();
 
     optional<Response> get(const Resource&);
 
+    // Returns the stored size of a resource, without reading its data or recording an access.
+    optional<int64_t> has(const Resource&);
+
+    // Returns a response for each of the given tile resources, in the same order. Tiles that
+    // share a URL template, pixel ratio and zoom level, like the tiles of a pyramid cover, are
+    // read with a single statement.
+    std::vector<optional<Response>> getTiles(const std::vector<Resource>&);
+
+    // Reads don't update the access timestamps used for LRU eviction right away; they are
+    // buffered and written in a single transaction once `accessedFlushThreshold` of them are
+    // pending, before evicting, and when the database is closed. Reads also write them once the
+    // oldest one is `accessedFlushInterval` old, but the database has no timer of its own: its
+    // owner should call this, or runMaintenance(), shortly after reads. This writes the pending
+    // timestamps immediately.
+    void flushAccessed();
+
+    // Buffers the access timestamp of a resource that was read through a ReadOnly database.
+    void recordAccess(const Resource&);
+
+    static constexpr std::size_t accessedFlushThreshold = 256;
+    static constexpr Seconds accessedFlushInterval { 60 };
+
+    // Writes buffered access timestamps, then evicts least recently used ambient resources and
+    // tiles in small transactions until the cache is back under `maintenanceTargetPercent` of
+    // its maximum size, or until `budget` has passed. Puts only evict once the cache is
+    // `putEvictionPercent` of its maximum size, so this should be called regularly to keep the
+    // cache within its maximum size. Returns true if it ran out of time before reaching the
+    // target size.
+    bool runMaintenance(Duration budget);
+
+    static constexpr uint64_t maintenanceTargetPercent = 90;
+    static constexpr uint64_t putEvictionPercent = 150;
+    static constexpr uint32_t putEvictionBatches = 4;
+
     // Return value is (inserted, stored size)
     std::pair<bool, uint64_t> put(const Resource&, const Response&);
 
@@ -98,6 +145,7 @@ private:
     void migrateToVersion5();
     void migrateToVersion3();
     void migrateToVersion6();
+    void migrateToVersion7();
     void cleanup();
 
     mapbox::sqlite::Statement& getStatement(const char *);
@@ -114,9 +162,21 @@ private:
 
     uint64_t putRegionResourceInternal(int64_t regionID, const Resource&, const Response&);
 
+    // Reads the tiles at the given indices of `resources`, which must be sorted and share a URL
+    // template, pixel ratio and zoom level.
+    void getTileRange(const std::vector<Resource>& resources,
+                      std::vector<std::size_t>::const_iterator first,
+                      std::vector<std::size_t>::const_iterator last,
+                      std::vector<optional<Response>>&);
+
+    void recordResourceAccess(const std::string& url, Timestamp);
+    void recordTileAccess(const Resource::TileData&, Timestamp);
+    void flushAccessedIfNeeded();
+    void writeAccessed();
+
     optional<std::pair<Response, uint64_t>> getInternal(const Resource&);
     optional<int64_t> hasInternal(const Resource&);
-    std::pair<bool, uint64_t> putInternal(const Resource&, const Response&, bool evict);
+    std::pair<bool, uint64_t> putInternal(const Resource&, const Response&, bool ambient);
 
     // Return value is true iff the resource was previously unused by any other regions.
     bool markUsed(int64_t regionID, const Resource&);
@@ -125,6 +185,8 @@ private:
     std::pair<int64_t, int64_t> getCompletedTileCountAndSize(int64_t regionID);
 
     std::string path;
+    const Mode mode;
+    bool concurrentReads = false;
     std::unique_ptr<mapbox::sqlite::Database> db;
     std::unordered_map<const char *, const std::unique_ptr<mapbox::sqlite::Statement>> statements;
 
@@ -133,10 +195,20 @@ private:
 
     uint64_t maximumCacheSize;
 
+    // Access timestamps that haven't been written yet, in the order of the reads.
+    std::vector<std::pair<std::string, Timestamp>> pendingResourceAccesses;
+    std::vector<std::pair<Resource::TileData, Timestamp>> pendingTileAccesses;
+    optional<Timestamp> oldestPendingAccess;
+
     uint64_t offlineMapboxTileCountLimit = util::mapbox::DEFAULT_OFFLINE_TILE_COUNT_LIMIT;
     optional<uint64_t> offlineMapboxTileCount;
 
+    // Total length of the stored data, as tracked in the metadata table.
+    uint64_t getDataSize();
+
     bool evict(uint64_t neededFreeSize);
+    bool evictForPut(uint64_t size);
+    bool evictBatch();
 };
 
 } // namespace mbgl
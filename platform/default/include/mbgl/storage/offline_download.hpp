@@ -36,6 +36,14 @@ public:
 
     OfflineRegionStatus getStatus() const;
 
+    /*
+     * Looks up the size of a stored resource, e.g. on a read-only connection, and calls back
+     * later on this thread unless the returned request is cancelled first. A null request means
+     * the lookup isn't available, in which case the download queries its database instead.
+     */
+    using CacheLookup = std::function<std::unique_ptr<AsyncRequest> (const Resource&, std::function<void (optional<int64_t>)>)>;
+    void setCacheLookup(CacheLookup);
+
 private:
     void activateDownload();
     void continueDownload();
@@ -47,6 +55,7 @@ private:
      * is deactivated, all in progress requests are cancelled.
      */
     void ensureResource(const Resource&, std::function<void (Response)> = {});
+    void ensureResourceAfterLookup(const Resource&, std::function<void (Response)>, optional<int64_t> size);
 
     void onMapboxTileCountLimitExceeded();
 
@@ -54,6 +63,7 @@ private:
     OfflineRegionDefinition definition;
     OfflineDatabase& offlineDatabase;
     OnlineFileSource& onlineFileSource;
+    CacheLookup cacheLookup;
     OfflineRegionStatus status;
     std::unique_ptr<OfflineRegionObserver> observer;
 
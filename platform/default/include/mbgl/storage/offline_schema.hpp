@@ -1,7 +1,7 @@
 #pragma once
 
-// THIS IS A GENERATED FILE; EDIT offline_schema.sql INSTEAD
-// To regenerate, run `node platform/default/mbgl/storage/offline_schema.js`
+// THIS IS A GENERATED FILE; EDIT offline_schema.sql AND offline_triggers.sql INSTEAD
+// To regenerate, run `node platform/default/include/mbgl/storage/offline_schema.js`
 
 namespace mbgl {
 
@@ -17,6 +17,7 @@ static constexpr const char* offlineDatabaseSchema =
 "  compressed INTEGER NOT NULL DEFAULT 0,\n"
 "  accessed INTEGER NOT NULL,\n"
 "  must_revalidate INTEGER NOT NULL DEFAULT 0,\n"
+"  evictable INTEGER NOT NULL DEFAULT 1,\n"
 "  UNIQUE (url)\n"
 ");\n"
 "CREATE TABLE tiles (\n"
@@ -33,6 +34,7 @@ static constexpr const char* offlineDatabaseSchema =
 "  compressed INTEGER NOT NULL DEFAULT 0,\n"
 "  accessed INTEGER NOT NULL,\n"
 "  must_revalidate INTEGER NOT NULL DEFAULT 0,\n"
+"  evictable INTEGER NOT NULL DEFAULT 1,\n"
 "  UNIQUE (url_template, pixel_ratio, z, x, y)\n"
 ");\n"
 "CREATE TABLE regions (\n"
@@ -50,14 +52,55 @@ static constexpr const char* offlineDatabaseSchema =
 "  tile_id INTEGER NOT NULL REFERENCES tiles(id),\n"
 "  UNIQUE (region_id, tile_id)\n"
 ");\n"
-"CREATE INDEX resources_accessed\n"
-"ON resources (accessed);\n"
-"CREATE INDEX tiles_accessed\n"
-"ON tiles (accessed);\n"
+"CREATE TABLE metadata (\n"
+"  key TEXT NOT NULL PRIMARY KEY,\n"
+"  value INTEGER NOT NULL\n"
+");\n"
+"INSERT INTO metadata (key, value) VALUES ('data_size', 0);\n"
+"CREATE INDEX resources_evictable_accessed\n"
+"ON resources (evictable, accessed);\n"
+"CREATE INDEX tiles_evictable_accessed\n"
+"ON tiles (evictable, accessed);\n"
 "CREATE INDEX region_resources_resource_id\n"
 "ON region_resources (resource_id);\n"
 "CREATE INDEX region_tiles_tile_id\n"
 "ON region_tiles (tile_id);\n"
 ;
 
+// Applied after the schema, and by the migration that introduced them.
+static constexpr const char* offlineDatabaseTriggers =
+"CREATE TRIGGER resources_insert_data_size AFTER INSERT ON resources BEGIN\n"
+"  UPDATE metadata SET value = value + ifnull(length(NEW.data), 0) WHERE key = 'data_size';\n"
+"END;\n"
+"CREATE TRIGGER resources_update_data_size AFTER UPDATE OF data ON resources BEGIN\n"
+"  UPDATE metadata SET value = value + ifnull(length(NEW.data), 0) - ifnull(length(OLD.data), 0) WHERE key = 'data_size';\n"
+"END;\n"
+"CREATE TRIGGER resources_delete_data_size AFTER DELETE ON resources BEGIN\n"
+"  UPDATE metadata SET value = value - ifnull(length(OLD.data), 0) WHERE key = 'data_size';\n"
+"END;\n"
+"CREATE TRIGGER tiles_insert_data_size AFTER INSERT ON tiles BEGIN\n"
+"  UPDATE metadata SET value = value + ifnull(length(NEW.data), 0) WHERE key = 'data_size';\n"
+"END;\n"
+"CREATE TRIGGER tiles_update_data_size AFTER UPDATE OF data ON tiles BEGIN\n"
+"  UPDATE metadata SET value = value + ifnull(length(NEW.data), 0) - ifnull(length(OLD.data), 0) WHERE key = 'data_size';\n"
+"END;\n"
+"CREATE TRIGGER tiles_delete_data_size AFTER DELETE ON tiles BEGIN\n"
+"  UPDATE metadata SET value = value - ifnull(length(OLD.data), 0) WHERE key = 'data_size';\n"
+"END;\n"
+"CREATE TRIGGER region_resources_insert_evictable AFTER INSERT ON region_resources BEGIN\n"
+"  UPDATE resources SET evictable = 0 WHERE id = NEW.resource_id;\n"
+"END;\n"
+"CREATE TRIGGER region_resources_delete_evictable AFTER DELETE ON region_resources BEGIN\n"
+"  UPDATE resources SET evictable = 1 WHERE id = OLD.resource_id\n"
+"    AND NOT EXISTS (SELECT 1 FROM region_resources WHERE resource_id = OLD.resource_id);\n"
+"END;\n"
+"CREATE TRIGGER region_tiles_insert_evictable AFTER INSERT ON region_tiles BEGIN\n"
+"  UPDATE tiles SET evictable = 0 WHERE id = NEW.tile_id;\n"
+"END;\n"
+"CREATE TRIGGER region_tiles_delete_evictable AFTER DELETE ON region_tiles BEGIN\n"
+"  UPDATE tiles SET evictable = 1 WHERE id = OLD.tile_id\n"
+"    AND NOT EXISTS (SELECT 1 FROM region_tiles WHERE tile_id = OLD.tile_id);\n"
+"END;\n"
+;
+
 } // namespace mbgl
@@ -1,21 +1,29 @@
 var fs = require('fs');
-fs.writeFileSync('platform/default/mbgl/storage/offline_schema.hpp', `#pragma once
+var dir = 'platform/default/include/mbgl/storage/';
 
-// THIS IS A GENERATED FILE; EDIT offline_schema.sql INSTEAD
-// To regenerate, run \`node platform/default/mbgl/storage/offline_schema.js\`
-
-namespace mbgl {
-
-static constexpr const char* offlineDatabaseSchema =
-${fs.readFileSync('platform/default/mbgl/storage/offline_schema.sql', 'utf8')
+function constant(name, file) {
+    return `static constexpr const char* ${name} =
+${fs.readFileSync(dir + file, 'utf8')
     .replace(/ *--.*/g, '')
     .split('\n')
     .filter(a => a)
     .map(line => '"' + line + '\\n"')
     .join('\n')
 }
-;
+;`;
+}
+
+fs.writeFileSync(dir + 'offline_schema.hpp', `#pragma once
+
+// THIS IS A GENERATED FILE; EDIT offline_schema.sql AND offline_triggers.sql INSTEAD
+// To regenerate, run \`node ${dir}offline_schema.js\`
+
+namespace mbgl {
+
+${constant('offlineDatabaseSchema', 'offline_schema.sql')}
+
+// Applied after the schema, and by the migration that introduced them.
+${constant('offlineDatabaseTriggers', 'offline_triggers.sql')}
 
 } // namespace mbgl
 `);
-
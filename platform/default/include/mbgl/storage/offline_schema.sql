@@ -9,6 +9,7 @@ CREATE TABLE resources (                   -- Generic table for style, source, s
   compressed INTEGER NOT NULL DEFAULT 0,
   accessed INTEGER NOT NULL,
   must_revalidate INTEGER NOT NULL DEFAULT 0,
+  evictable INTEGER NOT NULL DEFAULT 1,    -- 0 if any region uses the resource; kept current by triggers.
   UNIQUE (url)
 );
 
@@ -26,6 +27,7 @@ CREATE TABLE tiles (
   compressed INTEGER NOT NULL DEFAULT 0,
   accessed INTEGER NOT NULL,
   must_revalidate INTEGER NOT NULL DEFAULT 0,
+  evictable INTEGER NOT NULL DEFAULT 1,    -- 0 if any region uses the tile; kept current by triggers.
   UNIQUE (url_template, pixel_ratio, z, x, y)
 );
 
@@ -49,13 +51,21 @@ CREATE TABLE region_tiles (
   UNIQUE (region_id, tile_id)
 );
 
+CREATE TABLE metadata (
+  key TEXT NOT NULL PRIMARY KEY,
+  value INTEGER NOT NULL
+);
+
+-- Total length of the data stored in resources and tiles; kept current by triggers.
+INSERT INTO metadata (key, value) VALUES ('data_size', 0);
+
 -- Indexes for efficient eviction queries
 
-CREATE INDEX resources_accessed
-ON resources (accessed);
+CREATE INDEX resources_evictable_accessed
+ON resources (evictable, accessed);
 
-CREATE INDEX tiles_accessed
-ON tiles (accessed);
+CREATE INDEX tiles_evictable_accessed
+ON tiles (evictable, accessed);
 
 CREATE INDEX region_resources_resource_id
 ON region_resources (resource_id);
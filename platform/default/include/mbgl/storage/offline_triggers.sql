@@ -0,0 +1,45 @@
+-- Triggers maintaining the data size
+
+CREATE TRIGGER resources_insert_data_size AFTER INSERT ON resources BEGIN
+  UPDATE metadata SET value = value + ifnull(length(NEW.data), 0) WHERE key = 'data_size';
+END;
+
+CREATE TRIGGER resources_update_data_size AFTER UPDATE OF data ON resources BEGIN
+  UPDATE metadata SET value = value + ifnull(length(NEW.data), 0) - ifnull(length(OLD.data), 0) WHERE key = 'data_size';
+END;
+
+CREATE TRIGGER resources_delete_data_size AFTER DELETE ON resources BEGIN
+  UPDATE metadata SET value = value - ifnull(length(OLD.data), 0) WHERE key = 'data_size';
+END;
+
+CREATE TRIGGER tiles_insert_data_size AFTER INSERT ON tiles BEGIN
+  UPDATE metadata SET value = value + ifnull(length(NEW.data), 0) WHERE key = 'data_size';
+END;
+
+CREATE TRIGGER tiles_update_data_size AFTER UPDATE OF data ON tiles BEGIN
+  UPDATE metadata SET value = value + ifnull(length(NEW.data), 0) - ifnull(length(OLD.data), 0) WHERE key = 'data_size';
+END;
+
+CREATE TRIGGER tiles_delete_data_size AFTER DELETE ON tiles BEGIN
+  UPDATE metadata SET value = value - ifnull(length(OLD.data), 0) WHERE key = 'data_size';
+END;
+
+-- Triggers maintaining the evictable markers
+
+CREATE TRIGGER region_resources_insert_evictable AFTER INSERT ON region_resources BEGIN
+  UPDATE resources SET evictable = 0 WHERE id = NEW.resource_id;
+END;
+
+CREATE TRIGGER region_resources_delete_evictable AFTER DELETE ON region_resources BEGIN
+  UPDATE resources SET evictable = 1 WHERE id = OLD.resource_id
+    AND NOT EXISTS (SELECT 1 FROM region_resources WHERE resource_id = OLD.resource_id);
+END;
+
+CREATE TRIGGER region_tiles_insert_evictable AFTER INSERT ON region_tiles BEGIN
+  UPDATE tiles SET evictable = 0 WHERE id = NEW.tile_id;
+END;
+
+CREATE TRIGGER region_tiles_delete_evictable AFTER DELETE ON region_tiles BEGIN
+  UPDATE tiles SET evictable = 1 WHERE id = OLD.tile_id
+    AND NOT EXISTS (SELECT 1 FROM region_tiles WHERE tile_id = OLD.tile_id);
+END;
@@ -1,4 +1,8 @@
 #include <mbgl/gfx/headless_backend.hpp>
+#include <mbgl/gfx/backend_scope.hpp>
+#include <mbgl/programs/programs.hpp>
+
+#include <cassert>
 
 namespace mbgl {
 namespace gfx {
@@ -12,5 +16,28 @@ void HeadlessBackend::setSize(Size size_) {
     resource.reset();
 }
 
+void HeadlessBackend::startReadStillImage() {
+    pendingImages.push_back(readStillImage());
+}
+
+PremultipliedImage HeadlessBackend::finishReadStillImage() {
+    assert(!pendingImages.empty());
+    auto image = std::move(pendingImages.front());
+    pendingImages.pop_front();
+    return image;
+}
+
+std::size_t HeadlessBackend::pendingReadCount() const {
+    return pendingImages.size();
+}
+
+void HeadlessBackend::precompilePrograms(const std::string& programCacheDir, const float pixelRatio) {
+    auto backend = make({ 1, 1 });
+    auto& rendererBackend = *backend->getRendererBackend();
+    BackendScope scope { rendererBackend };
+    Programs programs(rendererBackend.getContext(), ProgramParameters { pixelRatio, false, programCacheDir });
+    programs.precompile();
+}
+
 } // namespace gfx
 } // namespace mbgl
@@ -148,6 +148,45 @@ PremultipliedImage HeadlessFrontend::render(Map& map) {
     return result;
 }
 
+void HeadlessFrontend::renderAsync(Map& map, ImageCallback callback) {
+    bool rendered = false;
+
+    map.renderStill([&](std::exception_ptr error) {
+        if (error) {
+            std::rethrow_exception(error);
+        } else {
+            backend->startReadStillImage();
+            rendered = true;
+        }
+    });
+
+    while (!rendered) {
+        util::RunLoop::Get()->runOnce();
+    }
+
+    pendingCallbacks.push_back(std::move(callback));
+
+    // Keep at most one read in flight, which double-buffers the readback.
+    if (pendingCallbacks.size() > 1) {
+        gfx::BackendScope guard { *getBackend() };
+        auto image = backend->finishReadStillImage();
+        auto pendingCallback = std::move(pendingCallbacks.front());
+        pendingCallbacks.pop_front();
+        pendingCallback(std::move(image));
+    }
+}
+
+void HeadlessFrontend::finishRendering() {
+    gfx::BackendScope guard { *getBackend() };
+    while (!pendingCallbacks.empty()) {
+        assert(backend->pendingReadCount() == pendingCallbacks.size());
+        auto image = backend->finishReadStillImage();
+        auto pendingCallback = std::move(pendingCallbacks.front());
+        pendingCallbacks.pop_front();
+        pendingCallback(std::move(image));
+    }
+}
+
 optional<TransformState> HeadlessFrontend::getTransformState() const {
     if (updateParameters) {
         return updateParameters->transformState;
@@ -3,6 +3,7 @@
 #include <mbgl/gl/context.hpp>
 #include <mbgl/gfx/backend_scope.hpp>
 
+#include <algorithm>
 #include <cassert>
 #include <stdexcept>
 #include <type_traits>
@@ -37,6 +38,8 @@ HeadlessBackend::HeadlessBackend(const Size size_, const gfx::ContextMode contex
 
 HeadlessBackend::~HeadlessBackend() {
     gfx::BackendScope guard { *this };
+    pendingReads.clear();
+    unusedPixelBuffers.clear();
     resource.reset();
     // Explicitly reset the context so that it is destructed and cleaned up before we destruct
     // the impl object.
@@ -79,7 +82,48 @@ void HeadlessBackend::updateAssumedState() {
 PremultipliedImage HeadlessBackend::readStillImage() {
     return static_cast<gl::Context&>(getContext()).readFramebuffer<PremultipliedImage>(size);
 }
-    
+
+void HeadlessBackend::startReadStillImage() {
+    auto& glContext = static_cast<gl::Context&>(getContext());
+    if (!glContext.supportsPixelBuffers()) {
+        gfx::HeadlessBackend::startReadStillImage();
+        return;
+    }
+
+    auto it = std::find_if(unusedPixelBuffers.begin(), unusedPixelBuffers.end(),
+                           [&](const PixelBuffer& pixelBuffer) { return pixelBuffer.size == size; });
+    if (it != unusedPixelBuffers.end()) {
+        pendingReads.splice(pendingReads.end(), unusedPixelBuffers, it);
+    } else {
+        pendingReads.push_back({ glContext.createPixelBuffer(size), size });
+    }
+
+    glContext.readFramebufferToPixelBuffer(pendingReads.back().buffer, size);
+}
+
+PremultipliedImage HeadlessBackend::finishReadStillImage() {
+    if (pendingReads.empty()) {
+        return gfx::HeadlessBackend::finishReadStillImage();
+    }
+
+    auto& glContext = static_cast<gl::Context&>(getContext());
+    PixelBuffer pixelBuffer = std::move(pendingReads.front());
+    pendingReads.pop_front();
+    PremultipliedImage image { pixelBuffer.size, glContext.readPixelBuffer(pixelBuffer.buffer, pixelBuffer.size) };
+
+    // Buffers of another size are left over from before a resize.
+    unusedPixelBuffers.remove_if([&](const PixelBuffer& unused) { return unused.size != size; });
+    if (pixelBuffer.size == size) {
+        unusedPixelBuffers.push_back(std::move(pixelBuffer));
+    }
+
+    return image;
+}
+
+std::size_t HeadlessBackend::pendingReadCount() const {
+    return pendingReads.size() + gfx::HeadlessBackend::pendingReadCount();
+}
+
 RendererBackend* HeadlessBackend::getRendererBackend() {
     return this;
 }
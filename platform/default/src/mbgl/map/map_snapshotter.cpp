@@ -1,6 +1,8 @@
 #include <mbgl/map/map_snapshotter.hpp>
 
+#include <mbgl/actor/actor.hpp>
 #include <mbgl/actor/actor_ref.hpp>
+#include <mbgl/actor/scheduler.hpp>
 #include <mbgl/gfx/headless_frontend.hpp>
 #include <mbgl/map/map.hpp>
 #include <mbgl/map/map_options.hpp>
@@ -12,6 +14,38 @@
 
 namespace mbgl {
 
+namespace {
+
+// Encodes snapshots on the background scheduler.
+class SnapshotEncoder {
+public:
+    void encode(PremultipliedImage image,
+                PNGEncodeOptions options,
+                MapSnapshotter::Attributions attributions,
+                MapSnapshotter::PointForFn pointForFn,
+                MapSnapshotter::LatLngForFn latLngForFn,
+                ActorRef<MapSnapshotter::PNGCallback> callback) {
+        std::exception_ptr error;
+        std::string png;
+        try {
+            png = encodePNG(image, options);
+        } catch (...) {
+            error = std::current_exception();
+        }
+
+        callback.invoke(
+                &MapSnapshotter::PNGCallback::operator(),
+                error,
+                std::move(png),
+                std::move(attributions),
+                std::move(pointForFn),
+                std::move(latLngForFn)
+        );
+    }
+};
+
+} // namespace
+
 class MapSnapshotter::Impl {
 public:
     Impl(const std::pair<bool, std::string> style,
@@ -39,10 +73,14 @@ public:
     LatLngBounds getRegion() const;
 
     void snapshot(ActorRef<MapSnapshotter::Callback>);
+    void snapshotPNG(ActorRef<MapSnapshotter::PNGCallback>, PNGEncodeOptions);
 
 private:
+    void renderSnapshot(MapSnapshotter::Callback);
+
     HeadlessFrontend frontend;
     Map map;
+    Actor<SnapshotEncoder> encoder { Scheduler::GetBackground() };
 };
 
 MapSnapshotter::Impl::Impl(const std::pair<bool, std::string> style,
@@ -76,6 +114,39 @@ MapSnapshotter::Impl::Impl(const std::pair<bool, std::string> style,
 }
 
 void MapSnapshotter::Impl::snapshot(ActorRef<MapSnapshotter::Callback> callback) {
+    renderSnapshot([callback = std::move(callback)] (std::exception_ptr error,
+                                                     PremultipliedImage image,
+                                                     Attributions attributions,
+                                                     PointForFn pointForFn,
+                                                     LatLngForFn latLngForFn) {
+        callback.invoke(
+                &MapSnapshotter::Callback::operator(),
+                error,
+                std::move(image),
+                std::move(attributions),
+                std::move(pointForFn),
+                std::move(latLngForFn)
+        );
+    });
+}
+
+void MapSnapshotter::Impl::snapshotPNG(ActorRef<MapSnapshotter::PNGCallback> callback, PNGEncodeOptions options) {
+    renderSnapshot([this, callback = std::move(callback), options] (std::exception_ptr error,
+                                                                    PremultipliedImage image,
+                                                                    Attributions attributions,
+                                                                    PointForFn pointForFn,
+                                                                    LatLngForFn latLngForFn) {
+        if (error) {
+            callback.invoke(&MapSnapshotter::PNGCallback::operator(), error, std::string(),
+                            std::move(attributions), std::move(pointForFn), std::move(latLngForFn));
+            return;
+        }
+        encoder.self().invoke(&SnapshotEncoder::encode, std::move(image), options, std::move(attributions),
+                              std::move(pointForFn), std::move(latLngForFn), callback);
+    });
+}
+
+void MapSnapshotter::Impl::renderSnapshot(MapSnapshotter::Callback callback) {
     map.renderStill([this, callback = std::move(callback)] (std::exception_ptr error) {
 
         // Create lambda that captures the current transform state
@@ -108,8 +179,7 @@ void MapSnapshotter::Impl::snapshot(ActorRef<MapSnapshotter::Callback> callback)
         }
 
         // Invoke callback
-        callback.invoke(
-                &MapSnapshotter::Callback::operator(),
+        callback(
                 error,
                 error ? PremultipliedImage() : frontend.readStillImage(),
                 std::move(attributions),
@@ -181,6 +251,10 @@ void MapSnapshotter::snapshot(ActorRef<MapSnapshotter::Callback> callback) {
     impl->actor().invoke(&Impl::snapshot, std::move(callback));
 }
 
+void MapSnapshotter::snapshotPNG(ActorRef<MapSnapshotter::PNGCallback> callback, PNGEncodeOptions options) {
+    impl->actor().invoke(&Impl::snapshotPNG, std::move(callback), std::move(options));
+}
+
 void MapSnapshotter::setStyleURL(const std::string& styleURL) {
     impl->actor().invoke(&Impl::setStyleURL, styleURL);
 }
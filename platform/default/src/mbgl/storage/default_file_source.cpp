@@ -10,6 +10,7 @@
 #include <mbgl/util/platform.hpp>
 #include <mbgl/util/url.hpp>
 #include <mbgl/util/thread.hpp>
+#include <mbgl/util/timer.hpp>
 #include <mbgl/util/work_request.hpp>
 #include <mbgl/util/stopwatch.hpp>
 
@@ -18,14 +19,73 @@
 
 namespace mbgl {
 
+// Serves cache lookups from a read-only connection to the offline database, so that they
+// don't wait for the writes on the DefaultFileSource thread.
+class CacheReader {
+public:
+    CacheReader(const std::string& cachePath)
+        : offlineDatabase(cachePath, 0, OfflineDatabase::Mode::ReadOnly) {
+    }
+
+    void changePath(const std::string& path) {
+        offlineDatabase.changePath(path);
+    }
+
+    void get(const Resource& resource, std::function<void (optional<Response>)> callback) {
+        callback(offlineDatabase.get(resource));
+    }
+
+    void has(const Resource& resource, std::function<void (optional<int64_t>)> callback) {
+        callback(offlineDatabase.has(resource));
+    }
+
+private:
+    OfflineDatabase offlineDatabase;
+};
+
 class DefaultFileSource::Impl {
 public:
-    Impl(std::shared_ptr<FileSource> assetFileSource_, std::string cachePath, uint64_t maximumCacheSize)
-            : assetFileSource(std::move(assetFileSource_))
+    Impl(ActorRef<Impl> self_, std::shared_ptr<FileSource> assetFileSource_, std::string cachePath_, uint64_t maximumCacheSize)
+            : self(std::move(self_))
+            , assetFileSource(std::move(assetFileSource_))
             , localFileSource(std::make_unique<LocalFileSource>())
+            , cachePath(std::move(cachePath_))
             , offlineDatabase(std::make_unique<OfflineDatabase>(cachePath, maximumCacheSize)) {
     }
 
+    void setCacheReaderCount(uint32_t count) {
+        // Connections to an in-memory database don't share it.
+        if (cachePath == ":memory:") {
+            count = 0;
+        }
+        // Leaving write-ahead logging requires that no other connection is open.
+        readers.clear();
+        offlineDatabase->setConcurrentReads(count > 0);
+        for (uint32_t i = 0; i < count; ++i) {
+            readers.push_back(std::make_unique<util::Thread<CacheReader>>("CacheReader", cachePath));
+        }
+
+        // The old readers may have dropped lookups they hadn't gotten to yet.
+        auto reads = std::move(pendingReads);
+        pendingReads.clear();
+        for (auto& read : reads) {
+            auto offlineResponse = offlineDatabase->get(read.second.resource);
+            requestAfterCacheLookup(read.first, std::move(read.second.resource), std::move(read.second.ref), std::move(offlineResponse));
+        }
+
+        // Answering a download's lookup may cancel its other lookups, so look them up by ID.
+        std::vector<uint64_t> lookupIDs;
+        for (const auto& pending : pendingLookups) {
+            lookupIDs.push_back(pending.first);
+        }
+        for (const uint64_t lookupID : lookupIDs) {
+            auto it = pendingLookups.find(lookupID);
+            if (it != pendingLookups.end()) {
+                lookupResponse(lookupID, offlineDatabase->has(it->second.resource));
+            }
+        }
+    }
+
     void setAPIBaseURL(const std::string& url) {
         onlineFileSource.setAPIBaseURL(url);
     }
@@ -47,7 +107,9 @@ public:
     }
 
     void setResourceCachePath(const std::string& path) {
+        cachePath = path;
         offlineDatabase->changePath(path);
+        reopenReaders();
     }
 
     void listRegions(std::function<void (expected<OfflineRegions, std::exception_ptr>)> callback) {
@@ -107,62 +169,70 @@ public:
         } else if (LocalFileSource::acceptsURL(resource.url)) {
             //Local file request
             tasks[req] = localFileSource->request(resource, callback);
+        } else if (!resource.hasLoadingMethod(Resource::LoadingMethod::Cache)) {
+            requestAfterCacheLookup(req, std::move(resource), std::move(ref), {});
+        } else if (!readers.empty()) {
+            // Read from the cache on a reader thread; the response comes back in cacheResponse().
+            const uint64_t readID = nextReadID++;
+            pendingReads.erase(req);
+            pendingReads.emplace(req, PendingRead { readID, resource, ref });
+            auto& reader = readers[readID % readers.size()];
+            reader->actor().invoke(&CacheReader::get, resource,
+                [self_ = self, req, readID, resource, ref] (optional<Response> offlineResponse) {
+                    self_.invoke(&Impl::cacheResponse, req, readID, resource, ref, std::move(offlineResponse));
+                });
         } else {
-            // Try the offline database
-            if (resource.hasLoadingMethod(Resource::LoadingMethod::Cache)) {
-                auto offlineResponse = offlineDatabase->get(resource);
-
-                if (resource.loadingMethod == Resource::LoadingMethod::CacheOnly) {
-                    if (!offlineResponse) {
-                        // Ensure there's always a response that we can send, so the caller knows that
-                        // there's no optional data available in the cache, when it's the only place
-                        // we're supposed to load from.
-                        offlineResponse.emplace();
-                        offlineResponse->noContent = true;
-                        offlineResponse->error = std::make_unique<Response::Error>(
-                                Response::Error::Reason::NotFound, "Not found in offline database");
-                    } else if (!offlineResponse->isUsable()) {
-                        // Don't return resources the server requested not to show when they're stale.
-                        // Even if we can't directly use the response, we may still use it to send a
-                        // conditional HTTP request, which is why we're saving it above.
-                        offlineResponse->error = std::make_unique<Response::Error>(
-                            Response::Error::Reason::NotFound, "Cached resource is unusable");
-                    }
-                    callback(*offlineResponse);
-                } else if (offlineResponse) {
-                    // Copy over the fields so that we can use them when making a refresh request.
-                    resource.priorModified = offlineResponse->modified;
-                    resource.priorExpires = offlineResponse->expires;
-                    resource.priorEtag = offlineResponse->etag;
-                    resource.priorData = offlineResponse->data;
-
-                    if (offlineResponse->isUsable()) {
-                        callback(*offlineResponse);
-                    }
-                }
-            }
+            auto offlineResponse = offlineDatabase->get(resource);
+            scheduleMaintenance();
+            requestAfterCacheLookup(req, std::move(resource), std::move(ref), std::move(offlineResponse));
+        }
+    }
 
-            // Get from the online file source
-            if (resource.hasLoadingMethod(Resource::LoadingMethod::Network)) {
-                MBGL_TIMING_START(watch);
-                tasks[req] = onlineFileSource.request(resource, [=] (Response onlineResponse) {
-                    this->offlineDatabase->put(resource, onlineResponse);
-                    if (resource.kind == Resource::Kind::Tile) {
-                        // onlineResponse.data will be null if data not modified
-                        MBGL_TIMING_FINISH(watch,
-                                           " Action: " << "Requesting," <<
-                                           " URL: " << resource.url.c_str() <<
-                                           " Size: " << (onlineResponse.data != nullptr ? onlineResponse.data->size() : 0) << "B," <<
-                                           " Time")
-                    }
-                    callback(onlineResponse);
-                });
-            }
+    void cacheResponse(AsyncRequest* req, uint64_t readID, Resource resource, ActorRef<FileSourceRequest> ref, optional<Response> offlineResponse) {
+        auto it = pendingReads.find(req);
+        if (it == pendingReads.end() || it->second.id != readID) {
+            // The request was canceled while the reader was looking it up.
+            return;
+        }
+        pendingReads.erase(it);
+
+        if (offlineResponse) {
+            offlineDatabase->recordAccess(resource);
+            scheduleMaintenance();
         }
+        requestAfterCacheLookup(req, std::move(resource), std::move(ref), std::move(offlineResponse));
+    }
+
+    // Serves the existence checks of offline downloads from the readers. The download marks
+    // the resources that are found as used by its region on the writer connection.
+    std::unique_ptr<AsyncRequest> lookup(const Resource& resource, std::function<void (optional<int64_t>)> callback) {
+        if (readers.empty()) {
+            return nullptr;
+        }
+        const uint64_t lookupID = nextReadID++;
+        pendingLookups.emplace(lookupID, PendingLookup { resource, std::move(callback) });
+        auto& reader = readers[lookupID % readers.size()];
+        reader->actor().invoke(&CacheReader::has, resource,
+            [self_ = self, lookupID] (optional<int64_t> size) {
+                self_.invoke(&Impl::lookupResponse, lookupID, size);
+            });
+        return std::make_unique<LookupRequest>(*this, lookupID);
+    }
+
+    void lookupResponse(uint64_t lookupID, optional<int64_t> size) {
+        auto it = pendingLookups.find(lookupID);
+        if (it == pendingLookups.end()) {
+            // The download canceled the lookup while the reader was looking it up.
+            return;
+        }
+        auto callback = std::move(it->second.callback);
+        pendingLookups.erase(it);
+        callback(size);
     }
 
     void cancel(AsyncRequest* req) {
         tasks.erase(req);
+        pendingReads.erase(req);
     }
 
     void setOfflineMapboxTileCountLimit(uint64_t limit) {
@@ -175,13 +245,94 @@ public:
 
     void put(const Resource& resource, const Response& response) {
         offlineDatabase->put(resource, response);
+        scheduleMaintenance();
     }
 
     void resetCache(std::function<void (std::exception_ptr)> callback) {
-        callback(offlineDatabase->resetCache());
+        auto result = offlineDatabase->resetCache();
+        reopenReaders();
+        callback(result);
     }
 
 private:
+    void requestAfterCacheLookup(AsyncRequest* req, Resource resource, ActorRef<FileSourceRequest> ref, optional<Response> offlineResponse) {
+        auto callback = [ref] (const Response& res) {
+            ref.invoke(&FileSourceRequest::setResponse, res);
+        };
+
+        // Use the response from the offline database
+        if (resource.hasLoadingMethod(Resource::LoadingMethod::Cache)) {
+            if (resource.loadingMethod == Resource::LoadingMethod::CacheOnly) {
+                if (!offlineResponse) {
+                    // Ensure there's always a response that we can send, so the caller knows that
+                    // there's no optional data available in the cache, when it's the only place
+                    // we're supposed to load from.
+                    offlineResponse.emplace();
+                    offlineResponse->noContent = true;
+                    offlineResponse->error = std::make_unique<Response::Error>(
+                            Response::Error::Reason::NotFound, "Not found in offline database");
+                } else if (!offlineResponse->isUsable()) {
+                    // Don't return resources the server requested not to show when they're stale.
+                    // Even if we can't directly use the response, we may still use it to send a
+                    // conditional HTTP request, which is why we're saving it above.
+                    offlineResponse->error = std::make_unique<Response::Error>(
+                        Response::Error::Reason::NotFound, "Cached resource is unusable");
+                }
+                callback(*offlineResponse);
+            } else if (offlineResponse) {
+                // Copy over the fields so that we can use them when making a refresh request.
+                resource.priorModified = offlineResponse->modified;
+                resource.priorExpires = offlineResponse->expires;
+                resource.priorEtag = offlineResponse->etag;
+                resource.priorData = offlineResponse->data;
+
+                if (offlineResponse->isUsable()) {
+                    callback(*offlineResponse);
+                }
+            }
+        }
+
+        // Get from the online file source
+        if (resource.hasLoadingMethod(Resource::LoadingMethod::Network)) {
+            MBGL_TIMING_START(watch);
+            tasks[req] = onlineFileSource.request(resource, [=] (Response onlineResponse) {
+                this->offlineDatabase->put(resource, onlineResponse);
+                this->scheduleMaintenance();
+                if (resource.kind == Resource::Kind::Tile) {
+                    // onlineResponse.data will be null if data not modified
+                    MBGL_TIMING_FINISH(watch,
+                                       " Action: " << "Requesting," <<
+                                       " URL: " << resource.url.c_str() <<
+                                       " Size: " << (onlineResponse.data != nullptr ? onlineResponse.data->size() : 0) << "B," <<
+                                       " Time")
+                }
+                callback(onlineResponse);
+            });
+        }
+    }
+
+    void reopenReaders() {
+        for (auto& reader : readers) {
+            reader->actor().invoke(&CacheReader::changePath, cachePath);
+        }
+    }
+
+    // Cache maintenance runs shortly after the database was used, in slices that leave this
+    // thread free to serve requests in between. It first writes the access timestamps that
+    // reads buffered, so they don't wait for the next read.
+    void scheduleMaintenance() {
+        if (maintenanceScheduled) {
+            return;
+        }
+        maintenanceScheduled = true;
+        maintenanceTimer.start(Seconds(1), Duration::zero(), [this] {
+            maintenanceScheduled = false;
+            if (offlineDatabase->runMaintenance(Milliseconds(50))) {
+                scheduleMaintenance();
+            }
+        });
+    }
+
     expected<OfflineDownload*, std::exception_ptr> getDownload(int64_t regionID) {
         auto it = downloads.find(regionID);
         if (it != downloads.end()) {
@@ -193,16 +344,53 @@ private:
         }
         auto download = std::make_unique<OfflineDownload>(regionID, std::move(definition.value()),
                                                           *offlineDatabase, onlineFileSource);
+        download->setCacheLookup([this] (const Resource& resource, std::function<void (optional<int64_t>)> callback) {
+            return lookup(resource, std::move(callback));
+        });
         return downloads.emplace(regionID, std::move(download)).first->second.get();
     }
 
     // shared so that destruction is done on the creating thread
+    const ActorRef<Impl> self;
     const std::shared_ptr<FileSource> assetFileSource;
     const std::unique_ptr<FileSource> localFileSource;
+    std::string cachePath;
     std::unique_ptr<OfflineDatabase> offlineDatabase;
+    std::vector<std::unique_ptr<util::Thread<CacheReader>>> readers;
+
+    // Cache lookups that were sent to a reader, by request.
+    struct PendingRead {
+        uint64_t id;
+        Resource resource;
+        ActorRef<FileSourceRequest> ref;
+    };
+    std::unordered_map<AsyncRequest*, PendingRead> pendingReads;
+
+    // Existence checks of offline downloads that were sent to a reader, by lookup ID.
+    struct PendingLookup {
+        Resource resource;
+        std::function<void (optional<int64_t>)> callback;
+    };
+    std::unordered_map<uint64_t, PendingLookup> pendingLookups;
+
+    class LookupRequest : public AsyncRequest {
+    public:
+        LookupRequest(Impl& impl_, uint64_t lookupID_) : impl(impl_), lookupID(lookupID_) {}
+        ~LookupRequest() override {
+            impl.pendingLookups.erase(lookupID);
+        }
+
+    private:
+        Impl& impl;
+        const uint64_t lookupID;
+    };
+
+    uint64_t nextReadID = 0;
     OnlineFileSource onlineFileSource;
     std::unordered_map<AsyncRequest*, std::unique_ptr<AsyncRequest>> tasks;
     std::unordered_map<int64_t, std::unique_ptr<OfflineDownload>> downloads;
+    util::Timer maintenanceTimer;
+    bool maintenanceScheduled = false;
 };
 
 DefaultFileSource::DefaultFileSource(const std::string& cachePath,
@@ -256,6 +444,10 @@ void DefaultFileSource::setResourceCachePath(const std::string& path) {
     impl->actor().invoke(&Impl::setResourceCachePath, path);
 }
 
+void DefaultFileSource::setCacheReaderCount(uint32_t count) {
+    impl->actor().invoke(&Impl::setCacheReaderCount, count);
+}
+
 std::unique_ptr<AsyncRequest> DefaultFileSource::request(const Resource& resource, Callback callback) {
     auto req = std::make_unique<FileSourceRequest>(std::move(callback));
 
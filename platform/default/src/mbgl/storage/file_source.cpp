@@ -9,6 +9,9 @@ std::shared_ptr<FileSource> FileSource::createPlatformFileSource(const ResourceO
     auto fileSource = std::make_shared<DefaultFileSource>(options.cachePath(), options.assetPath());
     fileSource->setAccessToken(options.accessToken());
     fileSource->setAPIBaseURL(options.baseURL());
+    if (options.cacheReaderCount() > 0) {
+        fileSource->setCacheReaderCount(options.cacheReaderCount());
+    }
     return fileSource;
 }
 
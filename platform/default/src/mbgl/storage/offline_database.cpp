@@ -10,11 +10,20 @@
 #include <mbgl/storage/offline_schema.hpp>
 #include <mbgl/storage/merge_sideloaded.hpp>
 
+#include <algorithm>
+#include <tuple>
 
 namespace mbgl {
 
-OfflineDatabase::OfflineDatabase(std::string path_, uint64_t maximumCacheSize_)
+constexpr std::size_t OfflineDatabase::accessedFlushThreshold;
+constexpr Seconds OfflineDatabase::accessedFlushInterval;
+constexpr uint64_t OfflineDatabase::maintenanceTargetPercent;
+constexpr uint64_t OfflineDatabase::putEvictionPercent;
+constexpr uint32_t OfflineDatabase::putEvictionBatches;
+
+OfflineDatabase::OfflineDatabase(std::string path_, uint64_t maximumCacheSize_, Mode mode_)
     : path(std::move(path_)),
+      mode(mode_),
       maximumCacheSize(maximumCacheSize_) {
     try {
         initialize();
@@ -34,6 +43,13 @@ void OfflineDatabase::initialize() {
     assert(!db);
     assert(statements.empty());
 
+    if (mode == Mode::ReadOnly) {
+        db = std::make_unique<mapbox::sqlite::Database>(
+            mapbox::sqlite::Database::open(path, mapbox::sqlite::ReadOnly));
+        db->setBusyTimeout(Milliseconds::max());
+        return;
+    }
+
     db = std::make_unique<mapbox::sqlite::Database>(
         mapbox::sqlite::Database::open(path, mapbox::sqlite::ReadWriteCreate));
     db->setBusyTimeout(Milliseconds::max());
@@ -46,7 +62,7 @@ void OfflineDatabase::initialize() {
         // Newly created database, or old cache-only database; remove old table if it exists.
         removeOldCacheTable();
         createSchema();
-        return;
+        break;
     case 2:
         migrateToVersion3();
         // fall through
@@ -60,12 +76,20 @@ void OfflineDatabase::initialize() {
         migrateToVersion6();
         // fall through
     case 6:
+        migrateToVersion7();
+        // fall through
+    case 7:
         // Happy path; we're done
-        return;
+        break;
     default:
         // Downgrade: delete the database and try to reinitialize.
         removeExisting();
         initialize();
+        return;
+    }
+
+    if (concurrentReads) {
+        db->exec("PRAGMA journal_mode = WAL");
     }
 }
 
@@ -76,7 +100,24 @@ void OfflineDatabase::changePath(const std::string& path_) {
     initialize();
 }
 
+void OfflineDatabase::setConcurrentReads(bool concurrentReads_) try {
+    concurrentReads = concurrentReads_;
+    if (!db) {
+        initialize();
+    } else {
+        db->exec(concurrentReads ? "PRAGMA journal_mode = WAL" : "PRAGMA journal_mode = DELETE");
+    }
+} catch (const util::IOException& ex) {
+    handleError(ex, "change journal mode");
+} catch (const mapbox::sqlite::Exception& ex) {
+    handleError(ex, "change journal mode");
+}
+
 void OfflineDatabase::cleanup() {
+    if (db) {
+        flushAccessed();
+    }
+
     // Deleting these SQLite objects may result in exceptions
     try {
         statements.clear();
@@ -89,7 +130,12 @@ void OfflineDatabase::cleanup() {
 }
 
 void OfflineDatabase::handleError(const mapbox::sqlite::Exception& ex, const char* action) {
-    if (ex.code == mapbox::sqlite::ResultCode::NotADB ||
+    if (mode == Mode::ReadOnly) {
+        // The writable database is responsible for recovering from errors. Reopen the
+        // database for the next operation, in case it replaced the file.
+        Log::Warning(Event::Database, static_cast<int>(ex.code), "Can't %s: %s", action, ex.what());
+        cleanup();
+    } else if (ex.code == mapbox::sqlite::ResultCode::NotADB ||
         ex.code == mapbox::sqlite::ResultCode::Corrupt ||
         (ex.code == mapbox::sqlite::ResultCode::ReadOnly &&
          ex.extendedCode == mapbox::sqlite::ExtendedResultCode::ReadOnlyDBMoved)) {
@@ -115,6 +161,10 @@ void OfflineDatabase::handleError(const util::IOException& ex, const char* actio
 void OfflineDatabase::removeExisting() {
     Log::Warning(Event::Database, "Removing existing incompatible offline database");
 
+    pendingResourceAccesses.clear();
+    pendingTileAccesses.clear();
+    oldestPendingAccess = nullopt;
+
     statements.clear();
     db.reset();
 
@@ -134,7 +184,8 @@ void OfflineDatabase::createSchema() {
     db->exec("PRAGMA synchronous = FULL");
     mapbox::sqlite::Transaction transaction(*db);
     db->exec(offlineDatabaseSchema);
-    db->exec("PRAGMA user_version = 6");
+    db->exec(offlineDatabaseTriggers);
+    db->exec("PRAGMA user_version = 7");
     transaction.commit();
 }
 
@@ -167,6 +218,26 @@ void OfflineDatabase::migrateToVersion6() {
     transaction.commit();
 }
 
+void OfflineDatabase::migrateToVersion7() {
+    assert(db);
+    mapbox::sqlite::Transaction transaction(*db);
+    db->exec("ALTER TABLE resources ADD COLUMN evictable INTEGER NOT NULL DEFAULT 1");
+    db->exec("ALTER TABLE tiles ADD COLUMN evictable INTEGER NOT NULL DEFAULT 1");
+    db->exec("UPDATE resources SET evictable = 0 WHERE id IN (SELECT resource_id FROM region_resources)");
+    db->exec("UPDATE tiles SET evictable = 0 WHERE id IN (SELECT tile_id FROM region_tiles)");
+    db->exec("DROP INDEX IF EXISTS resources_accessed");
+    db->exec("DROP INDEX IF EXISTS tiles_accessed");
+    db->exec("CREATE INDEX resources_evictable_accessed ON resources (evictable, accessed)");
+    db->exec("CREATE INDEX tiles_evictable_accessed ON tiles (evictable, accessed)");
+    db->exec("CREATE TABLE metadata (key TEXT NOT NULL PRIMARY KEY, value INTEGER NOT NULL)");
+    db->exec("INSERT INTO metadata (key, value) "
+             "SELECT 'data_size', (SELECT ifnull(sum(length(data)), 0) FROM resources) + "
+             "                    (SELECT ifnull(sum(length(data)), 0) FROM tiles)");
+    db->exec(offlineDatabaseTriggers);
+    db->exec("PRAGMA user_version = 7");
+    transaction.commit();
+}
+
 mapbox::sqlite::Statement& OfflineDatabase::getStatement(const char* sql) {
     if (!db) {
         initialize();
@@ -180,6 +251,7 @@ mapbox::sqlite::Statement& OfflineDatabase::getStatement(const char* sql) {
 
 optional<Response> OfflineDatabase::get(const Resource& resource) try {
     auto result = getInternal(resource);
+    flushAccessedIfNeeded();
     return result ? optional<Response>{ result->first } : nullopt;
 } catch (const util::IOException& ex) {
     handleError(ex, "read resource");
@@ -189,6 +261,251 @@ optional<Response> OfflineDatabase::get(const Resource& resource) try {
     return nullopt;
 }
 
+optional<int64_t> OfflineDatabase::has(const Resource& resource) try {
+    return hasInternal(resource);
+} catch (const mapbox::sqlite::Exception& ex) {
+    handleError(ex, "query resource");
+    return nullopt;
+}
+
+std::vector<optional<Response>> OfflineDatabase::getTiles(const std::vector<Resource>& resources) try {
+    std::vector<optional<Response>> responses(resources.size());
+    std::vector<std::size_t> tiles;
+    tiles.reserve(resources.size());
+
+    if (!db) {
+        initialize();
+    }
+
+    // A deferred transaction takes the shared lock once for all of the reads below.
+    {
+        mapbox::sqlite::Transaction transaction(*db);
+
+        for (std::size_t i = 0; i < resources.size(); ++i) {
+            if (resources[i].kind == Resource::Kind::Tile) {
+                assert(resources[i].tileData);
+                tiles.push_back(i);
+            } else if (auto result = getResource(resources[i])) {
+                responses[i] = std::move(result->first);
+            }
+        }
+
+        const auto key = [&](std::size_t i) {
+            const Resource::TileData& tile = *resources[i].tileData;
+            return std::tie(tile.urlTemplate, tile.pixelRatio, tile.z, tile.x, tile.y);
+        };
+
+        std::sort(tiles.begin(), tiles.end(), [&](std::size_t a, std::size_t b) {
+            return key(a) < key(b);
+        });
+
+        for (auto first = tiles.begin(); first != tiles.end();) {
+            const Resource::TileData& tile = *resources[*first].tileData;
+            const auto last = std::find_if(first, tiles.end(), [&](std::size_t i) {
+                const Resource::TileData& other = *resources[i].tileData;
+                return other.urlTemplate != tile.urlTemplate ||
+                       other.pixelRatio != tile.pixelRatio ||
+                       other.z != tile.z;
+            });
+            // A cover that wraps around the antimeridian holds tiles at both ends of the x range.
+            // Read each run of adjacent columns separately, so that no query spans the columns
+            // in between.
+            for (auto run = first; run != last;) {
+                auto runEnd = std::adjacent_find(run, last, [&](std::size_t a, std::size_t b) {
+                    return resources[b].tileData->x - resources[a].tileData->x > 1;
+                });
+                if (runEnd != last) {
+                    ++runEnd;
+                }
+                getTileRange(resources, run, runEnd, responses);
+                run = runEnd;
+            }
+            first = last;
+        }
+
+        transaction.commit();
+    }
+
+    flushAccessedIfNeeded();
+    return responses;
+} catch (const util::IOException& ex) {
+    handleError(ex, "read tiles");
+    return std::vector<optional<Response>>(resources.size());
+} catch (const mapbox::sqlite::Exception& ex) {
+    handleError(ex, "read tiles");
+    return std::vector<optional<Response>>(resources.size());
+}
+
+void OfflineDatabase::getTileRange(const std::vector<Resource>& resources,
+                                   std::vector<std::size_t>::const_iterator first,
+                                   std::vector<std::size_t>::const_iterator last,
+                                   std::vector<optional<Response>>& responses) {
+    const Resource::TileData& tile = *resources[*first].tileData;
+
+    int32_t minX = tile.x, maxX = tile.x, minY = tile.y, maxY = tile.y;
+    for (auto it = first; it != last; ++it) {
+        const Resource::TileData& other = *resources[*it].tileData;
+        minX = std::min(minX, other.x);
+        maxX = std::max(maxX, other.x);
+        minY = std::min(minY, other.y);
+        maxY = std::max(maxY, other.y);
+    }
+
+    // Covers are compact, so reading their bounding box returns few tiles that weren't
+    // requested, and uses the (url_template, pixel_ratio, z, x, y) index.
+    // clang-format off
+    mapbox::sqlite::Query query{ getStatement(
+        //    0  1    2      3            4            5       6      7
+        "SELECT x, y, etag, expires, must_revalidate, modified, data, compressed "
+        "FROM tiles "
+        "WHERE url_template = ?1 "
+        "  AND pixel_ratio  = ?2 "
+        "  AND z            = ?3 "
+        "  AND x BETWEEN ?4 AND ?5 "
+        "  AND y BETWEEN ?6 AND ?7 "
+        "ORDER BY x, y") };
+    // clang-format on
+
+    query.bind(1, tile.urlTemplate);
+    query.bind(2, tile.pixelRatio);
+    query.bind(3, tile.z);
+    query.bind(4, minX);
+    query.bind(5, maxX);
+    query.bind(6, minY);
+    query.bind(7, maxY);
+
+    const Timestamp accessed = util::now();
+    const auto requested = [&](std::size_t i) {
+        return std::make_pair(resources[i].tileData->x, resources[i].tileData->y);
+    };
+
+    // Both the rows and the requested tiles are sorted by (x, y), so they can be merged.
+    while (first != last && query.run()) {
+        const std::pair<int32_t, int32_t> position { query.get<int>(0), query.get<int>(1) };
+        while (first != last && requested(*first) < position) {
+            ++first;
+        }
+        if (first == last || requested(*first) != position) {
+            continue;
+        }
+
+        Response response;
+        response.etag           = query.get<optional<std::string>>(2);
+        response.expires        = query.get<optional<Timestamp>>(3);
+        response.mustRevalidate = query.get<bool>(4);
+        response.modified       = query.get<optional<Timestamp>>(5);
+
+        optional<std::string> data = query.get<optional<std::string>>(6);
+        if (!data) {
+            response.noContent = true;
+        } else if (query.get<bool>(7)) {
+            response.data = std::make_shared<std::string>(util::decompress(*data));
+        } else {
+            response.data = std::make_shared<std::string>(std::move(*data));
+        }
+
+        recordTileAccess(*resources[*first].tileData, accessed);
+
+        // The same tile may have been requested more than once.
+        for (; first != last && requested(*first) == position; ++first) {
+            responses[*first] = response;
+        }
+    }
+}
+
+void OfflineDatabase::flushAccessed() try {
+    if (pendingResourceAccesses.empty() && pendingTileAccesses.empty()) {
+        return;
+    }
+    if (!db) {
+        initialize();
+    }
+    mapbox::sqlite::Transaction transaction(*db, mapbox::sqlite::Transaction::Immediate);
+    writeAccessed();
+    transaction.commit();
+} catch (const util::IOException& ex) {
+    handleError(ex, "update timestamp");
+} catch (const mapbox::sqlite::Exception& ex) {
+    handleError(ex, "update timestamp");
+}
+
+void OfflineDatabase::recordAccess(const Resource& resource) {
+    if (resource.kind == Resource::Kind::Tile) {
+        assert(resource.tileData);
+        recordTileAccess(*resource.tileData, util::now());
+    } else {
+        recordResourceAccess(resource.url, util::now());
+    }
+    flushAccessedIfNeeded();
+}
+
+void OfflineDatabase::recordResourceAccess(const std::string& url, Timestamp accessed) {
+    if (mode == Mode::ReadOnly) {
+        return;
+    }
+    pendingResourceAccesses.emplace_back(url, accessed);
+    if (!oldestPendingAccess) {
+        oldestPendingAccess = accessed;
+    }
+}
+
+void OfflineDatabase::recordTileAccess(const Resource::TileData& tile, Timestamp accessed) {
+    if (mode == Mode::ReadOnly) {
+        return;
+    }
+    pendingTileAccesses.emplace_back(tile, accessed);
+    if (!oldestPendingAccess) {
+        oldestPendingAccess = accessed;
+    }
+}
+
+void OfflineDatabase::flushAccessedIfNeeded() {
+    if (oldestPendingAccess &&
+        (pendingResourceAccesses.size() + pendingTileAccesses.size() >= accessedFlushThreshold ||
+         util::now() - *oldestPendingAccess >= accessedFlushInterval)) {
+        flushAccessed();
+    }
+}
+
+// Writes the pending access timestamps without starting a transaction of its own. The pending
+// timestamps are dropped even if writing them fails; they only affect the eviction order.
+void OfflineDatabase::writeAccessed() {
+    const auto resources = std::move(pendingResourceAccesses);
+    const auto tiles = std::move(pendingTileAccesses);
+    pendingResourceAccesses.clear();
+    pendingTileAccesses.clear();
+    oldestPendingAccess = nullopt;
+
+    for (const auto& access : resources) {
+        mapbox::sqlite::Query accessedQuery{ getStatement("UPDATE resources SET accessed = ?1 WHERE url = ?2") };
+        accessedQuery.bind(1, access.second);
+        accessedQuery.bind(2, access.first);
+        accessedQuery.run();
+    }
+
+    for (const auto& access : tiles) {
+        // clang-format off
+        mapbox::sqlite::Query accessedQuery{ getStatement(
+            "UPDATE tiles "
+            "SET accessed       = ?1 "
+            "WHERE url_template = ?2 "
+            "  AND pixel_ratio  = ?3 "
+            "  AND x            = ?4 "
+            "  AND y            = ?5 "
+            "  AND z            = ?6 ") };
+        // clang-format on
+
+        const Resource::TileData& tile = access.first;
+        accessedQuery.bind(1, access.second);
+        accessedQuery.bind(2, tile.urlTemplate);
+        accessedQuery.bind(3, tile.pixelRatio);
+        accessedQuery.bind(4, tile.x);
+        accessedQuery.bind(5, tile.y);
+        accessedQuery.bind(6, tile.z);
+        accessedQuery.run();
+    }
+}
+
 optional<std::pair<Response, uint64_t>> OfflineDatabase::getInternal(const Resource& resource) {
     if (resource.kind == Resource::Kind::Tile) {
         assert(resource.tileData);
@@ -220,7 +537,7 @@ std::pair<bool, uint64_t> OfflineDatabase::put(const Resource& resource, const R
     return { false, 0 };
 }
 
-std::pair<bool, uint64_t> OfflineDatabase::putInternal(const Resource& resource, const Response& response, bool evict_) {
+std::pair<bool, uint64_t> OfflineDatabase::putInternal(const Resource& resource, const Response& response, bool ambient) {
     if (response.error) {
         return { false, 0 };
     }
@@ -235,7 +552,7 @@ std::pair<bool, uint64_t> OfflineDatabase::putInternal(const Resource& resource,
         size = compressed ? compressedData.size() : response.data->size();
     }
 
-    if (evict_ && !evict(size)) {
+    if (ambient && !evictForPut(size)) {
         Log::Info(Event::Database, "Unable to make space for entry");
         return { false, 0 };
     }
@@ -257,22 +574,6 @@ std::pair<bool, uint64_t> OfflineDatabase::putInternal(const Resource& resource,
 }
 
 optional<std::pair<Response, uint64_t>> OfflineDatabase::getResource(const Resource& resource) {
-    // Update accessed timestamp used for LRU eviction.
-    try {
-        mapbox::sqlite::Query accessedQuery{ getStatement("UPDATE resources SET accessed = ?1 WHERE url = ?2") };
-        accessedQuery.bind(1, util::now());
-        accessedQuery.bind(2, resource.url);
-        accessedQuery.run();
-    } catch (const mapbox::sqlite::Exception& ex) {
-        if (ex.code == mapbox::sqlite::ResultCode::NotADB ||
-            ex.code == mapbox::sqlite::ResultCode::Corrupt) {
-            throw;
-        }
-
-        // If we don't have any indication that the database is corrupt, continue as usual.
-        Log::Warning(Event::Database, static_cast<int>(ex.code), "Can't update timestamp: %s", ex.what());
-    }
-
     // clang-format off
     mapbox::sqlite::Query query{ getStatement(
         //        0      1            2            3       4      5
@@ -306,6 +607,9 @@ optional<std::pair<Response, uint64_t>> OfflineDatabase::getResource(const Resou
         size = data->length();
     }
 
+    // Buffer the accessed timestamp used for LRU eviction; see flushAccessed().
+    recordResourceAccess(resource.url, util::now());
+
     return std::make_pair(response, size);
 }
 
@@ -405,35 +709,6 @@ bool OfflineDatabase::putResource(const Resource& resource,
 }
 
 optional<std::pair<Response, uint64_t>> OfflineDatabase::getTile(const Resource::TileData& tile) {
-    // Update accessed timestamp used for LRU eviction.
-    try {
-        // clang-format off
-        mapbox::sqlite::Query accessedQuery{ getStatement(
-            "UPDATE tiles "
-            "SET accessed       = ?1 "
-            "WHERE url_template = ?2 "
-            "  AND pixel_ratio  = ?3 "
-            "  AND x            = ?4 "
-            "  AND y            = ?5 "
-            "  AND z            = ?6 ") };
-        // clang-format on
-
-        accessedQuery.bind(1, util::now());
-        accessedQuery.bind(2, tile.urlTemplate);
-        accessedQuery.bind(3, tile.pixelRatio);
-        accessedQuery.bind(4, tile.x);
-        accessedQuery.bind(5, tile.y);
-        accessedQuery.bind(6, tile.z);
-        accessedQuery.run();
-    } catch (const mapbox::sqlite::Exception& ex) {
-        if (ex.code == mapbox::sqlite::ResultCode::NotADB || ex.code == mapbox::sqlite::ResultCode::Corrupt) {
-            throw;
-        }
-
-        // If we don't have any indication that the database is corrupt, continue as usual.
-        Log::Warning(Event::Database, static_cast<int>(ex.code), "Can't update timestamp: %s", ex.what());
-    }
-
     // clang-format off
     mapbox::sqlite::Query query{ getStatement(
         //        0      1           2,            3,      4,      5
@@ -475,6 +750,9 @@ optional<std::pair<Response, uint64_t>> OfflineDatabase::getTile(const Resource:
         size = data->length();
     }
 
+    // Buffer the accessed timestamp used for LRU eviction; see flushAccessed().
+    recordTileAccess(tile, util::now());
+
     return std::make_pair(response, size);
 }
 
@@ -703,12 +981,12 @@ OfflineDatabase::mergeDatabase(const std::string& sideDatabasePath) {
         return unexpected<std::exception_ptr>(std::current_exception());
     }
     try {
-        // Support sideloaded databases at user_version = 6. Future schema version
-        // changes will need to implement migration paths for sideloaded databases at
-        // version 6.
+        // Support sideloaded databases at user_version = 6 and 7. Version 7 only added
+        // columns and tables the merge doesn't read. Future schema version changes will
+        // need to implement migration paths for sideloaded databases at version 6.
         auto sideUserVersion = static_cast<int>(getPragma<int64_t>("PRAGMA side.user_version"));
         const auto mainUserVersion = getPragma<int64_t>("PRAGMA user_version");
-        if (sideUserVersion < 6 || sideUserVersion != mainUserVersion) {
+        if (sideUserVersion < 6 || sideUserVersion > mainUserVersion) {
             throw std::runtime_error("Merge database has incorrect user_version");
         }
 
@@ -808,6 +1086,7 @@ optional<std::pair<Response, uint64_t>> OfflineDatabase::getRegionResource(int64
         markUsed(regionID, resource);
     }
 
+    flushAccessedIfNeeded();
     return response;
 } catch (const mapbox::sqlite::Exception& ex) {
     handleError(ex, "read region resource");
@@ -1045,91 +1324,145 @@ T OfflineDatabase::getPragma(const char* sql) {
     return query.get<T>(0);
 }
 
-// Remove least-recently used resources and tiles until the used database size,
-// as calculated by multiplying the number of in-use pages by the page size, is
-// less than the maximum cache size. Returns false if this condition cannot be
-// satisfied.
-//
-// SQLite database never shrinks in size unless we call VACCUM. We here
-// are monitoring the soft limit (i.e. number of free pages in the file)
-// and as it approaches to the hard limit (i.e. the actual file size) we
-// delete an arbitrary number of old cache entries. The free pages approach saves
-// us from calling VACCUM or keeping a running total, which can be costly.
-bool OfflineDatabase::evict(uint64_t neededFreeSize) {
-    uint64_t pageSize = getPragma<int64_t>("PRAGMA page_size");
-    uint64_t pageCount = getPragma<int64_t>("PRAGMA page_count");
+uint64_t OfflineDatabase::getDataSize() {
+    mapbox::sqlite::Query query{ getStatement("SELECT value FROM metadata WHERE key = 'data_size'") };
+    query.run();
+    return query.get<int64_t>(0);
+}
 
-    auto usedSize = [&] {
-        return pageSize * (pageCount - getPragma<int64_t>("PRAGMA freelist_count"));
-    };
+// Remove least-recently used resources and tiles until the size of the stored data,
+// which triggers keep current in the metadata table, is less than the maximum cache
+// size. Returns false if this condition cannot be satisfied.
+bool OfflineDatabase::evict(uint64_t neededFreeSize) {
+    // Eviction picks the least recently accessed entries, so their timestamps must be current.
+    writeAccessed();
 
-    // The addition of pageSize is a fudge factor to account for non `data` column
-    // size, and because pages can get fragmented on the database.
-    while (usedSize() + neededFreeSize + pageSize > maximumCacheSize) {
-        // clang-format off
-        mapbox::sqlite::Query accessedQuery{ getStatement(
-            "SELECT max(accessed) "
-            "FROM ( "
-            "    SELECT accessed "
-            "    FROM resources "
-            "    LEFT JOIN region_resources "
-            "    ON resource_id = resources.id "
-            "    WHERE resource_id IS NULL "
-            "  UNION ALL "
-            "    SELECT accessed "
-            "    FROM tiles "
-            "    LEFT JOIN region_tiles "
-            "    ON tile_id = tiles.id "
-            "    WHERE tile_id IS NULL "
-            "  ORDER BY accessed ASC LIMIT ?1 "
-            ") "
-        ) };
-        accessedQuery.bind(1, 50);
-        // clang-format on
-        if (!accessedQuery.run()) {
+    while (getDataSize() + neededFreeSize > maximumCacheSize) {
+        if (!evictBatch()) {
             return false;
         }
-        Timestamp accessed = accessedQuery.get<Timestamp>(0);
+    }
 
-        // clang-format off
-        mapbox::sqlite::Query resourceQuery{ getStatement(
-            "DELETE FROM resources "
-            "WHERE id IN ( "
-            "  SELECT id FROM resources "
-            "  LEFT JOIN region_resources "
-            "  ON resource_id = resources.id "
-            "  WHERE resource_id IS NULL "
-            "  AND accessed <= ?1 "
-            ") ") };
-        // clang-format on
-        resourceQuery.bind(1, accessed);
-        resourceQuery.run();
-        const uint64_t resourceChanges = resourceQuery.changes();
+    return true;
+}
 
-        // clang-format off
-        mapbox::sqlite::Query tileQuery{ getStatement(
-            "DELETE FROM tiles "
-            "WHERE id IN ( "
-            "  SELECT id FROM tiles "
-            "  LEFT JOIN region_tiles "
-            "  ON tile_id = tiles.id "
-            "  WHERE tile_id IS NULL "
-            "  AND accessed <= ?1 "
-            ") ") };
-        // clang-format on
-        tileQuery.bind(1, accessed);
-        tileQuery.run();
-        const uint64_t tileChanges = tileQuery.changes();
+// Ambient puts leave eviction to runMaintenance() as long as the cache stays within
+// `putEvictionPercent` of its maximum size. Beyond that, e.g. when maintenance isn't run,
+// a put evicts up to `putEvictionBatches` batches towards the maximum size, and is refused
+// if the cache would still exceed that percentage. Returns false if the entry is refused.
+bool OfflineDatabase::evictForPut(uint64_t size) {
+    if (size > maximumCacheSize) {
+        return false;
+    }
+
+    const uint64_t limit = maximumCacheSize / 100 * putEvictionPercent;
+    if (getDataSize() + size <= limit) {
+        return true;
+    }
+
+    writeAccessed();
+    for (uint32_t batch = 0; batch < putEvictionBatches && getDataSize() + size > maximumCacheSize; ++batch) {
+        if (!evictBatch()) {
+            break;
+        }
+    }
+
+    return getDataSize() + size <= limit;
+}
 
-        // The cached value of offlineTileCount does not need to be updated
-        // here because only non-offline tiles can be removed by eviction.
+// Deletes up to 50 of the least recently used resources and up to 50 of the least
+// recently used tiles that no region uses. Returns false if there was nothing to delete.
+bool OfflineDatabase::evictBatch() {
+    // clang-format off
+    mapbox::sqlite::Query accessedQuery{ getStatement(
+        "SELECT max(accessed) "
+        "FROM ( "
+        "    SELECT accessed "
+        "    FROM resources "
+        "    WHERE evictable = 1 "
+        "  UNION ALL "
+        "    SELECT accessed "
+        "    FROM tiles "
+        "    WHERE evictable = 1 "
+        "  ORDER BY accessed ASC LIMIT ?1 "
+        ") "
+    ) };
+    // clang-format on
+    accessedQuery.bind(1, 50);
+    if (!accessedQuery.run()) {
+        return false;
+    }
+    const optional<int64_t> accessed = accessedQuery.get<optional<int64_t>>(0);
+    if (!accessed) {
+        return false;
+    }
+
+    // clang-format off
+    mapbox::sqlite::Query resourceQuery{ getStatement(
+        "DELETE FROM resources "
+        "WHERE id IN ( "
+        "  SELECT id FROM resources "
+        "  WHERE evictable = 1 "
+        "  AND accessed <= ?1 "
+        "  ORDER BY accessed ASC LIMIT ?2 "
+        ") ") };
+    // clang-format on
+    resourceQuery.bind(1, *accessed);
+    resourceQuery.bind(2, 50);
+    resourceQuery.run();
+    const uint64_t resourceChanges = resourceQuery.changes();
+
+    // clang-format off
+    mapbox::sqlite::Query tileQuery{ getStatement(
+        "DELETE FROM tiles "
+        "WHERE id IN ( "
+        "  SELECT id FROM tiles "
+        "  WHERE evictable = 1 "
+        "  AND accessed <= ?1 "
+        "  ORDER BY accessed ASC LIMIT ?2 "
+        ") ") };
+    // clang-format on
+    tileQuery.bind(1, *accessed);
+    tileQuery.bind(2, 50);
+    tileQuery.run();
+    const uint64_t tileChanges = tileQuery.changes();
+
+    // The cached value of offlineTileCount does not need to be updated
+    // here because only non-offline tiles can be removed by eviction.
 
-        if (resourceChanges == 0 && tileChanges == 0) {
+    return resourceChanges != 0 || tileChanges != 0;
+}
+
+bool OfflineDatabase::runMaintenance(Duration budget) try {
+    const TimePoint deadline = Clock::now() + budget;
+
+    if (!db) {
+        initialize();
+    }
+    flushAccessed();
+
+    const uint64_t targetSize = maximumCacheSize / 100 * maintenanceTargetPercent;
+    while (getDataSize() > targetSize) {
+        // Evict in short transactions so that other connections aren't locked out for long.
+        mapbox::sqlite::Transaction transaction(*db, mapbox::sqlite::Transaction::Immediate);
+        const bool evicted = evictBatch();
+        transaction.commit();
+
+        if (!evicted) {
             return false;
         }
+        if (Clock::now() >= deadline) {
+            return getDataSize() > targetSize;
+        }
     }
 
-    return true;
+    return false;
+} catch (const util::IOException& ex) {
+    handleError(ex, "run maintenance");
+    return false;
+} catch (const mapbox::sqlite::Exception& ex) {
+    handleError(ex, "run maintenance");
+    return false;
 }
 
 void OfflineDatabase::setOfflineMapboxTileCountLimit(uint64_t limit) {
@@ -99,6 +99,10 @@ void OfflineDownload::setObserver(std::unique_ptr<OfflineRegionObserver> observe
     observer = observer_ ? std::move(observer_) : std::make_unique<OfflineRegionObserver>();
 }
 
+void OfflineDownload::setCacheLookup(CacheLookup cacheLookup_) {
+    cacheLookup = std::move(cacheLookup_);
+}
+
 void OfflineDownload::setState(OfflineRegionDownloadState state) {
     if (status.downloadState == state) {
         return;
@@ -396,61 +400,82 @@ void OfflineDownload::ensureResource(const Resource& resource,
             return response->second;
         };
 
-        optional<int64_t> offlineResponse = getResourceSizeInDatabase();
-        if (offlineResponse) {
-            status.completedResourceCount++;
-            status.completedResourceSize += *offlineResponse;
-            if (resource.kind == Resource::Kind::Tile) {
-                status.completedTileCount += 1;
-                status.completedTileSize += *offlineResponse;
+        // Resources that aren't in the cache yet don't need the writer connection to find out.
+        // The lookup only answers whether the resource is stored; hits are checked again and
+        // marked as used by the region on the writer connection.
+        if (!callback && cacheLookup) {
+            auto lookupRequestsIt = requests.insert(requests.begin(), nullptr);
+            *lookupRequestsIt = cacheLookup(resource, [=](optional<int64_t> size) {
+                requests.erase(lookupRequestsIt);
+                ensureResourceAfterLookup(resource, callback,
+                                          size ? offlineDatabase.hasRegionResource(id, resource) : nullopt);
+            });
+            if (*lookupRequestsIt) {
+                return;
             }
-
-            observer->statusChanged(status);
-            continueDownload();
-            return;
+            requests.erase(lookupRequestsIt);
         }
 
-        if (offlineDatabase.exceedsOfflineMapboxTileCountLimit(resource)) {
-            onMapboxTileCountLimitExceeded();
-            return;
+        ensureResourceAfterLookup(resource, callback, getResourceSizeInDatabase());
+    });
+}
+
+void OfflineDownload::ensureResourceAfterLookup(const Resource& resource,
+                                                std::function<void(Response)> callback,
+                                                optional<int64_t> offlineResponse) {
+    if (offlineResponse) {
+        status.completedResourceCount++;
+        status.completedResourceSize += *offlineResponse;
+        if (resource.kind == Resource::Kind::Tile) {
+            status.completedTileCount += 1;
+            status.completedTileSize += *offlineResponse;
         }
 
-        auto fileRequestsIt = requests.insert(requests.begin(), nullptr);
-        *fileRequestsIt = onlineFileSource.request(resource, [=](Response onlineResponse) {
-            if (onlineResponse.error) {
-                observer->responseError(*onlineResponse.error);
-                return;
-            }
+        observer->statusChanged(status);
+        continueDownload();
+        return;
+    }
 
-            requests.erase(fileRequestsIt);
+    if (offlineDatabase.exceedsOfflineMapboxTileCountLimit(resource)) {
+        onMapboxTileCountLimitExceeded();
+        return;
+    }
 
-            if (callback) {
-                callback(onlineResponse);
-            }
+    auto fileRequestsIt = requests.insert(requests.begin(), nullptr);
+    *fileRequestsIt = onlineFileSource.request(resource, [=](Response onlineResponse) {
+        if (onlineResponse.error) {
+            observer->responseError(*onlineResponse.error);
+            return;
+        }
 
-            // Queue up for batched insertion
-            buffer.emplace_back(resource, onlineResponse);
+        requests.erase(fileRequestsIt);
 
-            // Flush buffer periodically
-            if (buffer.size() == 64 || resourcesRemaining.size() == 0) {
-                try {
-                    offlineDatabase.putRegionResources(id, buffer, status);
-                } catch (const MapboxTileLimitExceededException&) {
-                    onMapboxTileCountLimitExceeded();
-                    return;
-                }
+        if (callback) {
+            callback(onlineResponse);
+        }
 
-                buffer.clear();
-                observer->statusChanged(status);
-            }
+        // Queue up for batched insertion
+        buffer.emplace_back(resource, onlineResponse);
 
-            if (offlineDatabase.exceedsOfflineMapboxTileCountLimit(resource)) {
+        // Flush buffer periodically
+        if (buffer.size() == 64 || resourcesRemaining.size() == 0) {
+            try {
+                offlineDatabase.putRegionResources(id, buffer, status);
+            } catch (const MapboxTileLimitExceededException&) {
                 onMapboxTileCountLimitExceeded();
                 return;
             }
 
-            continueDownload();
-        });
+            buffer.clear();
+            observer->statusChanged(status);
+        }
+
+        if (offlineDatabase.exceedsOfflineMapboxTileCountLimit(resource)) {
+            onMapboxTileCountLimitExceeded();
+            return;
+        }
+
+        continueDownload();
     });
 }
 
@@ -1,31 +1,54 @@
 #include <mbgl/util/image.hpp>
 #include <mbgl/util/string.hpp>
-#include <mbgl/util/premultiply.hpp>
 
 namespace mbgl {
 
-PremultipliedImage decodePNG(const uint8_t*, size_t);
-PremultipliedImage decodeJPEG(const uint8_t*, size_t);
+void decodePNG(const uint8_t*, size_t, ImageDecodeTarget&);
+void decodeJPEG(const uint8_t*, size_t, ImageDecodeTarget&);
 
-PremultipliedImage decodeImage(const std::string& string) {
+void decodeImage(const std::string& string, ImageDecodeTarget& target) {
     const auto* data = reinterpret_cast<const uint8_t*>(string.data());
     const size_t size = string.size();
 
     if (size >= 4) {
         uint32_t magic = (data[0] << 24) | (data[1] << 16) | (data[2] << 8) | data[3];
         if (magic == 0x89504E47U) {
-            return decodePNG(data, size);
+            return decodePNG(data, size, target);
         }
     }
 
     if (size >= 2) {
         uint16_t magic = ((data[0] << 8) | data[1]) & 0xffff;
         if (magic == 0xFFD8) {
-            return decodeJPEG(data, size);
+            return decodeJPEG(data, size, target);
         }
     }
 
     throw std::runtime_error("unsupported image type");
 }
 
+namespace {
+
+// Decodes rows straight into the memory of the image they end up in.
+class PremultipliedImageTarget final : public ImageDecodeTarget {
+public:
+    void begin(Size size) override {
+        image = PremultipliedImage(size);
+    }
+
+    uint8_t* row(uint32_t y) override {
+        return image.data.get() + y * image.stride();
+    }
+
+    PremultipliedImage image;
+};
+
+} // namespace
+
+PremultipliedImage decodeImage(const std::string& string) {
+    PremultipliedImageTarget target;
+    decodeImage(string, target);
+    return std::move(target.image);
+}
+
 } // namespace mbgl
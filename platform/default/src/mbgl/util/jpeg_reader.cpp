@@ -89,7 +89,7 @@ struct jpeg_info_guard {
     jpeg_decompress_struct* i_;
 };
 
-PremultipliedImage decodeJPEG(const uint8_t* data, size_t size) {
+void decodeJPEG(const uint8_t* data, size_t size, ImageDecodeTarget& target) {
     util::CharArrayBuffer dataBuffer { reinterpret_cast<const char*>(data), size };
     std::istream stream(&dataBuffer);
 
@@ -119,13 +119,15 @@ PremultipliedImage decodeJPEG(const uint8_t* data, size_t size) {
     size_t components = cinfo.output_components;
     size_t rowStride = components * width;
 
-    PremultipliedImage image({ static_cast<uint32_t>(width), static_cast<uint32_t>(height) });
-    uint8_t* dst = image.data.get();
+    target.begin({ static_cast<uint32_t>(width), static_cast<uint32_t>(height) });
 
     JSAMPARRAY buffer = (*cinfo.mem->alloc_sarray)((j_common_ptr) &cinfo, JPOOL_IMAGE, rowStride, 1);
 
+    // JPEGs are opaque, so rows don't need to be premultiplied.
     while (cinfo.output_scanline < cinfo.output_height) {
+        const uint32_t y = cinfo.output_scanline;
         jpeg_read_scanlines(&cinfo, buffer, 1);
+        uint8_t* dst = target.row(y);
 
         for (size_t i = 0; i < width; ++i) {
             dst[0] = buffer[0][components * i];
@@ -141,11 +143,11 @@ PremultipliedImage decodeJPEG(const uint8_t* data, size_t size) {
 
             dst += 4;
         }
+
+        target.endRow(y);
     }
 
     jpeg_finish_decompress(&cinfo);
-
-    return image;
 }
 
 } // namespace mbgl
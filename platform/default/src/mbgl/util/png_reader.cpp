@@ -1,9 +1,11 @@
 #include <mbgl/util/image.hpp>
-#include <mbgl/util/premultiply.hpp>
 #include <mbgl/util/char_array_buffer.hpp>
+#include <mbgl/util/pixel_kernels.hpp>
 #include <mbgl/util/logging.hpp>
 
+#include <algorithm>
 #include <istream>
+#include <memory>
 #include <sstream>
 
 extern "C"
@@ -62,7 +64,7 @@ struct png_struct_guard {
     png_infopp i_;
 };
 
-PremultipliedImage decodePNG(const uint8_t* data, size_t size) {
+void decodePNG(const uint8_t* data, size_t size, ImageDecodeTarget& target) {
     util::CharArrayBuffer dataBuffer { reinterpret_cast<const char*>(data), size };
     std::istream stream(&dataBuffer);
 
@@ -98,8 +100,6 @@ PremultipliedImage decodePNG(const uint8_t* data, size_t size) {
     int color_type = 0;
     png_get_IHDR(png_ptr, info_ptr, &width, &height, &bit_depth, &color_type, nullptr, nullptr, nullptr);
 
-    UnassociatedImage image({ static_cast<uint32_t>(width), static_cast<uint32_t>(height) });
-
     if (color_type == PNG_COLOR_TYPE_PALETTE)
         png_set_expand(png_ptr);
 
@@ -118,7 +118,8 @@ PremultipliedImage decodePNG(const uint8_t* data, size_t size) {
 
     png_set_add_alpha(png_ptr, 0xff, PNG_FILLER_AFTER);
 
-    if (png_get_interlace_type(png_ptr,info_ptr) == PNG_INTERLACE_ADAM7) {
+    const bool interlaced = png_get_interlace_type(png_ptr, info_ptr) == PNG_INTERLACE_ADAM7;
+    if (interlaced) {
         png_set_interlace_handling(png_ptr); // FIXME: libpng bug?
         // according to docs png_read_image
         // "..automatically handles interlacing,
@@ -127,16 +128,35 @@ PremultipliedImage decodePNG(const uint8_t* data, size_t size) {
 
     png_read_update_info(png_ptr, info_ptr);
 
-    // we can read whole image at once
-    // alloc row pointers
-    const std::unique_ptr<png_bytep[]> rows(new png_bytep[height]);
-    for (unsigned row = 0; row < height; ++row)
-        rows[row] = image.data.get() + row * width * 4;
-    png_read_image(png_ptr, rows.get());
+    const Size imageSize { static_cast<uint32_t>(width), static_cast<uint32_t>(height) };
+    const auto& kernels = util::PixelKernels::get();
+    target.begin(imageSize);
+
+    if (!interlaced) {
+        // Decode and premultiply each row straight into the target, while it's still in cache.
+        for (uint32_t y = 0; y < height; ++y) {
+            png_bytep row = target.row(y);
+            png_read_row(png_ptr, row, nullptr);
+            kernels.premultiply(row, width);
+            target.endRow(y);
+        }
+    } else {
+        // Interlaced images revisit every row in each pass, so they need all rows at once.
+        UnassociatedImage image(imageSize);
+        const std::unique_ptr<png_bytep[]> rows(new png_bytep[height]);
+        for (unsigned row = 0; row < height; ++row)
+            rows[row] = image.data.get() + row * width * 4;
+        png_read_image(png_ptr, rows.get());
+
+        for (uint32_t y = 0; y < height; ++y) {
+            uint8_t* row = target.row(y);
+            std::copy(rows[y], rows[y] + width * 4, row);
+            kernels.premultiply(row, width);
+            target.endRow(y);
+        }
+    }
 
     png_read_end(png_ptr, nullptr);
-
-    return util::premultiply(std::move(image));
 }
 
 } // namespace mbgl
@@ -1,11 +1,20 @@
-#include <mbgl/util/compression.hpp>
+#include <mbgl/actor/scheduler.hpp>
 #include <mbgl/util/image.hpp>
+#include <mbgl/util/parallel_for.hpp>
 #include <mbgl/util/premultiply.hpp>
 
 #include <boost/crc.hpp>
 
+#include <zlib.h>
+
+#include <algorithm>
 #include <cassert>
+#include <cstdint>
+#include <cstdlib>
 #include <cstring>
+#include <functional>
+#include <stdexcept>
+#include <vector>
 
 #define NETWORK_BYTE_UINT32(value)                                                                 \
     char(value >> 24), char(value >> 16), char(value >> 8), char(value >> 0)
@@ -30,12 +39,106 @@ void addChunk(std::string& png, const char* type, const char* data = "", const u
     png.append(crc, 4);
 }
 
+using Filter = mbgl::PNGEncodeOptions::Filter;
+
+// Bytes per pixel of RGBA images, which is also the distance filters look back within a scanline.
+constexpr std::size_t bpp = 4;
+
+// Size of the deflate window, i.e. how much preceding data each band is primed with.
+constexpr std::size_t windowSize = 32 * 1024;
+
+inline uint8_t paethPredictor(const int a, const int b, const int c) {
+    const int p = a + b - c;
+    const int pa = std::abs(p - a);
+    const int pb = std::abs(p - b);
+    const int pc = std::abs(p - c);
+    if (pa <= pb && pa <= pc) {
+        return a;
+    }
+    return pb <= pc ? b : c;
+}
+
+// Writes the filter type byte and the filtered bytes of `row` to `out`. `prev` is the scanline
+// above, or nullptr for the first scanline.
+void filterScanline(const Filter filter, const uint8_t* row, const uint8_t* prev, const std::size_t stride, uint8_t* out) {
+    assert(filter != Filter::Adaptive);
+    *out++ = static_cast<uint8_t>(filter);
+    for (std::size_t i = 0; i < stride; ++i) {
+        const int left = i >= bpp ? row[i - bpp] : 0;
+        const int up = prev ? prev[i] : 0;
+        const int upLeft = prev && i >= bpp ? prev[i - bpp] : 0;
+        switch (filter) {
+        case Filter::Sub: out[i] = row[i] - left; break;
+        case Filter::Up: out[i] = row[i] - up; break;
+        case Filter::Average: out[i] = row[i] - ((left + up) >> 1); break;
+        case Filter::Paeth: out[i] = row[i] - paethPredictor(left, up, upLeft); break;
+        default: out[i] = row[i]; break;
+        }
+    }
+}
+
+// Filters a scanline with every filter, and keeps the one with the smallest sum of absolute
+// signed differences, which is the heuristic libpng uses.
+void filterScanlineAdaptive(const uint8_t* row, const uint8_t* prev, const std::size_t stride, uint8_t* out, std::vector<uint8_t>& scratch) {
+    scratch.resize(stride + 1);
+    uint64_t best = UINT64_MAX;
+    for (Filter filter : { Filter::None, Filter::Sub, Filter::Up, Filter::Average, Filter::Paeth }) {
+        filterScanline(filter, row, prev, stride, scratch.data());
+        uint64_t sum = 0;
+        for (std::size_t i = 1; i <= stride; ++i) {
+            sum += std::abs(static_cast<int8_t>(scratch[i]));
+        }
+        if (sum < best) {
+            best = sum;
+            std::memcpy(out, scratch.data(), stride + 1);
+        }
+    }
+}
+
+// Deflates `data[begin, end)` as a piece of one raw deflate stream, primed with the window of
+// data before it. Pieces other than the last one end with an empty stored block, so that they
+// end on a byte boundary and can be concatenated.
+std::string deflateBand(const uint8_t* data, const std::size_t begin, const std::size_t end, const bool last, const int level) {
+    z_stream stream;
+    std::memset(&stream, 0, sizeof(stream));
+    if (deflateInit2(&stream, level, Z_DEFLATED, -15, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+        throw std::runtime_error("failed to initialize deflate");
+    }
+
+    if (begin > 0) {
+        const std::size_t dictionarySize = std::min(begin, windowSize);
+        deflateSetDictionary(&stream, data + begin - dictionarySize, uInt(dictionarySize));
+    }
+
+    std::string result;
+    result.resize(deflateBound(&stream, uLong(end - begin)) + 16);
+    stream.next_in = const_cast<Bytef*>(data + begin);
+    stream.avail_in = uInt(end - begin);
+    stream.next_out = reinterpret_cast<Bytef*>(&result[0]);
+    stream.avail_out = uInt(result.size());
+
+    const int code = deflate(&stream, last ? Z_FINISH : Z_SYNC_FLUSH);
+    const bool done = last ? code == Z_STREAM_END : (code == Z_OK && stream.avail_in == 0 && stream.avail_out > 0);
+    result.resize(stream.total_out);
+    deflateEnd(&stream);
+
+    if (!done) {
+        throw std::runtime_error("failed to deflate image data");
+    }
+
+    return result;
+}
+
 } // namespace
 
 namespace mbgl {
 
-// Encode PNGs without libpng.
 std::string encodePNG(const PremultipliedImage& pre) {
+    return encodePNG(pre, PNGEncodeOptions());
+}
+
+// Encode PNGs without libpng.
+std::string encodePNG(const PremultipliedImage& pre, const PNGEncodeOptions& options) {
     // Make copy of the image so that we can unpremultiply it.
     const auto src = util::unpremultiply(pre.clone());
 
@@ -53,15 +156,71 @@ std::string encodePNG(const PremultipliedImage& pre) {
         0,                                    // interlace method == none
     };
 
-    // Prepare the (compressed) data chunk.
-    const auto stride = src.stride();
+    // Prepare the (compressed) data chunk. Every scanline is prefixed with one byte that
+    // indicates its filter type.
+    const std::size_t stride = src.stride();
+    const std::size_t height = src.size.height;
+    const std::size_t rowsPerBand = options.bandSize
+        ? std::max<std::size_t>(1, options.bandSize / (stride + 1))
+        : std::max<std::size_t>(1, height);
+    const std::size_t bandCount = std::max<std::size_t>(1, (height + rowsPerBand - 1) / rowsPerBand);
+
+    auto bandBegin = [&](std::size_t band) { return std::min(height, band * rowsPerBand) * (stride + 1); };
+
+    std::vector<uint8_t> filtered(height * (stride + 1));
+    std::vector<std::string> deflated(bandCount);
+    std::vector<uLong> checksums(bandCount);
+
+    auto forEachBand = [&](std::function<void(std::size_t)> fn) {
+        if (bandCount > 1) {
+            util::parallelFor(*Scheduler::GetBackground(), MailboxPriority::Visible, bandCount, std::move(fn));
+        } else {
+            fn(0);
+        }
+    };
+
+    // Filters only look at the unfiltered scanline above, so bands can be filtered independently.
+    forEachBand([&](std::size_t band) {
+        std::vector<uint8_t> scratch;
+        const std::size_t end = std::min(height, (band + 1) * rowsPerBand);
+        for (std::size_t y = band * rowsPerBand; y < end; ++y) {
+            const uint8_t* row = src.data.get() + y * stride;
+            const uint8_t* prev = y > 0 ? row - stride : nullptr;
+            uint8_t* out = filtered.data() + y * (stride + 1);
+            if (options.filter == PNGEncodeOptions::Filter::Adaptive) {
+                filterScanlineAdaptive(row, prev, stride, out, scratch);
+            } else {
+                filterScanline(options.filter, row, prev, stride, out);
+            }
+        }
+    });
+
+    // Deflating a band reads the window before it, so it has to wait until all bands are filtered.
+    forEachBand([&](std::size_t band) {
+        const std::size_t begin = bandBegin(band);
+        const std::size_t end = bandBegin(band + 1);
+        deflated[band] = deflateBand(filtered.data(), begin, end, band + 1 == bandCount, options.compressionLevel);
+        checksums[band] = adler32(adler32(0, nullptr, 0), filtered.data() + begin, uInt(end - begin));
+    });
+
+    // Wrap the pieces in a zlib stream: a header, and the Adler-32 checksum of all data.
+    uLong checksum = checksums[0];
+    std::size_t idatSize = 2 + 4;
+    for (std::size_t band = 0; band < bandCount; ++band) {
+        if (band > 0) {
+            checksum = adler32_combine(checksum, checksums[band], z_off_t(bandBegin(band + 1) - bandBegin(band)));
+        }
+        idatSize += deflated[band].size();
+    }
+
     std::string idat;
-    for (uint32_t y = 0; y < src.size.height; y++) {
-        // Every scanline needs to be prefixed with one byte that indicates the filter type.
-        idat.append(1, 0); // filter type 0
-        idat.append((const char*)(src.data.get() + y * stride), stride);
+    idat.reserve(idatSize);
+    idat.append({ char(0x78), char(0x9C) });
+    for (const auto& piece : deflated) {
+        idat.append(piece);
     }
-    idat = util::compress(idat);
+    const char adler[4] = { NETWORK_BYTE_UINT32(checksum) };
+    idat.append(adler, 4);
 
     // Assemble the PNG.
     std::string png;
@@ -4,9 +4,17 @@
 #include <QByteArray>
 #include <QImage>
 
+#include <algorithm>
+
 namespace mbgl {
 
 std::string encodePNG(const PremultipliedImage& pre) {
+    return encodePNG(pre, PNGEncodeOptions());
+}
+
+// Qt encodes on the calling thread and picks filters itself; only the compression level maps
+// to its quality setting.
+std::string encodePNG(const PremultipliedImage& pre, const PNGEncodeOptions& options) {
     QImage image(pre.data.get(), pre.size.width, pre.size.height,
         QImage::Format_ARGB32_Premultiplied);
 
@@ -14,13 +22,35 @@ std::string encodePNG(const PremultipliedImage& pre) {
     QBuffer buffer(&array);
 
     buffer.open(QIODevice::WriteOnly);
-    image.rgbSwapped().save(&buffer, "PNG");
+    const int quality = options.compressionLevel < 0 ? -1 : 100 - std::min(options.compressionLevel, 9) * 100 / 9;
+    image.rgbSwapped().save(&buffer, "PNG", quality);
 
     return std::string(array.constData(), array.size());
 }
 
 #if !defined(QT_IMAGE_DECODERS)
-PremultipliedImage decodeJPEG(const uint8_t*, size_t);
+void decodeJPEG(const uint8_t*, size_t, ImageDecodeTarget&);
+
+namespace {
+
+class PremultipliedImageTarget final : public ImageDecodeTarget {
+public:
+    void begin(Size size) override {
+        image = PremultipliedImage(size);
+    }
+
+    uint8_t* row(uint32_t y) override {
+        return image.data.get() + y * image.stride();
+    }
+
+    PremultipliedImage image;
+};
+
+bool isJPEG(const uint8_t* data, size_t size) {
+    return size >= 2 && (((data[0] << 8) | data[1]) & 0xffff) == 0xFFD8;
+}
+
+} // namespace
 #endif
 
 PremultipliedImage decodeImage(const std::string& string) {
@@ -28,11 +58,10 @@ PremultipliedImage decodeImage(const std::string& string) {
     const size_t size = string.size();
 
 #if !defined(QT_IMAGE_DECODERS)
-    if (size >= 2) {
-        uint16_t magic = ((data[0] << 8) | data[1]) & 0xffff;
-        if (magic == 0xFFD8) {
-            return decodeJPEG(data, size);
-        }
+    if (isJPEG(data, size)) {
+        PremultipliedImageTarget target;
+        decodeJPEG(data, size, target);
+        return std::move(target.image);
     }
 #endif
 
@@ -51,4 +80,18 @@ PremultipliedImage decodeImage(const std::string& string) {
     return { { static_cast<uint32_t>(image.width()), static_cast<uint32_t>(image.height()) },
              std::move(img) };
 }
+
+// QImage decodes whole images, so the rows are handed to the target once decoding is done.
+void decodeImage(const std::string& string, ImageDecodeTarget& target) {
+#if !defined(QT_IMAGE_DECODERS)
+    const uint8_t* data = reinterpret_cast<const uint8_t*>(string.data());
+    if (isJPEG(data, string.size())) {
+        decodeJPEG(data, string.size(), target);
+        return;
+    }
+#endif
+
+    target.write(decodeImage(string));
+}
+
 }
@@ -45,6 +45,14 @@ void Mailbox::close() {
 
 bool Mailbox::isOpen() const { return bool(scheduler); }
 
+void Mailbox::setPriority(MailboxPriority priority_) {
+    priority = priority_;
+}
+
+MailboxPriority Mailbox::getPriority() const {
+    return priority;
+}
+
 
 void Mailbox::push(std::unique_ptr<Message> message) {
     std::lock_guard<std::mutex> pushingLock(pushingMutex);
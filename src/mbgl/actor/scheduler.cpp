@@ -1,6 +1,9 @@
 #include <mbgl/actor/scheduler.hpp>
 #include <mbgl/util/thread_local.hpp>
 #include <mbgl/util/thread_pool.hpp>
+#include <mbgl/util/work_stealing_thread_pool.hpp>
+
+#include <atomic>
 
 namespace mbgl {
 
@@ -19,6 +22,16 @@ Scheduler* Scheduler::GetCurrent() {
     return current().get();
 }
 
+static auto& backgroundType() {
+    static std::atomic<Scheduler::BackgroundType> type { Scheduler::BackgroundType::ThreadPool };
+    return type;
+}
+
+// static
+void Scheduler::SetBackgroundType(BackgroundType type) {
+    backgroundType() = type;
+}
+
 // static
 std::shared_ptr<Scheduler> Scheduler::GetBackground() {
     static std::weak_ptr<Scheduler> weak;
@@ -28,7 +41,11 @@ std::shared_ptr<Scheduler> Scheduler::GetBackground() {
     std::shared_ptr<Scheduler> scheduler = weak.lock();
 
     if (!scheduler) {
-        weak = scheduler = std::make_shared<ThreadPool>(4);
+        if (backgroundType() == BackgroundType::WorkStealing) {
+            weak = scheduler = std::make_shared<WorkStealingThreadPool>(4);
+        } else {
+            weak = scheduler = std::make_shared<ThreadPool>(4);
+        }
     }
 
     return scheduler;
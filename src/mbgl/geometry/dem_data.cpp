@@ -1,18 +1,68 @@
 #include <mbgl/geometry/dem_data.hpp>
 #include <mbgl/math/clamp.hpp>
+#include <mbgl/util/optional.hpp>
+
+#include <cstring>
+#include <stdexcept>
 
 namespace mbgl {
 
-DEMData::DEMData(const PremultipliedImage& _image, Tileset::DEMEncoding encoding):
-    dim(_image.size.height),
+DEMData::DEMData(const int32_t dim_):
+    dim(dim_),
     // extra two pixels per row for border backfilling on either edge
     stride(dim + 2),
     image({ static_cast<uint32_t>(stride), static_cast<uint32_t>(stride) }) {
+    std::memset(image.data.get(), 0, image.bytes());
+}
+
+DEMData::DEMData(const PremultipliedImage& _image, Tileset::DEMEncoding encoding):
+    DEMData(_image.size.height) {
 
     if (_image.size.height != _image.size.width){
         throw std::runtime_error("raster-dem tiles must be square.");
     }
 
+    for (int32_t y = 0; y < dim; y++) {
+        setRow(y, _image.data.get() + y * _image.stride(), encoding);
+    }
+
+    fillBorder();
+}
+
+DEMData DEMData::decode(const std::string& encodedImage, Tileset::DEMEncoding encoding) {
+    // Decodes each row into one reused buffer and converts it to elevations right away.
+    class Target final : public ImageDecodeTarget {
+    public:
+        explicit Target(Tileset::DEMEncoding encoding_) : encoding(encoding_) {}
+
+        void begin(Size size) override {
+            if (size.height != size.width) {
+                throw std::runtime_error("raster-dem tiles must be square.");
+            }
+            data.emplace(DEMData(static_cast<int32_t>(size.height)));
+            rowData.resize(size.width * 4);
+        }
+
+        uint8_t* row(uint32_t) override {
+            return rowData.data();
+        }
+
+        void endRow(uint32_t y) override {
+            data->setRow(y, rowData.data(), encoding);
+        }
+
+        const Tileset::DEMEncoding encoding;
+        optional<DEMData> data;
+        std::vector<uint8_t> rowData;
+    };
+
+    Target target(encoding);
+    decodeImage(encodedImage, target);
+    target.data->fillBorder();
+    return std::move(*target.data);
+}
+
+void DEMData::setRow(const int32_t y, const uint8_t* rgba, Tileset::DEMEncoding encoding) {
     auto decodeMapbox = [] (const uint8_t r, const uint8_t g, const uint8_t b){
         // https://www.mapbox.com/help/access-elevation-data/#mapbox-terrain-rgb
         return (r * 256 * 256 + g * 256 + b)/10 - 10000;
@@ -25,16 +75,13 @@ DEMData::DEMData(const PremultipliedImage& _image, Tileset::DEMEncoding encoding
 
     auto decodeRGB = encoding == Tileset::DEMEncoding::Terrarium ? decodeTerrarium : decodeMapbox;
 
-    std::memset(image.data.get(), 0, image.bytes());
-
-    for (int32_t y = 0; y < dim; y++) {
-        for (int32_t x = 0; x < dim; x++) {
-            const int32_t i = y * dim + x;
-            const int32_t j = i * 4;
-            set(x, y, decodeRGB(_image.data[j], _image.data[j+1], _image.data[j+2]));
-        }
+    for (int32_t x = 0; x < dim; x++) {
+        const int32_t j = x * 4;
+        set(x, y, decodeRGB(rgba[j], rgba[j+1], rgba[j+2]));
     }
-    
+}
+
+void DEMData::fillBorder() {
     // in order to avoid flashing seams between tiles, here we are initially populating a 1px border of
     // pixels around the image with the data of the nearest pixel from the image. this data is eventually
     // replaced when the tile's neighboring tiles are loaded and the accurate data can be backfilled using
@@ -7,6 +7,7 @@
 #include <memory>
 #include <array>
 #include <cassert>
+#include <string>
 #include <vector>
 
 namespace mbgl {
@@ -14,6 +15,9 @@ namespace mbgl {
 class DEMData {
 public:
     DEMData(const PremultipliedImage& image, Tileset::DEMEncoding encoding);
+    // Decodes a PNG or JPEG tile one row at a time, without holding its RGBA pixels.
+    static DEMData decode(const std::string& encodedImage, Tileset::DEMEncoding encoding);
+
     void backfillBorder(const DEMData& borderTileData, int8_t dx, int8_t dy);
 
     void set(const int32_t x, const int32_t y, const int32_t value) {
@@ -33,6 +37,11 @@ public:
 
 
     private:
+        explicit DEMData(int32_t dim);
+
+        void setRow(int32_t y, const uint8_t* rgba, Tileset::DEMEncoding encoding);
+        void fillBorder();
+
         PremultipliedImage image;
 
         size_t idx(const int32_t x, const int32_t y) const {
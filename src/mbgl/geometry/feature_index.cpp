@@ -11,6 +11,7 @@
 
 #include <mapbox/geometry/envelope.hpp>
 
+#include <algorithm>
 #include <cassert>
 #include <string>
 
@@ -21,20 +22,47 @@ FeatureIndex::FeatureIndex(std::unique_ptr<const GeometryTileData> tileData_)
     , tileData(std::move(tileData_)) {
 }
 
+StringIdentity FeatureIndex::intern(const std::string& string) {
+    // A tile only refers to a handful of layers, so a linear search is fast enough.
+    auto it = std::find(strings.begin(), strings.end(), string);
+    if (it == strings.end()) {
+        it = strings.insert(it, string);
+    }
+    return static_cast<StringIdentity>(it - strings.begin());
+}
+
 void FeatureIndex::insert(const GeometryCollection& geometries,
                           std::size_t index,
-                          const std::string& sourceLayerName,
-                          const std::string& bucketLeaderID) {
-    auto featureSortIndex = sortIndex++;
+                          StringIdentity sourceLayerNameId,
+                          StringIdentity bucketLeaderId) {
+    std::size_t featureSortIndex = sortIndex++;
     for (const auto& ring : geometries) {
-        auto envelope = mapbox::geometry::envelope(ring);
-        if (envelope.min.x < util::EXTENT &&
-            envelope.min.y < util::EXTENT &&
-            envelope.max.x >= 0 &&
-            envelope.max.y >= 0) {
-            grid.insert(IndexedSubfeature(index, sourceLayerName, bucketLeaderID, featureSortIndex++),
-                        {convertPoint<float>(envelope.min), convertPoint<float>(envelope.max)});
-        }
+        insertRing(mapbox::geometry::envelope(ring), index, sourceLayerNameId, bucketLeaderId, featureSortIndex);
+    }
+}
+
+void FeatureIndex::insert(RingEnvelopes::const_iterator begin,
+                          RingEnvelopes::const_iterator end,
+                          std::size_t index,
+                          StringIdentity sourceLayerNameId,
+                          StringIdentity bucketLeaderId) {
+    std::size_t featureSortIndex = sortIndex++;
+    for (auto it = begin; it != end; ++it) {
+        insertRing(*it, index, sourceLayerNameId, bucketLeaderId, featureSortIndex);
+    }
+}
+
+void FeatureIndex::insertRing(const mapbox::geometry::box<int16_t>& envelope,
+                              std::size_t index,
+                              StringIdentity sourceLayerNameId,
+                              StringIdentity bucketLeaderId,
+                              std::size_t& featureSortIndex) {
+    if (envelope.min.x < util::EXTENT &&
+        envelope.min.y < util::EXTENT &&
+        envelope.max.x >= 0 &&
+        envelope.max.y >= 0) {
+        grid.insert(IndexedSubfeature(index, sourceLayerNameId, bucketLeaderId, featureSortIndex++),
+                    {convertPoint<float>(envelope.min), convertPoint<float>(envelope.max)});
     }
 }
 
@@ -68,13 +96,14 @@ void FeatureIndex::query(
         return a.sortIndex > b.sortIndex;
     });
     size_t previousSortIndex = std::numeric_limits<size_t>::max();
+    SourceLayers sourceLayers;
     for (const auto& indexedFeature : features) {
 
         // If this feature is the same as the previous feature, skip it.
         if (indexedFeature.sortIndex == previousSortIndex) continue;
         previousSortIndex = indexedFeature.sortIndex;
 
-        addFeature(result, indexedFeature, queryOptions, tileID.canonical, layers, queryGeometry, transformState, pixelsToTileUnits, posMatrix);
+        addFeature(result, sourceLayers, indexedFeature, queryOptions, tileID.canonical, layers, queryGeometry, transformState, pixelsToTileUnits, posMatrix);
     }
 }
     
@@ -111,15 +140,17 @@ FeatureIndex::lookupSymbolFeatures(const std::vector<IndexedSubfeature>& symbolF
         }
     });
 
+    SourceLayers sourceLayers;
     for (const auto& symbolFeature : sortedFeatures) {
         mat4 unusedMatrix;
-        addFeature(result, symbolFeature, queryOptions, tileID.canonical, layers, GeometryCoordinates(), {}, 0, unusedMatrix);
+        addFeature(result, sourceLayers, symbolFeature, queryOptions, tileID.canonical, layers, GeometryCoordinates(), {}, 0, unusedMatrix);
     }
     return result;
 }
 
 void FeatureIndex::addFeature(
     std::unordered_map<std::string, std::vector<Feature>>& result,
+    SourceLayers& sourceLayers,
     const IndexedSubfeature& indexedFeature,
     const RenderedQueryOptions& options,
     const CanonicalTileID& tileID,
@@ -139,17 +170,20 @@ void FeatureIndex::addFeature(
     };
 
     // Lazily calculated.
-    std::unique_ptr<GeometryTileLayer> sourceLayer;
     std::unique_ptr<GeometryTileFeature> geometryTileFeature;
 
-    for (const std::string& layerID : bucketLayerIDs.at(indexedFeature.bucketLeaderID)) {
+    for (const std::string& layerID : bucketLayerIDs.at(indexedFeature.bucketLeaderId)) {
         const RenderLayer* renderLayer = getRenderLayer(layerID);
         if (!renderLayer) {
             continue;
         }
 
         if (!geometryTileFeature) {
-            sourceLayer = tileData->getLayer(indexedFeature.sourceLayerName);
+            // Opening a source layer parses its feature table, so do it once per query.
+            auto& sourceLayer = sourceLayers[indexedFeature.sourceLayerNameId];
+            if (!sourceLayer) {
+                sourceLayer = tileData->getLayer(lookup(indexedFeature.sourceLayerNameId));
+            }
             assert(sourceLayer);
 
             geometryTileFeature = sourceLayer->getFeature(indexedFeature.index);
@@ -192,8 +226,33 @@ optional<GeometryCoordinates> FeatureIndex::translateQueryGeometry(
     return translated;
 }
 
-void FeatureIndex::setBucketLayerIDs(const std::string& bucketLeaderID, const std::vector<std::string>& layerIDs) {
-    bucketLayerIDs[bucketLeaderID] = layerIDs;
+void FeatureIndex::setBucketLayerIDs(StringIdentity bucketLeaderId, const std::vector<std::string>& layerIDs) {
+    bucketLayerIDs[bucketLeaderId] = layerIDs;
+}
+
+void FeatureIndex::compact() {
+    grid.compact();
+}
+
+std::size_t FeatureIndex::bytes() const {
+    return grid.bytes() + (tileData ? tileData->bytes() : 0);
+}
+
+void FeatureIndexBatch::add(std::size_t index, const GeometryCollection& geometries) {
+    for (const auto& ring : geometries) {
+        ringEnvelopes.push_back(mapbox::geometry::envelope(ring));
+    }
+    entries.push_back({ index, geometries.size() });
+}
+
+void FeatureIndexBatch::insertInto(FeatureIndex& featureIndex,
+                                   StringIdentity sourceLayerNameId,
+                                   StringIdentity bucketLeaderId) const {
+    auto envelope = ringEnvelopes.cbegin();
+    for (const auto& entry : entries) {
+        featureIndex.insert(envelope, envelope + entry.ringCount, entry.index, sourceLayerNameId, bucketLeaderId);
+        envelope += entry.ringCount;
+    }
 }
 
 } // namespace mbgl
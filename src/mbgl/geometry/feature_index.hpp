@@ -7,6 +7,8 @@
 #include <mbgl/util/feature.hpp>
 #include <mbgl/util/mat4.hpp>
 
+#include <mapbox/geometry/box.hpp>
+
 #include <vector>
 #include <string>
 #include <unordered_map>
@@ -19,31 +21,35 @@ class TransformState;
 
 class CollisionIndex;
 
+// Refers to a layer or source layer name, in the table of the FeatureIndex that a subfeature
+// belongs to.
+using StringIdentity = uint32_t;
+
 class IndexedSubfeature {
 public:
     IndexedSubfeature() = delete;
-    IndexedSubfeature(std::size_t index_, std::string sourceLayerName_, std::string bucketName_, size_t sortIndex_)
+    IndexedSubfeature(std::size_t index_, StringIdentity sourceLayerNameId_, StringIdentity bucketLeaderId_, size_t sortIndex_)
         : index(index_)
-        , sourceLayerName(std::move(sourceLayerName_))
-        , bucketLeaderID(std::move(bucketName_))
         , sortIndex(sortIndex_)
+        , sourceLayerNameId(sourceLayerNameId_)
+        , bucketLeaderId(bucketLeaderId_)
         , bucketInstanceId(0)
         , collisionGroupId(0)
     {}
-    
-    
+
     IndexedSubfeature(const IndexedSubfeature& other, uint32_t bucketInstanceId_, uint16_t collisionGroupId_)
         : index(other.index)
-        , sourceLayerName(other.sourceLayerName)
-        , bucketLeaderID(other.bucketLeaderID)
         , sortIndex(other.sortIndex)
+        , sourceLayerNameId(other.sourceLayerNameId)
+        , bucketLeaderId(other.bucketLeaderId)
         , bucketInstanceId(bucketInstanceId_)
         , collisionGroupId(collisionGroupId_)
     {}
+
     size_t index;
-    std::string sourceLayerName;
-    std::string bucketLeaderID;
     size_t sortIndex;
+    StringIdentity sourceLayerNameId;
+    StringIdentity bucketLeaderId;
 
     // Only used for symbol features
     uint32_t bucketInstanceId;
@@ -55,8 +61,20 @@ public:
     FeatureIndex(std::unique_ptr<const GeometryTileData> tileData_);
 
     const GeometryTileData* getData() { return tileData.get(); }
+
+    // Subfeatures refer to layer and source layer names through identities that are only
+    // meaningful to the index that issued them. Symbol subfeatures are issued by the index
+    // that their tile was laid out with, and are looked up in that same index.
+    StringIdentity intern(const std::string&);
+    const std::string& lookup(StringIdentity id) const { return strings.at(id); }
     
-    void insert(const GeometryCollection&, std::size_t index, const std::string& sourceLayerName, const std::string& bucketLeaderID);
+    void insert(const GeometryCollection&, std::size_t index, StringIdentity sourceLayerNameId, StringIdentity bucketLeaderId);
+
+    // Same as insert() with the geometries these ring envelopes were computed from, for
+    // callers that don't keep the geometries around.
+    using RingEnvelopes = std::vector<mapbox::geometry::box<int16_t>>;
+    void insert(RingEnvelopes::const_iterator begin, RingEnvelopes::const_iterator end,
+                std::size_t index, StringIdentity sourceLayerNameId, StringIdentity bucketLeaderId);
 
     void query(
             std::unordered_map<std::string, std::vector<Feature>>& result,
@@ -77,7 +95,13 @@ public:
             const float bearing,
             const float pixelsToTileUnits);
 
-    void setBucketLayerIDs(const std::string& bucketLeaderID, const std::vector<std::string>& layerIDs);
+    void setBucketLayerIDs(StringIdentity bucketLeaderId, const std::vector<std::string>& layerIDs);
+
+    // Lays out the index for querying. Call once all features have been inserted.
+    void compact();
+
+    // Estimated memory held by the index and the tile data it refers to.
+    std::size_t bytes() const;
     
     std::unordered_map<std::string, std::vector<Feature>> lookupSymbolFeatures(
            const std::vector<IndexedSubfeature>& symbolFeatures,
@@ -87,8 +111,15 @@ public:
            const std::shared_ptr<std::vector<size_t>>& featureSortOrder) const;
 
 private:
+    // Source layers opened while answering a single query, by interned name.
+    using SourceLayers = std::unordered_map<StringIdentity, std::unique_ptr<GeometryTileLayer>>;
+
+    void insertRing(const mapbox::geometry::box<int16_t>& envelope, std::size_t index, StringIdentity sourceLayerNameId,
+                    StringIdentity bucketLeaderId, std::size_t& featureSortIndex);
+
     void addFeature(
             std::unordered_map<std::string, std::vector<Feature>>& result,
+            SourceLayers&,
             const IndexedSubfeature&,
             const RenderedQueryOptions& options,
             const CanonicalTileID&,
@@ -101,7 +132,28 @@ private:
     GridIndex<IndexedSubfeature> grid;
     unsigned int sortIndex = 0;
 
-    std::unordered_map<std::string, std::vector<std::string>> bucketLayerIDs;
+    std::vector<std::string> strings;
+    std::unordered_map<StringIdentity, std::vector<std::string>> bucketLayerIDs;
     std::unique_ptr<const GeometryTileData> tileData;
 };
+
+// Features of one layer group that are added to a FeatureIndex later on, so that layer
+// groups can be parsed concurrently without sharing the index.
+class FeatureIndexBatch {
+public:
+    void add(std::size_t index, const GeometryCollection&);
+
+    // Inserts the features in the order they were added.
+    void insertInto(FeatureIndex&, StringIdentity sourceLayerNameId, StringIdentity bucketLeaderId) const;
+
+private:
+    struct Entry {
+        std::size_t index;
+        std::size_t ringCount;
+    };
+
+    std::vector<Entry> entries;
+    FeatureIndex::RingEnvelopes ringEnvelopes;
+};
+
 } // namespace mbgl
@@ -6,6 +6,7 @@
 #include <mbgl/gfx/program.hpp>
 #include <mbgl/gfx/types.hpp>
 #include <mbgl/gfx/texture.hpp>
+#include <mbgl/gfx/rendering_stats.hpp>
 
 namespace mbgl {
 
@@ -38,6 +39,14 @@ public:
     // Called at the end of a frame.
     virtual void performCleanup() = 0;
 
+    // Commands issued since the stats were last reset.
+    RenderingStats& renderingStats() { return stats; }
+    const RenderingStats& renderingStats() const { return stats; }
+    void resetRenderingStats() { stats = {}; }
+
+protected:
+    RenderingStats stats;
+
 public:
     virtual std::unique_ptr<OffscreenTexture>
         createOffscreenTexture(Size,
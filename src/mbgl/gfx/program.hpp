@@ -49,6 +49,10 @@ public:
                       const IndexBuffer&,
                       std::size_t indexOffset,
                       std::size_t indexLength) = 0;
+
+    // Builds the variant of the program that draws with the first `boundAttributes` attributes
+    // bound and all others replaced by uniforms, ahead of the first draw that needs it.
+    virtual void precompile(Context&, std::size_t boundAttributes) = 0;
 };
 
 } // namespace gfx
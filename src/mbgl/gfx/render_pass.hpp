@@ -35,6 +35,12 @@ public:
     DebugGroup<RenderPass> createDebugGroup(const char* name) {
         return { *this, name };
     }
+
+    // Draws issued between these calls are recorded, and issued sorted by depth range and
+    // program when the list ends. Only record draws whose order only matters among draws that
+    // share both, such as the tiles of a layer that each draw inside their own clipping mask.
+    virtual void beginDrawList() = 0;
+    virtual void endDrawList() = 0;
 };
 
 } // namespace gfx
@@ -109,6 +109,16 @@ public:
                         0)... });
         return result;
     }
+
+    // Returns the defines of the bindings that compute() maps to `key`.
+    static std::string defines(uint32_t key) {
+        std::string result;
+        util::ignore({ (!(key & (1 << TypeIndex<As, As...>::value))
+                            ? (void)(result += concat_literals<&attributeDefinePrefix, &As::name, &string_literal<'\n'>::value>::value())
+                            : (void)0,
+                        0)... });
+        return result;
+    }
 };
 
 } // namespace gl
@@ -0,0 +1,144 @@
+#include <mbgl/gl/binary_program.hpp>
+#include <mbgl/gl/context.hpp>
+#include <mbgl/util/io.hpp>
+#include <mbgl/util/logging.hpp>
+#include <mbgl/util/string.hpp>
+
+#include <protozero/pbf_reader.hpp>
+#include <protozero/pbf_writer.hpp>
+
+#include <cstdio>
+#include <functional>
+#include <random>
+#include <stdexcept>
+#include <thread>
+
+#if defined(_WIN32)
+#include <process.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace mbgl {
+namespace gl {
+
+namespace {
+
+// Returns a file name next to `path` that other threads and processes writing the same program
+// don't pick. The random part covers processes with the same ID, e.g. in different containers
+// that share the cache directory.
+std::string temporaryPathFor(const std::string& path) {
+#if defined(_WIN32)
+    const auto processID = static_cast<uint64_t>(_getpid());
+#else
+    const auto processID = static_cast<uint64_t>(getpid());
+#endif
+    const auto threadID = static_cast<uint64_t>(std::hash<std::thread::id>()(std::this_thread::get_id()));
+    const auto random = static_cast<uint64_t>(std::random_device()());
+    return path + '.' + util::toHex(processID) + '-' + util::toHex(threadID) + '-' + util::toHex(random) + ".tmp";
+}
+
+} // namespace
+
+BinaryProgram::BinaryProgram(std::string&& data) {
+    bool hasFormat = false;
+    bool hasCode = false;
+
+    protozero::pbf_reader pbf(data);
+    while (pbf.next()) {
+        switch (pbf.tag()) {
+        case 1: // format
+            binaryFormat = pbf.get_uint32();
+            hasFormat = true;
+            break;
+        case 2: // code
+            binaryCode = pbf.get_bytes();
+            hasCode = true;
+            break;
+        case 3: // identifier
+            binaryIdentifier = pbf.get_string();
+            break;
+        case 4: // driver
+            driverIdentifier = pbf.get_string();
+            break;
+        default:
+            pbf.skip();
+            break;
+        }
+    }
+
+    if (!hasFormat || !hasCode) {
+        throw std::runtime_error("BinaryProgram binary data is missing");
+    }
+}
+
+BinaryProgram::BinaryProgram(BinaryProgramFormat binaryFormat_,
+                             std::string&& binaryCode_,
+                             std::string binaryIdentifier_,
+                             std::string driverIdentifier_)
+    : binaryFormat(binaryFormat_),
+      binaryCode(std::move(binaryCode_)),
+      binaryIdentifier(std::move(binaryIdentifier_)),
+      driverIdentifier(std::move(driverIdentifier_)) {
+}
+
+std::string BinaryProgram::serialize() const {
+    std::string data;
+    data.reserve(32 + binaryCode.size() + binaryIdentifier.size() + driverIdentifier.size());
+    protozero::pbf_writer pbf(data);
+    pbf.add_uint32(1 /* format */, binaryFormat);
+    pbf.add_bytes(2 /* code */, binaryCode.data(), binaryCode.size());
+    pbf.add_string(3 /* identifier */, binaryIdentifier);
+    pbf.add_string(4 /* driver */, driverIdentifier);
+    return data;
+}
+
+optional<BinaryProgram> readBinaryProgram(const Context& context,
+                                          const std::string& path,
+                                          const std::string& identifier) {
+    try {
+        auto data = util::readFile(path);
+        if (!data) {
+            return {};
+        }
+        BinaryProgram binaryProgram(std::move(*data));
+        if (binaryProgram.identifier() != identifier) {
+            Log::Warning(Event::OpenGL, "Cached program %s changed. Recompilation required.", path.c_str());
+            return {};
+        }
+        if (binaryProgram.driver() != context.getDriverIdentifier()) {
+            Log::Warning(Event::OpenGL, "Cached program %s was built by another driver. Recompilation required.", path.c_str());
+            return {};
+        }
+        return optional<BinaryProgram>(std::move(binaryProgram));
+    } catch (const std::exception& error) {
+        Log::Warning(Event::OpenGL, "Could not load cached program: %s", error.what());
+        return {};
+    }
+}
+
+void writeBinaryProgram(Context& context, ProgramID program, const std::string& path, std::string identifier) {
+    try {
+        auto binary = context.getBinaryProgram(program);
+        if (!binary) {
+            return;
+        }
+        const BinaryProgram binaryProgram(binary->first, std::move(binary->second),
+                                          std::move(identifier), context.getDriverIdentifier());
+
+        // Other renderers may read the cache at the same time, so write to a file of our own and
+        // move it into place, which never leaves a partially written program at `path`.
+        const std::string temporaryPath = temporaryPathFor(path);
+        util::write_file(temporaryPath, binaryProgram.serialize());
+        if (std::rename(temporaryPath.c_str(), path.c_str()) != 0) {
+            std::remove(temporaryPath.c_str());
+            return;
+        }
+        Log::Info(Event::OpenGL, "Caching program in: %s", path.c_str());
+    } catch (const std::exception& error) {
+        Log::Warning(Event::OpenGL, "Failed to cache program: %s", error.what());
+    }
+}
+
+} // namespace gl
+} // namespace mbgl
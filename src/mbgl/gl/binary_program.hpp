@@ -0,0 +1,60 @@
+#pragma once
+
+#include <mbgl/gl/types.hpp>
+#include <mbgl/util/optional.hpp>
+
+#include <string>
+
+namespace mbgl {
+namespace gl {
+
+// A linked program as returned by the driver, along with what it was built from, so that it can
+// be stored on disk and checked before it's loaded again.
+class BinaryProgram {
+public:
+    // Parses a serialized program; throws if the data is malformed.
+    BinaryProgram(std::string&& data);
+
+    BinaryProgram(BinaryProgramFormat binaryFormat,
+                  std::string&& binaryCode,
+                  std::string binaryIdentifier,
+                  std::string driverIdentifier);
+
+    std::string serialize() const;
+
+    BinaryProgramFormat format() const {
+        return binaryFormat;
+    }
+
+    const std::string& code() const {
+        return binaryCode;
+    }
+
+    // Identifies the shader sources and defines the program was built from.
+    const std::string& identifier() const {
+        return binaryIdentifier;
+    }
+
+    // Identifies the driver that built the program, see Context::getDriverIdentifier().
+    const std::string& driver() const {
+        return driverIdentifier;
+    }
+
+private:
+    BinaryProgramFormat binaryFormat = 0;
+    std::string binaryCode;
+    std::string binaryIdentifier;
+    std::string driverIdentifier;
+};
+
+class Context;
+
+// Reads the program cached at `path`, if it was built from the sources and defines that
+// `identifier` describes, by the driver of `context`.
+optional<BinaryProgram> readBinaryProgram(const Context&, const std::string& path, const std::string& identifier);
+
+// Caches the binary of `program` at `path`, if the driver provides one.
+void writeBinaryProgram(Context&, ProgramID program, const std::string& path, std::string identifier);
+
+} // namespace gl
+} // namespace mbgl
@@ -0,0 +1,208 @@
+#include <mbgl/gl/buffer_arena.hpp>
+#include <mbgl/gl/context.hpp>
+#include <mbgl/gl/defines.hpp>
+#include <mbgl/gl/enum.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <iterator>
+
+namespace mbgl {
+namespace gl {
+
+using namespace platform;
+
+constexpr std::size_t BufferArena::pageSize;
+constexpr std::size_t BufferArena::maxSharedSize;
+constexpr std::size_t BufferArena::alignment;
+
+BufferArena::Allocation::Allocation(BufferArena& arena_, Page& page_, std::size_t offset_, std::size_t size_)
+    : arena(&arena_), page(&page_), offset(offset_), size(size_) {
+}
+
+BufferArena::Allocation::Allocation(Allocation&& other) noexcept
+    : arena(other.arena), page(other.page), offset(other.offset), size(other.size) {
+    other.arena = nullptr;
+}
+
+BufferArena::Allocation& BufferArena::Allocation::operator=(Allocation&& other) noexcept {
+    if (this != &other) {
+        if (arena) {
+            arena->release(*page, offset, size);
+        }
+        arena = other.arena;
+        page = other.page;
+        offset = other.offset;
+        size = other.size;
+        other.arena = nullptr;
+    }
+    return *this;
+}
+
+BufferArena::Allocation::~Allocation() {
+    if (arena) {
+        arena->release(*page, offset, size);
+    }
+}
+
+BufferID BufferArena::Allocation::getBuffer() const {
+    return page->buffer;
+}
+
+BufferArena::BufferArena(Context& context_, Target target_)
+    : context(context_), target(target_) {
+}
+
+BufferArena::Allocation BufferArena::allocate(const void* data, std::size_t size, const gfx::BufferUsageType usage) {
+    if (usage != gfx::BufferUsageType::StaticDraw || size > maxSharedSize) {
+        Page& page = createPage(size, usage, data, false);
+        page.used = size;
+        return { *this, page, 0, size };
+    }
+
+    const std::size_t rounded = std::max(alignment, (size + alignment - 1) / alignment * alignment);
+
+    Page* page = nullptr;
+    std::size_t offset = 0;
+    for (auto& candidate : pages) {
+        if (!candidate->shared) {
+            continue;
+        }
+        auto it = candidate->freeBySize.lower_bound(rounded);
+        if (it != candidate->freeBySize.end()) {
+            page = candidate.get();
+            offset = it->second;
+            break;
+        }
+    }
+
+    if (!page) {
+        page = &createPage(pageSize, usage, nullptr, true);
+        addFreeRange(*page, 0, pageSize);
+    } else {
+        bind(page->buffer);
+    }
+
+    takeRange(*page, page->freeByOffset.find(offset), rounded);
+    MBGL_CHECK_ERROR(glBufferSubData(target == Target::Vertex ? GL_ARRAY_BUFFER : GL_ELEMENT_ARRAY_BUFFER,
+                                     offset, size, data));
+    return { *this, *page, offset, rounded };
+}
+
+void BufferArena::update(const Allocation& allocation, const void* data, std::size_t size) {
+    assert(size <= allocation.getSize());
+    bind(allocation.getBuffer());
+    MBGL_CHECK_ERROR(glBufferSubData(target == Target::Vertex ? GL_ARRAY_BUFFER : GL_ELEMENT_ARRAY_BUFFER,
+                                     allocation.getOffset(), size, data));
+}
+
+void BufferArena::shrink() {
+    pages.erase(std::remove_if(pages.begin(), pages.end(), [](const auto& page) {
+        return page->used == 0;
+    }), pages.end());
+}
+
+std::size_t BufferArena::getBytesUsed() const {
+    std::size_t result = 0;
+    for (const auto& page : pages) {
+        result += page->used;
+    }
+    return result;
+}
+
+void BufferArena::bind(BufferID id) {
+    if (target == Target::Vertex) {
+        context.vertexBuffer = id;
+    } else {
+        // Be sure to unbind any existing vertex array object before binding the index buffer
+        // so that we don't mess up another VAO
+        context.bindVertexArray = 0;
+        context.globalVertexArrayState.indexBuffer = id;
+    }
+}
+
+BufferArena::Page& BufferArena::createPage(std::size_t size, const gfx::BufferUsageType usage, const void* data, bool shared) {
+    BufferID id = 0;
+    MBGL_CHECK_ERROR(glGenBuffers(1, &id));
+    UniqueBuffer buffer{ std::move(id), { context } };
+    bind(buffer);
+    MBGL_CHECK_ERROR(glBufferData(target == Target::Vertex ? GL_ARRAY_BUFFER : GL_ELEMENT_ARRAY_BUFFER,
+                                  size, data, Enum<gfx::BufferUsageType>::to(usage)));
+    pages.push_back(std::make_unique<Page>(std::move(buffer), size, shared));
+    return *pages.back();
+}
+
+void BufferArena::release(Page& page, std::size_t offset, std::size_t size) {
+    assert(page.used >= size);
+    page.used -= size;
+
+    if (!page.shared) {
+        removePage(page);
+        return;
+    }
+
+    // Merge the range with the unused ranges right before and after it.
+    auto next = page.freeByOffset.lower_bound(offset);
+    if (next != page.freeByOffset.begin()) {
+        auto prev = std::prev(next);
+        if (prev->first + prev->second == offset) {
+            offset = prev->first;
+            size += prev->second;
+            removeFreeRange(page, prev);
+        }
+    }
+    if (next != page.freeByOffset.end() && next->first == offset + size) {
+        size += next->second;
+        removeFreeRange(page, next);
+    }
+    addFreeRange(page, offset, size);
+
+    if (page.used == 0) {
+        // Keep one empty page around, so that a tile replacing the last one that was evicted
+        // doesn't create a new buffer object.
+        const auto sharedPages = std::count_if(pages.begin(), pages.end(), [](const auto& candidate) {
+            return candidate->shared;
+        });
+        if (sharedPages > 1) {
+            removePage(page);
+        }
+    }
+}
+
+void BufferArena::removePage(Page& page) {
+    auto it = std::find_if(pages.begin(), pages.end(), [&](const auto& candidate) {
+        return candidate.get() == &page;
+    });
+    assert(it != pages.end());
+    pages.erase(it);
+}
+
+void BufferArena::takeRange(Page& page, std::map<std::size_t, std::size_t>::iterator it, std::size_t size) {
+    assert(it != page.freeByOffset.end() && it->second >= size);
+    const std::size_t offset = it->first;
+    const std::size_t rangeSize = it->second;
+    removeFreeRange(page, it);
+    if (rangeSize > size) {
+        addFreeRange(page, offset + size, rangeSize - size);
+    }
+    page.used += size;
+}
+
+void BufferArena::addFreeRange(Page& page, std::size_t offset, std::size_t size) {
+    page.freeByOffset.emplace(offset, size);
+    page.freeBySize.emplace(size, offset);
+}
+
+void BufferArena::removeFreeRange(Page& page, std::map<std::size_t, std::size_t>::iterator it) {
+    auto range = page.freeBySize.equal_range(it->second);
+    for (auto bySize = range.first; bySize != range.second; ++bySize) {
+        if (bySize->second == it->first) {
+            page.freeBySize.erase(bySize);
+            break;
+        }
+    }
+    page.freeByOffset.erase(it);
+}
+
+} // namespace gl
+} // namespace mbgl
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <mbgl/gfx/types.hpp>
+#include <mbgl/gl/object.hpp>
+#include <mbgl/util/noncopyable.hpp>
+
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <vector>
+
+namespace mbgl {
+namespace gl {
+
+class Context;
+
+// Packs the vertex or index data of many buckets into a few large buffer objects, so that
+// uploading a tile doesn't create a buffer object per bucket. Each allocation is a range of one
+// of the arena's buffers, which goes back to the arena when the allocation is destroyed.
+// Large and non-static buffers get a buffer object of their own.
+class BufferArena : private util::noncopyable {
+public:
+    enum class Target : bool { Vertex, Index };
+
+    // Size of the buffer objects that are shared between allocations.
+    static constexpr std::size_t pageSize = 1024 * 1024;
+    // Allocations larger than this get their own buffer object.
+    static constexpr std::size_t maxSharedSize = pageSize / 4;
+    // Shared allocations start at multiples of this, which satisfies the alignment of every
+    // vertex attribute and index type.
+    static constexpr std::size_t alignment = 16;
+
+private:
+    struct Page {
+        Page(UniqueBuffer&& buffer_, std::size_t size_, bool shared_)
+            : buffer(std::move(buffer_)), size(size_), shared(shared_) {
+        }
+
+        UniqueBuffer buffer;
+        const std::size_t size;
+        const bool shared;
+        std::size_t used = 0;
+        // Unused ranges, indexed both ways so that allocations find the smallest range they
+        // fit in, and released ranges merge with their neighbors.
+        std::map<std::size_t, std::size_t> freeByOffset;
+        std::multimap<std::size_t, std::size_t> freeBySize;
+    };
+
+public:
+    class Allocation {
+    public:
+        Allocation(BufferArena&, Page&, std::size_t offset, std::size_t size);
+        Allocation(Allocation&&) noexcept;
+        Allocation& operator=(Allocation&&) noexcept;
+        ~Allocation();
+
+        BufferID getBuffer() const;
+        std::size_t getOffset() const { return offset; }
+        std::size_t getSize() const { return size; }
+
+    private:
+        BufferArena* arena;
+        Page* page;
+        std::size_t offset;
+        std::size_t size;
+    };
+
+    BufferArena(Context&, Target);
+
+    // Creates a range of at least `size` bytes, initialized with `data`, and leaves its buffer bound.
+    Allocation allocate(const void* data, std::size_t size, gfx::BufferUsageType);
+    // Replaces the first `size` bytes of the allocation's range.
+    void update(const Allocation&, const void* data, std::size_t size);
+
+    // Deletes buffer objects that no longer hold any allocation.
+    void shrink();
+
+    std::size_t getPageCount() const { return pages.size(); }
+    std::size_t getBytesUsed() const;
+
+private:
+    void bind(BufferID);
+    Page& createPage(std::size_t size, gfx::BufferUsageType, const void* data, bool shared);
+    void release(Page&, std::size_t offset, std::size_t size);
+    void removePage(Page&);
+
+    static void takeRange(Page&, std::map<std::size_t, std::size_t>::iterator, std::size_t size);
+    static void addFreeRange(Page&, std::size_t offset, std::size_t size);
+    static void removeFreeRange(Page&, std::map<std::size_t, std::size_t>::iterator);
+
+    Context& context;
+    const Target target;
+    std::vector<std::unique_ptr<Page>> pages;
+};
+
+} // namespace gl
+} // namespace mbgl
@@ -9,10 +9,13 @@
 #include <mbgl/gl/command_encoder.hpp>
 #include <mbgl/gl/debugging_extension.hpp>
 #include <mbgl/gl/vertex_array_extension.hpp>
+#include <mbgl/gl/pixel_buffer_extension.hpp>
+#include <mbgl/gl/program_binary_extension.hpp>
 #include <mbgl/util/traits.hpp>
 #include <mbgl/util/std.hpp>
 #include <mbgl/util/logging.hpp>
 
+#include <cassert>
 #include <cstring>
 
 namespace mbgl {
@@ -30,6 +33,7 @@ static_assert(std::is_same<TextureID, GLuint>::value, "OpenGL type mismatch");
 static_assert(std::is_same<VertexArrayID, GLuint>::value, "OpenGL type mismatch");
 static_assert(std::is_same<FramebufferID, GLuint>::value, "OpenGL type mismatch");
 static_assert(std::is_same<RenderbufferID, GLuint>::value, "OpenGL type mismatch");
+static_assert(std::is_same<BinaryProgramFormat, GLenum>::value, "OpenGL type mismatch");
 
 static_assert(underlying_type(UniformDataType::Float) == GL_FLOAT, "OpenGL type mismatch");
 static_assert(underlying_type(UniformDataType::FloatVec2) == GL_FLOAT_VEC2, "OpenGL type mismatch");
@@ -104,6 +108,27 @@ void Context::initializeExtensions(const std::function<gl::ProcAddress(const cha
                 vertexArray = std::make_unique<extension::VertexArray>(fn);
         }
 
+        pixelBuffer = std::make_unique<extension::PixelBuffer>(fn);
+
+        // Block Adreno 3xx, 4xx and 5xx, whose drivers return program binaries that crash or
+        // fail to load again.
+        if (renderer.find("Adreno (TM) 3") == std::string::npos
+            && renderer.find("Adreno (TM) 4") == std::string::npos
+            && renderer.find("Adreno (TM) 5") == std::string::npos) {
+            programBinary = std::make_unique<extension::ProgramBinary>(fn);
+            if (programBinary->getProgramBinary && programBinary->programBinary) {
+                GLint formats = 0;
+                MBGL_CHECK_ERROR(glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats));
+                hasProgramBinaryFormats = formats > 0;
+            }
+        }
+
+        auto glString = [](GLenum name) {
+            const auto* value = reinterpret_cast<const char*>(MBGL_CHECK_ERROR(glGetString(name)));
+            return std::string(value ? value : "");
+        };
+        driverIdentifier = glString(GL_VENDOR) + '|' + renderer + '|' + glString(GL_VERSION);
+
 #if MBGL_USE_GLES2
         constexpr const char* halfFloatExtensionName = "OES_texture_half_float";
         constexpr const char* halfFloatColorBufferExtensionName = "EXT_color_buffer_half_float";
@@ -174,11 +199,57 @@ UniqueProgram Context::createProgram(ShaderID vertexShader, ShaderID fragmentSha
     // AttributeLocations::getFirstAttribName.
     MBGL_CHECK_ERROR(glBindAttribLocation(result, 0, location0AttribName));
 
+    // Ask the driver to keep the binary around, so that it can be cached.
+    if (supportsProgramBinaries() && programBinary->programParameteri) {
+        MBGL_CHECK_ERROR(programBinary->programParameteri(result, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE));
+    }
+
     linkProgram(result);
 
     return result;
 }
 
+UniqueProgram Context::createProgram(BinaryProgramFormat binaryFormat,
+                                     const std::string& binaryProgram) {
+    assert(supportsProgramBinaries());
+    UniqueProgram result { MBGL_CHECK_ERROR(glCreateProgram()), { this } };
+    MBGL_CHECK_ERROR(programBinary->programBinary(result, static_cast<GLenum>(binaryFormat),
+                                                  binaryProgram.data(),
+                                                  static_cast<GLint>(binaryProgram.size())));
+    // Drivers reject binaries they can't load, e.g. after an update, by failing to link them.
+    verifyProgramLinkage(result);
+    return result;
+}
+
+bool Context::supportsProgramBinaries() const {
+    return !disableProgramBinaries &&
+           hasProgramBinaryFormats &&
+           programBinary &&
+           programBinary->getProgramBinary &&
+           programBinary->programBinary;
+}
+
+optional<std::pair<BinaryProgramFormat, std::string>>
+Context::getBinaryProgram(ProgramID program_) const {
+    if (!supportsProgramBinaries()) {
+        return {};
+    }
+    GLint binaryLength = 0;
+    MBGL_CHECK_ERROR(glGetProgramiv(program_, GL_PROGRAM_BINARY_LENGTH, &binaryLength));
+    if (binaryLength <= 0) {
+        return {};
+    }
+    std::string binary;
+    binary.resize(binaryLength);
+    GLenum binaryFormat;
+    MBGL_CHECK_ERROR(programBinary->getProgramBinary(program_, binaryLength, &binaryLength,
+                                                     &binaryFormat, &binary[0]));
+    if (size_t(binaryLength) != binary.size()) {
+        return {};
+    }
+    return { { binaryFormat, std::move(binary) } };
+}
+
 void Context::linkProgram(ProgramID program_) {
     MBGL_CHECK_ERROR(glLinkProgram(program_));
     verifyProgramLinkage(program_);
@@ -304,6 +375,65 @@ std::unique_ptr<uint8_t[]> Context::readFramebuffer(const Size size, const gfx::
     return data;
 }
 
+bool Context::supportsPixelBuffers() const {
+    return !disablePixelBufferExtension &&
+           pixelBuffer &&
+           pixelBuffer->mapBuffer &&
+           pixelBuffer->unmapBuffer;
+}
+
+UniqueBuffer Context::createPixelBuffer(const Size size) {
+    assert(supportsPixelBuffers());
+    BufferID id = 0;
+    MBGL_CHECK_ERROR(glGenBuffers(1, &id));
+    UniqueBuffer result { std::move(id), { *this } };
+    // The pixel pack binding isn't tracked, and is reset right away so that other reads keep
+    // going to client memory.
+    MBGL_CHECK_ERROR(glBindBuffer(GL_PIXEL_PACK_BUFFER, result));
+    MBGL_CHECK_ERROR(glBufferData(GL_PIXEL_PACK_BUFFER, size.width * size.height * 4, nullptr, GL_STREAM_READ));
+    MBGL_CHECK_ERROR(glBindBuffer(GL_PIXEL_PACK_BUFFER, 0));
+    return result;
+}
+
+void Context::readFramebufferToPixelBuffer(const BufferID buffer, const Size size) {
+    assert(supportsPixelBuffers());
+    pixelStorePack = { 1 };
+
+    // With a pixel pack buffer bound, the pointer is an offset into it, and the read returns
+    // without waiting for rendering to finish.
+    MBGL_CHECK_ERROR(glBindBuffer(GL_PIXEL_PACK_BUFFER, buffer));
+    MBGL_CHECK_ERROR(glReadPixels(0, 0, size.width, size.height, GL_RGBA, GL_UNSIGNED_BYTE, nullptr));
+    MBGL_CHECK_ERROR(glBindBuffer(GL_PIXEL_PACK_BUFFER, 0));
+}
+
+std::unique_ptr<uint8_t[]> Context::readPixelBuffer(const BufferID buffer, const Size size, const bool flip) {
+    assert(supportsPixelBuffers());
+    const size_t stride = size.width * 4;
+    auto data = std::make_unique<uint8_t[]>(stride * size.height);
+
+    MBGL_CHECK_ERROR(glBindBuffer(GL_PIXEL_PACK_BUFFER, buffer));
+    const auto* mapped = reinterpret_cast<const uint8_t*>(
+        MBGL_CHECK_ERROR(pixelBuffer->mapBuffer(GL_PIXEL_PACK_BUFFER, GL_READ_ONLY)));
+    if (!mapped) {
+        // The framebuffer has moved on since the read was started, so it can't be read again.
+        MBGL_CHECK_ERROR(glBindBuffer(GL_PIXEL_PACK_BUFFER, 0));
+        throw std::runtime_error("Couldn't map pixel buffer");
+    }
+
+    if (flip) {
+        // Flip while copying out of the mapped buffer instead of swapping rows afterwards.
+        for (size_t i = 0, j = size.height - 1; i < size.height; i++, j--) {
+            std::memcpy(data.get() + i * stride, mapped + j * stride, stride);
+        }
+    } else {
+        std::memcpy(data.get(), mapped, stride * size.height);
+    }
+    MBGL_CHECK_ERROR(pixelBuffer->unmapBuffer(GL_PIXEL_PACK_BUFFER));
+    MBGL_CHECK_ERROR(glBindBuffer(GL_PIXEL_PACK_BUFFER, 0));
+
+    return data;
+}
+
 #if not MBGL_USE_GLES2
 void Context::drawPixels(const Size size, const void* data, gfx::TexturePixelType format) {
     pixelStoreUnpack = { 1 };
@@ -451,6 +581,8 @@ std::unique_ptr<gfx::DrawScopeResource> Context::createDrawScopeResource() {
 void Context::reset() {
     std::copy(pooledTextures.begin(), pooledTextures.end(), std::back_inserter(abandonedTextures));
     pooledTextures.resize(0);
+    vertexBufferArena.shrink();
+    indexBufferArena.shrink();
     performCleanup();
 }
 
@@ -605,6 +737,7 @@ void Context::draw(const gfx::DrawMode& drawMode,
         break;
     }
 
+    stats.numDrawCalls++;
     MBGL_CHECK_ERROR(glDrawElements(
         Enum<gfx::DrawModeType>::to(drawMode.type),
         static_cast<GLsizei>(indexLength),
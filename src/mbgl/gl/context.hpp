@@ -1,6 +1,7 @@
 #pragma once
 
 #include <mbgl/gfx/context.hpp>
+#include <mbgl/gl/buffer_arena.hpp>
 #include <mbgl/gl/object.hpp>
 #include <mbgl/gl/state.hpp>
 #include <mbgl/gl/value.hpp>
@@ -32,6 +33,8 @@ class RendererBackend;
 namespace extension {
 class VertexArray;
 class Debugging;
+class PixelBuffer;
+class ProgramBinary;
 } // namespace extension
 
 class Context final : public gfx::Context {
@@ -49,10 +52,20 @@ public:
 
     UniqueShader createShader(ShaderType type, const std::initializer_list<const char*>& sources);
     UniqueProgram createProgram(ShaderID vertexShader, ShaderID fragmentShader, const char* location0AttribName);
+    UniqueProgram createProgram(BinaryProgramFormat binaryFormat, const std::string& binaryProgram);
     void verifyProgramLinkage(ProgramID);
     void linkProgram(ProgramID);
     UniqueTexture createUniqueTexture();
 
+    // Program binaries, where the GL supports them with at least one binary format. Binaries
+    // only load into contexts of the driver that produced them, which getDriverIdentifier()
+    // tells apart.
+    bool supportsProgramBinaries() const;
+    optional<std::pair<BinaryProgramFormat, std::string>> getBinaryProgram(ProgramID) const;
+    const std::string& getDriverIdentifier() const {
+        return driverIdentifier;
+    }
+
     Framebuffer createFramebuffer(const gfx::Renderbuffer<gfx::RenderbufferPixelType::RGBA>&,
                                   const gfx::Renderbuffer<gfx::RenderbufferPixelType::DepthStencil>&);
     Framebuffer createFramebuffer(const gfx::Renderbuffer<gfx::RenderbufferPixelType::RGBA>&);
@@ -71,6 +84,14 @@ public:
         return { size, readFramebuffer(size, format, flip) };
     }
 
+    // Asynchronous framebuffer reads through pixel buffer objects, where the GL supports them:
+    // readFramebufferToPixelBuffer() only queues the copy, and readPixelBuffer() waits for it to
+    // finish and returns the RGBA pixels. It throws if the buffer can't be mapped.
+    bool supportsPixelBuffers() const;
+    UniqueBuffer createPixelBuffer(Size);
+    void readFramebufferToPixelBuffer(BufferID, Size);
+    std::unique_ptr<uint8_t[]> readPixelBuffer(BufferID, Size, bool flip = true);
+
 #if not MBGL_USE_GLES2
     template <typename Image>
     void drawPixels(const Image& image) {
@@ -130,6 +151,10 @@ private:
 
     std::unique_ptr<extension::Debugging> debugging;
     std::unique_ptr<extension::VertexArray> vertexArray;
+    std::unique_ptr<extension::PixelBuffer> pixelBuffer;
+    std::unique_ptr<extension::ProgramBinary> programBinary;
+    bool hasProgramBinaryFormats = false;
+    std::string driverIdentifier;
 
 public:
     State<value::ActiveTextureUnit> activeTextureUnit;
@@ -221,8 +246,15 @@ private:
     std::vector<RenderbufferID> abandonedRenderbuffers;
 
 public:
+    // Vertex and index buffers are suballocated from these. Declared after the abandoned object
+    // lists, so that buffers still held at destruction are abandoned to lists that still exist.
+    BufferArena vertexBufferArena { *this, BufferArena::Target::Vertex };
+    BufferArena indexBufferArena { *this, BufferArena::Target::Index };
+
     // For testing
     bool disableVAOExtension = false;
+    bool disableProgramBinaries = false;
+    bool disablePixelBufferExtension = false;
 
 #if not defined(NDEBUG)
 public:
@@ -114,7 +114,9 @@
 #define GL_ONE_MINUS_SRC_COLOR 0x0301
 #define GL_OUT_OF_MEMORY 0x0505
 #define GL_PACK_ALIGNMENT 0x0D05
+#define GL_PIXEL_PACK_BUFFER 0x88EB
 #define GL_POINTS 0x0000
+#define GL_READ_ONLY 0x88B8
 #define GL_RENDERBUFFER 0x8D41
 #define GL_RENDERBUFFER_BINDING 0x8CA7
 #define GL_RENDERER 0x1F01
@@ -143,6 +145,7 @@
 #define GL_STENCIL_VALUE_MASK 0x0B93
 #define GL_STENCIL_WRITEMASK 0x0B98
 #define GL_STREAM_DRAW 0x88E0
+#define GL_STREAM_READ 0x88E1
 #define GL_TEXTURE0 0x84C0
 #define GL_TEXTURE_2D 0x0DE1
 #define GL_TEXTURE_BINDING_2D 0x8069
@@ -158,6 +161,8 @@
 #define GL_UNSIGNED_BYTE 0x1401
 #define GL_UNSIGNED_INT 0x1405
 #define GL_UNSIGNED_SHORT 0x1403
+#define GL_VENDOR 0x1F00
+#define GL_VERSION 0x1F02
 #define GL_VERTEX_SHADER 0x8B31
 #define GL_VIEWPORT 0x0BA2
 #define GL_ZERO 0
@@ -0,0 +1,61 @@
+#include <mbgl/gl/draw_list.hpp>
+
+#include <algorithm>
+#include <tuple>
+
+namespace mbgl {
+namespace gl {
+
+constexpr std::size_t DrawList::blockSize;
+
+DrawList::~DrawList() {
+    clear();
+}
+
+void DrawList::replay() {
+    // Number the depth ranges in the order they were first used.
+    depthRanges.clear();
+    for (auto& command : commands) {
+        auto it = std::find(depthRanges.begin(), depthRanges.end(), command.depthRange);
+        command.group = it - depthRanges.begin();
+        if (it == depthRanges.end()) {
+            depthRanges.push_back(command.depthRange);
+        }
+    }
+
+    std::stable_sort(commands.begin(), commands.end(), [](const Command& a, const Command& b) {
+        return std::tie(a.group, a.program) < std::tie(b.group, b.program);
+    });
+
+    for (const auto& command : commands) {
+        command.invoke(command.draw);
+    }
+    clear();
+}
+
+void DrawList::clear() {
+    for (const auto& command : commands) {
+        command.destroy(command.draw);
+    }
+    commands.clear();
+    currentBlock = 0;
+    used = 0;
+}
+
+void* DrawList::allocate(std::size_t size, std::size_t alignment) {
+    std::size_t offset = (used + alignment - 1) / alignment * alignment;
+    if (blocks.empty() || offset + size > blockSize) {
+        if (!blocks.empty()) {
+            currentBlock++;
+        }
+        if (currentBlock == blocks.size()) {
+            blocks.push_back(std::make_unique<Block>());
+        }
+        offset = 0;
+    }
+    used = offset + size;
+    return blocks[currentBlock]->data + offset;
+}
+
+} // namespace gl
+} // namespace mbgl
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <mbgl/gl/types.hpp>
+#include <mbgl/util/noncopyable.hpp>
+#include <mbgl/util/range.hpp>
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace mbgl {
+namespace gl {
+
+// Records draws so that they can be issued in a different order. Each draw is a callable that
+// holds copies of the state it needs. Callables are stored in blocks that the list keeps for
+// the next draws, so recording doesn't allocate per draw.
+//
+// Draws are issued grouped by depth range, in the order the ranges were first used, which keeps
+// the sublayers of a layer in order, and then by program. Draws that share both are issued in
+// the order they were recorded.
+class DrawList : private util::noncopyable {
+public:
+    ~DrawList();
+
+    template <class Fn>
+    void record(const Range<float>& depthRange, ProgramID program, Fn&& fn) {
+        using Draw = std::decay_t<Fn>;
+        static_assert(sizeof(Draw) <= blockSize, "draw doesn't fit in a block");
+        static_assert(alignof(Draw) <= alignof(std::max_align_t), "draw is overaligned");
+
+        void* draw = new (allocate(sizeof(Draw), alignof(Draw))) Draw(std::forward<Fn>(fn));
+        commands.push_back({ depthRange, program, 0, draw,
+                             [](void* d) { (*static_cast<Draw*>(d))(); },
+                             [](void* d) { static_cast<Draw*>(d)->~Draw(); } });
+    }
+
+    std::size_t size() const {
+        return commands.size();
+    }
+
+    // Issues the recorded draws and empties the list.
+    void replay();
+
+    // Empties the list without issuing the draws.
+    void clear();
+
+    static constexpr std::size_t blockSize = 64 * 1024;
+
+private:
+    void* allocate(std::size_t size, std::size_t alignment);
+
+    struct Command {
+        Range<float> depthRange;
+        ProgramID program;
+        std::size_t group;
+        void* draw;
+        void (*invoke)(void*);
+        void (*destroy)(void*);
+    };
+
+    struct Block {
+        alignas(std::max_align_t) unsigned char data[blockSize];
+    };
+
+    std::vector<Command> commands;
+    std::vector<Range<float>> depthRanges;
+    std::vector<std::unique_ptr<Block>> blocks;
+    std::size_t currentBlock = 0;
+    std::size_t used = 0;
+};
+
+} // namespace gl
+} // namespace mbgl
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <mbgl/gl/extension.hpp>
+#include <mbgl/gl/defines.hpp>
+#include <mbgl/platform/gl_functions.hpp>
+
+namespace mbgl {
+namespace gl {
+namespace extension {
+
+class PixelBuffer {
+public:
+    template <typename Fn>
+    PixelBuffer(const Fn& loadExtension)
+        : mapBuffer(
+              loadExtension({ { "GL_ARB_pixel_buffer_object", "glMapBuffer" },
+                              { "GL_ARB_pixel_buffer_object", "glMapBufferARB" },
+                              { "GL_EXT_pixel_buffer_object", "glMapBuffer" } })),
+          unmapBuffer(
+              loadExtension({ { "GL_ARB_pixel_buffer_object", "glUnmapBuffer" },
+                              { "GL_ARB_pixel_buffer_object", "glUnmapBufferARB" },
+                              { "GL_EXT_pixel_buffer_object", "glUnmapBuffer" } })) {
+    }
+
+    const ExtensionFunction<void*(platform::GLenum target, platform::GLenum access)> mapBuffer;
+
+    const ExtensionFunction<platform::GLboolean(platform::GLenum target)> unmapBuffer;
+};
+
+} // namespace extension
+} // namespace gl
+} // namespace mbgl
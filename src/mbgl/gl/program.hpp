@@ -5,6 +5,8 @@
 #include <mbgl/gl/object.hpp>
 #include <mbgl/gl/context.hpp>
 #include <mbgl/gl/draw_scope_resource.hpp>
+#include <mbgl/gl/index_buffer_resource.hpp>
+#include <mbgl/gl/render_pass.hpp>
 #include <mbgl/gfx/vertex_buffer.hpp>
 #include <mbgl/gfx/index_buffer.hpp>
 #include <mbgl/gfx/uniform.hpp>
@@ -12,12 +14,14 @@
 #include <mbgl/gl/attribute.hpp>
 #include <mbgl/gl/uniform.hpp>
 #include <mbgl/gl/texture.hpp>
+#include <mbgl/gl/binary_program.hpp>
 #include <mbgl/util/io.hpp>
 
 #include <mbgl/util/logging.hpp>
 #include <mbgl/programs/program_parameters.hpp>
 #include <mbgl/programs/gl/shader_source.hpp>
 #include <mbgl/programs/gl/shaders.hpp>
+#include <mbgl/programs/gl/preludes.hpp>
 
 #include <string>
 
@@ -55,10 +59,40 @@ public:
             textureStates.queryLocations(program);
         }
 
+        Instance(Context& context, const BinaryProgram& binaryProgram)
+            : program(context.createProgram(binaryProgram.format(), binaryProgram.code())) {
+            attributeLocations.queryLocations(program);
+            uniformStates.queryLocations(program);
+            textureStates.queryLocations(program);
+        }
+
         static std::unique_ptr<Instance>
         createInstance(gl::Context& context,
                        const ProgramParameters& programParameters,
                        const std::string& additionalDefines) {
+            const char* name = programs::gl::ShaderSource<Name>::name;
+            optional<std::string> cachePath;
+            std::string identifier;
+            if (context.supportsProgramBinaries()) {
+                cachePath = programParameters.cachePath(name, additionalDefines);
+            }
+
+            // Load the program the driver built on an earlier run, if the sources, defines and
+            // driver are still the same. Anything else falls back to compiling.
+            if (cachePath) {
+                identifier = programs::gl::programIdentifier(programParameters.getDefines(),
+                                                             additionalDefines,
+                                                             programs::gl::preludeHash,
+                                                             programs::gl::ShaderSource<Name>::hash);
+                if (auto binaryProgram = readBinaryProgram(context, *cachePath, identifier)) {
+                    try {
+                        return std::make_unique<Instance>(context, *binaryProgram);
+                    } catch (const std::runtime_error& error) {
+                        Log::Warning(Event::OpenGL, "Could not load cached program %s: %s", name, error.what());
+                    }
+                }
+            }
+
             // Compile the shader
             const std::initializer_list<const char*> vertexSource = {
                 programParameters.getDefines().c_str(),
@@ -74,6 +108,10 @@ public:
             };
             auto result = std::make_unique<Instance>(context, vertexSource, fragmentSource);
 
+            if (cachePath) {
+                writeBinaryProgram(context, result->program, *cachePath, std::move(identifier));
+            }
+
             return std::move(result);
         }
 
@@ -84,7 +122,7 @@ public:
     };
 
     void draw(gfx::Context& genericContext,
-              gfx::RenderPass&,
+              gfx::RenderPass& renderPass,
               const gfx::DrawMode& drawMode,
               const gfx::DepthMode& depthMode,
               const gfx::StencilMode& stencilMode,
@@ -99,11 +137,6 @@ public:
               std::size_t indexLength) override {
         auto& context = static_cast<gl::Context&>(genericContext);
 
-        context.setDepthMode(depthMode);
-        context.setStencilMode(stencilMode);
-        context.setColorMode(colorMode);
-        context.setCullFaceMode(cullFaceMode);
-
         const uint32_t key = gl::AttributeKey<AttributeList>::compute(attributeBindings);
         auto it = instances.find(key);
         if (it == instances.end()) {
@@ -117,6 +150,59 @@ public:
         }
 
         auto& instance = *it->second;
+
+        auto& glRenderPass = static_cast<gl::RenderPass&>(renderPass);
+        if (glRenderPass.isRecordingDrawList()) {
+            glRenderPass.recordDraw(depthMode, instance.program,
+                [=, &context, &instance, &drawScope, &indexBuffer] {
+                    drawInstance(context, instance, drawMode, depthMode, stencilMode, colorMode,
+                                 cullFaceMode, uniformValues, drawScope, attributeBindings,
+                                 textureBindings, indexBuffer, indexOffset, indexLength);
+                });
+            return;
+        }
+
+        drawInstance(context, instance, drawMode, depthMode, stencilMode, colorMode, cullFaceMode,
+                     uniformValues, drawScope, attributeBindings, textureBindings, indexBuffer,
+                     indexOffset, indexLength);
+    }
+
+    void precompile(gfx::Context& genericContext, std::size_t boundAttributes) override {
+        auto& context = static_cast<gl::Context&>(genericContext);
+
+        const uint32_t key = boundAttributes >= 32 ? ~uint32_t(0) : (uint32_t(1) << boundAttributes) - 1;
+        if (instances.find(key) == instances.end()) {
+            instances.emplace(key,
+                              Instance::createInstance(
+                                  context,
+                                  programParameters,
+                                  gl::AttributeKey<AttributeList>::defines(key)));
+        }
+    }
+
+private:
+    static void drawInstance(gl::Context& context,
+                             Instance& instance,
+                             const gfx::DrawMode& drawMode,
+                             const gfx::DepthMode& depthMode,
+                             const gfx::StencilMode& stencilMode,
+                             const gfx::ColorMode& colorMode,
+                             const gfx::CullFaceMode& cullFaceMode,
+                             const gfx::UniformValues<UniformList>& uniformValues,
+                             gfx::DrawScope& drawScope,
+                             const gfx::AttributeBindings<AttributeList>& attributeBindings,
+                             const gfx::TextureBindings<TextureList>& textureBindings,
+                             const gfx::IndexBuffer& indexBuffer,
+                             std::size_t indexOffset,
+                             std::size_t indexLength) {
+        context.setDepthMode(depthMode);
+        context.setStencilMode(stencilMode);
+        context.setColorMode(colorMode);
+        context.setCullFaceMode(cullFaceMode);
+
+        if (context.program != instance.program) {
+            context.renderingStats().numProgramBinds++;
+        }
         context.program = instance.program;
 
         instance.uniformStates.bind(uniformValues);
@@ -128,12 +214,15 @@ public:
                         indexBuffer,
                         instance.attributeLocations.toBindingArray(attributeBindings));
 
+        // The index buffer may be a range of a buffer that is shared with other buckets.
+        const std::size_t indexBufferOffset =
+            indexBuffer.getResource<gl::IndexBufferResource>().getOffset() / sizeof(uint16_t);
+
         context.draw(drawMode,
-                     indexOffset,
+                     indexBufferOffset + indexOffset,
                      indexLength);
     }
 
-private:
     std::map<uint32_t, std::unique_ptr<Instance>> instances;
 };
 
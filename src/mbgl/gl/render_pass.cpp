@@ -3,6 +3,8 @@
 #include <mbgl/gl/renderable_resource.hpp>
 #include <mbgl/gl/context.hpp>
 
+#include <cassert>
+
 namespace mbgl {
 namespace gl {
 
@@ -16,6 +18,17 @@ RenderPass::RenderPass(gl::CommandEncoder& commandEncoder_,
                                  descriptor.clearStencil);
 }
 
+void RenderPass::beginDrawList() {
+    assert(!recordingDrawList);
+    recordingDrawList = true;
+}
+
+void RenderPass::endDrawList() {
+    assert(recordingDrawList);
+    recordingDrawList = false;
+    drawList.replay();
+}
+
 void RenderPass::pushDebugGroup(const char* name) {
     commandEncoder.pushDebugGroup(name);
 }
@@ -1,6 +1,12 @@
 #pragma once
 
 #include <mbgl/gfx/render_pass.hpp>
+#include <mbgl/gfx/depth_mode.hpp>
+#include <mbgl/gl/draw_list.hpp>
+#include <mbgl/gl/types.hpp>
+
+#include <cassert>
+#include <utility>
 
 namespace mbgl {
 namespace gfx {
@@ -18,6 +24,20 @@ class RenderPass final : public gfx::RenderPass {
 public:
     RenderPass(gl::CommandEncoder&, const char* name, const gfx::RenderPassDescriptor&);
 
+    void beginDrawList() override;
+    void endDrawList() override;
+
+    bool isRecordingDrawList() const {
+        return recordingDrawList;
+    }
+
+    // Adds a draw to the current draw list, to be issued when the list ends.
+    template <class Fn>
+    void recordDraw(const gfx::DepthMode& depthMode, ProgramID program, Fn&& draw) {
+        assert(recordingDrawList);
+        drawList.record(depthMode.range, program, std::forward<Fn>(draw));
+    }
+
 private:
     void pushDebugGroup(const char* name) override;
     void popDebugGroup() override;
@@ -25,6 +45,9 @@ private:
 private:
     gl::CommandEncoder& commandEncoder;
     const gfx::DebugGroup<gfx::CommandEncoder> debugGroup;
+
+    bool recordingDrawList = false;
+    DrawList drawList;
 };
 
 } // namespace gl
@@ -8,8 +8,11 @@ namespace gl {
 void VertexArray::bind(Context& context,
                        const gfx::IndexBuffer& indexBuffer,
                        const AttributeBindingArray& bindings) {
+    if (context.bindVertexArray != state->vertexArray) {
+        context.renderingStats().numVertexArrayBinds++;
+    }
     context.bindVertexArray = state->vertexArray;
-    state->indexBuffer = indexBuffer.getResource<gl::IndexBufferResource>().buffer;
+    state->indexBuffer = indexBuffer.getResource<gl::IndexBufferResource>().getBuffer();
 
     state->bindings.reserve(bindings.size());
     for (AttributeLocation location = 0; location < bindings.size(); ++location) {
@@ -1,17 +1,21 @@
 #pragma once
 
 #include <mbgl/gfx/vertex_buffer.hpp>
-#include <mbgl/gl/object.hpp>
+#include <mbgl/gl/buffer_arena.hpp>
 
 namespace mbgl {
 namespace gl {
 
 class VertexBufferResource : public gfx::VertexBufferResource {
 public:
-    VertexBufferResource(UniqueBuffer&& buffer_) : buffer(std::move(buffer_)) {
+    VertexBufferResource(BufferArena::Allocation&& allocation_) : allocation(std::move(allocation_)) {
     }
 
-    UniqueBuffer buffer;
+    BufferID getBuffer() const { return allocation.getBuffer(); }
+    // Byte offset of the vertices in the buffer.
+    std::size_t getOffset() const { return allocation.getOffset(); }
+
+    BufferArena::Allocation allocation;
 };
 
 } // namespace gl
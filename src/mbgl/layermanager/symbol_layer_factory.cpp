@@ -31,7 +31,8 @@ std::unique_ptr<Layout> SymbolLayerFactory::createLayout(const LayoutParameters&
                                           group,
                                           std::move(tileLayer),
                                           parameters.imageDependencies,
-                                          parameters.glyphDependencies);
+                                          parameters.glyphDependencies,
+                                          parameters.featureIndex);
 }
 
 std::unique_ptr<RenderLayer> SymbolLayerFactory::createRenderLayer(Immutable<style::Layer::Impl> impl) noexcept {
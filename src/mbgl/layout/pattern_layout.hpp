@@ -16,10 +16,11 @@ public:
 
 using PatternLayerMap = std::map<std::string, PatternDependency>;
 
+// A feature that passed the filter, by its position in the source layer. Its geometry is
+// decoded once the pattern images are available.
 class PatternFeature  {
 public:
     const uint32_t i;
-    std::unique_ptr<GeometryTileFeature> feature;
     PatternLayerMap patterns;
 };
 
@@ -60,38 +61,52 @@ public:
             layerPropertiesMap.emplace(layerId, layerProperties);
         }
 
-        const size_t featureCount = sourceLayer->featureCount();
-        for (size_t i = 0; i < featureCount; ++i) {
-            auto feature = sourceLayer->getFeature(i);
-            if (!leaderLayerProperties->layerImpl().filter(style::expression::EvaluationContext { this->zoom, feature.get() }))
-                continue;
+        // Without patterns, the bucket doesn't depend on any images and is built right away.
+        // This only touches state owned by this layout, so the layouts of several layer groups
+        // can be created concurrently.
+        if (!hasPattern) {
+            bucket = std::make_shared<BucketType>(layout, layerPropertiesMap, zoom, overscaling);
+        }
+
+        // Features are streamed and only decoded if they pass the filter, into the same
+        // geometry collection every time.
+        const style::Filter& filter = leaderLayerProperties->layerImpl().filter;
+        GeometryCollection geometries;
+        sourceLayer->forEachFeature([&](std::size_t i, const GeometryTileFeature& feature) {
+            if (!filter(style::expression::EvaluationContext { this->zoom, &feature }))
+                return true;
+
+            if (bucket) {
+                feature.decodeGeometries(geometries);
+                addFeature(i, feature, geometries, {}, {});
+                return true;
+            }
 
             PatternLayerMap patternDependencyMap;
-            if (hasPattern) {
-                for (const auto& layerProperties : group) {
-                    const std::string& layerId = layerProperties->baseImpl->id;
-                    const auto it = layerPropertiesMap.find(layerId);
-                    if (it != layerPropertiesMap.end()) {
-                        const auto paint = static_cast<const LayerPropertiesType&>(*it->second).evaluated;
-                        const auto patternProperty = paint.template get<PatternPropertyType>();
-                        if (!patternProperty.isConstant()) {
-                            // For layers with non-data-constant pattern properties, evaluate their expression and add
-                            // the patterns to the dependency vector
-                            const auto min = patternProperty.evaluate(*feature, zoom - 1, PatternPropertyType::defaultValue());
-                            const auto mid = patternProperty.evaluate(*feature, zoom, PatternPropertyType::defaultValue());
-                            const auto max = patternProperty.evaluate(*feature, zoom + 1, PatternPropertyType::defaultValue());
-
-                            patternDependencies.emplace(min.to, ImageType::Pattern);
-                            patternDependencies.emplace(mid.to, ImageType::Pattern);
-                            patternDependencies.emplace(max.to, ImageType::Pattern);
-                            patternDependencyMap.emplace(layerId, PatternDependency {min.to, mid.to, max.to});
-
-                        }
+            for (const auto& layerProperties : group) {
+                const std::string& layerId = layerProperties->baseImpl->id;
+                const auto it = layerPropertiesMap.find(layerId);
+                if (it != layerPropertiesMap.end()) {
+                    const auto paint = static_cast<const LayerPropertiesType&>(*it->second).evaluated;
+                    const auto patternProperty = paint.template get<PatternPropertyType>();
+                    if (!patternProperty.isConstant()) {
+                        // For layers with non-data-constant pattern properties, evaluate their expression and add
+                        // the patterns to the dependency vector
+                        const auto min = patternProperty.evaluate(feature, zoom - 1, PatternPropertyType::defaultValue());
+                        const auto mid = patternProperty.evaluate(feature, zoom, PatternPropertyType::defaultValue());
+                        const auto max = patternProperty.evaluate(feature, zoom + 1, PatternPropertyType::defaultValue());
+
+                        patternDependencies.emplace(min.to, ImageType::Pattern);
+                        patternDependencies.emplace(mid.to, ImageType::Pattern);
+                        patternDependencies.emplace(max.to, ImageType::Pattern);
+                        patternDependencyMap.emplace(layerId, PatternDependency {min.to, mid.to, max.to});
+
                     }
                 }
             }
-            features.push_back({static_cast<uint32_t>(i), std::move(feature), patternDependencyMap});
-        }
+            features.push_back({static_cast<uint32_t>(i), patternDependencyMap});
+            return true;
+        });
     };
 
     ~PatternLayout() final = default;
@@ -101,16 +116,27 @@ public:
     }
 
     void createBucket(const ImagePositions& patternPositions, std::unique_ptr<FeatureIndex>& featureIndex, std::unordered_map<std::string, LayerRenderData>& renderData, const bool, const bool) override {
-        auto bucket = std::make_shared<BucketType>(layout, layerPropertiesMap, zoom, overscaling);
-        for (auto & patternFeature : features) {
-            const auto i = patternFeature.i;
-            std::unique_ptr<GeometryTileFeature> feature = std::move(patternFeature.feature);
-            const PatternLayerMap& patterns = patternFeature.patterns;
-            GeometryCollection geometries = feature->getGeometries();
-
-            bucket->addFeature(*feature, geometries, patternPositions, patterns);
-            featureIndex->insert(geometries, i, sourceLayerID, bucketLeaderID);
+        if (!bucket) {
+            bucket = std::make_shared<BucketType>(layout, layerPropertiesMap, zoom, overscaling);
+
+            // Stream the source layer again, and decode the features that passed the filter.
+            auto next = features.cbegin();
+            GeometryCollection geometries;
+            sourceLayer->forEachFeature([&](std::size_t i, const GeometryTileFeature& feature) {
+                if (next == features.cend()) {
+                    return false;
+                }
+                if (i != next->i) {
+                    return true;
+                }
+                feature.decodeGeometries(geometries);
+                addFeature(i, feature, geometries, patternPositions, next->patterns);
+                ++next;
+                return true;
+            });
         }
+
+        indexedFeatures.insertInto(*featureIndex, featureIndex->intern(sourceLayerID), featureIndex->intern(bucketLeaderID));
         if (bucket->hasData()) {
             for (const auto& pair : layerPropertiesMap) {
                 renderData.emplace(pair.first, LayerRenderData {bucket, pair.second});
@@ -119,11 +145,19 @@ public:
     };
 
 private:
+    void addFeature(std::size_t i, const GeometryTileFeature& feature, const GeometryCollection& geometries,
+                    const ImagePositions& patternPositions, const PatternLayerMap& patterns) {
+        bucket->addFeature(feature, geometries, patternPositions, patterns);
+        indexedFeatures.add(i, geometries);
+    }
+
     std::map<std::string, Immutable<style::LayerProperties>> layerPropertiesMap;
     std::string bucketLeaderID;
 
     const std::unique_ptr<GeometryTileLayer> sourceLayer;
     std::vector<PatternFeature> features;
+    std::shared_ptr<BucketType> bucket;
+    FeatureIndexBatch indexedFeatures;
     PossiblyEvaluatedLayoutPropertiesType layout;
 
     const float zoom;
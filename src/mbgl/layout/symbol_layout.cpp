@@ -51,9 +51,12 @@ SymbolLayout::SymbolLayout(const BucketParameters& parameters,
                            const std::vector<Immutable<style::LayerProperties>>& layers,
                            std::unique_ptr<GeometryTileLayer> sourceLayer_,
                            ImageDependencies& imageDependencies,
-                           GlyphDependencies& glyphDependencies)
+                           GlyphDependencies& glyphDependencies,
+                           FeatureIndex& featureIndex)
     : bucketLeaderID(layers.front()->baseImpl->id),
       sourceLayer(std::move(sourceLayer_)),
+      sourceLayerNameId(featureIndex.intern(sourceLayer->getName())),
+      bucketLeaderId(featureIndex.intern(bucketLeaderID)),
       overscaling(parameters.tileID.overscaleFactor()),
       zoom(parameters.tileID.overscaledZ),
       mode(parameters.mode),
@@ -110,14 +113,14 @@ SymbolLayout::SymbolLayout(const BucketParameters& parameters,
         layerPaintProperties.emplace(layer->baseImpl->id, layer);
     }
 
-    // Determine glyph dependencies
-    const size_t featureCount = sourceLayer->featureCount();
-    for (size_t i = 0; i < featureCount; ++i) {
-        auto feature = sourceLayer->getFeature(i);
-        if (!leader.filter(expression::EvaluationContext { this->zoom, feature.get() }))
-            continue;
+    // Determine glyph dependencies. Features are streamed, and only those that pass the
+    // filter are materialized: a symbol feature outlives this loop and keeps its own copy of
+    // the geometry, which mergeLines() modifies.
+    sourceLayer->forEachFeature([&](std::size_t i, const GeometryTileFeature& feature) {
+        if (!leader.filter(expression::EvaluationContext { this->zoom, &feature }))
+            return true;
 
-        SymbolFeature ft(std::move(feature));
+        SymbolFeature ft(sourceLayer->getFeature(i));
 
         ft.index = i;
 
@@ -174,7 +177,8 @@ SymbolLayout::SymbolLayout(const BucketParameters& parameters,
                 features.push_back(std::move(ft));
             }
         }
-    }
+        return true;
+    });
 
     if (layout.get<SymbolPlacement>() == SymbolPlacementType::Line) {
         util::mergeLines(features);
@@ -427,7 +431,7 @@ void SymbolLayout::addFeature(const std::size_t layoutFeatureIndex,
 
     const float textRepeatDistance = symbolSpacing / 2;
     const auto evaluatedLayoutProperties = layout.evaluate(zoom, feature);
-    IndexedSubfeature indexedFeature(feature.index, sourceLayer->getName(), bucketLeaderID, symbolInstances.size());
+    IndexedSubfeature indexedFeature(feature.index, sourceLayerNameId, bucketLeaderId, symbolInstances.size());
 
     auto addSymbolInstance = [&] (const GeometryCoordinates& line, Anchor& anchor) {
         const bool anchorInsideTile = anchor.point.x >= 0 && anchor.point.x < util::EXTENT && anchor.point.y >= 0 && anchor.point.y < util::EXTENT;
@@ -7,6 +7,7 @@
 #include <mbgl/layout/symbol_instance.hpp>
 #include <mbgl/text/bidi.hpp>
 #include <mbgl/renderer/buckets/symbol_bucket.hpp>
+#include <mbgl/geometry/feature_index.hpp>
 
 #include <memory>
 #include <map>
@@ -28,7 +29,8 @@ public:
                  const std::vector<Immutable<style::LayerProperties>>&,
                  std::unique_ptr<GeometryTileLayer>,
                  ImageDependencies&,
-                 GlyphDependencies&);
+                 GlyphDependencies&,
+                 FeatureIndex&);
     
     ~SymbolLayout() final = default;
 
@@ -85,6 +87,8 @@ private:
     // Stores the layer so that we can hold on to GeometryTileFeature instances in SymbolFeature,
     // which may reference data from this object.
     const std::unique_ptr<GeometryTileLayer> sourceLayer;
+    const StringIdentity sourceLayerNameId;
+    const StringIdentity bucketLeaderId;
     const float overscaling;
     const float zoom;
     const MapMode mode;
@@ -18,7 +18,7 @@ std::string programIdentifier(const std::string& defines1,
     result.reserve(8 + 8 + (sizeof(size_t) * 2) * 2 + 2);
     result.append(util::toHex(static_cast<uint64_t>(std::hash<std::string>()(defines1))));
     result.append(util::toHex(static_cast<uint64_t>(std::hash<std::string>()(defines2))));
-    result.append(hash1, hash2 + 8);
+    result.append(hash1, hash1 + 8);
     result.append(hash2, hash2 + 8);
     result.append("v3");
     return result;
@@ -10,6 +10,7 @@
 #include <mbgl/renderer/paint_property_binder.hpp>
 #include <mbgl/util/io.hpp>
 
+#include <tuple>
 #include <unordered_map>
 
 namespace mbgl {
@@ -49,6 +50,12 @@ public:
         : program(context.createProgram<Name>(programParameters)) {
     }
 
+    // Builds the variant that draws layers whose paint properties are all constant.
+    void precompile(gfx::Context& context) {
+        program->precompile(context,
+            std::tuple_size<typename LayoutAttributeList::template ExpandInto<std::tuple>>::value);
+    }
+
     static UniformValues computeAllUniformValues(
         const LayoutUniformValues& layoutUniformValues,
         const Binders& paintPropertyBinders,
@@ -24,17 +24,19 @@ const std::string& ProgramParameters::getDefines() const {
     return defines;
 }
 
-optional<std::string> ProgramParameters::cachePath(const char* name) const {
+optional<std::string> ProgramParameters::cachePath(const char* name, const std::string& additionalDefines) const {
     if (!cacheDir) {
         return {};
     } else {
         std::string result;
-        result.reserve(cacheDir->length() + 64);
+        result.reserve(cacheDir->length() + 80);
         result += *cacheDir;
         result += "/com.mapbox.gl.shader.";
         result += name;
         result += '.';
         result += util::toHex(static_cast<uint64_t>(std::hash<std::string>()(defines)));
+        result += '.';
+        result += util::toHex(static_cast<uint64_t>(std::hash<std::string>()(additionalDefines)));
         result += ".pbf";
         return result;
     }
@@ -11,7 +11,8 @@ public:
     ProgramParameters(float pixelRatio, bool overdraw, optional<std::string> cacheDir);
 
     const std::string& getDefines() const;
-    optional<std::string> cachePath(const char* name) const;
+    // Returns where to cache the binary of the program variant that `additionalDefines` selects.
+    optional<std::string> cachePath(const char* name, const std::string& additionalDefines) const;
 
 private:
     std::string defines;
@@ -84,4 +84,48 @@ SymbolLayerPrograms& Programs::getSymbolLayerPrograms() noexcept {
     return static_cast<SymbolLayerPrograms&>(*symbolPrograms);   
 }
 
+void Programs::precompile() {
+    debug.precompile(context);
+    clippingMask.precompile(context);
+
+    auto& background = getBackgroundLayerPrograms();
+    background.background.precompile(context);
+    background.backgroundPattern.precompile(context);
+
+    getRasterLayerPrograms().raster.precompile(context);
+
+    auto& heatmap = getHeatmapLayerPrograms();
+    heatmap.heatmap.precompile(context);
+    heatmap.heatmapTexture.precompile(context);
+
+    getCircleLayerPrograms().circle.precompile(context);
+
+    auto& hillshade = getHillshadeLayerPrograms();
+    hillshade.hillshade.precompile(context);
+    hillshade.hillshadePrepare.precompile(context);
+
+    auto& fill = getFillLayerPrograms();
+    fill.fill.precompile(context);
+    fill.fillPattern.precompile(context);
+    fill.fillOutline.precompile(context);
+    fill.fillOutlinePattern.precompile(context);
+
+    auto& fillExtrusion = getFillExtrusionLayerPrograms();
+    fillExtrusion.fillExtrusion.precompile(context);
+    fillExtrusion.fillExtrusionPattern.precompile(context);
+
+    auto& line = getLineLayerPrograms();
+    line.line.precompile(context);
+    line.lineGradient.precompile(context);
+    line.lineSDF.precompile(context);
+    line.linePattern.precompile(context);
+
+    auto& symbol = getSymbolLayerPrograms();
+    symbol.symbolIcon.precompile(context);
+    symbol.symbolIconSDF.precompile(context);
+    symbol.symbolGlyph.precompile(context);
+    symbol.collisionBox.precompile(context);
+    symbol.collisionCircle.precompile(context);
+}
+
 } // namespace mbgl
@@ -33,6 +33,10 @@ public:
     LineLayerPrograms& getLineLayerPrograms() noexcept;
     SymbolLayerPrograms& getSymbolLayerPrograms() noexcept;
 
+    // Builds every program in the variant that layers without data-driven paint properties use,
+    // so that the first frames don't wait for them and their binaries end up in the program cache.
+    void precompile();
+
     DebugProgram debug;
     ClippingMaskProgram clippingMask;
 
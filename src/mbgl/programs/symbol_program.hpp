@@ -270,6 +270,12 @@ public:
         : program(context.createProgram<Name>(programParameters)) {
     }
 
+    // Builds the variant that draws layers whose paint properties are all constant.
+    void precompile(gfx::Context& context) {
+        program->precompile(context,
+            std::tuple_size<typename LayoutAndSizeAttributeList::template ExpandInto<std::tuple>>::value);
+    }
+
     static UniformValues computeAllUniformValues(
         const LayoutUniformValues& layoutUniformValues,
         const SymbolSizeBinder& symbolSizeBinder,
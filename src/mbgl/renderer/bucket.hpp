@@ -4,6 +4,11 @@
 #include <mbgl/style/image_impl.hpp>
 #include <mbgl/renderer/image_atlas.hpp>
 #include <mbgl/style/layer_impl.hpp>
+#include <mbgl/gfx/vertex_vector.hpp>
+#include <mbgl/gfx/vertex_buffer.hpp>
+#include <mbgl/gfx/index_vector.hpp>
+#include <mbgl/gfx/index_buffer.hpp>
+#include <mbgl/util/optional.hpp>
 #include <atomic>
 
 namespace mbgl {
@@ -19,6 +24,7 @@ class PatternDependency;
 using PatternLayerMap = std::map<std::string, PatternDependency>;
 class Placement;
 class BucketPlacementParameters;
+class BucketPlacementData;
 
 class Bucket {
 public:
@@ -48,6 +54,10 @@ public:
     bool needsUpload() const {
         return hasData() && !uploaded;
     }
+
+    // Estimated memory held by this bucket, counting both vertex data that's waiting for upload
+    // and the buffers it was uploaded to.
+    virtual std::size_t bytes() const { return 0; }
    
     // The following methods are implemented by buckets that require cross-tile indexing and placement.
 
@@ -57,12 +67,26 @@ public:
     virtual std::pair<uint32_t, bool> registerAtCrossTileIndex(CrossTileSymbolLayerIndex&, const OverscaledTileID&, uint32_t&) {
         return std::make_pair(0u, false);
     }
-    // Places this bucket to the given placement. Returns bucket cross-tile id on success call; `0` otherwise.
-    virtual uint32_t place(Placement&, const BucketPlacementParameters&, std::set<uint32_t>&) { return 0u; }
+    // Copies the placement state that the render thread keeps changing into a placement snapshot.
+    virtual void takePlacementSnapshot(BucketPlacementData&) {}
+    // Places this bucket to the given placement. Only reads the bucket, so that placement can
+    // run on another thread while the bucket is being rendered.
+    virtual void place(Placement&, const BucketPlacementParameters&, std::set<uint32_t>&) const {}
     virtual void updateOpacities(Placement&, std::set<uint32_t>&) {}
 
 protected:
     Bucket() = default;
+
+    template <class Vertex>
+    static std::size_t bufferBytes(const gfx::VertexVector<Vertex>& vertices, const optional<gfx::VertexBuffer<Vertex>>& buffer) {
+        return vertices.bytes() + (buffer ? buffer->elements * sizeof(Vertex) : 0);
+    }
+
+    template <class DrawMode>
+    static std::size_t bufferBytes(const gfx::IndexVector<DrawMode>& indices, const optional<gfx::IndexBuffer>& buffer) {
+        return indices.bytes() + (buffer ? buffer->elements * sizeof(uint16_t) : 0);
+    }
+
     std::atomic<bool> uploaded { false };
 };
 
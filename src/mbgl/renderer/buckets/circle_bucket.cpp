@@ -39,6 +39,10 @@ bool CircleBucket::hasData() const {
     return !segments.empty();
 }
 
+std::size_t CircleBucket::bytes() const {
+    return bufferBytes(vertices, vertexBuffer) + bufferBytes(triangles, indexBuffer);
+}
+
 void CircleBucket::addFeature(const GeometryTileFeature& feature,
                                  const GeometryCollection& geometry,
                                  const ImagePositions&,
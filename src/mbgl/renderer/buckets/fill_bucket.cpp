@@ -137,6 +137,12 @@ bool FillBucket::hasData() const {
     return !triangleSegments.empty() || !lineSegments.empty();
 }
 
+std::size_t FillBucket::bytes() const {
+    return bufferBytes(vertices, vertexBuffer) +
+           bufferBytes(lines, lineIndexBuffer) +
+           bufferBytes(triangles, triangleIndexBuffer);
+}
+
 float FillBucket::getQueryRadius(const RenderLayer& layer) const {
     const auto& evaluated = getEvaluated<FillLayerProperties>(layer.evaluatedProperties);
     const std::array<float, 2>& translate = evaluated.get<FillTranslate>();
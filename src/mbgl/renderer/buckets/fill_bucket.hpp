@@ -32,6 +32,7 @@ public:
                     const PatternLayerMap&) override;
 
     bool hasData() const override;
+    std::size_t bytes() const override;
 
     void upload(gfx::UploadPass&) override;
 
@@ -39,6 +39,10 @@ bool HeatmapBucket::hasData() const {
     return !segments.empty();
 }
 
+std::size_t HeatmapBucket::bytes() const {
+    return bufferBytes(vertices, vertexBuffer) + bufferBytes(triangles, indexBuffer);
+}
+
 void HeatmapBucket::addFeature(const GeometryTileFeature& feature,
                                const GeometryCollection& geometry,
                                const ImagePositions&,
@@ -23,6 +23,7 @@ public:
                             const ImagePositions&,
                             const PatternLayerMap&) override;
     bool hasData() const override;
+    std::size_t bytes() const override;
 
     void upload(gfx::UploadPass&) override;
 
@@ -114,5 +114,17 @@ bool HillshadeBucket::hasData() const {
     return demdata.getImage()->valid();
 }
 
+std::size_t HillshadeBucket::bytes() const {
+    std::size_t result = bufferBytes(vertices, vertexBuffer) + bufferBytes(indices, indexBuffer);
+    result += demdata.getImage()->bytes();
+    if (dem) {
+        result += dem->size.area() * 4;
+    }
+    if (texture) {
+        result += texture->size.area() * 4;
+    }
+    return result;
+}
+
 
 } // namespace mbgl
@@ -523,6 +523,10 @@ bool LineBucket::hasData() const {
     return !segments.empty();
 }
 
+std::size_t LineBucket::bytes() const {
+    return bufferBytes(vertices, vertexBuffer) + bufferBytes(triangles, indexBuffer);
+}
+
 template <class Property>
 static float get(const LinePaintProperties::PossiblyEvaluated& evaluated, const std::string& id, const std::map<std::string, LineProgram::Binders>& paintPropertyBinders) {
     auto it = paintPropertyBinders.find(id);
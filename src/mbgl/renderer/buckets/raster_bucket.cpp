@@ -112,5 +112,16 @@ bool RasterBucket::hasData() const {
     return !!image;
 }
 
+std::size_t RasterBucket::bytes() const {
+    std::size_t result = bufferBytes(vertices, vertexBuffer) + bufferBytes(indices, indexBuffer);
+    if (image) {
+        result += image->bytes();
+    }
+    if (texture) {
+        result += texture->size.area() * 4;
+    }
+    return result;
+}
+
 
 } // namespace mbgl
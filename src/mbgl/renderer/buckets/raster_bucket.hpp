@@ -20,6 +20,7 @@ public:
 
     void upload(gfx::UploadPass&) override;
     bool hasData() const override;
+    std::size_t bytes() const override;
 
     void clear();
     void setImage(std::shared_ptr<PremultipliedImage>);
@@ -6,6 +6,8 @@
 #include <mbgl/text/glyph_atlas.hpp>
 #include <mbgl/text/placement.hpp>
 
+#include <numeric>
+
 namespace mbgl {
 
 using namespace style;
@@ -134,6 +136,23 @@ bool SymbolBucket::hasData() const {
     return hasTextData() || hasIconData() || hasCollisionBoxData();
 }
 
+std::size_t SymbolBucket::bytes() const {
+    auto symbolBytes = [](const Buffer& buffer) {
+        return bufferBytes(buffer.vertices, buffer.vertexBuffer) +
+               bufferBytes(buffer.dynamicVertices, buffer.dynamicVertexBuffer) +
+               bufferBytes(buffer.opacityVertices, buffer.opacityVertexBuffer) +
+               bufferBytes(buffer.triangles, buffer.indexBuffer) +
+               buffer.placedSymbols.size() * sizeof(PlacedSymbol);
+    };
+    auto collisionBytes = [](const CollisionBuffer& buffer) {
+        return bufferBytes(buffer.vertices, buffer.vertexBuffer) +
+               bufferBytes(buffer.dynamicVertices, buffer.dynamicVertexBuffer);
+    };
+    return symbolBytes(text) + symbolBytes(icon) + icon.atlasImage.bytes() +
+           collisionBytes(collisionBox) + bufferBytes(collisionBox.lines, collisionBox.indexBuffer) +
+           collisionBytes(collisionCircle) + bufferBytes(collisionCircle.triangles, collisionCircle.indexBuffer);
+}
+
 bool SymbolBucket::hasTextData() const {
     return !text.segments.empty();
 }
@@ -192,7 +211,8 @@ void SymbolBucket::sortFeatures(const float angle) {
     // If the symbols are allowed to overlap sort them by their vertical screen position.
     // The index array buffer is rewritten to reference the (unchanged) vertices in the
     // sorted order.
-    for (const SymbolInstance& symbolInstance : getSortedSymbols(angle)) {
+    for (std::size_t i : getSortedSymbols(angle)) {
+        const SymbolInstance& symbolInstance = symbolInstances[i];
         featureSortOrder->push_back(symbolInstance.dataFeatureIndex);
 
         if (symbolInstance.placedRightTextIndex) {
@@ -217,12 +237,15 @@ void SymbolBucket::sortFeatures(const float angle) {
     }
 }
 
-std::vector<std::reference_wrapper<SymbolInstance>> SymbolBucket::getSortedSymbols(const float angle) {
-    std::vector<std::reference_wrapper<SymbolInstance>> result(symbolInstances.begin(), symbolInstances.end());
+std::vector<std::size_t> SymbolBucket::getSortedSymbols(const float angle) const {
+    std::vector<std::size_t> result(symbolInstances.size());
+    std::iota(result.begin(), result.end(), 0);
     const float sin = std::sin(angle);
     const float cos = std::cos(angle);
 
-    std::sort(result.begin(), result.end(), [sin, cos](const SymbolInstance& a, const SymbolInstance& b) {
+    std::sort(result.begin(), result.end(), [this, sin, cos](std::size_t aIndex, std::size_t bIndex) {
+        const SymbolInstance& a = symbolInstances[aIndex];
+        const SymbolInstance& b = symbolInstances[bIndex];
         const auto aRotated = ::lround(sin * a.anchor.point.x + cos * a.anchor.point.y);
         const auto bRotated = ::lround(sin * b.anchor.point.x + cos * b.anchor.point.y);
         if (aRotated != bRotated) {
@@ -246,9 +269,18 @@ std::pair<uint32_t, bool> SymbolBucket::registerAtCrossTileIndex(CrossTileSymbol
     return std::make_pair(bucketInstanceId, added);
 }
 
-uint32_t SymbolBucket::place(Placement& placement, const BucketPlacementParameters& params, std::set<uint32_t>& seenIds) {
+void SymbolBucket::takePlacementSnapshot(BucketPlacementData& data) {
+    data.crossTileIDs.reserve(symbolInstances.size());
+    for (const SymbolInstance& symbolInstance : symbolInstances) {
+        data.crossTileIDs.push_back(symbolInstance.crossTileID);
+    }
+    data.bucketInstanceId = bucketInstanceId;
+    data.justReloaded = justReloaded;
+    justReloaded = false;
+}
+
+void SymbolBucket::place(Placement& placement, const BucketPlacementParameters& params, std::set<uint32_t>& seenIds) const {
     placement.placeLayerBucket(*this, params, seenIds);
-    return bucketInstanceId;
 }
 
 void SymbolBucket::updateOpacities(Placement& placement, std::set<uint32_t>& seenIds) {
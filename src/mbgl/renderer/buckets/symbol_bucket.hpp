@@ -58,8 +58,10 @@ public:
 
     void upload(gfx::UploadPass&) override;
     bool hasData() const override;
+    std::size_t bytes() const override;
     std::pair<uint32_t, bool> registerAtCrossTileIndex(CrossTileSymbolLayerIndex&, const OverscaledTileID&, uint32_t& maxCrossTileID) override;
-    uint32_t place(Placement&, const BucketPlacementParameters&, std::set<uint32_t>&) override;
+    void takePlacementSnapshot(BucketPlacementData&) override;
+    void place(Placement&, const BucketPlacementParameters&, std::set<uint32_t>&) const override;
     void updateOpacities(Placement&, std::set<uint32_t>&) override;
     bool hasTextData() const;
     bool hasIconData() const;
@@ -69,8 +71,8 @@ public:
 
     void updateOpacity();
     void sortFeatures(const float angle);
-    // The result contains references to the `symbolInstances` items, sorted by viewport Y.
-    std::vector<std::reference_wrapper<SymbolInstance>> getSortedSymbols(const float angle);
+    // The result contains indices of the `symbolInstances` items, sorted by viewport Y.
+    std::vector<std::size_t> getSortedSymbols(const float angle) const;
 
     const style::SymbolLayoutProperties::PossiblyEvaluated layout;
     const bool sdfIcons;
@@ -20,6 +20,9 @@ private:
     bool hasTransition() const override;
     bool hasCrossfade() const override;
     void render(PaintParameters&, RenderSource*) override;
+    // Each tile draws only inside its own clipping mask, so the fills of all tiles can be drawn
+    // before their outlines.
+    bool supportsDrawReordering() const override { return true; }
 
     bool queryIntersectsFeature(
             const GeometryCoordinates&,
@@ -669,14 +669,19 @@ void RenderSymbolLayer::setRenderTiles(RenderTiles tiles, const TransformState&
 
     placementData.clear();
     for (RenderTile& renderTile : renderTiles) {
-        auto bucket = renderTile.tile.getBucket<SymbolBucket>(*baseImpl);
+        const LayerRenderData* renderData = renderTile.tile.getLayerRenderData(*baseImpl);
+        if (!renderData) {
+            continue;
+        }
+        // The bucket is shared with placement snapshots, see PlacementSnapshot.
+        auto bucket = std::static_pointer_cast<SymbolBucket>(renderData->bucket);
         if (bucket && bucket->bucketLeaderID == getID()) {
             auto& layout = bucket->layout;
             bool pitchWithMap = layout.get<style::TextPitchAlignment>() == style::AlignmentType::Map;
             bool rotateWithMap = layout.get<style::TextRotationAlignment>() == style::AlignmentType::Map;
 
             // Only place this layer if it's the "group leader" for the bucket
-            placementData.push_back({*bucket, renderTile, pitchWithMap, rotateWithMap});
+            placementData.push_back({bucket, renderTile, pitchWithMap, rotateWithMap});
         }
     }
 }
@@ -28,7 +28,7 @@ public:
 
 class LayerPlacementData {
 public:
-    std::reference_wrapper<Bucket> bucket;
+    std::shared_ptr<Bucket> bucket;
     std::reference_wrapper<RenderTile> tile;
     bool pitchWithMap;
     bool rotateWithMap;
@@ -74,6 +74,10 @@ public:
     virtual void upload(gfx::UploadPass&, UploadParameters&) {}
     virtual void render(PaintParameters&, RenderSource*) = 0;
 
+    // Returns true if the layer's draws only need to stay ordered among draws that share a
+    // depth range and a program, so that the renderer may regroup them to save program binds.
+    virtual bool supportsDrawReordering() const { return false; }
+
     // Check wether the given geometry intersects
     // with the feature
     virtual bool queryIntersectsFeature(
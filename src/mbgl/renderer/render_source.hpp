@@ -8,6 +8,7 @@
 #include <mbgl/util/feature.hpp>
 #include <mbgl/style/source_impl.hpp>
 #include <mbgl/style/layer_properties.hpp>
+#include <mbgl/renderer/tile_cache_stats.hpp>
 
 #include <unordered_map>
 #include <vector>
@@ -86,6 +87,8 @@ public:
 
     virtual void reduceMemoryUse() = 0;
 
+    virtual TileCacheStats getTileCacheStats() const { return {}; }
+
     virtual void dumpDebugLogs() const = 0;
 
     void setObserver(RenderSourceObserver*);
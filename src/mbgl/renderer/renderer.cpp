@@ -116,4 +116,28 @@ void Renderer::reduceMemoryUse() {
     impl->reduceMemoryUse();
 }
 
+const gfx::RenderingStats& Renderer::getRenderingStats() const {
+    return impl->getRenderingStats();
+}
+
+void Renderer::setTileCacheMaxBytes(std::size_t maxBytes) {
+    impl->tileCacheMaxBytes = maxBytes;
+}
+
+TileCacheStats Renderer::getTileCacheStats() const {
+    return impl->getTileCacheStats();
+}
+
+void Renderer::setPlacementTimeBudget(Duration budget) {
+    impl->placementTimeBudget = budget;
+}
+
+void Renderer::setBackgroundPlacement(bool enabled) {
+    impl->backgroundPlacement = enabled;
+}
+
+void Renderer::setDrawReordering(bool enabled) {
+    impl->drawReordering = enabled;
+}
+
 } // namespace mbgl
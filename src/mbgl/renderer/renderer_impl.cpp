@@ -27,6 +27,8 @@
 #include <mbgl/style/transition_options.hpp>
 #include <mbgl/text/glyph_manager.hpp>
 #include <mbgl/tile/tile.hpp>
+#include <mbgl/actor/scheduler.hpp>
+#include <mbgl/util/image_buffer_pool.hpp>
 #include <mbgl/util/math.hpp>
 #include <mbgl/util/string.hpp>
 #include <mbgl/util/logging.hpp>
@@ -56,7 +58,8 @@ Renderer::Impl::Impl(gfx::RendererBackend& backend_,
     , sourceImpls(makeMutable<std::vector<Immutable<style::Source::Impl>>>())
     , layerImpls(makeMutable<std::vector<Immutable<style::Layer::Impl>>>())
     , renderLight(makeMutable<Light::Impl>())
-    , placement(std::make_unique<Placement>(TransformState{}, MapMode::Static, TransitionOptions{}, true)) {
+    , placement(std::make_shared<Placement>(TransformState{}, MapMode::Static, TransitionOptions{}, true))
+    , placementWorker(Scheduler::GetBackground()) {
     glyphManager->setObserver(this);
     imageManager->setObserver(this);
 }
@@ -116,7 +119,8 @@ void Renderer::Impl::render(const UpdateParameters& updateParameters) {
         updateParameters.annotationManager,
         *imageManager,
         *glyphManager,
-        updateParameters.prefetchZoomDelta
+        updateParameters.prefetchZoomDelta,
+        tileCacheMaxBytes
     };
 
     glyphManager->setURL(updateParameters.glyphURL);
@@ -290,6 +294,7 @@ void Renderer::Impl::render(const UpdateParameters& updateParameters) {
     }
 
     observer->onWillStartRenderingFrame();
+    backend.getContext().resetRenderingStats();
 
     // Set render tiles to the render items.
     for (auto& renderItem : renderItems) {
@@ -310,32 +315,81 @@ void Renderer::Impl::render(const UpdateParameters& updateParameters) {
         }
 
         bool symbolBucketsChanged = false;
-        const bool placementChanged = !placement->stillRecent(updateParameters.timePoint);
-        std::set<std::string> usedSymbolLayers;
-        mat4 projMatrix;
-        if (placementChanged) {
-            placement = std::make_unique<Placement>(
+        std::vector<std::reference_wrapper<const RenderLayer>> placementLayers;
+        std::vector<std::string> placementLayerIDs;
+        for (auto it = layersNeedPlacement.rbegin(); it != layersNeedPlacement.rend(); ++it) {
+            const RenderLayer& layer = *it;
+            if (crossTileSymbolIndex.addLayer(layer, updateParameters.transformState.getLatLng().longitude())) symbolBucketsChanged = true;
+            placementLayers.emplace_back(layer);
+            placementLayerIDs.push_back(layer.getID());
+        }
+
+        // A placement of a different set of symbol layers than the current one must not be
+        // committed. One that is still running on the placement worker reads the snapshot, which
+        // is therefore only dropped once its result has been handed back.
+        if (placementSnapshot && placementLayerIDs != placementSnapshotLayerIDs &&
+            (pendingPlacement || placementResult)) {
+            pendingPlacement.reset();
+            placementResult.reset();
+            placementSnapshot.reset();
+        }
+
+        const bool showCollisionBoxes = updateParameters.debugOptions & MapDebugOptions::Collision;
+        if (!placementSnapshot && !placement->stillRecent(updateParameters.timePoint)) {
+            placementSnapshot = std::make_unique<PlacementSnapshot>(placementLayers);
+            placementSnapshotLayerIDs = placementLayerIDs;
+            auto newPlacement = std::make_unique<Placement>(
                 updateParameters.transformState, updateParameters.mode,
                 updateParameters.transitionOptions, updateParameters.crossSourceCollisions,
-                std::move(placement));
-            updateParameters.transformState.getProjMatrix(projMatrix);
+                placement);
+            if (isMapModeContinuous && backgroundPlacement && Scheduler::GetCurrent()) {
+                if (!placementCallback) {
+                    placementCallback = std::make_unique<Actor<PlacementWorker::Callback>>(
+                        *Scheduler::GetCurrent(), [this](std::unique_ptr<Placement> result) {
+                            placementResult = std::move(result);
+                            observer->onInvalidate();
+                        });
+                }
+                placementWorker.self().invoke(&PlacementWorker::place,
+                                              std::move(newPlacement),
+                                              placementSnapshot.get(),
+                                              showCollisionBoxes,
+                                              placementCallback->self());
+            } else {
+                pendingPlacement = std::move(newPlacement);
+            }
         }
 
-        for (auto it = layersNeedPlacement.rbegin(); it != layersNeedPlacement.rend(); ++it) {
-            const RenderLayer& layer = *it;
-            if (crossTileSymbolIndex.addLayer(layer, updateParameters.transformState.getLatLng().longitude())) symbolBucketsChanged = true;
+        // In continuous mode, placement either runs in the background or gets a limited amount of
+        // time per frame; the current placement keeps being rendered until the new one is
+        // finished and committed.
+        bool placementChanged = false;
+        if (placementSnapshot) {
+            std::unique_ptr<Placement> finishedPlacement;
+            if (pendingPlacement) {
+                optional<TimePoint> deadline;
+                if (isMapModeContinuous && placementTimeBudget > Duration::zero()) {
+                    deadline = Clock::now() + placementTimeBudget;
+                }
+                if (pendingPlacement->continuePlacement(*placementSnapshot, showCollisionBoxes, deadline)) {
+                    finishedPlacement = std::move(pendingPlacement);
+                }
+            } else if (placementResult) {
+                finishedPlacement = std::move(placementResult);
+            }
 
-            if (placementChanged) {
-                usedSymbolLayers.insert(layer.getID());
-                placement->placeLayer(layer, projMatrix, updateParameters.debugOptions & MapDebugOptions::Collision);
+            if (finishedPlacement) {
+                finishedPlacement->commit(updateParameters.timePoint);
+                placement = std::move(finishedPlacement);
+                // Releases the snapshot's buckets here, on the render thread.
+                placementSnapshot.reset();
+                crossTileSymbolIndex.pruneUnusedLayers({ placementLayerIDs.begin(), placementLayerIDs.end() });
+                updateFadingTiles();
+                placementChanged = true;
             }
         }
 
-        if (placementChanged) {
-            placement->commit(updateParameters.timePoint);
-            crossTileSymbolIndex.pruneUnusedLayers(usedSymbolLayers);
-            updateFadingTiles();
-        } else {
+        if (!placementChanged) {
             placement->setStale();
         }
 
@@ -463,7 +517,13 @@ void Renderer::Impl::render(const UpdateParameters& updateParameters) {
             RenderLayer& renderLayer = it->layer;
             if (renderLayer.hasRenderPass(parameters.pass)) {
                 const auto layerDebugGroup(parameters.renderPass->createDebugGroup(renderLayer.getID().c_str()));
-                renderLayer.render(parameters, it->source);
+                if (drawReordering && renderLayer.supportsDrawReordering()) {
+                    parameters.renderPass->beginDrawList();
+                    renderLayer.render(parameters, it->source);
+                    parameters.renderPass->endDrawList();
+                } else {
+                    renderLayer.render(parameters, it->source);
+                }
             }
         }
     }
@@ -480,7 +540,13 @@ void Renderer::Impl::render(const UpdateParameters& updateParameters) {
             RenderLayer& renderLayer = it->layer;
             if (renderLayer.hasRenderPass(parameters.pass)) {
                 const auto layerDebugGroup(parameters.renderPass->createDebugGroup(renderLayer.getID().c_str()));
-                renderLayer.render(parameters, it->source);
+                if (drawReordering && renderLayer.supportsDrawReordering()) {
+                    parameters.renderPass->beginDrawList();
+                    renderLayer.render(parameters, it->source);
+                    parameters.renderPass->endDrawList();
+                } else {
+                    renderLayer.render(parameters, it->source);
+                }
             }
         }
     }
@@ -511,6 +577,8 @@ void Renderer::Impl::render(const UpdateParameters& updateParameters) {
     }
 #endif
 
+    renderingStats = parameters.context.renderingStats();
+
     const bool needsRepaint = isMapModeContinuous && hasTransitions(parameters.timePoint);
     observer->onDidFinishRenderingFrame(
         loaded ? RendererObserver::RenderMode::Full : RendererObserver::RenderMode::Partial,
@@ -667,15 +735,35 @@ void Renderer::Impl::reduceMemoryUse() {
     }
     backend.getContext().performCleanup();
     imageManager->reduceMemoryUse();
+    util::ImageBufferPool::get().shrink();
     observer->onInvalidate();
 }
 
+TileCacheStats Renderer::Impl::getTileCacheStats() const {
+    TileCacheStats result;
+    for (const auto& entry : renderSources) {
+        const TileCacheStats stats = entry.second->getTileCacheStats();
+        result.hits += stats.hits;
+        result.misses += stats.misses;
+        result.evictions += stats.evictions;
+        result.bytes += stats.bytes;
+    }
+    return result;
+}
+
 void Renderer::Impl::dumpDebugLogs() {
     for (const auto& entry : renderSources) {
         entry.second->dumpDebugLogs();
     }
 
     imageManager->dumpDebugLogs();
+
+    const auto stats = util::ImageBufferPool::get().getStats();
+    Log::Info(Event::General, "ImageBufferPool::hits: %zu", stats.hits);
+    Log::Info(Event::General, "ImageBufferPool::misses: %zu", stats.misses);
+    Log::Info(Event::General, "ImageBufferPool::discards: %zu", stats.discards);
+    Log::Info(Event::General, "ImageBufferPool::pooledBuffers: %zu", stats.pooledBuffers);
+    Log::Info(Event::General, "ImageBufferPool::pooledBytes: %zu", stats.pooledBytes);
 }
 
 RenderLayer* Renderer::Impl::getRenderLayer(const std::string& id) {
@@ -704,7 +792,8 @@ bool Renderer::Impl::hasTransitions(TimePoint timePoint) const {
         }
     }
 
-    if (placement->hasTransitions(timePoint)) {
+    // A placement running on the placement worker invalidates the renderer once it is finished.
+    if (placement->hasTransitions(timePoint) || pendingPlacement) {
         return true;
     }
     
@@ -12,6 +12,8 @@
 #include <mbgl/text/glyph_manager_observer.hpp>
 #include <mbgl/renderer/image_manager_observer.hpp>
 #include <mbgl/text/placement.hpp>
+#include <mbgl/text/placement_worker.hpp>
+#include <mbgl/actor/actor.hpp>
 
 #include <memory>
 #include <string>
@@ -66,6 +68,9 @@ public:
     void reduceMemoryUse();
     void dumpDebugLogs();
 
+    const gfx::RenderingStats& getRenderingStats() const { return renderingStats; }
+    TileCacheStats getTileCacheStats() const;
+
 private:
     bool isLoaded() const;
     bool hasTransitions(TimePoint) const;
@@ -114,6 +119,9 @@ private:
     RenderState renderState = RenderState::Never;
     ZoomHistory zoomHistory;
     TransformState transformState;
+    // Commands issued while rendering the last frame.
+    gfx::RenderingStats renderingStats;
+    bool drawReordering = true;
 
     std::unique_ptr<GlyphManager> glyphManager;
     std::unique_ptr<ImageManager> imageManager;
@@ -129,7 +137,25 @@ private:
     RenderLight renderLight;
 
     CrossTileSymbolIndex crossTileSymbolIndex;
-    std::unique_ptr<Placement> placement;
+    std::shared_ptr<Placement> placement;
+
+    // The buckets that the next placement is placed against. The placement either runs on the
+    // placement worker, or is spread over several frames on the render thread.
+    std::unique_ptr<PlacementSnapshot> placementSnapshot;
+    // The symbol layers the snapshot was taken of; a placement of any other set is discarded.
+    std::vector<std::string> placementSnapshotLayerIDs;
+    std::unique_ptr<Placement> pendingPlacement;
+    // A finished placement handed back by the placement worker, waiting for the next frame.
+    std::unique_ptr<Placement> placementResult;
+    Duration placementTimeBudget = Milliseconds(2);
+    bool backgroundPlacement = true;
+    // Receives placements from the placement worker on the render thread, and invalidates the
+    // renderer so that they get committed. Created on the first background placement.
+    std::unique_ptr<Actor<PlacementWorker::Callback>> placementCallback;
+    // Declared after the snapshot, so that it is destroyed, and stops placing, first.
+    Actor<PlacementWorker> placementWorker;
+
+    std::size_t tileCacheMaxBytes = 0;
 
     bool contextLost = false;
     bool fadingTiles = false;
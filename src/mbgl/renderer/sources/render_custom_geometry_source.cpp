@@ -80,6 +80,10 @@ void RenderCustomGeometrySource::reduceMemoryUse() {
     tilePyramid.reduceMemoryUse();
 }
 
+TileCacheStats RenderCustomGeometrySource::getTileCacheStats() const {
+    return tilePyramid.getCacheStats();
+}
+
 void RenderCustomGeometrySource::dumpDebugLogs() const {
     tilePyramid.dumpDebugLogs();
 }
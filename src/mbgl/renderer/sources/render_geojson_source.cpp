@@ -183,6 +183,10 @@ void RenderGeoJSONSource::reduceMemoryUse() {
     tilePyramid.reduceMemoryUse();
 }
 
+TileCacheStats RenderGeoJSONSource::getTileCacheStats() const {
+    return tilePyramid.getCacheStats();
+}
+
 void RenderGeoJSONSource::dumpDebugLogs() const {
     tilePyramid.dumpDebugLogs();
 }
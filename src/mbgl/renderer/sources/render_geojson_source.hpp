@@ -46,6 +46,7 @@ public:
                            const optional<std::map<std::string, Value>>& args) const final;
 
     void reduceMemoryUse() final;
+    TileCacheStats getTileCacheStats() const final;
     void dumpDebugLogs() const final;
 
 private:
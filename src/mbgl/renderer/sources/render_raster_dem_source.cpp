@@ -160,6 +160,10 @@ void RenderRasterDEMSource::reduceMemoryUse() {
     tilePyramid.reduceMemoryUse();
 }
 
+TileCacheStats RenderRasterDEMSource::getTileCacheStats() const {
+    return tilePyramid.getCacheStats();
+}
+
 void RenderRasterDEMSource::dumpDebugLogs() const {
     tilePyramid.dumpDebugLogs();
 }
@@ -91,6 +91,10 @@ void RenderRasterSource::reduceMemoryUse() {
     tilePyramid.reduceMemoryUse();
 }
 
+TileCacheStats RenderRasterSource::getTileCacheStats() const {
+    return tilePyramid.getCacheStats();
+}
+
 void RenderRasterSource::dumpDebugLogs() const {
     tilePyramid.dumpDebugLogs();
 }
@@ -90,6 +90,10 @@ void RenderVectorSource::reduceMemoryUse() {
     tilePyramid.reduceMemoryUse();
 }
 
+TileCacheStats RenderVectorSource::getTileCacheStats() const {
+    return tilePyramid.getCacheStats();
+}
+
 void RenderVectorSource::dumpDebugLogs() const {
     tilePyramid.dumpDebugLogs();
 }
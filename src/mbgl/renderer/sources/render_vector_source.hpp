@@ -35,6 +35,7 @@ public:
     querySourceFeatures(const SourceQueryOptions&) const final;
 
     void reduceMemoryUse() final;
+    TileCacheStats getTileCacheStats() const final;
     void dumpDebugLogs() const final;
 
 private:
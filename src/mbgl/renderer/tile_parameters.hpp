@@ -2,6 +2,7 @@
 
 #include <mbgl/map/mode.hpp>
 
+#include <cstddef>
 #include <memory>
 
 namespace mbgl {
@@ -23,6 +24,8 @@ public:
     ImageManager& imageManager;
     GlyphManager& glyphManager;
     const uint8_t prefetchZoomDelta;
+    // 0 means the tile caches are only limited by their tile count.
+    const std::size_t tileCacheMaxBytes;
 };
 
 } // namespace mbgl
@@ -4,19 +4,23 @@
 #include <mbgl/renderer/render_source.hpp>
 #include <mbgl/renderer/tile_parameters.hpp>
 #include <mbgl/renderer/query.hpp>
+#include <mbgl/actor/scheduler.hpp>
 #include <mbgl/map/transform.hpp>
 #include <mbgl/math/clamp.hpp>
 #include <mbgl/util/tile_cover.hpp>
 #include <mbgl/util/tile_range.hpp>
 #include <mbgl/util/enum.hpp>
 #include <mbgl/util/logging.hpp>
+#include <mbgl/util/parallel_for.hpp>
 
 #include <mbgl/algorithm/update_renderables.hpp>
 
 #include <mapbox/geometry/envelope.hpp>
 
+#include <atomic>
 #include <cmath>
 #include <algorithm>
+#include <iterator>
 
 namespace mbgl {
 
@@ -86,6 +90,7 @@ void TilePyramid::update(const std::vector<Immutable<style::LayerProperties>>& l
     if (!needsRendering) {
         if (!needsRelayout) {
             for (auto& entry : tiles) {
+                entry.second->setPriority(MailboxPriority::Idle);
                 cache.add(entry.first, std::move(entry.second));
             }
         }
@@ -137,11 +142,18 @@ void TilePyramid::update(const std::vector<Immutable<style::LayerProperties>>& l
     // we're actively using, e.g. as a replacement for tile that aren't loaded yet.
     std::set<OverscaledTileID> retain;
 
+    // Tiles retained for prefetching are processed after the tiles we need for the current
+    // viewport. Prefetch tiles are retained first, so a tile that is needed for both ends up
+    // with the higher priority.
+    MailboxPriority retainPriority = MailboxPriority::Prefetch;
+
     auto retainTileFn = [&](Tile& tile, TileNecessity necessity) -> void {
         if (retain.emplace(tile.id).second) {
             tile.setNecessity(necessity);
         }
 
+        tile.setPriority(retainPriority);
+
         if (needsRelayout) {
             tile.setLayers(layers);
         }
@@ -166,7 +178,7 @@ void TilePyramid::update(const std::vector<Immutable<style::LayerProperties>>& l
         if (!tile) {
             tile = createTile(tileID);
             if (tile) {
-                tile->setObserver(observer);
+                tile->setObserver(this);
                 tile->setLayers(layers);
             }
         }
@@ -194,6 +206,7 @@ void TilePyramid::update(const std::vector<Immutable<style::LayerProperties>>& l
                 [](const UnwrappedTileID&, Tile&) {}, panTiles, zoomRange, panZoom);
     }
 
+    retainPriority = MailboxPriority::Visible;
     algorithm::updateRenderables(getTileFn, createTileFn, retainTileFn, renderTileFn,
                                  idealTiles, zoomRange, tileZoom);
     
@@ -217,6 +230,8 @@ void TilePyramid::update(const std::vector<Immutable<style::LayerProperties>>& l
         cache.setSize(conservativeCacheSize);
     }
 
+    cache.setMaxBytes(parameters.tileCacheMaxBytes);
+
     // Remove stale tiles. This goes through the (sorted!) tiles map and retain set in lockstep
     // and removes items from tiles that don't have the corresponding key in the retain set.
     {
@@ -226,6 +241,7 @@ void TilePyramid::update(const std::vector<Immutable<style::LayerProperties>>& l
             if (retainIt == retain.end() || tilesIt->first < *retainIt) {
                 if (!needsRelayout) {
                     tilesIt->second->setNecessity(TileNecessity::Optional);
+                    tilesIt->second->setPriority(MailboxPriority::Idle);
                     cache.add(tilesIt->first, std::move(tilesIt->second));
                 }
                 tiles.erase(tilesIt++);
@@ -301,6 +317,17 @@ void TilePyramid::handleWrapJump(float lng) {
 }
 
 
+namespace {
+
+std::atomic<std::size_t> parallelQueryThreshold { TilePyramid::defaultParallelQueryThreshold };
+
+} // namespace
+
+// static
+void TilePyramid::setParallelQueryThreshold(std::size_t threshold) {
+    parallelQueryThreshold = threshold;
+}
+
 std::unordered_map<std::string, std::vector<Feature>> TilePyramid::queryRenderedFeatures(const ScreenLineString& geometry,
                                            const TransformState& transformState,
                                            const std::vector<const RenderLayer*>& layers,
@@ -329,6 +356,13 @@ std::unordered_map<std::string, std::vector<Feature>> TilePyramid::queryRendered
 
     auto maxPitchScaleFactor = transformState.maxPitchScaleFactor();
 
+    struct TileQuery {
+        Tile& tile;
+        GeometryCoordinates geometry;
+        std::unordered_map<std::string, std::vector<Feature>> result;
+    };
+    std::vector<TileQuery> tileQueries;
+
     for (const RenderTile& renderTile : sortedTiles) {
         const float scale = std::pow(2, transformState.getZoom() - renderTile.id.canonical.z);
         auto queryPadding = maxPitchScaleFactor * renderTile.tile.getQueryPadding(layers) * util::EXTENT / util::tileSize / scale;
@@ -349,12 +383,39 @@ std::unordered_map<std::string, std::vector<Feature>> TilePyramid::queryRendered
             tileSpaceQueryGeometry.push_back(TileCoordinate::toGeometryCoordinate(renderTile.id, c));
         }
 
-        renderTile.tile.queryRenderedFeatures(result,
-                                              tileSpaceQueryGeometry,
-                                              transformState,
-                                              layers,
-                                              options,
-                                              projMatrix);
+        tileQueries.push_back({ renderTile.tile, std::move(tileSpaceQueryGeometry), {} });
+    }
+
+    // Tiles only read their own data while being queried, so they can be queried
+    // concurrently. The results are merged in tile order afterwards so that the
+    // features come out in the same order as a serial query would return them.
+    auto queryTile = [&] (std::size_t i) {
+        TileQuery& tileQuery = tileQueries[i];
+        tileQuery.tile.queryRenderedFeatures(tileQuery.result,
+                                             tileQuery.geometry,
+                                             transformState,
+                                             layers,
+                                             options,
+                                             projMatrix);
+    };
+
+    if (tileQueries.size() > 1 && tileQueries.size() >= parallelQueryThreshold) {
+        util::parallelFor(*Scheduler::GetBackground(), MailboxPriority::Visible, tileQueries.size(), queryTile);
+    } else {
+        for (std::size_t i = 0; i < tileQueries.size(); ++i) {
+            queryTile(i);
+        }
+    }
+
+    for (auto& tileQuery : tileQueries) {
+        for (auto& pair : tileQuery.result) {
+            auto& features = result[pair.first];
+            if (features.empty()) {
+                features = std::move(pair.second);
+            } else {
+                std::move(pair.second.begin(), pair.second.end(), std::back_inserter(features));
+            }
+        }
     }
 
     return result;
@@ -382,6 +443,15 @@ void TilePyramid::setObserver(TileObserver* observer_) {
     observer = observer_;
 }
 
+void TilePyramid::onTileChanged(Tile& tile) {
+    cache.updateBytes(tile);
+    observer->onTileChanged(tile);
+}
+
+void TilePyramid::onTileError(Tile& tile, std::exception_ptr error) {
+    observer->onTileError(tile, std::move(error));
+}
+
 void TilePyramid::dumpDebugLogs() const {
     for (const auto& pair : tiles) {
         pair.second->dumpDebugLogs();
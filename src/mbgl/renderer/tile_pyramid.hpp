@@ -26,7 +26,7 @@ class RenderedQueryOptions;
 class SourceQueryOptions;
 class TileParameters;
 
-class TilePyramid {
+class TilePyramid : private TileObserver {
 public:
     TilePyramid();
     ~TilePyramid();
@@ -59,9 +59,17 @@ public:
                           const RenderedQueryOptions& options,
                           const mat4& projMatrix) const;
 
+    // Rendered features are queried on the background scheduler, one tile per task, once a
+    // query touches at least this many tiles. Hover queries around a point near a tile corner
+    // touch two to four tiles, so by default every query of more than one tile is parallel;
+    // queries of a single tile stay on the calling thread.
+    static constexpr std::size_t defaultParallelQueryThreshold = 2;
+    static void setParallelQueryThreshold(std::size_t);
+
     std::vector<Feature> querySourceFeatures(const SourceQueryOptions&) const;
 
     void setCacheSize(size_t);
+    TileCacheStats getCacheStats() const { return cache.getStats(); }
     void reduceMemoryUse();
 
     void setObserver(TileObserver*);
@@ -73,6 +81,11 @@ public:
 private:
     void addRenderTile(const UnwrappedTileID& tileID, Tile& tile);
 
+    // TileObserver implementation. Keeps the cache's byte count up to date, and forwards
+    // to the observer.
+    void onTileChanged(Tile&) override;
+    void onTileError(Tile&, std::exception_ptr) override;
+
     std::map<OverscaledTileID, std::unique_ptr<Tile>> tiles;
     TileCache cache;
 
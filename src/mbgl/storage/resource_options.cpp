@@ -10,6 +10,7 @@ public:
     std::string cachePath = ":memory:";
     std::string assetPath = ".";
     uint64_t maximumSize = mbgl::util::DEFAULT_MAX_CACHE_SIZE;
+    uint32_t cacheReaderCount = 0;
     void* platformContext = nullptr;
 };
 
@@ -68,6 +69,15 @@ uint64_t ResourceOptions::maximumCacheSize() const {
     return impl_->maximumSize;
 }
 
+ResourceOptions& ResourceOptions::withCacheReaderCount(uint32_t count) {
+    impl_->cacheReaderCount = count;
+    return *this;
+}
+
+uint32_t ResourceOptions::cacheReaderCount() const {
+    return impl_->cacheReaderCount;
+}
+
 ResourceOptions& ResourceOptions::withPlatformContext(void* context) {
     impl_->platformContext = context;
     return *this;
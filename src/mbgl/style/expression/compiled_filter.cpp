@@ -0,0 +1,411 @@
+#include <mbgl/style/expression/compiled_filter.hpp>
+#include <mbgl/style/expression/compound_expression.hpp>
+#include <mbgl/style/expression/literal.hpp>
+#include <mbgl/tile/geometry_tile_data.hpp>
+
+#include <cassert>
+
+namespace mbgl {
+namespace style {
+namespace expression {
+
+namespace {
+
+std::vector<const Expression*> childrenOf(const Expression& expression) {
+    std::vector<const Expression*> children;
+    expression.eachChild([&](const Expression& child) {
+        children.push_back(&child);
+    });
+    return children;
+}
+
+optional<Value> literalValue(const Expression& expression) {
+    if (expression.getKind() != Kind::Literal) {
+        return nullopt;
+    }
+    return static_cast<const Literal&>(expression).getValue();
+}
+
+optional<std::string> literalString(const Expression& expression) {
+    optional<Value> value = literalValue(expression);
+    if (!value || !value->is<std::string>()) {
+        return nullopt;
+    }
+    return value->get<std::string>();
+}
+
+bool isCompound(const Expression& expression, const char* name, std::size_t parameterCount) {
+    if (expression.getKind() != Kind::CompoundExpression) {
+        return false;
+    }
+    auto compound = static_cast<const CompoundExpression*>(&expression);
+    optional<std::size_t> count = compound->getParameterCount();
+    return compound->getOperator() == name && count && *count == parameterCount;
+}
+
+// Returns the key of a ["get", key] expression with a literal key.
+optional<std::string> propertyKey(const Expression& expression) {
+    if (!isCompound(expression, "get", 1)) {
+        return nullopt;
+    }
+    return literalString(*childrenOf(expression).at(0));
+}
+
+optional<uint8_t> typeBit(const std::string& type) {
+    if (type == "Point") return uint8_t(1u << uint8_t(FeatureType::Point));
+    if (type == "LineString") return uint8_t(1u << uint8_t(FeatureType::LineString));
+    if (type == "Polygon") return uint8_t(1u << uint8_t(FeatureType::Polygon));
+    if (type == "Unknown") return uint8_t(1u << uint8_t(FeatureType::Unknown));
+    return nullopt;
+}
+
+// Same as `toExpressionValue(property) == value`, without converting the property.
+bool equals(const mbgl::Value& property, const Value& value) {
+    return property.match(
+        [&](const NullValue&) { return value.is<NullValue>(); },
+        [&](bool b) { return value.is<bool>() && value.get<bool>() == b; },
+        [&](uint64_t n) { return value.is<double>() && value.get<double>() == static_cast<double>(n); },
+        [&](int64_t n) { return value.is<double>() && value.get<double>() == static_cast<double>(n); },
+        [&](double n) { return value.is<double>() && value.get<double>() == n; },
+        [&](const std::string& s) { return value.is<std::string>() && value.get<std::string>() == s; },
+        [&](const auto&) { return toExpressionValue(property) == value; }
+    );
+}
+
+} // namespace
+
+std::unique_ptr<CompiledFilter> CompiledFilter::compile(const Expression& expression) {
+    auto compiled = std::make_unique<CompiledFilter>();
+    if (!compiled->compileNode(expression)) {
+        return nullptr;
+    }
+    return compiled;
+}
+
+bool CompiledFilter::compileNode(const Expression& expression) {
+    const std::size_t index = nodes.size();
+    nodes.emplace_back();
+
+    bool compiled = false;
+    const std::vector<const Expression*> children = childrenOf(expression);
+
+    switch (expression.getKind()) {
+    case Kind::Literal: {
+        optional<Value> value = literalValue(expression);
+        if (value && value->is<bool>()) {
+            nodes[index].op = Op::Constant;
+            nodes[index].flag = value->get<bool>();
+            compiled = true;
+        }
+        break;
+    }
+
+    case Kind::All:
+    case Kind::Any:
+        nodes[index].op = expression.getKind() == Kind::All ? Op::All : Op::Any;
+        compiled = true;
+        for (const Expression* child : children) {
+            if (!compileNode(*child)) {
+                return false;
+            }
+        }
+        break;
+
+    case Kind::Comparison: {
+        // Collator comparisons have a third child.
+        if (children.size() != 2) {
+            break;
+        }
+        const std::string op = expression.getOperator();
+        const Expression& lhs = *children[0];
+        const Expression& rhs = *children[1];
+
+        if (isCompound(lhs, "zoom", 0)) {
+            nodes.pop_back();
+            return compileZoomComparison(op, lhs, rhs, true);
+        } else if (isCompound(rhs, "zoom", 0)) {
+            nodes.pop_back();
+            return compileZoomComparison(op, rhs, lhs, false);
+        } else if (op == "==" || op == "!=") {
+            nodes.pop_back();
+            return propertyKey(lhs) ? compilePropertyComparison(lhs, rhs, op == "!=")
+                                    : compilePropertyComparison(rhs, lhs, op == "!=");
+        }
+        break;
+    }
+
+    case Kind::Match:
+        nodes.pop_back();
+        return compileMatch(expression);
+
+    case Kind::CompoundExpression: {
+        const std::string name = expression.getOperator();
+
+        if (name == "!" && children.size() == 1) {
+            nodes[index].op = Op::Not;
+            compiled = compileNode(*children[0]);
+        } else if ((name == "has" && isCompound(expression, "has", 1)) || name == "filter-has") {
+            optional<std::string> key = literalString(*children.at(0));
+            if (key) {
+                nodes[index].op = Op::Has;
+                nodes[index].key = keys.size();
+                keys.push_back(*key);
+                compiled = true;
+            }
+        } else if ((name == "filter-==" || name == "filter-in") && !children.empty()) {
+            optional<std::string> key = literalString(*children[0]);
+            if (!key) {
+                break;
+            }
+            nodes[index].op = name == "filter-==" ? Op::Equals : Op::In;
+            nodes[index].key = keys.size();
+            keys.push_back(*key);
+            nodes[index].valuesBegin = values.size();
+            for (std::size_t i = 1; i < children.size(); ++i) {
+                optional<Value> value = literalValue(*children[i]);
+                if (!value) {
+                    return false;
+                }
+                values.push_back(std::move(*value));
+            }
+            nodes[index].valuesEnd = values.size();
+            compiled = name == "filter-in" || values.size() == nodes[index].valuesBegin + 1;
+        } else if (name == "filter-type-==" || name == "filter-type-in") {
+            nodes[index].op = Op::TypeIn;
+            compiled = true;
+            for (const Expression* child : children) {
+                optional<std::string> type = literalString(*child);
+                if (!type) {
+                    return false;
+                }
+                if (optional<uint8_t> bit = typeBit(*type)) {
+                    nodes[index].typeMask |= *bit;
+                }
+            }
+        }
+        break;
+    }
+
+    default:
+        break;
+    }
+
+    if (!compiled) {
+        return false;
+    }
+
+    nodes[index].size = nodes.size() - index;
+    return true;
+}
+
+bool CompiledFilter::compilePropertyComparison(const Expression& property, const Expression& operand, bool negate) {
+    optional<std::string> key = propertyKey(property);
+    optional<Value> value = literalValue(operand);
+    if (!key || !value) {
+        return false;
+    }
+
+    if (negate) {
+        Node node;
+        node.op = Op::Not;
+        node.size = 2;
+        nodes.push_back(node);
+    }
+
+    Node node;
+    node.op = Op::Equals;
+    node.flag = true;
+    node.key = keys.size();
+    keys.push_back(*key);
+    node.valuesBegin = values.size();
+    values.push_back(std::move(*value));
+    node.valuesEnd = values.size();
+    nodes.push_back(node);
+    return true;
+}
+
+bool CompiledFilter::compileMatch(const Expression& expression) {
+    // Only matches on a property that choose between boolean literals are compiled. They're
+    // equivalent to testing whether the property is one of the labels whose output differs
+    // from the fallback output.
+    const std::vector<const Expression*> children = childrenOf(expression);
+    optional<std::string> key = propertyKey(*children.at(0));
+    if (!key) {
+        return false;
+    }
+    for (std::size_t i = 1; i < children.size(); ++i) {
+        optional<Value> output = literalValue(*children[i]);
+        if (!output || !output->is<bool>()) {
+            return false;
+        }
+    }
+
+    // The labels are only reachable through the serialized form, which is
+    // ["match", input, label(s), output, ..., otherwise].
+    const mbgl::Value serialized = expression.serialize();
+    if (!serialized.is<std::vector<mbgl::Value>>()) {
+        return false;
+    }
+    const auto& parts = serialized.get<std::vector<mbgl::Value>>();
+    if (parts.size() < 3 || !parts.back().is<bool>()) {
+        return false;
+    }
+    const bool otherwise = parts.back().get<bool>();
+
+    Node node;
+    node.op = Op::In;
+    node.key = keys.size();
+    node.valuesBegin = values.size();
+
+    auto addLabel = [&](const mbgl::Value& label) {
+        return label.match(
+            [&](const std::string& s) { values.emplace_back(s); return true; },
+            [&](int64_t n) { values.emplace_back(static_cast<double>(n)); return true; },
+            [&](uint64_t n) { values.emplace_back(static_cast<double>(n)); return true; },
+            [&](double n) { values.emplace_back(n); return true; },
+            [&](const auto&) { return false; }
+        );
+    };
+
+    for (std::size_t i = 2; i + 1 < parts.size(); i += 2) {
+        if (!parts[i + 1].is<bool>()) {
+            return false;
+        }
+        if (parts[i + 1].get<bool>() == otherwise) {
+            continue;
+        }
+        if (parts[i].is<std::vector<mbgl::Value>>()) {
+            for (const auto& label : parts[i].get<std::vector<mbgl::Value>>()) {
+                if (!addLabel(label)) {
+                    return false;
+                }
+            }
+        } else if (!addLabel(parts[i])) {
+            return false;
+        }
+    }
+
+    node.valuesEnd = values.size();
+    keys.push_back(*key);
+
+    if (otherwise) {
+        Node negation;
+        negation.op = Op::Not;
+        negation.size = 2;
+        nodes.push_back(negation);
+    }
+    nodes.push_back(node);
+    return true;
+}
+
+bool CompiledFilter::compileZoomComparison(const std::string& op, const Expression&, const Expression& operand, bool zoomFirst) {
+    optional<Value> value = literalValue(operand);
+    if (!value || !value->is<double>()) {
+        return false;
+    }
+
+    Node node;
+    node.zoom = value->get<double>();
+    if (op == "==" || op == "!=") {
+        node.op = Op::ZoomEquals;
+    } else if (op == "<") {
+        node.op = zoomFirst ? Op::ZoomLess : Op::ZoomGreater;
+    } else if (op == "<=") {
+        node.op = zoomFirst ? Op::ZoomLessOrEqual : Op::ZoomGreaterOrEqual;
+    } else if (op == ">") {
+        node.op = zoomFirst ? Op::ZoomGreater : Op::ZoomLess;
+    } else if (op == ">=") {
+        node.op = zoomFirst ? Op::ZoomGreaterOrEqual : Op::ZoomLessOrEqual;
+    } else {
+        return false;
+    }
+
+    if (op == "!=") {
+        Node negation;
+        negation.op = Op::Not;
+        negation.size = 2;
+        nodes.push_back(negation);
+    }
+    nodes.push_back(node);
+    usesZoom = true;
+    return true;
+}
+
+bool CompiledFilter::evaluate(const EvaluationContext& context) const {
+    assert(canEvaluate(context));
+    return evaluate(context, 0);
+}
+
+bool CompiledFilter::evaluate(const EvaluationContext& context, std::size_t index) const {
+    const Node& node = nodes[index];
+    const std::size_t end = index + node.size;
+
+    switch (node.op) {
+    case Op::Constant:
+        return node.flag;
+
+    case Op::All:
+        for (std::size_t child = index + 1; child < end; child += nodes[child].size) {
+            if (!evaluate(context, child)) {
+                return false;
+            }
+        }
+        return true;
+
+    case Op::Any:
+        for (std::size_t child = index + 1; child < end; child += nodes[child].size) {
+            if (evaluate(context, child)) {
+                return true;
+            }
+        }
+        return false;
+
+    case Op::Not:
+        return !evaluate(context, index + 1);
+
+    case Op::Has:
+        return bool(context.feature->getValue(keys[node.key]));
+
+    case Op::Equals: {
+        const optional<mbgl::Value> property = context.feature->getValue(keys[node.key]);
+        if (!property) {
+            return node.flag && values[node.valuesBegin].is<NullValue>();
+        }
+        return equals(*property, values[node.valuesBegin]);
+    }
+
+    case Op::In: {
+        const optional<mbgl::Value> property = context.feature->getValue(keys[node.key]);
+        if (!property) {
+            return false;
+        }
+        for (std::size_t i = node.valuesBegin; i < node.valuesEnd; ++i) {
+            if (equals(*property, values[i])) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    case Op::TypeIn:
+        return node.typeMask & (1u << uint8_t(context.feature->getType()));
+
+    case Op::ZoomLess:
+        return double(*context.zoom) < node.zoom;
+    case Op::ZoomLessOrEqual:
+        return double(*context.zoom) <= node.zoom;
+    case Op::ZoomGreater:
+        return double(*context.zoom) > node.zoom;
+    case Op::ZoomGreaterOrEqual:
+        return double(*context.zoom) >= node.zoom;
+    case Op::ZoomEquals:
+        return double(*context.zoom) == node.zoom;
+    }
+
+    assert(false);
+    return false;
+}
+
+} // namespace expression
+} // namespace style
+} // namespace mbgl
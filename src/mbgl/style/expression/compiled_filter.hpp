@@ -0,0 +1,87 @@
+#pragma once
+
+#include <mbgl/style/expression/expression.hpp>
+#include <mbgl/util/feature.hpp>
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace mbgl {
+namespace style {
+namespace expression {
+
+/*
+    CompiledFilter is a flat representation of the filter shapes styles use
+    most: ==, != and match on ["get", key], legacy property filters, has,
+    $type filters, zoom comparisons, and the boolean combinators over them.
+    Evaluating it walks an array of nodes without virtual calls and without
+    creating intermediate EvaluationResults. Expressions of any other shape
+    aren't compiled, and are evaluated by the expression tree instead.
+*/
+class CompiledFilter {
+public:
+    // Returns nullptr if the expression contains a node this evaluator doesn't handle.
+    static std::unique_ptr<CompiledFilter> compile(const Expression&);
+
+    // Returns whether evaluate() can be used in the given context. Contexts that lack
+    // the feature or the zoom a filter needs produce evaluation errors, which only the
+    // expression tree reports faithfully.
+    bool canEvaluate(const EvaluationContext& context) const {
+        return context.feature && (context.zoom || !usesZoom);
+    }
+
+    bool evaluate(const EvaluationContext&) const;
+
+private:
+    enum class Op : uint8_t {
+        Constant,
+        All,
+        Any,
+        Not,
+        Has,
+        Equals,
+        In,
+        TypeIn,
+        ZoomLess,
+        ZoomLessOrEqual,
+        ZoomGreater,
+        ZoomGreaterOrEqual,
+        ZoomEquals
+    };
+
+    struct Node {
+        Op op;
+        // Constant: the result. Equals: whether a missing property compares as null, like
+        // ["get", key] does, rather than failing the comparison, like legacy filters do.
+        bool flag = false;
+        // TypeIn: a bit for each matching FeatureType.
+        uint8_t typeMask = 0;
+        // Number of nodes in the subtree rooted at this node, including itself.
+        uint32_t size = 1;
+        // Has, Equals, In: index into `keys`.
+        uint32_t key = 0;
+        // Equals, In: range in `values`.
+        uint32_t valuesBegin = 0;
+        uint32_t valuesEnd = 0;
+        // Zoom comparisons: the operand.
+        double zoom = 0;
+    };
+
+    bool compileNode(const Expression&);
+    bool compilePropertyComparison(const Expression& property, const Expression& operand, bool negate);
+    bool compileMatch(const Expression&);
+    bool compileZoomComparison(const std::string& op, const Expression& zoom, const Expression& operand, bool zoomFirst);
+
+    bool evaluate(const EvaluationContext&, std::size_t index) const;
+
+    std::vector<Node> nodes;
+    std::vector<std::string> keys;
+    std::vector<Value> values;
+    bool usesZoom = false;
+};
+
+} // namespace expression
+} // namespace style
+} // namespace mbgl
@@ -1,12 +1,26 @@
 #include <mbgl/style/filter.hpp>
+#include <mbgl/style/expression/compiled_filter.hpp>
 #include <mbgl/tile/geometry_tile_data.hpp>
 
 namespace mbgl {
 namespace style {
 
+Filter::Filter(expression::ParseResult _expression, optional<mbgl::Value> _filter)
+    : expression(std::move(*_expression)),
+      legacyFilter(std::move(_filter)) {
+    assert(!expression || *expression != nullptr);
+    if (expression) {
+        compiled = expression::CompiledFilter::compile(**expression);
+    }
+}
+
 bool Filter::operator()(const expression::EvaluationContext &context) const {
     
     if (!this->expression) return true;
+
+    if (compiled && compiled->canEvaluate(context)) {
+        return compiled->evaluate(context);
+    }
     
     const expression::EvaluationResult result = (*this->expression)->evaluate(context);
     if (result) {
@@ -12,7 +12,7 @@ namespace mbgl {
 class CollisionBox {
 public:
     CollisionBox(Point<float> _anchor, Point<float> _offset, float _x1, float _y1, float _x2, float _y2, float _signedDistanceFromAnchor = 0, float _radius = 0) :
-        anchor(std::move(_anchor)), offset(_offset), x1(_x1), y1(_y1), x2(_x2), y2(_y2), used(true), signedDistanceFromAnchor(_signedDistanceFromAnchor), radius(_radius) {}
+        anchor(std::move(_anchor)), offset(_offset), x1(_x1), y1(_y1), x2(_x2), y2(_y2), signedDistanceFromAnchor(_signedDistanceFromAnchor), radius(_radius) {}
 
     // the box is centered around the anchor point
     Point<float> anchor;
@@ -26,17 +26,6 @@ public:
     float x2;
     float y2;
 
-    // Projected box geometry: generated/updated at placement time
-    float px1;
-    float py1;
-    float px2;
-    float py2;
-    
-    // Projected circle geometry: generated/updated at placement time
-    float px;
-    float py;
-    bool used;
-
     float signedDistanceFromAnchor;
     float radius;
 };
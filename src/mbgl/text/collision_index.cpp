@@ -24,6 +24,13 @@ namespace mbgl {
 // stability, but it's expensive.
 static const float viewportPadding = 100;
 
+// Symbols only collide with symbols of their own collision group.
+static auto inCollisionGroup(uint16_t collisionGroupId) {
+    return [collisionGroupId](const IndexedSubfeature& feature) {
+        return feature.collisionGroupId == collisionGroupId;
+    };
+}
+
 CollisionIndex::CollisionIndex(const TransformState& transformState_)
     : transformState(transformState_)
     , collisionGrid(transformState.getSize().width + 2 * viewportPadding, transformState.getSize().height + 2 * viewportPadding, 25)
@@ -55,11 +62,11 @@ float CollisionIndex::approximateTileDistance(const TileDistance& tileDistance,
         (incidenceStretch - 1) * lastSegmentTile * std::abs(std::sin(lastSegmentAngle));
 }
 
-bool CollisionIndex::isOffscreen(const CollisionBox& box) const {
+bool CollisionIndex::isOffscreen(const ProjectedCollisionBox& box) const {
     return box.px2 < viewportPadding || box.px1 >= screenRightBoundary || box.py2 < viewportPadding || box.py1 >= screenBottomBoundary;
 }
 
-bool CollisionIndex::isInsideGrid(const CollisionBox& box) const {
+bool CollisionIndex::isInsideGrid(const ProjectedCollisionBox& box) const {
     return box.px2 >= 0 && box.px1 < gridRightBoundary && box.py2 >= 0 && box.py1 < gridBottomBoundary;
 }
     
@@ -71,7 +78,7 @@ CollisionTileBoundaries CollisionIndex::projectTileBoundaries(const mat4& posMat
     
 }
 
-bool CollisionIndex::isInsideTile(const CollisionBox& box, const CollisionTileBoundaries& tileBoundaries) const {
+bool CollisionIndex::isInsideTile(const ProjectedCollisionBox& box, const CollisionTileBoundaries& tileBoundaries) const {
     // This check is only well defined when the tile boundaries are axis-aligned
     // We are relying on it only being used in MapMode::Tile, where that is always the case
 
@@ -79,53 +86,59 @@ bool CollisionIndex::isInsideTile(const CollisionBox& box, const CollisionTileBo
 }
 
 
-std::pair<bool,bool> CollisionIndex::placeFeature(CollisionFeature& feature,
+std::pair<bool,bool> CollisionIndex::placeFeature(const CollisionFeature& feature,
+                                      ProjectedCollisionFeature& projected,
                                       Point<float> shift,
                                       const mat4& posMatrix,
                                       const mat4& labelPlaneMatrix,
                                       const float textPixelRatio,
-                                      PlacedSymbol& symbol,
+                                      const PlacedSymbol& symbol,
                                       const float scale,
                                       const float fontSize,
                                       const bool allowOverlap,
                                       const bool pitchWithMap,
                                       const bool collisionDebug,
                                       const optional<CollisionTileBoundaries>& avoidEdges,
-                                      const optional<std::function<bool(const IndexedSubfeature&)>> collisionGroupPredicate) {
+                                      const uint16_t collisionGroupId) {
+    projected.assign(feature.boxes.size(), ProjectedCollisionBox());
+
     if (!feature.alongLine) {
-        CollisionBox& box = feature.boxes.front();
-        const auto projectedPoint = projectAndGetPerspectiveRatio(posMatrix, box.anchor);
+        const CollisionBox& featureBox = feature.boxes.front();
+        ProjectedCollisionBox& box = projected.front();
+        const auto projectedPoint = projectAndGetPerspectiveRatio(posMatrix, featureBox.anchor);
         const float tileToViewport = textPixelRatio * projectedPoint.second;
-        box.px1 = (box.x1 + shift.x) * tileToViewport + projectedPoint.first.x;
-        box.py1 = (box.y1 + shift.y) * tileToViewport + projectedPoint.first.y;
-        box.px2 = (box.x2 + shift.x) * tileToViewport + projectedPoint.first.x;
-        box.py2 = (box.y2 + shift.y) * tileToViewport + projectedPoint.first.y;
-    
+        box.px1 = (featureBox.x1 + shift.x) * tileToViewport + projectedPoint.first.x;
+        box.py1 = (featureBox.y1 + shift.y) * tileToViewport + projectedPoint.first.y;
+        box.px2 = (featureBox.x2 + shift.x) * tileToViewport + projectedPoint.first.x;
+        box.py2 = (featureBox.y2 + shift.y) * tileToViewport + projectedPoint.first.y;
+        box.used = true;
+
 
         if ((avoidEdges && !isInsideTile(box, *avoidEdges)) ||
             !isInsideGrid(box) ||
-            (!allowOverlap && collisionGrid.hitTest({{ box.px1, box.py1 }, { box.px2, box.py2 }}, collisionGroupPredicate))) {
+            (!allowOverlap && collisionGrid.hitTest({{ box.px1, box.py1 }, { box.px2, box.py2 }}, inCollisionGroup(collisionGroupId)))) {
             return { false, false };
         }
 
         return {true, isOffscreen(box)};
     } else {
-        return placeLineFeature(feature, posMatrix, labelPlaneMatrix, textPixelRatio, symbol, scale, fontSize, allowOverlap, pitchWithMap, collisionDebug, avoidEdges, collisionGroupPredicate);
+        return placeLineFeature(feature, projected, posMatrix, labelPlaneMatrix, textPixelRatio, symbol, scale, fontSize, allowOverlap, pitchWithMap, collisionDebug, avoidEdges, collisionGroupId);
     }
 }
 
-std::pair<bool,bool> CollisionIndex::placeLineFeature(CollisionFeature& feature,
+std::pair<bool,bool> CollisionIndex::placeLineFeature(const CollisionFeature& feature,
+                                      ProjectedCollisionFeature& projected,
                                       const mat4& posMatrix,
                                       const mat4& labelPlaneMatrix,
                                       const float textPixelRatio,
-                                      PlacedSymbol& symbol,
+                                      const PlacedSymbol& symbol,
                                       const float scale,
                                       const float fontSize,
                                       const bool allowOverlap,
                                       const bool pitchWithMap,
                                       const bool collisionDebug,
                                       const optional<CollisionTileBoundaries>& avoidEdges,
-                                      const optional<std::function<bool(const IndexedSubfeature&)>> collisionGroupPredicate) {
+                                      const uint16_t collisionGroupId) {
 
     const auto tileUnitAnchorPoint = symbol.anchorPoint;
     const auto projectedAnchor = projectAnchor(posMatrix, tileUnitAnchorPoint);
@@ -163,28 +176,28 @@ std::pair<bool,bool> CollisionIndex::placeLineFeature(CollisionFeature& feature,
         lastTileDistance = approximateTileDistance(*(firstAndLastGlyph->second.tileDistance), firstAndLastGlyph->second.angle, pixelsToTileUnits, projectedAnchor.second, pitchWithMap);
     }
 
-    bool atLeastOneCirclePlaced = false;
+    // Boxes start out unused (see placeFeature), so skipping a circle leaves it marked unused.
+    const ProjectedCollisionBox* previousCircle = nullptr;
     for (size_t i = 0; i < feature.boxes.size(); i++) {
-        CollisionBox& circle = feature.boxes[i];
-        const float boxSignedDistanceFromAnchor = circle.signedDistanceFromAnchor;
+        const CollisionBox& featureCircle = feature.boxes[i];
+        ProjectedCollisionBox& circle = projected[i];
+        const float boxSignedDistanceFromAnchor = featureCircle.signedDistanceFromAnchor;
         if (!firstAndLastGlyph ||
             (boxSignedDistanceFromAnchor < -firstTileDistance) ||
             (boxSignedDistanceFromAnchor > lastTileDistance)) {
             // The label either doesn't fit on its line or we
             // don't need to use this circle because the label
-            // doesn't extend this far. Either way, mark the circle unused.
-            circle.used = false;
+            // doesn't extend this far. Either way, leave the circle unused.
             continue;
         }
 
-        const auto projectedPoint = projectPoint(posMatrix, circle.anchor);
-        const float tileUnitRadius = (circle.x2 - circle.x1) / 2;
+        const auto projectedPoint = projectPoint(posMatrix, featureCircle.anchor);
+        const float tileUnitRadius = (featureCircle.x2 - featureCircle.x1) / 2;
         const float radius = tileUnitRadius * tileToViewport;
 
-        if (atLeastOneCirclePlaced) {
-            const CollisionBox& previousCircle = feature.boxes[i - 1];
-            const float dx = projectedPoint.x - previousCircle.px;
-            const float dy = projectedPoint.y - previousCircle.py;
+        if (previousCircle) {
+            const float dx = projectedPoint.x - previousCircle->px;
+            const float dy = projectedPoint.y - previousCircle->py;
             // The circle edges touch when the distance between their centers is 2x the radius
             // When the distance is 1x the radius, they're doubled up, and we could remove
             // every other circle while keeping them all in touch.
@@ -202,14 +215,13 @@ std::pair<bool,bool> CollisionIndex::placeLineFeature(CollisionFeature& feature,
                         // Hide significantly overlapping circles, unless this is the last one we can
                         // use, in which case we want to keep it in place even if it's tightly packed
                         // with the one before it.
-                        circle.used = false;
                         continue;
                     }
                 }
             }
         }
 
-        atLeastOneCirclePlaced = true;
+        previousCircle = &circle;
         circle.px1 = projectedPoint.x - radius;
         circle.px2 = projectedPoint.x + radius;
         circle.py1 = projectedPoint.y - radius;
@@ -225,7 +237,7 @@ std::pair<bool,bool> CollisionIndex::placeLineFeature(CollisionFeature& feature,
         inGrid |= isInsideGrid(circle);
 
         if ((avoidEdges && !isInsideTile(circle, *avoidEdges)) ||
-            (!allowOverlap && collisionGrid.hitTest({{circle.px, circle.py}, circle.radius}, collisionGroupPredicate))) {
+            (!allowOverlap && collisionGrid.hitTest({{circle.px, circle.py}, circle.radius}, inCollisionGroup(collisionGroupId)))) {
             if (!collisionDebug) {
                 return {false, false};
             } else {
@@ -240,9 +252,10 @@ std::pair<bool,bool> CollisionIndex::placeLineFeature(CollisionFeature& feature,
 }
 
 
-void CollisionIndex::insertFeature(CollisionFeature& feature, bool ignorePlacement, uint32_t bucketInstanceId, uint16_t collisionGroupId) {
+void CollisionIndex::insertFeature(const CollisionFeature& feature, const ProjectedCollisionFeature& projected, bool ignorePlacement, uint32_t bucketInstanceId, uint16_t collisionGroupId) {
+    assert(projected.size() == feature.boxes.size());
     if (feature.alongLine) {
-        for (auto& circle : feature.boxes) {
+        for (auto& circle : projected) {
             if (!circle.used) {
                 continue;
             }
@@ -261,7 +274,7 @@ void CollisionIndex::insertFeature(CollisionFeature& feature, bool ignorePlaceme
         }
     } else {
         assert(feature.boxes.size() == 1);
-        auto& box = feature.boxes[0];
+        auto& box = projected[0];
         if (ignorePlacement) {
             ignoredGrid.insert(
                 IndexedSubfeature(feature.indexedFeature, bucketInstanceId, collisionGroupId),
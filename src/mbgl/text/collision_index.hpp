@@ -7,6 +7,7 @@
 #include <mbgl/map/transform_state.hpp>
 
 #include <array>
+#include <vector>
 
 namespace mbgl {
 
@@ -16,49 +17,71 @@ struct TileDistance;
     
 using CollisionTileBoundaries = std::array<float,4>;
 
+// Where a collision box or circle of a feature lands on screen. Computed by placeFeature() and
+// kept apart from the feature, so that placing a feature doesn't write to the bucket it comes from.
+class ProjectedCollisionBox {
+public:
+    // Projected box geometry, or the bounding box of a projected circle.
+    float px1 = 0;
+    float py1 = 0;
+    float px2 = 0;
+    float py2 = 0;
+
+    // Projected circle geometry.
+    float px = 0;
+    float py = 0;
+    float radius = 0;
+    bool used = false;
+};
+
+using ProjectedCollisionFeature = std::vector<ProjectedCollisionBox>;
+
 class CollisionIndex {
 public:
     using CollisionGrid = GridIndex<IndexedSubfeature>;
 
     explicit CollisionIndex(const TransformState&);
 
-    std::pair<bool,bool> placeFeature(CollisionFeature& feature,
+    // Projects the feature into `projected`, which insertFeature() then adds to the index.
+    std::pair<bool,bool> placeFeature(const CollisionFeature& feature,
+                                      ProjectedCollisionFeature& projected,
                                       Point<float> shift,
                                       const mat4& posMatrix,
                                       const mat4& labelPlaneMatrix,
                                       const float textPixelRatio,
-                                      PlacedSymbol& symbol,
+                                      const PlacedSymbol& symbol,
                                       const float scale,
                                       const float fontSize,
                                       const bool allowOverlap,
                                       const bool pitchWithMap,
                                       const bool collisionDebug,
                                       const optional<CollisionTileBoundaries>& avoidEdges,
-                                      const optional<std::function<bool(const IndexedSubfeature&)>> collisionGroupPredicate);
+                                      const uint16_t collisionGroupId);
 
-    void insertFeature(CollisionFeature& feature, bool ignorePlacement, uint32_t bucketInstanceId, uint16_t collisionGroupId);
+    void insertFeature(const CollisionFeature& feature, const ProjectedCollisionFeature& projected, bool ignorePlacement, uint32_t bucketInstanceId, uint16_t collisionGroupId);
 
     std::unordered_map<uint32_t, std::vector<IndexedSubfeature>> queryRenderedSymbols(const ScreenLineString&) const;
     
     CollisionTileBoundaries projectTileBoundaries(const mat4& posMatrix) const;
 
 private:
-    bool isOffscreen(const CollisionBox&) const;
-    bool isInsideGrid(const CollisionBox&) const;
-    bool isInsideTile(const CollisionBox&, const CollisionTileBoundaries& tileBoundaries) const;
+    bool isOffscreen(const ProjectedCollisionBox&) const;
+    bool isInsideGrid(const ProjectedCollisionBox&) const;
+    bool isInsideTile(const ProjectedCollisionBox&, const CollisionTileBoundaries& tileBoundaries) const;
 
-    std::pair<bool,bool> placeLineFeature(CollisionFeature& feature,
+    std::pair<bool,bool> placeLineFeature(const CollisionFeature& feature,
+                                  ProjectedCollisionFeature& projected,
                                   const mat4& posMatrix,
                                   const mat4& labelPlaneMatrix,
                                   const float textPixelRatio,
-                                  PlacedSymbol& symbol,
+                                  const PlacedSymbol& symbol,
                                   const float scale,
                                   const float fontSize,
                                   const bool allowOverlap,
                                   const bool pitchWithMap,
                                   const bool collisionDebug,
                                   const optional<CollisionTileBoundaries>& avoidEdges,
-                                  const optional<std::function<bool(const IndexedSubfeature&)>> collisionGroupPredicate);
+                                  const uint16_t collisionGroupId);
     
     float approximateTileDistance(const TileDistance& tileDistance, const float lastSegmentAngle, const float pixelsToTileUnits, const float cameraToAnchorDistance, const bool pitchWithMap);
     
@@ -173,7 +173,7 @@ bool CrossTileSymbolIndex::addLayer(const RenderLayer& layer, float lng) {
 
     for (const auto& item : layer.getPlacementData()) {
         RenderTile& renderTile = item.tile;
-        Bucket& bucket = item.bucket;
+        Bucket& bucket = *item.bucket;
         auto result = bucket.registerAtCrossTileIndex(layerIndex, renderTile.tile.id, maxCrossTileID);
         assert(result.first != 0u);
         symbolBucketsChanged = symbolBucketsChanged || result.second;
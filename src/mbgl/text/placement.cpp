@@ -37,28 +37,51 @@ bool JointOpacityState::isHidden() const {
     return icon.isHidden() && text.isHidden();
 }
     
-const CollisionGroups::CollisionGroup& CollisionGroups::get(const std::string& sourceID) {
-    // The predicate/groupID mechanism allows for arbitrary grouping,
+uint16_t CollisionGroups::get(const std::string& sourceID) {
+    // The groupID mechanism allows for arbitrary grouping,
     // but the current interface defines one source == one group when
-    // crossSourceCollisions == true.
+    // crossSourceCollisions == false. Otherwise, all symbols share group 0.
     if (!crossSourceCollisions) {
-        if (collisionGroups.find(sourceID) == collisionGroups.end()) {
-            uint16_t nextGroupID = ++maxGroupID;
-            collisionGroups.emplace(sourceID, CollisionGroup(
-                nextGroupID,
-                optional<Predicate>([nextGroupID](const IndexedSubfeature& feature) -> bool {
-                    return feature.collisionGroupId == nextGroupID;
-                })
-            ));
+        auto it = collisionGroups.find(sourceID);
+        if (it == collisionGroups.end()) {
+            it = collisionGroups.emplace(sourceID, ++maxGroupID).first;
         }
-        return collisionGroups[sourceID];
+        return it->second;
     } else {
-        static CollisionGroup nullGroup{0, nullopt};
-        return nullGroup;
+        return 0;
     }
 }
 
-Placement::Placement(const TransformState& state_, MapMode mapMode_, style::TransitionOptions transitionOptions_, const bool crossSourceCollisions, std::unique_ptr<Placement> prevPlacement_)
+PlacementSnapshot::PlacementSnapshot(const std::vector<std::reference_wrapper<const RenderLayer>>& placementLayers) {
+    layers.reserve(placementLayers.size());
+    for (const RenderLayer& layer : placementLayers) {
+        std::vector<BucketPlacementData> buckets;
+        buckets.reserve(layer.getPlacementData().size());
+        for (const auto& item : layer.getPlacementData()) {
+            const RenderTile& renderTile = item.tile;
+            assert(renderTile.tile.kind == Tile::Kind::Geometry);
+            const auto& geometryTile = static_cast<const GeometryTile&>(renderTile.tile);
+
+            BucketPlacementData data{
+                item.bucket,
+                geometryTile.getFeatureIndex(),
+                renderTile.id,
+                geometryTile.id,
+                geometryTile.sourceID,
+                item.pitchWithMap,
+                item.rotateWithMap,
+                geometryTile.holdForFade(),
+                {},
+                0u,
+                false};
+            item.bucket->takePlacementSnapshot(data);
+            buckets.push_back(std::move(data));
+        }
+        layers.push_back(std::move(buckets));
+    }
+}
+
+Placement::Placement(const TransformState& state_, MapMode mapMode_, style::TransitionOptions transitionOptions_, const bool crossSourceCollisions, std::shared_ptr<Placement> prevPlacement_)
     : collisionIndex(state_)
     , state(state_)
     , mapMode(mapMode_)
@@ -71,58 +94,71 @@ Placement::Placement(const TransformState& state_, MapMode mapMode_, style::Tran
     }
 }
 
-void Placement::placeLayer(const RenderLayer& layer, const mat4& projMatrix, bool showCollisionBoxes) {
-
-    std::set<uint32_t> seenCrossTileIDs;
-
-    for (const auto& item : layer.getPlacementData()) {
-        RenderTile& renderTile = item.tile;
-        assert(renderTile.tile.kind == Tile::Kind::Geometry);
-        auto& geometryTile = static_cast<GeometryTile&>(renderTile.tile);
-        Bucket& bucket = item.bucket;
-
-        const float pixelsToTileUnits = renderTile.id.pixelsToTileUnits(1, state.getZoom());
-
-        const float scale = std::pow(2, state.getZoom() - geometryTile.id.overscaledZ);
-        const float textPixelRatio = (util::tileSize * geometryTile.id.overscaleFactor()) / util::EXTENT;
-
-        mat4 posMatrix;
-        state.matrixFor(posMatrix, renderTile.id);
-        matrix::multiply(posMatrix, projMatrix, posMatrix);
-
-        mat4 textLabelPlaneMatrix = getLabelPlaneMatrix(posMatrix,
-                item.pitchWithMap,
-                item.rotateWithMap,
-                state,
-                pixelsToTileUnits);
-
-        mat4 iconLabelPlaneMatrix = getLabelPlaneMatrix(posMatrix,
-                item.pitchWithMap,
-                item.rotateWithMap,
-                state,
-                pixelsToTileUnits);
-
-        const auto& collisionGroup = collisionGroups.get(geometryTile.sourceID);
-        BucketPlacementParameters params{
-                posMatrix,
-                textLabelPlaneMatrix,
-                iconLabelPlaneMatrix,
-                scale,
-                textPixelRatio,
-                showCollisionBoxes,
-                renderTile.tile.holdForFade(),
-                collisionGroup};
-        auto bucketInstanceId = bucket.place(*this, params, seenCrossTileIDs);
-        assert(bucketInstanceId != 0u);
-        
-        // As long as this placement lives, we have to hold onto this bucket's
-        // matching FeatureIndex/data for querying purposes
-        retainedQueryData.emplace(std::piecewise_construct,
-                                  std::forward_as_tuple(bucketInstanceId),
-                                  std::forward_as_tuple(bucketInstanceId, geometryTile.getFeatureIndex(), geometryTile.id));
-        
-
+bool Placement::continuePlacement(const PlacementSnapshot& snapshot,
+                                  bool showCollisionBoxes,
+                                  optional<TimePoint> deadline) {
+    mat4 projMatrix;
+    state.getProjMatrix(projMatrix);
+
+    bool placedAny = false;
+    for (; currentLayer < snapshot.layers.size(); ++currentLayer) {
+        const auto& buckets = snapshot.layers[currentLayer];
+        for (; currentBucket < buckets.size(); ++currentBucket) {
+            if (placedAny && deadline && Clock::now() >= *deadline) {
+                return false;
+            }
+            placeBucket(buckets[currentBucket], projMatrix, showCollisionBoxes);
+            placedAny = true;
+        }
+        currentBucket = 0;
+        layerCrossTileIDs.clear();
     }
+    return true;
+}
+
+void Placement::placeBucket(const BucketPlacementData& data, const mat4& projMatrix, bool showCollisionBoxes) {
+    const float pixelsToTileUnits = data.tileID.pixelsToTileUnits(1, state.getZoom());
+
+    const float scale = std::pow(2, state.getZoom() - data.overscaledTileID.overscaledZ);
+    const float textPixelRatio = (util::tileSize * data.overscaledTileID.overscaleFactor()) / util::EXTENT;
+
+    mat4 posMatrix;
+    state.matrixFor(posMatrix, data.tileID);
+    matrix::multiply(posMatrix, projMatrix, posMatrix);
+
+    mat4 textLabelPlaneMatrix = getLabelPlaneMatrix(posMatrix,
+            data.pitchWithMap,
+            data.rotateWithMap,
+            state,
+            pixelsToTileUnits);
+
+    mat4 iconLabelPlaneMatrix = getLabelPlaneMatrix(posMatrix,
+            data.pitchWithMap,
+            data.rotateWithMap,
+            state,
+            pixelsToTileUnits);
+
+    const uint16_t collisionGroupId = collisionGroups.get(data.sourceID);
+    BucketPlacementParameters params{
+            posMatrix,
+            textLabelPlaneMatrix,
+            iconLabelPlaneMatrix,
+            scale,
+            textPixelRatio,
+            showCollisionBoxes,
+            data.holdingForFade,
+            collisionGroupId,
+            data.crossTileIDs,
+            data.bucketInstanceId,
+            data.justReloaded};
+    assert(data.bucketInstanceId != 0u);
+    data.bucket->place(*this, params, layerCrossTileIDs);
+
+    // As long as this placement lives, we have to hold onto this bucket's
+    // matching FeatureIndex/data for querying purposes
+    retainedQueryData.emplace(std::piecewise_construct,
+                              std::forward_as_tuple(data.bucketInstanceId),
+                              std::forward_as_tuple(data.bucketInstanceId, data.featureIndex, data.overscaledTileID));
 }
 
 namespace {
@@ -139,7 +175,7 @@ Point<float> calculateVariableLayoutOffset(style::SymbolAnchorType anchor, float
 } // namespace
 
 void Placement::placeLayerBucket(
-        SymbolBucket& bucket,
+        const SymbolBucket& bucket,
         const BucketPlacementParameters& params,
         std::set<uint32_t>& seenCrossTileIDs) {
 
@@ -177,31 +213,42 @@ void Placement::placeLayerBucket(
 
     const bool zOrderByViewportY = bucket.layout.get<style::SymbolZOrder>() == style::SymbolZOrderType::ViewportY;
 
-    auto placeSymbol = [&] (SymbolInstance& symbolInstance) {
-        if (seenCrossTileIDs.count(symbolInstance.crossTileID) != 0u) return;
+    assert(params.crossTileIDs.size() == bucket.symbolInstances.size());
+    ProjectedCollisionFeature projectedText;
+    ProjectedCollisionFeature projectedIcon;
+
+    // The symbol instance's own crossTileID may be rewritten by the render thread while this
+    // runs, so the one copied into the snapshot is used instead.
+    auto placeSymbol = [&] (std::size_t symbolIndex) {
+        const SymbolInstance& symbolInstance = bucket.symbolInstances[symbolIndex];
+        const uint32_t crossTileID = params.crossTileIDs[symbolIndex];
+        if (seenCrossTileIDs.count(crossTileID) != 0u) return;
 
         if (params.holdingForFade) {
             // Mark all symbols from this tile as "not placed", but don't add to seenCrossTileIDs, because we don't
             // know yet if we have a duplicate in a parent tile that _should_ be placed.
-            placements.emplace(symbolInstance.crossTileID, JointPlacement(false, false, false));
+            placements.emplace(crossTileID, JointPlacement(false, false, false));
             return;
         }
 
+        projectedText.clear();
+        projectedIcon.clear();
+
         bool placeText = false;
         bool placeIcon = false;
         bool offscreen = true;
         optional<size_t> horizontalTextIndex = symbolInstance.getDefaultHorizontalPlacedTextIndex();
         if (horizontalTextIndex) {
-            CollisionFeature& textCollisionFeature = symbolInstance.textCollisionFeature;
-            PlacedSymbol& placedSymbol = bucket.text.placedSymbols.at(*horizontalTextIndex);
+            const CollisionFeature& textCollisionFeature = symbolInstance.textCollisionFeature;
+            const PlacedSymbol& placedSymbol = bucket.text.placedSymbols.at(*horizontalTextIndex);
             const float fontSize = evaluateSizeForFeature(partiallyEvaluatedTextSize, placedSymbol);
             if (variableTextAnchors.empty()) {
-                auto placed = collisionIndex.placeFeature(textCollisionFeature, {},
+                auto placed = collisionIndex.placeFeature(textCollisionFeature, projectedText, {},
                         params.posMatrix, params.textLabelPlaneMatrix, params.pixelRatio,
                         placedSymbol, params.scale, fontSize,
                         bucket.layout.get<style::TextAllowOverlap>(),
                         pitchWithMap,
-                        params.showCollisionBoxes, avoidEdges, params.collisionGroup.second);
+                        params.showCollisionBoxes, avoidEdges, params.collisionGroupId);
                 placeText = placed.first;
                 offscreen &= placed.second;
             } else if (!textCollisionFeature.alongLine && !textCollisionFeature.boxes.empty()) {
@@ -213,7 +260,7 @@ void Placement::placeLayerBucket(
                 // If this symbol was in the last placement, shift the previously used
                 // anchor to the front of the anchor list.
                 if (prevPlacement) {
-                    auto prevOffset = prevPlacement->variableOffsets.find(symbolInstance.crossTileID);
+                    auto prevOffset = prevPlacement->variableOffsets.find(crossTileID);
                     if (prevOffset != prevPlacement->variableOffsets.end() &&
                         variableTextAnchors.front() != prevOffset->second.anchor) {
                         std::vector<style::TextVariableAnchorType> filtered;
@@ -235,22 +282,22 @@ void Placement::placeLayerBucket(
                         shift = util::rotate(shift, angle);
                     }
 
-                    auto placed = collisionIndex.placeFeature(textCollisionFeature, shift,
+                    auto placed = collisionIndex.placeFeature(textCollisionFeature, projectedText, shift,
                                                                 params.posMatrix, mat4(), params.pixelRatio,
                                                                 placedSymbol, params.scale, fontSize,
                                                                 bucket.layout.get<style::TextAllowOverlap>(),
                                                                 pitchWithMap,
-                                                                params.showCollisionBoxes, avoidEdges, params.collisionGroup.second);
+                                                                params.showCollisionBoxes, avoidEdges, params.collisionGroupId);
 
                     if (placed.first) {
-                        assert(symbolInstance.crossTileID != 0u);
+                        assert(crossTileID != 0u);
                         optional<style::TextVariableAnchorType> prevAnchor;
 
                         // If this label was placed in the previous placement, record the anchor position
                         // to allow us to animate the transition
                         if (prevPlacement) {
-                            auto prevOffset = prevPlacement->variableOffsets.find(symbolInstance.crossTileID);
-                            auto prevPlacements = prevPlacement->placements.find(symbolInstance.crossTileID);
+                            auto prevOffset = prevPlacement->variableOffsets.find(crossTileID);
+                            auto prevPlacements = prevPlacement->placements.find(crossTileID);
                             if (prevOffset != prevPlacement->variableOffsets.end() &&
                                 prevPlacements != prevPlacement->placements.end() &&
                                 prevPlacements->second.text) {
@@ -258,7 +305,7 @@ void Placement::placeLayerBucket(
                             }
                         }
 
-                        variableOffsets.insert(std::make_pair(symbolInstance.crossTileID, VariableOffset{
+                        variableOffsets.insert(std::make_pair(crossTileID, VariableOffset{
                             symbolInstance.radialTextOffset,
                             width,
                             height,
@@ -266,7 +313,9 @@ void Placement::placeLayerBucket(
                             textBoxScale,
                             prevAnchor
                         }));
-                        markUsedJustification(bucket, anchor, symbolInstance);
+                        // The justification of the chosen anchor is applied to the bucket by
+                        // updateBucketOpacities once this placement is committed, so that a
+                        // placement in progress doesn't change what the current one renders.
 
                         placeText = placed.first;
                         offscreen &= placed.second;
@@ -276,26 +325,25 @@ void Placement::placeLayerBucket(
 
                 // If we didn't get placed, we still need to copy our position from the last placement for
                 // fade animations
-                if (prevPlacement && variableOffsets.find(symbolInstance.crossTileID) == variableOffsets.end()) {
-                    auto prevOffset = prevPlacement->variableOffsets.find(symbolInstance.crossTileID);
+                if (prevPlacement && variableOffsets.find(crossTileID) == variableOffsets.end()) {
+                    auto prevOffset = prevPlacement->variableOffsets.find(crossTileID);
                     if (prevOffset != prevPlacement->variableOffsets.end()) {
-                        variableOffsets[symbolInstance.crossTileID] = prevOffset->second;
-                        markUsedJustification(bucket, prevOffset->second.anchor, symbolInstance);
+                        variableOffsets[crossTileID] = prevOffset->second;
                     }
                 }
             }
         }
 
         if (symbolInstance.placedIconIndex) {
-            PlacedSymbol& placedSymbol = bucket.icon.placedSymbols.at(*symbolInstance.placedIconIndex);
+            const PlacedSymbol& placedSymbol = bucket.icon.placedSymbols.at(*symbolInstance.placedIconIndex);
             const float fontSize = evaluateSizeForFeature(partiallyEvaluatedIconSize, placedSymbol);
 
-            auto placed = collisionIndex.placeFeature(symbolInstance.iconCollisionFeature, {},
+            auto placed = collisionIndex.placeFeature(symbolInstance.iconCollisionFeature, projectedIcon, {},
                     params.posMatrix, params.iconLabelPlaneMatrix, params.pixelRatio,
                     placedSymbol, params.scale, fontSize,
                     bucket.layout.get<style::IconAllowOverlap>(),
                     pitchWithMap,
-                    params.showCollisionBoxes, avoidEdges, params.collisionGroup.second);
+                    params.showCollisionBoxes, avoidEdges, params.collisionGroupId);
             placeIcon = placed.first;
             offscreen &= placed.second;
         }
@@ -313,38 +361,53 @@ void Placement::placeLayerBucket(
         }
 
         if (placeText) {
-            collisionIndex.insertFeature(symbolInstance.textCollisionFeature, bucket.layout.get<style::TextIgnorePlacement>(), bucket.bucketInstanceId, params.collisionGroup.first);
+            collisionIndex.insertFeature(symbolInstance.textCollisionFeature, projectedText, bucket.layout.get<style::TextIgnorePlacement>(), params.bucketInstanceId, params.collisionGroupId);
         }
 
         if (placeIcon) {
-            collisionIndex.insertFeature(symbolInstance.iconCollisionFeature, bucket.layout.get<style::IconIgnorePlacement>(), bucket.bucketInstanceId, params.collisionGroup.first);
+            collisionIndex.insertFeature(symbolInstance.iconCollisionFeature, projectedIcon, bucket.layout.get<style::IconIgnorePlacement>(), params.bucketInstanceId, params.collisionGroupId);
         }
 
-        assert(symbolInstance.crossTileID != 0);
+        assert(crossTileID != 0);
 
-        if (placements.find(symbolInstance.crossTileID) != placements.end()) {
+        if (placements.find(crossTileID) != placements.end()) {
             // If there's a previous placement with this ID, it comes from a tile that's fading out
             // Erase it so that the placement result from the non-fading tile supersedes it
-            placements.erase(symbolInstance.crossTileID);
+            placements.erase(crossTileID);
         }
         
-        placements.emplace(symbolInstance.crossTileID, JointPlacement(placeText || alwaysShowText, placeIcon || alwaysShowIcon, offscreen || bucket.justReloaded));
-        seenCrossTileIDs.insert(symbolInstance.crossTileID);
+        placements.emplace(crossTileID, JointPlacement(placeText || alwaysShowText, placeIcon || alwaysShowIcon, offscreen || params.justReloaded));
+        seenCrossTileIDs.insert(crossTileID);
+
+        if (params.showCollisionBoxes && (symbolInstance.textCollisionFeature.alongLine || symbolInstance.iconCollisionFeature.alongLine)) {
+            auto usedCircles = [] (const CollisionFeature& feature, const ProjectedCollisionFeature& projected) {
+                std::vector<bool> used;
+                if (feature.alongLine && projected.size() == feature.boxes.size()) {
+                    used.reserve(projected.size());
+                    for (const auto& circle : projected) {
+                        used.push_back(circle.used);
+                    }
+                }
+                return used;
+            };
+            usedCollisionCircles[crossTileID] = UsedCollisionCircles {
+                usedCircles(symbolInstance.textCollisionFeature, projectedText),
+                usedCircles(symbolInstance.iconCollisionFeature, projectedIcon)
+            };
+        }
     };
 
     if (zOrderByViewportY) {
-        const auto& sortedSymbols = bucket.getSortedSymbols(state.getBearing());
+        const auto sortedSymbols = bucket.getSortedSymbols(state.getBearing());
         // Place in the reverse order than draw i.e., starting from the foreground elements.
         for (auto it = sortedSymbols.rbegin(); it != sortedSymbols.rend(); ++it) {
             placeSymbol(*it);
         }
     } else {
-        for (SymbolInstance& symbol : bucket.symbolInstances) {
-            placeSymbol(symbol);
+        for (std::size_t i = 0; i < bucket.symbolInstances.size(); ++i) {
+            placeSymbol(i);
         }
     }
-
-    bucket.justReloaded = false;
 }
 
 void Placement::commit(TimePoint now) {
@@ -399,7 +462,7 @@ void Placement::commit(TimePoint now) {
 void Placement::updateLayerOpacities(const RenderLayer& layer) {
     std::set<uint32_t> seenCrossTileIDs;
     for (const auto& item : layer.getPlacementData()) {
-        item.bucket.get().updateOpacities(*this, seenCrossTileIDs);
+        item.bucket->updateOpacities(*this, seenCrossTileIDs);
     }
 }
 
@@ -536,12 +599,15 @@ void Placement::updateBucketOpacities(SymbolBucket& bucket, std::set<uint32_t>&
             }
         };
         
-        auto updateCollisionCircles = [&](const auto& feature, const bool placed) {
+        // Circles of symbols that weren't placed while collision boxes were shown count as unused.
+        auto circles = usedCollisionCircles.find(symbolInstance.crossTileID);
+        auto updateCollisionCircles = [&](const auto& feature, const std::vector<bool>* used, const bool placed) {
             if (!feature.alongLine) {
                 return;
             }
-            for (const CollisionBox& box : feature.boxes) {
-                auto dynamicVertex = CollisionBoxProgram::dynamicVertex(placed, !box.used, {});
+            for (std::size_t i = 0; i < feature.boxes.size(); ++i) {
+                const bool circleUsed = used && i < used->size() && (*used)[i];
+                auto dynamicVertex = CollisionBoxProgram::dynamicVertex(placed, !circleUsed, {});
                 bucket.collisionCircle.dynamicVertices.emplace_back(dynamicVertex);
                 bucket.collisionCircle.dynamicVertices.emplace_back(dynamicVertex);
                 bucket.collisionCircle.dynamicVertices.emplace_back(dynamicVertex);
@@ -554,8 +620,9 @@ void Placement::updateBucketOpacities(SymbolBucket& bucket, std::set<uint32_t>&
             updateCollisionBox(symbolInstance.iconCollisionFeature, opacityState.icon.placed);
         }
         if (bucket.hasCollisionCircleData()) {
-            updateCollisionCircles(symbolInstance.textCollisionFeature, opacityState.text.placed);
-            updateCollisionCircles(symbolInstance.iconCollisionFeature, opacityState.icon.placed);
+            const bool hasCircles = circles != usedCollisionCircles.end();
+            updateCollisionCircles(symbolInstance.textCollisionFeature, hasCircles ? &circles->second.text : nullptr, opacityState.text.placed);
+            updateCollisionCircles(symbolInstance.iconCollisionFeature, hasCircles ? &circles->second.icon : nullptr, opacityState.icon.placed);
         }
     }
 
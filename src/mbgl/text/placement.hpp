@@ -7,11 +7,16 @@
 #include <mbgl/layout/symbol_projection.hpp>
 #include <mbgl/style/transition_options.hpp>
 #include <unordered_set>
+#include <memory>
+#include <set>
+#include <vector>
 
 namespace mbgl {
 
+class Bucket;
 class SymbolBucket;
 class SymbolInstance;
+class RenderLayer;
 
 class OpacityState {
 public:
@@ -70,24 +75,54 @@ struct RetainedQueryData {
         , tileID(std::move(tileID_)) {}
 };
     
+// Symbols only collide with symbols of the same collision group.
 class CollisionGroups {
 public:
-    using Predicate = std::function<bool(const IndexedSubfeature&)>;
-    using CollisionGroup = std::pair<uint16_t, optional<Predicate>>;
-    
     CollisionGroups(const bool crossSourceCollisions_)
         : maxGroupID(0)
         , crossSourceCollisions(crossSourceCollisions_)
     {}
     
-    const CollisionGroup& get(const std::string& sourceID);
+    uint16_t get(const std::string& sourceID);
     
 private:
-    std::map<std::string, CollisionGroup> collisionGroups;
+    std::map<std::string, uint16_t> collisionGroups;
     uint16_t maxGroupID;
     bool crossSourceCollisions;
 };
 
+// A symbol bucket and the tile it is placed in, as they were when a placement started. The
+// bucket is shared rather than copied: its placement inputs don't change once it has been laid
+// out, and the state that the render thread keeps updating is copied here instead.
+class BucketPlacementData {
+public:
+    std::shared_ptr<Bucket> bucket;
+    std::shared_ptr<FeatureIndex> featureIndex;
+    UnwrappedTileID tileID;
+    OverscaledTileID overscaledTileID;
+    std::string sourceID;
+    bool pitchWithMap;
+    bool rotateWithMap;
+    bool holdingForFade;
+
+    // Filled in by Bucket::takePlacementSnapshot(). The cross-tile IDs are in the order of the
+    // bucket's symbol instances.
+    std::vector<uint32_t> crossTileIDs;
+    uint32_t bucketInstanceId = 0;
+    bool justReloaded = false;
+};
+
+// Everything a placement reads apart from the transform state, so that it can run on another
+// thread while the render thread keeps updating tiles and cross-tile indexes. Must be created
+// and destroyed on the render thread, as it keeps the buckets alive.
+class PlacementSnapshot {
+public:
+    // Takes the placement data of the given layers, in placement order.
+    explicit PlacementSnapshot(const std::vector<std::reference_wrapper<const RenderLayer>>&);
+
+    std::vector<std::vector<BucketPlacementData>> layers;
+};
+
 class BucketPlacementParameters {
 public:
     const mat4& posMatrix;
@@ -97,13 +132,26 @@ public:
     float pixelRatio;
     bool showCollisionBoxes;
     bool holdingForFade;
-    const CollisionGroups::CollisionGroup& collisionGroup;
+    uint16_t collisionGroupId;
+    const std::vector<uint32_t>& crossTileIDs;
+    uint32_t bucketInstanceId;
+    bool justReloaded;
 };
     
 class Placement {
 public:
-    Placement(const TransformState&, MapMode, style::TransitionOptions, const bool crossSourceCollisions, std::unique_ptr<Placement> prevPlacementOrNull = nullptr);
-    void placeLayer(const RenderLayer&, const mat4&, bool showCollisionBoxes);
+    // The previous placement is only read while placing, so it can keep being used for rendering
+    // while this placement runs on another thread, as long as it isn't committed meanwhile.
+    Placement(const TransformState&, MapMode, style::TransitionOptions, const bool crossSourceCollisions, std::shared_ptr<Placement> prevPlacementOrNull = nullptr);
+
+    // Places the buckets of the snapshot, picking up where the previous call stopped. Returns
+    // false if `deadline` passed before all of them were placed, in which case the placement
+    // must be continued with the same snapshot in a later call before it is committed. At least
+    // one bucket is placed per call. Doesn't touch anything outside of this placement and the
+    // snapshot, so it may be called on any thread.
+    bool continuePlacement(const PlacementSnapshot&,
+                           bool showCollisionBoxes,
+                           optional<TimePoint> deadline = {});
     void commit(TimePoint);
     void updateLayerOpacities(const RenderLayer&);
     float symbolFadeChange(TimePoint now) const;
@@ -121,8 +169,9 @@ public:
 
 private:
     friend SymbolBucket;
+    void placeBucket(const BucketPlacementData&, const mat4& projMatrix, bool showCollisionBoxes);
     void placeLayerBucket(
-            SymbolBucket&,
+            const SymbolBucket&,
             const BucketPlacementParameters&,
             std::set<uint32_t>& seenCrossTileIDs);
 
@@ -142,11 +191,25 @@ private:
     std::unordered_map<uint32_t, JointOpacityState> opacities;
     std::unordered_map<uint32_t, VariableOffset> variableOffsets;
 
+    // Which collision circles of along-line symbols were used, for the collision debug overlay.
+    // Only recorded while collision boxes are shown.
+    struct UsedCollisionCircles {
+        std::vector<bool> text;
+        std::vector<bool> icon;
+    };
+    std::unordered_map<uint32_t, UsedCollisionCircles> usedCollisionCircles;
+
     bool stale = false;
     
     std::unordered_map<uint32_t, RetainedQueryData> retainedQueryData;
     CollisionGroups collisionGroups;
-    std::unique_ptr<Placement> prevPlacement;
+    std::shared_ptr<Placement> prevPlacement;
+
+    // Progress of an incremental placement: the layer and bucket of the snapshot to be placed
+    // next, and the symbols of that layer that were placed so far.
+    std::size_t currentLayer = 0;
+    std::size_t currentBucket = 0;
+    std::set<uint32_t> layerCrossTileIDs;
 };
 
 } // namespace mbgl
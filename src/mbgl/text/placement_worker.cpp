@@ -0,0 +1,21 @@
+#include <mbgl/text/placement_worker.hpp>
+#include <mbgl/text/placement.hpp>
+
+#include <cassert>
+
+namespace mbgl {
+
+PlacementWorker::PlacementWorker(ActorRef<PlacementWorker>) {
+}
+
+void PlacementWorker::place(std::unique_ptr<Placement> placement,
+                            const PlacementSnapshot* snapshot,
+                            bool showCollisionBoxes,
+                            ActorRef<Callback> callback) {
+    assert(placement);
+    assert(snapshot);
+    placement->continuePlacement(*snapshot, showCollisionBoxes);
+    callback.invoke(&Callback::operator(), std::move(placement));
+}
+
+} // namespace mbgl
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <mbgl/actor/actor_ref.hpp>
+
+#include <functional>
+#include <memory>
+
+namespace mbgl {
+
+class Placement;
+class PlacementSnapshot;
+
+// Runs symbol placement off the render thread. The snapshot is shared with the render thread,
+// which must keep it alive, and only read, until the placement has been handed back.
+class PlacementWorker {
+public:
+    using Callback = std::function<void (std::unique_ptr<Placement>)>;
+
+    PlacementWorker(ActorRef<PlacementWorker>);
+
+    // Hands the finished placement back by sending it to `callback`.
+    void place(std::unique_ptr<Placement>,
+               const PlacementSnapshot*,
+               bool showCollisionBoxes,
+               ActorRef<Callback> callback);
+};
+
+} // namespace mbgl
@@ -19,6 +19,8 @@
 #include <mbgl/util/logging.hpp>
 #include <mbgl/actor/scheduler.hpp>
 
+#include <unordered_set>
+
 namespace mbgl {
 
 using namespace style;
@@ -46,8 +48,10 @@ GeometryTile::GeometryTile(const OverscaledTileID& id_,
       ImageRequestor(parameters.imageManager),
       sourceID(std::move(sourceID_)),
       mailbox(std::make_shared<Mailbox>(*Scheduler::GetCurrent())),
-      worker(Scheduler::GetBackground(),
+      threadPool(Scheduler::GetBackground()),
+      worker(threadPool,
              ActorRef<GeometryTile>(*this, mailbox),
+             *threadPool,
              id_,
              sourceID,
              obsolete,
@@ -70,6 +74,10 @@ void GeometryTile::cancel() {
     markObsolete();
 }
 
+void GeometryTile::setPriority(MailboxPriority priority) {
+    worker.setPriority(priority);
+}
+
 void GeometryTile::markObsolete() {
     obsolete = true;
 }
@@ -176,6 +184,34 @@ const optional<ImagePosition> GeometryTile::getPattern(const std::string& patter
     return {};
 }
 
+std::size_t GeometryTile::bytes() const {
+    std::size_t result = 0;
+
+    // Layers in the same group share a bucket.
+    std::unordered_set<const Bucket*> buckets;
+    for (const auto& entry : layerIdToLayerRenderData) {
+        const Bucket* bucket = entry.second.bucket.get();
+        if (bucket && buckets.insert(bucket).second) {
+            result += bucket->bytes();
+        }
+    }
+
+    if (latestFeatureIndex) {
+        result += latestFeatureIndex->bytes();
+    }
+    if (glyphAtlasImage) {
+        result += glyphAtlasImage->bytes();
+    }
+    if (glyphAtlasTexture) {
+        result += glyphAtlasTexture->size.area();
+    }
+    result += iconAtlas.image.bytes();
+    if (iconAtlasTexture) {
+        result += iconAtlasTexture->size.area() * 4;
+    }
+    return result;
+}
+
 void GeometryTile::upload(gfx::UploadPass& uploadPass) {
     auto uploadFn = [&] (Bucket& bucket) {
         if (bucket.needsUpload()) {
@@ -43,6 +43,7 @@ public:
     void getImages(ImageRequestPair);
 
     void upload(gfx::UploadPass&) override;
+    std::size_t bytes() const override;
     Bucket* getBucket(const style::Layer::Impl&) const override;
     const LayerRenderData* getLayerRenderData(const style::Layer::Impl&) const override;
     bool updateLayerProperties(const Immutable<style::LayerProperties>&) override;
@@ -62,6 +63,7 @@ public:
     float getQueryPadding(const std::vector<const RenderLayer*>&) override;
 
     void cancel() override;
+    void setPriority(MailboxPriority) override;
 
     class LayoutResult {
     public:
@@ -106,6 +108,7 @@ private:
     std::atomic<bool> obsolete { false };
 
     std::shared_ptr<Mailbox> mailbox;
+    std::shared_ptr<Scheduler> threadPool;
     Actor<GeometryTileWorker> worker;
 
     std::shared_ptr<FileSource> fileSource;
@@ -5,6 +5,7 @@
 #include <mbgl/util/optional.hpp>
 
 #include <cstdint>
+#include <functional>
 #include <string>
 #include <vector>
 #include <memory>
@@ -45,6 +46,12 @@ public:
     virtual PropertyMap getProperties() const { return PropertyMap(); }
     virtual FeatureIdentifier getID() const { return NullValue {}; }
     virtual GeometryCollection getGeometries() const = 0;
+
+    // Same as getGeometries(), but decodes into the given collection so that callers
+    // iterating over many features can reuse its storage.
+    virtual void decodeGeometries(GeometryCollection& geometries) const {
+        geometries = getGeometries();
+    }
 };
 
 class GeometryTileLayer {
@@ -56,6 +63,12 @@ public:
     // object may *not* outlive the layer object.
     virtual std::unique_ptr<GeometryTileFeature> getFeature(std::size_t) const = 0;
 
+    // Calls `fn` with the position and the feature object of every feature in the layer,
+    // in order, until `fn` returns false. The feature object is only valid during the
+    // call. Unlike getFeature(), implementations don't need to allocate per feature.
+    using FeatureVisitor = std::function<bool (std::size_t, const GeometryTileFeature&)>;
+    virtual void forEachFeature(const FeatureVisitor&) const;
+
     virtual std::string getName() const = 0;
 };
 
@@ -67,6 +80,9 @@ public:
     // Returns the layer with the given name. The returned layer object *may* outlive the data
     // object.
     virtual std::unique_ptr<GeometryTileLayer> getLayer(const std::string&) const = 0;
+
+    // Estimated memory held by the data, or 0 if unknown.
+    virtual std::size_t bytes() const { return 0; }
 };
 
 // classifies an array of rings into polygons with outer rings and holes
@@ -19,6 +19,7 @@
 #include <mbgl/util/string.hpp>
 #include <mbgl/util/exception.hpp>
 #include <mbgl/util/stopwatch.hpp>
+#include <mbgl/util/parallel_for.hpp>
 
 #include <unordered_set>
 #include <utility>
@@ -29,6 +30,7 @@ using namespace style;
 
 GeometryTileWorker::GeometryTileWorker(ActorRef<GeometryTileWorker> self_,
                                        ActorRef<GeometryTile> parent_,
+                                       Scheduler& scheduler_,
                                        OverscaledTileID id_,
                                        std::string sourceID_,
                                        const std::atomic<bool>& obsolete_,
@@ -37,6 +39,7 @@ GeometryTileWorker::GeometryTileWorker(ActorRef<GeometryTileWorker> self_,
                                        const bool showCollisionBoxes_)
     : self(std::move(self_)),
       parent(std::move(parent_)),
+      scheduler(scheduler_),
       id(std::move(id_)),
       sourceID(std::move(sourceID_)),
       obsolete(obsolete_),
@@ -312,6 +315,36 @@ void GeometryTileWorker::requestNewImages(const ImageDependencies& imageDependen
     }
 }
 
+namespace {
+
+std::atomic<bool> parallelParsing { true };
+std::atomic<std::size_t> parallelParsedGroupCount { 0 };
+
+struct LayerGroup {
+    const std::vector<Immutable<style::LayerProperties>>& layers;
+    std::unique_ptr<GeometryTileLayer> geometryLayer;
+
+    // Set by parsing a group that doesn't need a layout step.
+    std::shared_ptr<Bucket> bucket;
+    FeatureIndexBatch indexedFeatures;
+
+    // Set by parsing a group with a pattern layout.
+    std::unique_ptr<Layout> layout;
+    ImageDependencies imageDependencies;
+};
+
+} // namespace
+
+// static
+void GeometryTileWorker::setParallelParsing(bool enabled) {
+    parallelParsing = enabled;
+}
+
+// static
+std::size_t GeometryTileWorker::getParallelParsedGroupCount() {
+    return parallelParsedGroupCount;
+}
+
 void GeometryTileWorker::parse() {
     if (!data || !layers) {
         return;
@@ -335,64 +368,122 @@ void GeometryTileWorker::parse() {
         groupMap[layoutKey(*layer->baseImpl)].push_back(std::move(layer));
     }
 
-    for (auto& pair : groupMap) {
-        const auto& group = pair.second;
-        if (obsolete) {
-            return;
+    // Look up the source layers up front: GeometryTileData parses lazily and must
+    // not be used from several threads at once.
+    std::vector<LayerGroup> groups;
+    if (*data) {
+        groups.reserve(groupMap.size());
+        for (const auto& pair : groupMap) {
+            const style::Layer::Impl& leaderImpl = *(pair.second.at(0)->baseImpl);
+            if (auto geometryLayer = (*data)->getLayer(leaderImpl.sourceLayer)) {
+                groups.push_back({ pair.second, std::move(geometryLayer), nullptr, {}, nullptr, {} });
+            }
         }
+    }
 
-        if (!*data) {
-            continue; // Tile has no data.
+    // Apart from symbol layers, layer groups only read from their own source layer and
+    // write to their own bucket or layout, so they can be parsed independently. Symbol
+    // layouts intern names in the shared FeatureIndex when they're created.
+    std::vector<LayerGroup*> independentGroups;
+    for (auto& group : groups) {
+        if (group.layers.at(0)->baseImpl->getTypeInfo() != style::SymbolLayer::Impl::staticTypeInfo()) {
+            independentGroups.push_back(&group);
         }
+    }
 
-        const style::Layer::Impl& leaderImpl = *(group.at(0)->baseImpl);
+    auto parseIndependentGroup = [&](LayerGroup& group) {
+        const style::Layer::Impl& leaderImpl = *(group.layers.at(0)->baseImpl);
         BucketParameters parameters { id, mode, pixelRatio, leaderImpl.getTypeInfo() };
 
-        auto geometryLayer = (*data)->getLayer(leaderImpl.sourceLayer);
-        if (!geometryLayer) {
-            continue;
+        // Pattern layouts collect the images their features need, and build their bucket
+        // right away if there are none. They don't use the FeatureIndex until createBucket().
+        if (leaderImpl.getTypeInfo()->layout == LayerTypeInfo::Layout::Required) {
+            GlyphDependencies unusedGlyphDependencies;
+            group.layout = LayerManager::get()->createLayout({parameters, unusedGlyphDependencies, group.imageDependencies, *featureIndex}, std::move(group.geometryLayer), group.layers);
+            return;
         }
 
-        std::vector<std::string> layerIDs(group.size());
-        for (const auto& layer : group) {
+        const Filter& filter = leaderImpl.filter;
+        group.bucket = LayerManager::get()->createBucket(parameters, group.layers);
+
+        // Features are streamed and their geometry is decoded into the same collection
+        // every time, and only for features that pass the filter.
+        GeometryCollection geometries;
+        group.geometryLayer->forEachFeature([&](std::size_t i, const GeometryTileFeature& feature) {
+            if (obsolete) {
+                return false;
+            }
+
+            if (!filter(expression::EvaluationContext { static_cast<float>(this->id.overscaledZ), &feature }))
+                return true;
+
+            feature.decodeGeometries(geometries);
+            group.bucket->addFeature(feature, geometries, {}, PatternLayerMap ());
+            group.indexedFeatures.add(i, geometries);
+            return true;
+        });
+    };
+
+    if (parallelParsing && independentGroups.size() > 1) {
+        util::parallelFor(scheduler, self.getPriority(), independentGroups.size(), [&](std::size_t i) {
+            if (obsolete) {
+                return;
+            }
+            parseIndependentGroup(*independentGroups[i]);
+        });
+        parallelParsedGroupCount += independentGroups.size();
+    } else {
+        for (auto group : independentGroups) {
+            if (obsolete) {
+                return;
+            }
+            parseIndependentGroup(*group);
+        }
+    }
+
+    // Merge the results in group order, so that the FeatureIndex and render data are
+    // the same regardless of how the work above was distributed.
+    for (auto& group : groups) {
+        if (obsolete) {
+            return;
+        }
+
+        const style::Layer::Impl& leaderImpl = *(group.layers.at(0)->baseImpl);
+
+        std::vector<std::string> layerIDs(group.layers.size());
+        for (const auto& layer : group.layers) {
             layerIDs.push_back(layer->baseImpl->id);
         }
 
-        featureIndex->setBucketLayerIDs(leaderImpl.id, layerIDs);
+        const StringIdentity bucketLeaderId = featureIndex->intern(leaderImpl.id);
+        featureIndex->setBucketLayerIDs(bucketLeaderId, layerIDs);
 
         // Symbol layers and layers that support pattern properties have an extra step at layout time to figure out what images/glyphs
         // are needed to render the layer. They use the intermediate Layout data structure to accomplish this,
         // and either immediately create a bucket if no images/glyphs are used, or the Layout is stored until
         // the images/glyphs are available to add the features to the buckets.
         if (leaderImpl.getTypeInfo()->layout == LayerTypeInfo::Layout::Required) {
-            std::unique_ptr<Layout> layout = LayerManager::get()->createLayout({parameters, glyphDependencies, imageDependencies}, std::move(geometryLayer), group);
+            std::unique_ptr<Layout> layout = std::move(group.layout);
+            if (layout) {
+                imageDependencies.insert(group.imageDependencies.begin(), group.imageDependencies.end());
+            } else {
+                BucketParameters parameters { id, mode, pixelRatio, leaderImpl.getTypeInfo() };
+                layout = LayerManager::get()->createLayout({parameters, glyphDependencies, imageDependencies, *featureIndex}, std::move(group.geometryLayer), group.layers);
+            }
             if (layout->hasDependencies()) {
                 layouts.push_back(std::move(layout));
             } else {
                 layout->createBucket({}, featureIndex, renderData, firstLoad, showCollisionBoxes);
             }
         } else {
-            const Filter& filter = leaderImpl.filter;
-            const std::string& sourceLayerID = leaderImpl.sourceLayer;
-            std::shared_ptr<Bucket> bucket = LayerManager::get()->createBucket(parameters, group);
-
-            for (std::size_t i = 0; !obsolete && i < geometryLayer->featureCount(); i++) {
-                std::unique_ptr<GeometryTileFeature> feature = geometryLayer->getFeature(i);
-
-                if (!filter(expression::EvaluationContext { static_cast<float>(this->id.overscaledZ), feature.get() }))
-                    continue;
-
-                GeometryCollection geometries = feature->getGeometries();
-                bucket->addFeature(*feature, geometries, {}, PatternLayerMap ());
-                featureIndex->insert(geometries, i, sourceLayerID, leaderImpl.id);
-            }
+            group.indexedFeatures.insertInto(*featureIndex, featureIndex->intern(leaderImpl.sourceLayer), bucketLeaderId);
 
-            if (!bucket->hasData()) {
+            if (!group.bucket->hasData()) {
                 continue;
             }
 
-            for (const auto& layer : group) {
-                renderData.emplace(layer->baseImpl->id, LayerRenderData{bucket, layer});
+            for (const auto& layer : group.layers) {
+                renderData.emplace(layer->baseImpl->id, LayerRenderData{group.bucket, layer});
             }
         }
     }
@@ -451,6 +542,7 @@ void GeometryTileWorker::finalizeLayout() {
     }
 
     layouts.clear();
+    featureIndex->compact();
 
     firstLoad = false;
     
@@ -20,6 +20,7 @@ namespace mbgl {
 
 class GeometryTile;
 class GeometryTileData;
+class Scheduler;
 class Layout;
 
 namespace style {
@@ -30,6 +31,7 @@ class GeometryTileWorker {
 public:
     GeometryTileWorker(ActorRef<GeometryTileWorker> self,
                        ActorRef<GeometryTile> parent,
+                       Scheduler&,
                        OverscaledTileID,
                        std::string,
                        const std::atomic<bool>&,
@@ -45,6 +47,14 @@ public:
     void onGlyphsAvailable(GlyphMap glyphs);
     void onImagesAvailable(ImageMap icons, ImageMap patterns, ImageVersionMap versionMap, uint64_t imageCorrelationID);
 
+    // Layer groups other than symbol layers are parsed concurrently on the scheduler the
+    // worker runs on, at the priority of the worker's mailbox. Disabling this parses them
+    // one after another on the worker's own thread, e.g. to compare results in tests.
+    static void setParallelParsing(bool);
+
+    // The number of layer groups that were parsed concurrently so far, by all workers.
+    static std::size_t getParallelParsedGroupCount();
+
 private:
     void coalesced();
     void parse();
@@ -63,6 +73,7 @@ private:
 
     ActorRef<GeometryTileWorker> self;
     ActorRef<GeometryTile> parent;
+    Scheduler& scheduler;
 
     const OverscaledTileID id;
     const std::string sourceID;
@@ -69,6 +69,10 @@ void RasterDEMTile::onError(std::exception_ptr err, const uint64_t resultCorrela
     observer->onTileError(*this, err);
 }
 
+std::size_t RasterDEMTile::bytes() const {
+    return bucket ? bucket->bytes() : 0;
+}
+
 void RasterDEMTile::upload(gfx::UploadPass& uploadPass) {
     if (bucket) {
         bucket->upload(uploadPass);
@@ -122,4 +126,8 @@ void RasterDEMTile::setNecessity(TileNecessity necessity) {
     loader.setNecessity(necessity);
 }
 
+void RasterDEMTile::setPriority(MailboxPriority priority) {
+    worker.setPriority(priority);
+}
+
 } // namespace mbgl
@@ -17,7 +17,7 @@ void RasterDEMTileWorker::parse(std::shared_ptr<const std::string> data, uint64_
     }
 
     try {
-        auto bucket = std::make_unique<HillshadeBucket>(decodeImage(*data), encoding);
+        auto bucket = std::make_unique<HillshadeBucket>(DEMData::decode(*data, encoding));
         parent.invoke(&RasterDEMTile::onParsed, std::move(bucket), correlationID);
     } catch (...) {
         parent.invoke(&RasterDEMTile::onError, std::current_exception(), correlationID);
@@ -58,6 +58,10 @@ void RasterTile::onError(std::exception_ptr err, const uint64_t resultCorrelatio
     observer->onTileError(*this, err);
 }
 
+std::size_t RasterTile::bytes() const {
+    return bucket ? bucket->bytes() : 0;
+}
+
 void RasterTile::upload(gfx::UploadPass& uploadPass) {
     if (bucket) {
         bucket->upload(uploadPass);
@@ -78,4 +82,8 @@ void RasterTile::setNecessity(TileNecessity necessity) {
     loader.setNecessity(necessity);
 }
 
+void RasterTile::setPriority(MailboxPriority priority) {
+    worker.setPriority(priority);
+}
+
 } // namespace mbgl
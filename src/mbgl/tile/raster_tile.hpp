@@ -23,12 +23,14 @@ public:
     ~RasterTile() override;
 
     void setNecessity(TileNecessity) final;
+    void setPriority(MailboxPriority) final;
 
     void setError(std::exception_ptr);
     void setMetadata(optional<Timestamp> modified, optional<Timestamp> expires);
     void setData(std::shared_ptr<const std::string> data);
 
     void upload(gfx::UploadPass&) override;
+    std::size_t bytes() const override;
     Bucket* getBucket(const style::Layer::Impl&) const override;
 
     void setMask(TileMask&&) override;
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <mbgl/actor/mailbox.hpp>
 #include <mbgl/util/noncopyable.hpp>
 #include <mbgl/util/chrono.hpp>
 #include <mbgl/util/optional.hpp>
@@ -49,10 +50,17 @@ public:
 
     virtual void setNecessity(TileNecessity) {}
 
+    // Sets the priority of the background work for this tile, relative to other tiles.
+    virtual void setPriority(MailboxPriority) {}
+
     // Mark this tile as no longer needed and cancel any pending work.
     virtual void cancel();
 
     virtual void upload(gfx::UploadPass&) = 0;
+
+    // Estimated memory held by the tile's render data, used for budgeting the tile cache.
+    virtual std::size_t bytes() const { return 0; }
+
     virtual Bucket* getBucket(const style::Layer::Impl&) const = 0;
     virtual const LayerRenderData* getLayerRenderData(const style::Layer::Impl&) const {
         assert(false);
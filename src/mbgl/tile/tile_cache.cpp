@@ -5,14 +5,13 @@ namespace mbgl {
 
 void TileCache::setSize(size_t size_) {
     size = size_;
+    evict();
+    assert(tiles.size() <= size);
+}
 
-    while (orderedKeys.size() > size) {
-        auto key = orderedKeys.front();
-        orderedKeys.pop_front();
-        tiles.erase(key);
-    }
-
-    assert(orderedKeys.size() <= size);
+void TileCache::setMaxBytes(size_t maxBytes_) {
+    maxBytes = maxBytes_;
+    evict();
 }
 
 void TileCache::add(const OverscaledTileID& key, std::unique_ptr<Tile> tile) {
@@ -20,44 +19,66 @@ void TileCache::add(const OverscaledTileID& key, std::unique_ptr<Tile> tile) {
         return;
     }
 
-    // insert new or query existing tile
-    if (tiles.emplace(key, std::move(tile)).second) {
-        // remove existing tile key
-        orderedKeys.remove(key);
+    // insert new or keep existing tile
+    auto result = tiles.emplace(key, Entry());
+    Entry& entry = result.first->second;
+    if (!result.second) {
+        unlink(entry);
+        link(entry);
+        return;
     }
 
-    // (re-)insert tile key as newest
-    orderedKeys.push_back(key);
+    entry.tile = std::move(tile);
+    entry.bytes = entry.tile->bytes();
+    entry.key = &result.first->first;
+    bytes += entry.bytes;
+
+    // (re-)insert tile as newest
+    link(entry);
+
+    // purge oldest tiles if necessary
+    evict();
+
+    assert(tiles.size() <= size);
+}
 
-    // purge oldest key/tile if necessary
-    if (orderedKeys.size() > size) {
-        pop(orderedKeys.front());
+void TileCache::updateBytes(const Tile& tile) {
+    auto it = tiles.find(tile.id);
+    if (it == tiles.end() || it->second.tile.get() != &tile) {
+        return;
     }
 
-    assert(orderedKeys.size() <= size);
+    Entry& entry = it->second;
+    bytes -= entry.bytes;
+    entry.bytes = tile.bytes();
+    bytes += entry.bytes;
+}
+
+TileCache::Stats TileCache::getStats() const {
+    Stats result = stats;
+    result.bytes = bytes;
+    return result;
 }
 
 Tile* TileCache::get(const OverscaledTileID& key) {
     auto it = tiles.find(key);
     if (it != tiles.end()) {
-        return it->second.get();
+        return it->second.tile.get();
     } else {
         return nullptr;
     }
 }
 
 std::unique_ptr<Tile> TileCache::pop(const OverscaledTileID& key) {
-
-    std::unique_ptr<Tile> tile;
-
     auto it = tiles.find(key);
-    if (it != tiles.end()) {
-        tile = std::move(it->second);
-        tiles.erase(it);
-        orderedKeys.remove(key);
-        assert(tile->isRenderable());
+    if (it == tiles.end()) {
+        ++stats.misses;
+        return nullptr;
     }
 
+    ++stats.hits;
+    std::unique_ptr<Tile> tile = remove(it);
+    assert(tile->isRenderable());
     return tile;
 }
 
@@ -66,8 +87,52 @@ bool TileCache::has(const OverscaledTileID& key) {
 }
 
 void TileCache::clear() {
-    orderedKeys.clear();
     tiles.clear();
+    oldest = nullptr;
+    newest = nullptr;
+    bytes = 0;
+}
+
+void TileCache::link(Entry& entry) {
+    entry.older = newest;
+    entry.newer = nullptr;
+    if (newest) {
+        newest->newer = &entry;
+    } else {
+        oldest = &entry;
+    }
+    newest = &entry;
+}
+
+void TileCache::unlink(Entry& entry) {
+    if (entry.older) {
+        entry.older->newer = entry.newer;
+    } else {
+        oldest = entry.newer;
+    }
+    if (entry.newer) {
+        entry.newer->older = entry.older;
+    } else {
+        newest = entry.older;
+    }
+    entry.older = nullptr;
+    entry.newer = nullptr;
+}
+
+std::unique_ptr<Tile> TileCache::remove(std::unordered_map<OverscaledTileID, Entry>::iterator it) {
+    Entry& entry = it->second;
+    unlink(entry);
+    bytes -= entry.bytes;
+    std::unique_ptr<Tile> tile = std::move(entry.tile);
+    tiles.erase(it);
+    return tile;
+}
+
+void TileCache::evict() {
+    while (oldest && (tiles.size() > size || (maxBytes && bytes > maxBytes))) {
+        remove(tiles.find(*oldest->key));
+        ++stats.evictions;
+    }
 }
 
 } // namespace mbgl
@@ -2,31 +2,74 @@
 
 #include <mbgl/tile/tile_id.hpp>
 #include <mbgl/tile/tile.hpp>
+#include <mbgl/renderer/tile_cache_stats.hpp>
 
-
-#include <list>
+#include <cstdint>
 #include <memory>
-#include <map>
+#include <unordered_map>
 
 namespace mbgl {
 
+// A least-recently-used cache of tiles that aren't currently needed for rendering. Tiles are
+// evicted when there are more than `size` of them, or when their estimated memory exceeds the
+// optional byte budget. All operations take amortized constant time.
 class TileCache {
 public:
+    // Hits and misses are counted by pop().
+    using Stats = TileCacheStats;
+
     TileCache(size_t size_ = 0) : size(size_) {}
 
     void setSize(size_t);
     size_t getSize() const { return size; };
+
+    // Limits the estimated memory held by the cached tiles, as reported by Tile::bytes().
+    // 0 means no limit.
+    void setMaxBytes(size_t);
+    size_t getMaxBytes() const { return maxBytes; }
+    size_t getBytes() const { return bytes; }
+
+    // Tiles are measured when they're added. Cached tiles can still receive new buckets
+    // from their workers, so this measures the given tile again if it is cached. It doesn't
+    // evict, since the tile may be calling this from its own observer: tiles over the
+    // budget are evicted by the next add(), setSize() or setMaxBytes().
+    void updateBytes(const Tile&);
+
+    // Adding a tile with the ID of a cached one keeps the cached tile, and only makes it the
+    // most recently added one.
     void add(const OverscaledTileID& key, std::unique_ptr<Tile> data);
     std::unique_ptr<Tile> pop(const OverscaledTileID& key);
     Tile* get(const OverscaledTileID& key);
     bool has(const OverscaledTileID& key);
     void clear();
 
+    Stats getStats() const;
+
 private:
-    std::map<OverscaledTileID, std::unique_ptr<Tile>> tiles;
-    std::list<OverscaledTileID> orderedKeys;
+    struct Entry {
+        std::unique_ptr<Tile> tile;
+        size_t bytes = 0;
+
+        // Intrusive recency list, from the least to the most recently added entry. Entries
+        // are stable in memory because unordered_map never moves its elements.
+        const OverscaledTileID* key = nullptr;
+        Entry* older = nullptr;
+        Entry* newer = nullptr;
+    };
+
+    void link(Entry&);
+    void unlink(Entry&);
+    std::unique_ptr<Tile> remove(std::unordered_map<OverscaledTileID, Entry>::iterator);
+    void evict();
+
+    std::unordered_map<OverscaledTileID, Entry> tiles;
+    Entry* oldest = nullptr;
+    Entry* newest = nullptr;
 
     size_t size;
+    size_t maxBytes = 0;
+    size_t bytes = 0;
+    Stats stats;
 };
 
 } // namespace mbgl
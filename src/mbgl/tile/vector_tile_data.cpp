@@ -1,64 +1,319 @@
 #include <mbgl/tile/vector_tile_data.hpp>
 #include <mbgl/util/constants.hpp>
 
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
 namespace mbgl {
 
-VectorTileFeature::VectorTileFeature(const mapbox::vector_tile::layer& layer,
+VectorTileFeature::VectorTileFeature(const VectorTileLayer& layer_,
                                      const protozero::data_view& view)
-    : feature(view, layer) {
+    : layer(layer_) {
+    protozero::pbf_reader reader(view);
+    while (reader.next()) {
+        switch (reader.tag()) {
+        case 1: // id
+            id = reader.get_uint64();
+            break;
+        case 2: // tags
+            packedTags = reader.get_packed_uint32();
+            break;
+        case 3: // type
+            switch (reader.get_enum()) {
+            case 1:
+                type = FeatureType::Point;
+                break;
+            case 2:
+                type = FeatureType::LineString;
+                break;
+            case 3:
+                type = FeatureType::Polygon;
+                break;
+            default:
+                type = FeatureType::Unknown;
+                break;
+            }
+            break;
+        case 4: // geometry
+            geometry = reader.get_packed_uint32();
+            break;
+        default:
+            reader.skip();
+            break;
+        }
+    }
 }
 
 FeatureType VectorTileFeature::getType() const {
-    switch (feature.getType()) {
-    case mapbox::vector_tile::GeomType::POINT:
-        return FeatureType::Point;
-    case mapbox::vector_tile::GeomType::LINESTRING:
-        return FeatureType::LineString;
-    case mapbox::vector_tile::GeomType::POLYGON:
-        return FeatureType::Polygon;
-    default:
-        return FeatureType::Unknown;
+    return type;
+}
+
+static Value parseValue(const protozero::data_view& view) {
+    protozero::pbf_reader reader(view);
+    Value value;
+    while (reader.next()) {
+        switch (reader.tag()) {
+        case 1: // string_value
+            value = reader.get_string();
+            break;
+        case 2: // float_value
+            value = static_cast<double>(reader.get_float());
+            break;
+        case 3: // double_value
+            value = reader.get_double();
+            break;
+        case 4: // int_value
+            value = reader.get_int64();
+            break;
+        case 5: // uint_value
+            value = reader.get_uint64();
+            break;
+        case 6: // sint_value
+            value = reader.get_sint64();
+            break;
+        case 7: // bool_value
+            value = reader.get_bool();
+            break;
+        default:
+            reader.skip();
+            break;
+        }
+    }
+    return value;
+}
+
+template <typename Fn>
+void VectorTileFeature::forEachTag(Fn&& fn) const {
+    for (auto it = packedTags.begin(); it != packedTags.end();) {
+        const uint32_t key = *it++;
+        if (it == packedTags.end()) {
+            throw std::runtime_error("uneven number of feature tag ids");
+        }
+        const uint32_t value = *it++;
+        if (!fn(key, value)) {
+            return;
+        }
     }
 }
 
 optional<Value> VectorTileFeature::getValue(const std::string& key) const {
-    const optional<Value> value(feature.getValue(key));
-    return value->is<NullValue>() ? nullopt : std::move(value);
+    const optional<uint32_t> keyIndex = layer.getKeyIndex(key);
+    if (!keyIndex) {
+        return nullopt;
+    }
+
+    optional<Value> result;
+    forEachTag([&](uint32_t tagKey, uint32_t tagValue) {
+        if (tagKey != *keyIndex) {
+            return true;
+        }
+        if (tagValue >= layer.values.size()) {
+            throw std::runtime_error("feature referenced out of range value");
+        }
+        Value value = parseValue(layer.values[tagValue]);
+        if (!value.is<NullValue>()) {
+            result = std::move(value);
+        }
+        return false;
+    });
+    return result;
 }
 
 std::unordered_map<std::string, Value> VectorTileFeature::getProperties() const {
-    return feature.getProperties();
+    std::unordered_map<std::string, Value> properties;
+    forEachTag([&](uint32_t tagKey, uint32_t tagValue) {
+        if (tagKey >= layer.keys.size()) {
+            throw std::runtime_error("feature referenced out of range key");
+        }
+        if (tagValue >= layer.values.size()) {
+            throw std::runtime_error("feature referenced out of range value");
+        }
+        const protozero::data_view& keyView = layer.keys[tagKey];
+        properties.emplace(std::string(keyView.data(), keyView.size()), parseValue(layer.values[tagValue]));
+        return true;
+    });
+    return properties;
 }
 
 FeatureIdentifier VectorTileFeature::getID() const {
-    return feature.getID();
+    if (id) {
+        return { *id };
+    }
+    return { NullValue() };
 }
 
 GeometryCollection VectorTileFeature::getGeometries() const {
-    const float scale = float(util::EXTENT) / feature.getExtent();
-    auto lines = feature.getGeometries<GeometryCollection>(scale);
-    if (feature.getVersion() >= 2 || feature.getType() != mapbox::vector_tile::GeomType::POLYGON) {
-        return lines;
-    } else {
-        return fixupPolygons(lines);
+    GeometryCollection geometries;
+    decodeGeometries(geometries);
+    return geometries;
+}
+
+void VectorTileFeature::decodeGeometries(GeometryCollection& geometries) const {
+    // This follows the decoder in mapbox::vector_tile::feature::getGeometries(), but
+    // clears and refills the rings already present in `geometries` instead of
+    // allocating new ones.
+    enum Command : uint32_t { MoveTo = 1, LineTo = 2, ClosePath = 7 };
+
+    const float scale = float(util::EXTENT) / layer.extent;
+    constexpr float minCoordinate = std::numeric_limits<GeometryCoordinate::coordinate_type>::min();
+    constexpr float maxCoordinate = std::numeric_limits<GeometryCoordinate::coordinate_type>::max();
+
+    std::size_t ringCount = 0;
+    auto addRing = [&] {
+        if (ringCount < geometries.size()) {
+            geometries[ringCount].clear();
+        } else {
+            geometries.emplace_back();
+        }
+        ++ringCount;
+    };
+    addRing();
+
+    uint32_t command = MoveTo;
+    uint32_t length = 0;
+    int64_t x = 0;
+    int64_t y = 0;
+
+    for (auto it = geometry.begin(); it != geometry.end();) {
+        if (length == 0) {
+            const uint32_t commandLength = *it++;
+            command = commandLength & 0x7;
+            length = commandLength >> 3;
+        }
+
+        --length;
+
+        if (command == MoveTo || command == LineTo) {
+            if (command == MoveTo && !geometries[ringCount - 1].empty()) {
+                addRing();
+            }
+
+            if (it == geometry.end()) {
+                throw std::runtime_error("incomplete geometry command");
+            }
+            x += protozero::decode_zigzag32(*it++);
+            if (it == geometry.end()) {
+                throw std::runtime_error("incomplete geometry command");
+            }
+            y += protozero::decode_zigzag32(*it++);
+
+            const float px = std::round(static_cast<float>(x) * scale);
+            const float py = std::round(static_cast<float>(y) * scale);
+
+            // Points outside of the coordinate range are skipped.
+            if (px >= minCoordinate && px <= maxCoordinate && py >= minCoordinate && py <= maxCoordinate) {
+                geometries[ringCount - 1].emplace_back(static_cast<int16_t>(px), static_cast<int16_t>(py));
+            }
+        } else if (command == ClosePath) {
+            auto& ring = geometries[ringCount - 1];
+            if (!ring.empty()) {
+                ring.push_back(ring[0]);
+            }
+            length = 0;
+        } else {
+            throw std::runtime_error("unknown command");
+        }
+    }
+
+    geometries.erase(geometries.begin() + ringCount, geometries.end());
+
+    if (layer.version < 2 && type == FeatureType::Polygon) {
+        geometries = fixupPolygons(geometries);
     }
 }
 
 VectorTileLayer::VectorTileLayer(std::shared_ptr<const std::string> data_,
                                  const protozero::data_view& view)
-    : data(std::move(data_)), layer(view) {
+    : data(std::move(data_)) {
+    bool hasName = false;
+    bool hasExtent = false;
+    bool hasVersion = false;
+    protozero::pbf_reader reader(view);
+    while (reader.next()) {
+        switch (reader.tag()) {
+        case 1: // name
+            name = reader.get_string();
+            hasName = true;
+            break;
+        case 2: // features
+            features.push_back(reader.get_view());
+            break;
+        case 3: // keys
+            keys.push_back(reader.get_view());
+            break;
+        case 4: // values
+            values.push_back(reader.get_view());
+            break;
+        case 5: // extent
+            extent = reader.get_uint32();
+            hasExtent = true;
+            break;
+        case 15: // version
+            version = reader.get_uint32();
+            hasVersion = true;
+            break;
+        default:
+            reader.skip();
+            break;
+        }
+    }
+    // Same validation as mapbox::vector_tile::layer.
+    if (!hasVersion || !hasName || !hasExtent) {
+        std::string message = "missing required field:";
+        if (!hasVersion) {
+            message += " version";
+        }
+        if (!hasExtent) {
+            message += " extent";
+        }
+        if (!hasName) {
+            message += " name";
+        }
+        throw std::runtime_error(message);
+    }
+    if (extent == 0) {
+        throw std::runtime_error("layer has an extent of 0");
+    }
 }
 
 std::size_t VectorTileLayer::featureCount() const {
-    return layer.featureCount();
+    return features.size();
 }
 
 std::unique_ptr<GeometryTileFeature> VectorTileLayer::getFeature(std::size_t i) const {
-    return std::make_unique<VectorTileFeature>(layer, layer.getFeature(i));
+    return std::make_unique<VectorTileFeature>(*this, features.at(i));
+}
+
+void VectorTileLayer::forEachFeature(const FeatureVisitor& fn) const {
+    for (std::size_t i = 0; i < features.size(); ++i) {
+        const VectorTileFeature feature(*this, features[i]);
+        if (!fn(i, feature)) {
+            return;
+        }
+    }
 }
 
 std::string VectorTileLayer::getName() const {
-    return layer.getName();
+    return name;
+}
+
+optional<uint32_t> VectorTileLayer::getKeyIndex(const std::string& key) const {
+    auto it = std::find_if(resolvedKeys.begin(), resolvedKeys.end(), [&](const auto& entry) {
+        return entry.first == key;
+    });
+    if (it == resolvedKeys.end()) {
+        const auto keyIt = std::find_if(keys.begin(), keys.end(), [&](const protozero::data_view& k) {
+            return k.size() == key.size() && std::equal(key.begin(), key.end(), k.data());
+        });
+        optional<uint32_t> index;
+        if (keyIt != keys.end()) {
+            index = static_cast<uint32_t>(keyIt - keys.begin());
+        }
+        it = resolvedKeys.emplace(resolvedKeys.end(), key, index);
+    }
+    return it->second;
 }
 
 VectorTileData::VectorTileData(std::shared_ptr<const std::string> data_) : data(std::move(data_)) {
@@ -83,6 +338,10 @@ std::unique_ptr<GeometryTileLayer> VectorTileData::getLayer(const std::string& n
     return nullptr;
 }
 
+std::size_t VectorTileData::bytes() const {
+    return data->size();
+}
+
 std::vector<std::string> VectorTileData::layerNames() const {
     return mapbox::vector_tile::buffer(*data).layerNames();
 }
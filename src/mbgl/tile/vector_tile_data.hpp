@@ -6,34 +6,65 @@
 #include <unordered_map>
 #include <functional>
 #include <utility>
+#include <vector>
 
 namespace mbgl {
 
+class VectorTileLayer;
+
 class VectorTileFeature : public GeometryTileFeature {
 public:
-    VectorTileFeature(const mapbox::vector_tile::layer&, const protozero::data_view&);
+    VectorTileFeature(const VectorTileLayer&, const protozero::data_view&);
 
     FeatureType getType() const override;
     optional<Value> getValue(const std::string& key) const override;
     std::unordered_map<std::string, Value> getProperties() const override;
     FeatureIdentifier getID() const override;
     GeometryCollection getGeometries() const override;
+    void decodeGeometries(GeometryCollection&) const override;
 
 private:
-    mapbox::vector_tile::feature feature;
+    using PackedUInt32 = protozero::iterator_range<protozero::pbf_reader::const_uint32_iterator>;
+
+    // Calls `fn` with the key and value index of every tag, in order, until it returns
+    // false. The tags are read straight from the packed field.
+    template <typename Fn>
+    void forEachTag(Fn&&) const;
+
+    const VectorTileLayer& layer;
+    optional<uint64_t> id;
+    FeatureType type = FeatureType::Unknown;
+    PackedUInt32 packedTags;
+    PackedUInt32 geometry;
 };
 
+// Parses the layer once, and resolves every property key that is looked up against its key
+// table only the first time, so that filters and data-driven properties that are evaluated for
+// every feature look up tags by index. Not thread-safe; features must be read from one thread.
 class VectorTileLayer : public GeometryTileLayer {
 public:
     VectorTileLayer(std::shared_ptr<const std::string> data, const protozero::data_view&);
 
     std::size_t featureCount() const override;
     std::unique_ptr<GeometryTileFeature> getFeature(std::size_t i) const override;
+    void forEachFeature(const FeatureVisitor&) const override;
     std::string getName() const override;
 
 private:
+    friend class VectorTileFeature;
+
+    optional<uint32_t> getKeyIndex(const std::string&) const;
+
     std::shared_ptr<const std::string> data;
-    mapbox::vector_tile::layer layer;
+    std::string name;
+    uint32_t version = 1;
+    uint32_t extent = 4096;
+    std::vector<protozero::data_view> features;
+    // The layer's key and value tables, which feature tags refer to by position.
+    std::vector<protozero::data_view> keys;
+    std::vector<protozero::data_view> values;
+    // Styles reference few keys per layer, so a linear scan beats hashing.
+    mutable std::vector<std::pair<std::string, optional<uint32_t>>> resolvedKeys;
 };
 
 class VectorTileData : public GeometryTileData {
@@ -42,6 +73,7 @@ public:
 
     std::unique_ptr<GeometryTileData> clone() const override;
     std::unique_ptr<GeometryTileLayer> getLayer(const std::string& name) const override;
+    std::size_t bytes() const override;
 
     std::vector<std::string> layerNames() const;
 
@@ -4,10 +4,11 @@
 #include <mapbox/geometry/box.hpp>
 #include <mbgl/util/optional.hpp>
 
+#include <algorithm>
 #include <cstdint>
 #include <cstddef>
+#include <limits>
 #include <vector>
-#include <functional>
 
 namespace mbgl {
 
@@ -51,8 +52,107 @@ constexpr bool operator!=(circle<T> const& lhs, circle<T> const& rhs)
  at least one cell. As long as the geometries are relatively
  uniformly distributed across the plane, this greatly reduces
  the number of comparisons necessary.
+ The geometries are kept apart from the items, so that the comparisons
+ only touch compact arrays of boxes and circles.
 */
 
+namespace detail {
+
+// The element ids of each cell of a grid, in insertion order. The ids are stored in one flat
+// array, cell after cell. Ids inserted after that array was last built are kept in per-cell
+// lists, threaded through a second flat array, until there are as many of them as in the first
+// one, at which point both are merged. This keeps inserting cheap while queries, which may be
+// interleaved with the inserts, mostly scan contiguous memory.
+class GridCells {
+public:
+    explicit GridCells(std::size_t cellCount)
+        : offsets(cellCount + 1, 0),
+          pendingHeads(cellCount, none),
+          pendingTails(cellCount, none) {
+    }
+
+    void insert(std::size_t cell, uint32_t id) {
+        const auto index = static_cast<uint32_t>(pending.size());
+        pending.push_back({ id, none });
+        if (pendingTails[cell] == none) {
+            pendingHeads[cell] = index;
+        } else {
+            pending[pendingTails[cell]].next = index;
+        }
+        pendingTails[cell] = index;
+
+        // Merging costs about as much as the ids merged so far, so it stays cheap per insert.
+        if (pending.size() > std::max<std::size_t>(ids.size(), 64)) {
+            compact();
+        }
+    }
+
+    // Calls `fn` with the ids of the given cell, in insertion order, until it returns true.
+    // Returns whether it did.
+    template <class Fn>
+    bool forEach(std::size_t cell, Fn&& fn) const {
+        for (uint32_t i = offsets[cell], end = offsets[cell + 1]; i < end; ++i) {
+            if (fn(ids[i])) {
+                return true;
+            }
+        }
+        for (uint32_t i = pendingHeads[cell]; i != none; i = pending[i].next) {
+            if (fn(pending[i].id)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Merges the pending ids into the flat array.
+    void compact() {
+        if (pending.empty()) {
+            return;
+        }
+
+        const std::size_t cellCount = pendingHeads.size();
+        std::vector<uint32_t> mergedOffsets(cellCount + 1);
+        std::vector<uint32_t> merged;
+        merged.reserve(ids.size() + pending.size());
+        for (std::size_t cell = 0; cell < cellCount; ++cell) {
+            mergedOffsets[cell] = static_cast<uint32_t>(merged.size());
+            merged.insert(merged.end(), ids.begin() + offsets[cell], ids.begin() + offsets[cell + 1]);
+            for (uint32_t i = pendingHeads[cell]; i != none; i = pending[i].next) {
+                merged.push_back(pending[i].id);
+            }
+        }
+        mergedOffsets[cellCount] = static_cast<uint32_t>(merged.size());
+
+        offsets = std::move(mergedOffsets);
+        ids = std::move(merged);
+        pending.clear();
+        std::fill(pendingHeads.begin(), pendingHeads.end(), none);
+        std::fill(pendingTails.begin(), pendingTails.end(), none);
+    }
+
+    std::size_t bytes() const {
+        return (offsets.capacity() + ids.capacity() + pendingHeads.capacity() + pendingTails.capacity()) * sizeof(uint32_t) +
+               pending.capacity() * sizeof(PendingID);
+    }
+
+private:
+    enum : uint32_t { none = std::numeric_limits<uint32_t>::max() };
+
+    struct PendingID {
+        uint32_t id;
+        uint32_t next;
+    };
+
+    std::vector<uint32_t> offsets;
+    std::vector<uint32_t> ids;
+
+    std::vector<uint32_t> pendingHeads;
+    std::vector<uint32_t> pendingTails;
+    std::vector<PendingID> pending;
+};
+
+} // namespace detail
+
 template <class T>
 class GridIndex {
 public:
@@ -68,25 +168,58 @@ public:
     std::vector<T> query(const BBox&) const;
     std::vector<std::pair<T,BBox>> queryWithBoxes(const BBox&) const;
     
-    bool hitTest(const BBox&, optional<std::function<bool(const T&)>> predicate = nullopt) const;
-    bool hitTest(const BCircle&, optional<std::function<bool(const T&)>> predicate = nullopt) const;
+    bool hitTest(const BBox&) const;
+    bool hitTest(const BCircle&) const;
+
+    // Only items for which `predicate` returns true count as hits.
+    template <class Predicate>
+    bool hitTest(const BBox&, Predicate&& predicate) const;
+    template <class Predicate>
+    bool hitTest(const BCircle&, Predicate&& predicate) const;
     
     bool empty() const;
 
+    // Speeds up the following queries when no more items will be inserted for a while.
+    void compact();
+
+    // Estimated memory held by the index, not counting memory owned by the elements themselves.
+    std::size_t bytes() const;
+
 private:
     bool noIntersection(const BBox& queryBBox) const;
     bool completeIntersection(const BBox& queryBBox) const;
-    BBox convertToBox(const BCircle& circle) const;
+    static BBox convertToBox(const BCircle& circle) {
+        return BBox{{circle.center.x - circle.radius, circle.center.y - circle.radius},
+                    {circle.center.x + circle.radius, circle.center.y + circle.radius}};
+    }
 
-    void query(const BBox&, std::function<bool (const T&, const BBox&)>) const;
-    void query(const BCircle&, std::function<bool (const T&, const BBox&)>) const;
+    // Calls `resultFn` with the items that intersect the query geometry and their bounding
+    // boxes, each item once, until it returns true.
+    template <class Fn>
+    void query(const BBox&, Fn&& resultFn) const;
+    template <class Fn>
+    void query(const BCircle&, Fn&& resultFn) const;
+    template <class Fn>
+    void queryAll(Fn&& resultFn) const;
 
     int16_t convertToXCellCoord(const float x) const;
     int16_t convertToYCellCoord(const float y) const;
+
+    // An item is reported in the first cell of the query in which it was found, which is the
+    // cell where the cell ranges of the item and of the query start to overlap.
+    bool isFirstCell(const BBox& bbox, int16_t x, int16_t y, int16_t queryX1, int16_t queryY1) const {
+        return x == std::max(queryX1, convertToXCellCoord(bbox.min.x)) &&
+               y == std::max(queryY1, convertToYCellCoord(bbox.min.y));
+    }
     
-    bool boxesCollide(const BBox&, const BBox&) const;
-    bool circlesCollide(const BCircle&, const BCircle&) const;
-    bool circleAndBoxCollide(const BCircle&, const BBox&) const;
+    static bool boxesCollide(const BBox& first, const BBox& second) {
+        return first.min.x <= second.max.x &&
+               first.min.y <= second.max.y &&
+               first.max.x >= second.min.x &&
+               first.max.y >= second.min.y;
+    }
+    static bool circlesCollide(const BCircle&, const BCircle&);
+    static bool circleAndBoxCollide(const BCircle&, const BBox&);
 
     const float width;
     const float height;
@@ -96,12 +229,130 @@ private:
     const double xScale;
     const double yScale;
 
-    std::vector<std::pair<T, BBox>> boxElements;
-    std::vector<std::pair<T, BCircle>> circleElements;
+    std::vector<T> boxItems;
+    std::vector<BBox> boxes;
+    std::vector<T> circleItems;
+    std::vector<BCircle> circles;
     
-    std::vector<std::vector<size_t>> boxCells;
-    std::vector<std::vector<size_t>> circleCells;
+    detail::GridCells boxCells;
+    detail::GridCells circleCells;
 
 };
 
+template <class T>
+template <class Predicate>
+bool GridIndex<T>::hitTest(const BBox& queryBBox, Predicate&& predicate) const {
+    bool hit = false;
+    query(queryBBox, [&](const T& t, const BBox&) -> bool {
+        hit = predicate(t);
+        return hit;
+    });
+    return hit;
+}
+
+template <class T>
+template <class Predicate>
+bool GridIndex<T>::hitTest(const BCircle& queryBCircle, Predicate&& predicate) const {
+    bool hit = false;
+    query(queryBCircle, [&](const T& t, const BBox&) -> bool {
+        hit = predicate(t);
+        return hit;
+    });
+    return hit;
+}
+
+template <class T>
+template <class Fn>
+void GridIndex<T>::queryAll(Fn&& resultFn) const {
+    for (std::size_t i = 0; i < boxes.size(); ++i) {
+        if (resultFn(boxItems[i], boxes[i])) {
+            return;
+        }
+    }
+    for (std::size_t i = 0; i < circles.size(); ++i) {
+        if (resultFn(circleItems[i], convertToBox(circles[i]))) {
+            return;
+        }
+    }
+}
+
+template <class T>
+template <class Fn>
+void GridIndex<T>::query(const BBox& queryBBox, Fn&& resultFn) const {
+    if (noIntersection(queryBBox)) {
+        return;
+    } else if (completeIntersection(queryBBox)) {
+        queryAll(resultFn);
+        return;
+    }
+
+    auto cx1 = convertToXCellCoord(queryBBox.min.x);
+    auto cy1 = convertToYCellCoord(queryBBox.min.y);
+    auto cx2 = convertToXCellCoord(queryBBox.max.x);
+    auto cy2 = convertToYCellCoord(queryBBox.max.y);
+
+    for (int16_t x = cx1; x <= cx2; ++x) {
+        for (int16_t y = cy1; y <= cy2; ++y) {
+            const std::size_t cellIndex = std::size_t(xCellCount) * y + x;
+            // Look up other boxes
+            const bool done = boxCells.forEach(cellIndex, [&](uint32_t uid) {
+                const BBox& bbox = boxes[uid];
+                return isFirstCell(bbox, x, y, cx1, cy1) &&
+                       boxesCollide(queryBBox, bbox) &&
+                       resultFn(boxItems[uid], bbox);
+            }) || circleCells.forEach(cellIndex, [&](uint32_t uid) {
+                // Look up circles
+                const BCircle& bcircle = circles[uid];
+                const BBox bbox = convertToBox(bcircle);
+                return isFirstCell(bbox, x, y, cx1, cy1) &&
+                       circleAndBoxCollide(bcircle, queryBBox) &&
+                       resultFn(circleItems[uid], bbox);
+            });
+            if (done) {
+                return;
+            }
+        }
+    }
+}
+
+template <class T>
+template <class Fn>
+void GridIndex<T>::query(const BCircle& queryBCircle, Fn&& resultFn) const {
+    const BBox queryBBox = convertToBox(queryBCircle);
+    if (noIntersection(queryBBox)) {
+        return;
+    } else if (completeIntersection(queryBBox)) {
+        queryAll(resultFn);
+        return;
+    }
+
+    auto cx1 = convertToXCellCoord(queryBBox.min.x);
+    auto cy1 = convertToYCellCoord(queryBBox.min.y);
+    auto cx2 = convertToXCellCoord(queryBBox.max.x);
+    auto cy2 = convertToYCellCoord(queryBBox.max.y);
+
+    for (int16_t x = cx1; x <= cx2; ++x) {
+        for (int16_t y = cy1; y <= cy2; ++y) {
+            const std::size_t cellIndex = std::size_t(xCellCount) * y + x;
+            // Look up boxes
+            const bool done = boxCells.forEach(cellIndex, [&](uint32_t uid) {
+                const BBox& bbox = boxes[uid];
+                return isFirstCell(bbox, x, y, cx1, cy1) &&
+                       circleAndBoxCollide(queryBCircle, bbox) &&
+                       resultFn(boxItems[uid], bbox);
+            }) || circleCells.forEach(cellIndex, [&](uint32_t uid) {
+                // Look up other circles
+                const BCircle& bcircle = circles[uid];
+                const BBox bbox = convertToBox(bcircle);
+                return isFirstCell(bbox, x, y, cx1, cy1) &&
+                       circlesCollide(queryBCircle, bcircle) &&
+                       resultFn(circleItems[uid], bbox);
+            });
+            if (done) {
+                return;
+            }
+        }
+    }
+}
+
 } // namespace mbgl
@@ -0,0 +1,164 @@
+#include <mbgl/util/image_buffer_pool.hpp>
+
+#include <cassert>
+#include <cstring>
+
+namespace mbgl {
+namespace util {
+
+namespace {
+
+// Allocations of up to 4 KiB are left to the system allocator, and so are allocations of more
+// than 64 MiB, which are rare enough that caching them would only waste memory.
+constexpr std::size_t minShift = 12;
+constexpr std::size_t maxShift = 26;
+constexpr std::size_t classesPerShift = 4;
+constexpr std::size_t classCount = (maxShift - minShift) * classesPerShift;
+
+std::size_t floorLog2(std::size_t value) {
+    std::size_t result = 0;
+    while (value >>= 1) {
+        ++result;
+    }
+    return result;
+}
+
+// Returns the index of the size class of `bytes`, or classCount if it isn't pooled.
+std::size_t classIndex(std::size_t bytes, std::size_t& capacity) {
+    if (bytes <= (std::size_t(1) << minShift) || bytes > (std::size_t(1) << maxShift)) {
+        capacity = 0;
+        return classCount;
+    }
+    const std::size_t shift = floorLog2(bytes - 1);
+    const std::size_t base = std::size_t(1) << shift;
+    const std::size_t step = base / classesPerShift;
+    const std::size_t sub = (bytes - base - 1) / step;
+    capacity = base + (sub + 1) * step;
+    return (shift - minShift) * classesPerShift + sub;
+}
+
+std::size_t classCapacity(std::size_t index) {
+    const std::size_t base = std::size_t(1) << (minShift + index / classesPerShift);
+    return base + (index % classesPerShift + 1) * (base / classesPerShift);
+}
+
+} // namespace
+
+void ImageBufferDeleter::operator()(uint8_t* buffer) const {
+    if (pool) {
+        pool->release(buffer, capacity);
+    } else {
+        delete[] buffer;
+    }
+}
+
+ImageBufferPool::ImageBufferPool(std::size_t maximumSize_)
+    : classes(classCount), maximumSize(maximumSize_) {
+}
+
+ImageBufferPool::~ImageBufferPool() {
+    shrink();
+}
+
+ImageBufferPool& ImageBufferPool::get() {
+    // Never destroyed, so that images with static storage duration can still return their
+    // buffers when they are destroyed at exit.
+    static ImageBufferPool* pool = new ImageBufferPool();
+    return *pool;
+}
+
+std::size_t ImageBufferPool::sizeClass(std::size_t bytes) {
+    std::size_t capacity;
+    classIndex(bytes, capacity);
+    return capacity;
+}
+
+ImageBuffer ImageBufferPool::allocate(std::size_t bytes, bool zero) {
+    std::size_t capacity;
+    const std::size_t index = classIndex(bytes, capacity);
+
+    uint8_t* buffer = nullptr;
+    if (index != classCount) {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto& buffers = classes[index];
+        if (!buffers.empty()) {
+            buffer = buffers.back();
+            buffers.pop_back();
+            stats.hits++;
+            stats.pooledBuffers--;
+            stats.pooledBytes -= capacity;
+        } else {
+            stats.misses++;
+        }
+    }
+
+    if (!buffer) {
+        buffer = new uint8_t[index != classCount ? capacity : bytes];
+    }
+    if (zero) {
+        std::memset(buffer, 0, bytes);
+    }
+
+    if (index == classCount) {
+        return ImageBuffer(buffer);
+    }
+    return ImageBuffer(buffer, ImageBufferDeleter(this, capacity));
+}
+
+void ImageBufferPool::release(uint8_t* buffer, std::size_t capacity) {
+    std::size_t unused;
+    const std::size_t index = classIndex(capacity, unused);
+    assert(index != classCount && unused == capacity);
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (stats.pooledBytes + capacity <= maximumSize) {
+            classes[index].push_back(buffer);
+            stats.pooledBuffers++;
+            stats.pooledBytes += capacity;
+            return;
+        }
+        stats.discards++;
+    }
+
+    delete[] buffer;
+}
+
+void ImageBufferPool::shrink(std::size_t bytes) {
+    std::vector<uint8_t*> unused;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        // Drop the largest buffers first; they are the ones that are least likely to be reused.
+        for (std::size_t index = classCount; index-- > 0 && stats.pooledBytes > bytes;) {
+            auto& buffers = classes[index];
+            const std::size_t capacity = classCapacity(index);
+            while (!buffers.empty() && stats.pooledBytes > bytes) {
+                unused.push_back(buffers.back());
+                buffers.pop_back();
+                stats.pooledBuffers--;
+                stats.pooledBytes -= capacity;
+            }
+        }
+    }
+
+    // Free the memory outside of the lock.
+    for (uint8_t* buffer : unused) {
+        delete[] buffer;
+    }
+}
+
+void ImageBufferPool::setMaximumSize(std::size_t bytes) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        maximumSize = bytes;
+    }
+    shrink(bytes);
+}
+
+ImageBufferPool::Stats ImageBufferPool::getStats() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return stats;
+}
+
+} // namespace util
+} // namespace mbgl
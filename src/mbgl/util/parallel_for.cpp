@@ -0,0 +1,105 @@
+#include <mbgl/util/parallel_for.hpp>
+
+#include <mbgl/actor/mailbox.hpp>
+#include <mbgl/actor/message.hpp>
+#include <mbgl/actor/scheduler.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace mbgl {
+namespace util {
+
+namespace {
+
+class ParallelForState {
+public:
+    ParallelForState(std::size_t count_, std::function<void(std::size_t)> fn_)
+        : count(count_), fn(std::move(fn_)) {
+    }
+
+    // Claims and runs indices until there are none left. `fn` is only ever called
+    // for a claimed index, so a helper that starts after the caller returned won't
+    // touch anything but this state object.
+    void run() {
+        for (std::size_t i = next++; i < count; i = next++) {
+            try {
+                fn(i);
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(mutex);
+                if (!error) {
+                    error = std::current_exception();
+                }
+            }
+
+            std::lock_guard<std::mutex> lock(mutex);
+            if (++done == count) {
+                cv.notify_all();
+            }
+        }
+    }
+
+    void wait() {
+        std::unique_lock<std::mutex> lock(mutex);
+        cv.wait(lock, [this] { return done == count; });
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+
+private:
+    const std::size_t count;
+    const std::function<void(std::size_t)> fn;
+
+    std::atomic<std::size_t> next { 0 };
+    std::size_t done = 0;
+    std::exception_ptr error;
+
+    std::mutex mutex;
+    std::condition_variable cv;
+};
+
+class ParallelForMessage : public Message {
+public:
+    ParallelForMessage(std::shared_ptr<ParallelForState> state_)
+        : state(std::move(state_)) {
+    }
+
+    void operator()() override {
+        state->run();
+    }
+
+private:
+    std::shared_ptr<ParallelForState> state;
+};
+
+} // namespace
+
+void parallelFor(Scheduler& scheduler, MailboxPriority priority, std::size_t count, std::function<void(std::size_t)> fn) {
+    auto state = std::make_shared<ParallelForState>(count, std::move(fn));
+
+    // The calling thread is one of the workers, so at most `count - 1` helpers are useful.
+    const std::size_t helperCount = count > 0 ? std::min<std::size_t>(count - 1, std::thread::hardware_concurrency()) : 0;
+
+    // The mailboxes only need to outlive this call: once every index is done, a
+    // helper that hasn't started yet has nothing left to do and can be dropped.
+    std::vector<std::shared_ptr<Mailbox>> helpers;
+    helpers.reserve(helperCount);
+    for (std::size_t i = 0; i < helperCount; ++i) {
+        helpers.push_back(std::make_shared<Mailbox>(scheduler));
+        helpers.back()->setPriority(priority);
+        helpers.back()->push(std::make_unique<ParallelForMessage>(state));
+    }
+
+    state->run();
+    state->wait();
+}
+
+} // namespace util
+} // namespace mbgl
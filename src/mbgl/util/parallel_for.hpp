@@ -0,0 +1,25 @@
+#pragma once
+
+#include <mbgl/actor/mailbox.hpp>
+
+#include <cstddef>
+#include <functional>
+
+namespace mbgl {
+
+class Scheduler;
+
+namespace util {
+
+// Calls `fn` once for every index in [0, count), spreading the calls over the
+// threads of `scheduler`. The calling thread takes part in the work and only
+// waits for calls that another thread has already started, so it's safe to call
+// this from a thread that belongs to `scheduler` itself. If any call throws, the
+// first exception is rethrown on the calling thread after all calls finished.
+// The other threads are asked for help at the given priority, which should be the
+// priority of the work the caller is doing, so that helping with prefetch work
+// doesn't delay work for visible content.
+void parallelFor(Scheduler&, MailboxPriority, std::size_t count, std::function<void(std::size_t)> fn);
+
+} // namespace util
+} // namespace mbgl
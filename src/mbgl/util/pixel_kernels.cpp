@@ -0,0 +1,355 @@
+#include <mbgl/util/pixel_kernels.hpp>
+
+#include <algorithm>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define MBGL_PIXEL_KERNELS_SSE2 1
+#include <emmintrin.h>
+// AVX2 code is compiled with function target attributes and only called after checking the CPU.
+#if defined(__GNUC__) || defined(__clang__)
+#define MBGL_PIXEL_KERNELS_AVX2 1
+#define MBGL_TARGET_AVX2 __attribute__((target("avx2")))
+#include <immintrin.h>
+#endif
+#endif
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define MBGL_PIXEL_KERNELS_NEON 1
+#include <arm_neon.h>
+#endif
+
+namespace mbgl {
+namespace util {
+
+namespace {
+
+// Scalar kernels. The SIMD kernels use these for the pixels that don't fill a whole register.
+
+void premultiplyScalar(uint8_t* data, std::size_t pixels) {
+    for (std::size_t i = 0; i < pixels * 4; i += 4) {
+        uint8_t& r = data[i + 0];
+        uint8_t& g = data[i + 1];
+        uint8_t& b = data[i + 2];
+        uint8_t& a = data[i + 3];
+        r = (r * a + 127) / 255;
+        g = (g * a + 127) / 255;
+        b = (b * a + 127) / 255;
+    }
+}
+
+void unpremultiplyScalar(uint8_t* data, std::size_t pixels) {
+    for (std::size_t i = 0; i < pixels * 4; i += 4) {
+        uint8_t& r = data[i + 0];
+        uint8_t& g = data[i + 1];
+        uint8_t& b = data[i + 2];
+        uint8_t& a = data[i + 3];
+        if (a) {
+            r = (255 * r + (a / 2)) / a;
+            g = (255 * g + (a / 2)) / a;
+            b = (255 * b + (a / 2)) / a;
+        }
+    }
+}
+
+void swapRedBlueScalar(uint8_t* data, std::size_t pixels) {
+    for (std::size_t i = 0; i < pixels * 4; i += 4) {
+        std::swap(data[i + 0], data[i + 2]);
+    }
+}
+
+void expandAlphaScalar(const uint8_t* alpha, uint8_t* rgba, std::size_t pixels) {
+    for (std::size_t i = 0; i < pixels; ++i) {
+        std::memset(rgba + i * 4, alpha[i], 4);
+    }
+}
+
+// The SIMD kernels compute (x + 127) / 255 as (y + 1 + (y >> 8)) >> 8 with y = x + 127, which
+// is exact for y < 65535, and unpremultiply with a single precision division: the numerator is
+// an integer below 2^24, and the rounding error of the quotient stays below the distance 1 / a
+// to the next integer, so truncating it yields the integer quotient.
+
+#if MBGL_PIXEL_KERNELS_SSE2
+
+inline __m128i premultiplySSE2(__m128i v) {
+    const __m128i alpha = _mm_shufflehi_epi16(_mm_shufflelo_epi16(v, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+    const __m128i x = _mm_add_epi16(_mm_mullo_epi16(v, alpha), _mm_set1_epi16(127));
+    return _mm_srli_epi16(_mm_add_epi16(_mm_add_epi16(x, _mm_set1_epi16(1)), _mm_srli_epi16(x, 8)), 8);
+}
+
+void premultiplySSE2(uint8_t* data, std::size_t pixels) {
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i alphaMask = _mm_set1_epi32(int32_t(0xFF000000u));
+    std::size_t i = 0;
+    for (; i + 4 <= pixels; i += 4) {
+        __m128i* p = reinterpret_cast<__m128i*>(data + i * 4);
+        const __m128i px = _mm_loadu_si128(p);
+        const __m128i result = _mm_packus_epi16(premultiplySSE2(_mm_unpacklo_epi8(px, zero)),
+                                                premultiplySSE2(_mm_unpackhi_epi8(px, zero)));
+        _mm_storeu_si128(p, _mm_or_si128(_mm_andnot_si128(alphaMask, result), _mm_and_si128(alphaMask, px)));
+    }
+    premultiplyScalar(data + i * 4, pixels - i);
+}
+
+inline __m128i unpremultiplySSE2(__m128i px, __m128 alpha, __m128 half, int shift) {
+    const __m128i byteMask = _mm_set1_epi32(0xFF);
+    const __m128 color = _mm_cvtepi32_ps(_mm_and_si128(_mm_srli_epi32(px, shift), byteMask));
+    const __m128 quotient = _mm_div_ps(_mm_add_ps(_mm_mul_ps(color, _mm_set1_ps(255.0f)), half), alpha);
+    return _mm_slli_epi32(_mm_and_si128(_mm_cvttps_epi32(quotient), byteMask), shift);
+}
+
+void unpremultiplySSE2(uint8_t* data, std::size_t pixels) {
+    const __m128i alphaMask = _mm_set1_epi32(int32_t(0xFF000000u));
+    std::size_t i = 0;
+    for (; i + 4 <= pixels; i += 4) {
+        __m128i* p = reinterpret_cast<__m128i*>(data + i * 4);
+        const __m128i px = _mm_loadu_si128(p);
+        const __m128i a = _mm_srli_epi32(px, 24);
+        const __m128 alpha = _mm_cvtepi32_ps(a);
+        const __m128 half = _mm_cvtepi32_ps(_mm_srli_epi32(px, 25));
+        __m128i result = _mm_and_si128(px, alphaMask);
+        result = _mm_or_si128(result, unpremultiplySSE2(px, alpha, half, 0));
+        result = _mm_or_si128(result, unpremultiplySSE2(px, alpha, half, 8));
+        result = _mm_or_si128(result, unpremultiplySSE2(px, alpha, half, 16));
+        // Pixels without alpha are left alone.
+        const __m128i transparent = _mm_cmpeq_epi32(a, _mm_setzero_si128());
+        _mm_storeu_si128(p, _mm_or_si128(_mm_and_si128(transparent, px), _mm_andnot_si128(transparent, result)));
+    }
+    unpremultiplyScalar(data + i * 4, pixels - i);
+}
+
+void swapRedBlueSSE2(uint8_t* data, std::size_t pixels) {
+    const __m128i greenAlphaMask = _mm_set1_epi32(int32_t(0xFF00FF00u));
+    const __m128i byteMask = _mm_set1_epi32(0xFF);
+    std::size_t i = 0;
+    for (; i + 4 <= pixels; i += 4) {
+        __m128i* p = reinterpret_cast<__m128i*>(data + i * 4);
+        const __m128i px = _mm_loadu_si128(p);
+        const __m128i red = _mm_slli_epi32(_mm_and_si128(px, byteMask), 16);
+        const __m128i blue = _mm_and_si128(_mm_srli_epi32(px, 16), byteMask);
+        _mm_storeu_si128(p, _mm_or_si128(_mm_and_si128(px, greenAlphaMask), _mm_or_si128(red, blue)));
+    }
+    swapRedBlueScalar(data + i * 4, pixels - i);
+}
+
+void expandAlphaSSE2(const uint8_t* alpha, uint8_t* rgba, std::size_t pixels) {
+    std::size_t i = 0;
+    for (; i + 16 <= pixels; i += 16) {
+        const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(alpha + i));
+        const __m128i lo = _mm_unpacklo_epi8(a, a);
+        const __m128i hi = _mm_unpackhi_epi8(a, a);
+        __m128i* p = reinterpret_cast<__m128i*>(rgba + i * 4);
+        _mm_storeu_si128(p + 0, _mm_unpacklo_epi16(lo, lo));
+        _mm_storeu_si128(p + 1, _mm_unpackhi_epi16(lo, lo));
+        _mm_storeu_si128(p + 2, _mm_unpacklo_epi16(hi, hi));
+        _mm_storeu_si128(p + 3, _mm_unpackhi_epi16(hi, hi));
+    }
+    expandAlphaScalar(alpha + i, rgba + i * 4, pixels - i);
+}
+
+#endif // MBGL_PIXEL_KERNELS_SSE2
+
+#if MBGL_PIXEL_KERNELS_AVX2
+
+MBGL_TARGET_AVX2 inline __m256i premultiplyAVX2(__m256i v) {
+    const __m256i alpha = _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(v, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+    const __m256i x = _mm256_add_epi16(_mm256_mullo_epi16(v, alpha), _mm256_set1_epi16(127));
+    return _mm256_srli_epi16(_mm256_add_epi16(_mm256_add_epi16(x, _mm256_set1_epi16(1)), _mm256_srli_epi16(x, 8)), 8);
+}
+
+MBGL_TARGET_AVX2 void premultiplyAVX2(uint8_t* data, std::size_t pixels) {
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i alphaMask = _mm256_set1_epi32(int32_t(0xFF000000u));
+    std::size_t i = 0;
+    for (; i + 8 <= pixels; i += 8) {
+        __m256i* p = reinterpret_cast<__m256i*>(data + i * 4);
+        const __m256i px = _mm256_loadu_si256(p);
+        // Unpacking and packing both work within 128-bit lanes, so the pixels end up in place.
+        const __m256i result = _mm256_packus_epi16(premultiplyAVX2(_mm256_unpacklo_epi8(px, zero)),
+                                                   premultiplyAVX2(_mm256_unpackhi_epi8(px, zero)));
+        _mm256_storeu_si256(p, _mm256_or_si256(_mm256_andnot_si256(alphaMask, result), _mm256_and_si256(alphaMask, px)));
+    }
+    premultiplyScalar(data + i * 4, pixels - i);
+}
+
+MBGL_TARGET_AVX2 inline __m256i unpremultiplyAVX2(__m256i px, __m256 alpha, __m256 half, int shift) {
+    const __m256i byteMask = _mm256_set1_epi32(0xFF);
+    const __m256 color = _mm256_cvtepi32_ps(_mm256_and_si256(_mm256_srli_epi32(px, shift), byteMask));
+    const __m256 quotient = _mm256_div_ps(_mm256_add_ps(_mm256_mul_ps(color, _mm256_set1_ps(255.0f)), half), alpha);
+    return _mm256_slli_epi32(_mm256_and_si256(_mm256_cvttps_epi32(quotient), byteMask), shift);
+}
+
+MBGL_TARGET_AVX2 void unpremultiplyAVX2(uint8_t* data, std::size_t pixels) {
+    const __m256i alphaMask = _mm256_set1_epi32(int32_t(0xFF000000u));
+    std::size_t i = 0;
+    for (; i + 8 <= pixels; i += 8) {
+        __m256i* p = reinterpret_cast<__m256i*>(data + i * 4);
+        const __m256i px = _mm256_loadu_si256(p);
+        const __m256i a = _mm256_srli_epi32(px, 24);
+        const __m256 alpha = _mm256_cvtepi32_ps(a);
+        const __m256 half = _mm256_cvtepi32_ps(_mm256_srli_epi32(px, 25));
+        __m256i result = _mm256_and_si256(px, alphaMask);
+        result = _mm256_or_si256(result, unpremultiplyAVX2(px, alpha, half, 0));
+        result = _mm256_or_si256(result, unpremultiplyAVX2(px, alpha, half, 8));
+        result = _mm256_or_si256(result, unpremultiplyAVX2(px, alpha, half, 16));
+        const __m256i transparent = _mm256_cmpeq_epi32(a, _mm256_setzero_si256());
+        _mm256_storeu_si256(p, _mm256_blendv_epi8(result, px, transparent));
+    }
+    unpremultiplyScalar(data + i * 4, pixels - i);
+}
+
+MBGL_TARGET_AVX2 void swapRedBlueAVX2(uint8_t* data, std::size_t pixels) {
+    const __m256i order = _mm256_setr_epi8(2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15,
+                                           2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15);
+    std::size_t i = 0;
+    for (; i + 8 <= pixels; i += 8) {
+        __m256i* p = reinterpret_cast<__m256i*>(data + i * 4);
+        _mm256_storeu_si256(p, _mm256_shuffle_epi8(_mm256_loadu_si256(p), order));
+    }
+    swapRedBlueScalar(data + i * 4, pixels - i);
+}
+
+bool cpuSupportsAVX2() {
+    static const bool supported = __builtin_cpu_supports("avx2");
+    return supported;
+}
+
+#endif // MBGL_PIXEL_KERNELS_AVX2
+
+#if MBGL_PIXEL_KERNELS_NEON
+
+inline uint8x8_t premultiplyNEON(uint8x8_t color, uint8x8_t alpha) {
+    const uint16x8_t x = vmlal_u8(vdupq_n_u16(127), color, alpha);
+    return vshrn_n_u16(vaddq_u16(x, vaddq_u16(vshrq_n_u16(x, 8), vdupq_n_u16(1))), 8);
+}
+
+void premultiplyNEON(uint8_t* data, std::size_t pixels) {
+    std::size_t i = 0;
+    for (; i + 8 <= pixels; i += 8) {
+        uint8x8x4_t px = vld4_u8(data + i * 4);
+        px.val[0] = premultiplyNEON(px.val[0], px.val[3]);
+        px.val[1] = premultiplyNEON(px.val[1], px.val[3]);
+        px.val[2] = premultiplyNEON(px.val[2], px.val[3]);
+        vst4_u8(data + i * 4, px);
+    }
+    premultiplyScalar(data + i * 4, pixels - i);
+}
+
+#if defined(__aarch64__)
+// Vector division only exists on AArch64; 32-bit ARM unpremultiplies with the scalar kernel.
+inline uint16x4_t unpremultiplyNEON(uint16x4_t color, float32x4_t alpha, float32x4_t half) {
+    const float32x4_t numerator = vmlaq_n_f32(half, vcvtq_f32_u32(vmovl_u16(color)), 255.0f);
+    return vmovn_u32(vcvtq_u32_f32(vdivq_f32(numerator, alpha)));
+}
+
+inline uint8x8_t unpremultiplyNEON(uint8x8_t color, uint8x8_t alpha) {
+    const uint16x8_t wideColor = vmovl_u8(color);
+    const uint16x8_t wideAlpha = vmovl_u8(alpha);
+    const uint16x8_t wideHalf = vshrq_n_u16(wideAlpha, 1);
+    const uint16x4_t lo = unpremultiplyNEON(vget_low_u16(wideColor),
+                                            vcvtq_f32_u32(vmovl_u16(vget_low_u16(wideAlpha))),
+                                            vcvtq_f32_u32(vmovl_u16(vget_low_u16(wideHalf))));
+    const uint16x4_t hi = unpremultiplyNEON(vget_high_u16(wideColor),
+                                            vcvtq_f32_u32(vmovl_u16(vget_high_u16(wideAlpha))),
+                                            vcvtq_f32_u32(vmovl_u16(vget_high_u16(wideHalf))));
+    // Narrowing keeps the low bits, like the scalar kernel's conversion to uint8_t does.
+    const uint8x8_t quotient = vmovn_u16(vcombine_u16(lo, hi));
+    return vbsl_u8(vceq_u8(alpha, vdup_n_u8(0)), color, quotient);
+}
+
+void unpremultiplyNEON(uint8_t* data, std::size_t pixels) {
+    std::size_t i = 0;
+    for (; i + 8 <= pixels; i += 8) {
+        uint8x8x4_t px = vld4_u8(data + i * 4);
+        px.val[0] = unpremultiplyNEON(px.val[0], px.val[3]);
+        px.val[1] = unpremultiplyNEON(px.val[1], px.val[3]);
+        px.val[2] = unpremultiplyNEON(px.val[2], px.val[3]);
+        vst4_u8(data + i * 4, px);
+    }
+    unpremultiplyScalar(data + i * 4, pixels - i);
+}
+#endif // __aarch64__
+
+void swapRedBlueNEON(uint8_t* data, std::size_t pixels) {
+    std::size_t i = 0;
+    for (; i + 16 <= pixels; i += 16) {
+        uint8x16x4_t px = vld4q_u8(data + i * 4);
+        const uint8x16_t red = px.val[0];
+        px.val[0] = px.val[2];
+        px.val[2] = red;
+        vst4q_u8(data + i * 4, px);
+    }
+    swapRedBlueScalar(data + i * 4, pixels - i);
+}
+
+void expandAlphaNEON(const uint8_t* alpha, uint8_t* rgba, std::size_t pixels) {
+    std::size_t i = 0;
+    for (; i + 16 <= pixels; i += 16) {
+        const uint8x16_t a = vld1q_u8(alpha + i);
+        const uint8x16x4_t px = { { a, a, a, a } };
+        vst4q_u8(rgba + i * 4, px);
+    }
+    expandAlphaScalar(alpha + i, rgba + i * 4, pixels - i);
+}
+
+#endif // MBGL_PIXEL_KERNELS_NEON
+
+} // namespace
+
+const PixelKernels* PixelKernels::get(const ISA isa) {
+    switch (isa) {
+    case ISA::Scalar: {
+        static const PixelKernels kernels { ISA::Scalar, premultiplyScalar, unpremultiplyScalar,
+                                            swapRedBlueScalar, expandAlphaScalar };
+        return &kernels;
+    }
+    case ISA::SSE2: {
+#if MBGL_PIXEL_KERNELS_SSE2
+        static const PixelKernels kernels { ISA::SSE2, premultiplySSE2, unpremultiplySSE2,
+                                            swapRedBlueSSE2, expandAlphaSSE2 };
+        return &kernels;
+#else
+        return nullptr;
+#endif
+    }
+    case ISA::AVX2: {
+#if MBGL_PIXEL_KERNELS_AVX2
+        static const PixelKernels kernels { ISA::AVX2, premultiplyAVX2, unpremultiplyAVX2,
+                                            swapRedBlueAVX2, expandAlphaSSE2 };
+        return cpuSupportsAVX2() ? &kernels : nullptr;
+#else
+        return nullptr;
+#endif
+    }
+    case ISA::NEON: {
+#if MBGL_PIXEL_KERNELS_NEON
+#if defined(__aarch64__)
+        static const PixelKernels kernels { ISA::NEON, premultiplyNEON, unpremultiplyNEON,
+                                            swapRedBlueNEON, expandAlphaNEON };
+#else
+        static const PixelKernels kernels { ISA::NEON, premultiplyNEON, unpremultiplyScalar,
+                                            swapRedBlueNEON, expandAlphaNEON };
+#endif
+        return &kernels;
+#else
+        return nullptr;
+#endif
+    }
+    }
+    return nullptr;
+}
+
+const PixelKernels& PixelKernels::get() {
+    static const PixelKernels& best = [] () -> const PixelKernels& {
+        for (const ISA isa : { ISA::AVX2, ISA::NEON, ISA::SSE2 }) {
+            if (const PixelKernels* kernels = get(isa)) {
+                return *kernels;
+            }
+        }
+        return *get(ISA::Scalar);
+    }();
+    return best;
+}
+
+} // namespace util
+} // namespace mbgl
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace mbgl {
+namespace util {
+
+// Loops over RGBA pixels, with SIMD implementations for the instruction sets that the build
+// targets and the CPU supports. Every implementation produces exactly the results of the scalar
+// one, including for color values that exceed their alpha.
+struct PixelKernels {
+    enum class ISA : uint8_t { Scalar, SSE2, AVX2, NEON };
+
+    // Returns the kernels of the best instruction set available, which is detected once.
+    static const PixelKernels& get();
+    // Returns the kernels of the given instruction set, or nullptr if this build or the CPU
+    // doesn't support it.
+    static const PixelKernels* get(ISA);
+
+    ISA isa;
+
+    // Sets each color channel c to (c * a + 127) / 255.
+    void (*premultiply)(uint8_t* rgba, std::size_t pixels);
+    // Sets each color channel c to (255 * c + a / 2) / a, truncated to 8 bits, for pixels whose
+    // alpha isn't 0.
+    void (*unpremultiply)(uint8_t* rgba, std::size_t pixels);
+    // Swaps the first and third channel, which converts between RGBA and BGRA.
+    void (*swapRedBlue)(uint8_t* rgba, std::size_t pixels);
+    // Writes a pixel with all four channels set to the alpha value for each alpha value.
+    void (*expandAlpha)(const uint8_t* alpha, uint8_t* rgba, std::size_t pixels);
+};
+
+} // namespace util
+} // namespace mbgl
@@ -1,6 +1,5 @@
 #include <mbgl/util/premultiply.hpp>
-
-#include <cmath>
+#include <mbgl/util/pixel_kernels.hpp>
 
 namespace mbgl {
 namespace util {
@@ -12,16 +11,7 @@ PremultipliedImage premultiply(UnassociatedImage&& src) {
     src.size = { 0, 0 };
     dst.data = std::move(src.data);
 
-    uint8_t* data = dst.data.get();
-    for (size_t i = 0; i < dst.bytes(); i += 4) {
-        uint8_t& r = data[i + 0];
-        uint8_t& g = data[i + 1];
-        uint8_t& b = data[i + 2];
-        uint8_t& a = data[i + 3];
-        r = (r * a + 127) / 255;
-        g = (g * a + 127) / 255;
-        b = (b * a + 127) / 255;
-    }
+    PixelKernels::get().premultiply(dst.data.get(), dst.size.area());
 
     return dst;
 }
@@ -33,19 +23,22 @@ UnassociatedImage unpremultiply(PremultipliedImage&& src) {
     src.size = { 0, 0 };
     dst.data = std::move(src.data);
 
-    uint8_t* data = dst.data.get();
-    for (size_t i = 0; i < dst.bytes(); i += 4) {
-        uint8_t& r = data[i + 0];
-        uint8_t& g = data[i + 1];
-        uint8_t& b = data[i + 2];
-        uint8_t& a = data[i + 3];
-        if (a) {
-            r = (255 * r + (a / 2)) / a;
-            g = (255 * g + (a / 2)) / a;
-            b = (255 * b + (a / 2)) / a;
-        }
-    }
+    PixelKernels::get().unpremultiply(dst.data.get(), dst.size.area());
+
+    return dst;
+}
+
+void swapRedBlue(PremultipliedImage& image) {
+    PixelKernels::get().swapRedBlue(image.data.get(), image.size.area());
+}
+
+void swapRedBlue(UnassociatedImage& image) {
+    PixelKernels::get().swapRedBlue(image.data.get(), image.size.area());
+}
 
+PremultipliedImage expandAlpha(const AlphaImage& src) {
+    PremultipliedImage dst(src.size);
+    PixelKernels::get().expandAlpha(src.data.get(), dst.data.get(), src.size.area());
     return dst;
 }
 
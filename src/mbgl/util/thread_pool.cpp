@@ -3,6 +3,8 @@
 #include <mbgl/util/platform.hpp>
 #include <mbgl/util/string.hpp>
 
+#include <algorithm>
+
 namespace mbgl {
 
 ThreadPool::ThreadPool(std::size_t count) {
@@ -16,15 +18,19 @@ ThreadPool::ThreadPool(std::size_t count) {
                 std::unique_lock<std::mutex> lock(mutex);
 
                 cv.wait(lock, [this] {
-                    return !queue.empty() || terminate;
+                    return queued > 0 || terminate;
                 });
 
                 if (terminate) {
                     return;
                 }
 
-                auto mailbox = queue.front();
+                auto& queue = *std::find_if(queues.begin(), queues.end(), [] (const auto& q) {
+                    return !q.empty();
+                });
+                auto mailbox = std::move(queue.front());
                 queue.pop();
+                --queued;
                 lock.unlock();
 
                 Mailbox::maybeReceive(mailbox);
@@ -47,9 +53,15 @@ ThreadPool::~ThreadPool() {
 }
 
 void ThreadPool::schedule(std::weak_ptr<Mailbox> mailbox) {
+    MailboxPriority priority = MailboxPriority::Idle;
+    if (auto locked = mailbox.lock()) {
+        priority = locked->getPriority();
+    }
+
     {
         std::lock_guard<std::mutex> lock(mutex);
-        queue.push(mailbox);
+        queues[static_cast<std::size_t>(priority)].push(std::move(mailbox));
+        ++queued;
     }
 
     cv.notify_one();
@@ -3,6 +3,7 @@
 #include <mbgl/actor/mailbox.hpp>
 #include <mbgl/actor/scheduler.hpp>
 
+#include <array>
 #include <condition_variable>
 #include <mutex>
 #include <queue>
@@ -19,7 +20,8 @@ public:
 
 private:
     std::vector<std::thread> threads;
-    std::queue<std::weak_ptr<Mailbox>> queue;
+    std::array<std::queue<std::weak_ptr<Mailbox>>, MailboxPriorityCount> queues;
+    std::size_t queued{ 0 };
     std::mutex mutex;
     std::condition_variable cv;
     bool terminate{ false };
@@ -0,0 +1,126 @@
+#include <mbgl/util/work_stealing_thread_pool.hpp>
+
+#include <mbgl/util/platform.hpp>
+#include <mbgl/util/string.hpp>
+
+#include <cassert>
+
+namespace mbgl {
+
+WorkStealingThreadPool::WorkStealingThreadPool(std::size_t count)
+    : workers(count) {
+    assert(count > 0);
+    threads.reserve(count);
+
+    for (std::size_t i = 0; i < count; ++i) {
+        threads.emplace_back([this, i]() {
+            platform::setCurrentThreadName(std::string{ "Worker " } + util::toString(i + 1));
+            currentWorker.set(&workers[i]);
+
+            std::weak_ptr<Mailbox> mailbox;
+
+            while (!terminate) {
+                if (next(i, mailbox)) {
+                    --pending;
+                    Mailbox::maybeReceive(std::move(mailbox));
+                    continue;
+                }
+
+                // `sleeping` is incremented before `pending` is checked, and schedule()
+                // increments `pending` before checking `sleeping`, so a wakeup can't be lost.
+                std::unique_lock<std::mutex> lock(mutex);
+                ++sleeping;
+                cv.wait(lock, [this] {
+                    return pending > 0 || terminate;
+                });
+                --sleeping;
+            }
+
+            currentWorker.set(nullptr);
+        });
+    }
+}
+
+WorkStealingThreadPool::~WorkStealingThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        terminate = true;
+    }
+
+    cv.notify_all();
+
+    for (auto& thread : threads) {
+        thread.join();
+    }
+}
+
+void WorkStealingThreadPool::schedule(std::weak_ptr<Mailbox> mailbox) {
+    MailboxPriority priority = MailboxPriority::Idle;
+    if (auto locked = mailbox.lock()) {
+        priority = locked->getPriority();
+    }
+
+    Worker* worker = currentWorker.get();
+    if (!worker) {
+        worker = &workers[nextWorker++ % workers.size()];
+    }
+
+    // Count the mailbox before it becomes visible so that `pending` never underflows
+    // when another thread picks it up immediately.
+    ++pending;
+
+    {
+        std::lock_guard<std::mutex> lock(worker->mutex);
+        worker->queues[static_cast<std::size_t>(priority)].push_back(std::move(mailbox));
+    }
+
+    if (sleeping > 0) {
+        std::lock_guard<std::mutex> lock(mutex);
+        cv.notify_one();
+    }
+}
+
+bool WorkStealingThreadPool::next(std::size_t index, std::weak_ptr<Mailbox>& mailbox) {
+    for (std::size_t priority = 0; priority < MailboxPriorityCount; ++priority) {
+        if (pop(index, priority, mailbox) || steal(index, priority, mailbox)) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+bool WorkStealingThreadPool::pop(std::size_t index, std::size_t priority, std::weak_ptr<Mailbox>& mailbox) {
+    Worker& worker = workers[index];
+    std::lock_guard<std::mutex> lock(worker.mutex);
+    auto& queue = worker.queues[priority];
+    if (queue.empty()) {
+        return false;
+    }
+
+    // The owner consumes its own queue in FIFO order so that a mailbox rescheduling
+    // itself after every message can't starve the others queued on the same thread.
+    mailbox = std::move(queue.front());
+    queue.pop_front();
+    return true;
+}
+
+bool WorkStealingThreadPool::steal(std::size_t index, std::size_t priority, std::weak_ptr<Mailbox>& mailbox) {
+    for (std::size_t offset = 1; offset < workers.size(); ++offset) {
+        Worker& victim = workers[(index + offset) % workers.size()];
+        std::unique_lock<std::mutex> lock(victim.mutex, std::try_to_lock);
+        if (!lock || victim.queues[priority].empty()) {
+            continue;
+        }
+
+        // Thieves take from the back, away from the end the owner is working on.
+        auto& queue = victim.queues[priority];
+        mailbox = std::move(queue.back());
+        queue.pop_back();
+        return true;
+    }
+
+    return false;
+}
+
+} // namespace mbgl
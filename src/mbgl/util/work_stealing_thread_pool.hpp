@@ -0,0 +1,55 @@
+#pragma once
+
+#include <mbgl/actor/mailbox.hpp>
+#include <mbgl/actor/scheduler.hpp>
+#include <mbgl/util/thread_local.hpp>
+
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace mbgl {
+
+// A Scheduler that gives every thread its own queue instead of funneling all
+// mailboxes through a single shared one. Mailboxes scheduled from one of the
+// pool's own threads are queued locally; mailboxes scheduled from elsewhere
+// are distributed round-robin. Idle threads steal from their siblings before
+// going to sleep. Per-mailbox ordering is provided by Mailbox itself, which
+// only ever has a single pending schedule() call at a time. Mailboxes with a
+// higher MailboxPriority are taken, locally or by stealing, before any mailbox
+// with a lower one.
+class WorkStealingThreadPool final : public Scheduler {
+public:
+    explicit WorkStealingThreadPool(std::size_t count);
+    ~WorkStealingThreadPool() override;
+
+    void schedule(std::weak_ptr<Mailbox>) override;
+
+private:
+    struct Worker {
+        std::mutex mutex;
+        std::array<std::deque<std::weak_ptr<Mailbox>>, MailboxPriorityCount> queues;
+    };
+
+    bool next(std::size_t index, std::weak_ptr<Mailbox>&);
+    bool pop(std::size_t index, std::size_t priority, std::weak_ptr<Mailbox>&);
+    bool steal(std::size_t index, std::size_t priority, std::weak_ptr<Mailbox>&);
+
+    std::vector<Worker> workers;
+    std::vector<std::thread> threads;
+    util::ThreadLocal<Worker> currentWorker;
+
+    std::atomic<std::size_t> pending{ 0 };
+    std::atomic<std::size_t> sleeping{ 0 };
+    std::atomic<std::size_t> nextWorker{ 0 };
+    std::atomic<bool> terminate{ false };
+
+    std::mutex mutex;
+    std::condition_variable cv;
+};
+
+} // namespace mbgl
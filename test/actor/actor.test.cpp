@@ -3,12 +3,14 @@
 #include <mbgl/actor/scheduler.hpp>
 #include <mbgl/test/util.hpp>
 #include <mbgl/util/run_loop.hpp>
+#include <mbgl/util/thread_pool.hpp>
 
 #include <chrono>
 #include <functional>
 #include <future>
 #include <memory>
 #include <thread>
+#include <vector>
 
 using namespace mbgl;
 using namespace std::chrono_literals;
@@ -413,4 +415,62 @@ TEST(Actor, TwoPhaseConstruction) {
     EXPECT_TRUE(*destroyed);
 }
 
+TEST(Actor, Priority) {
+    // Mailboxes with a higher priority are processed first, regardless of the
+    // order in which they were scheduled.
 
+    struct Test {
+        Test(ActorRef<Test>, std::vector<MailboxPriority>& order_)
+            : order(order_) {}
+
+        void block(std::promise<void> entered, std::shared_future<void> release) {
+            entered.set_value();
+            release.wait();
+        }
+
+        void record(MailboxPriority priority, std::promise<void> done) {
+            order.push_back(priority);
+            done.set_value();
+        }
+
+        std::vector<MailboxPriority>& order;
+    };
+
+    ThreadPool pool(1);
+    std::vector<MailboxPriority> order;
+
+    Actor<Test> blocker(pool, std::ref(order));
+    Actor<Test> idle(pool, std::ref(order));
+    Actor<Test> prefetch(pool, std::ref(order));
+    Actor<Test> visible(pool, std::ref(order));
+
+    idle.setPriority(MailboxPriority::Idle);
+    prefetch.setPriority(MailboxPriority::Prefetch);
+    visible.setPriority(MailboxPriority::Visible);
+
+    // Occupy the only thread so that the remaining messages are queued together.
+    std::promise<void> entered;
+    auto enteredFuture = entered.get_future();
+    std::promise<void> release;
+    blocker.self().invoke(&Test::block, std::move(entered), release.get_future().share());
+    enteredFuture.wait();
+
+    std::promise<void> idleDone;
+    auto idleFuture = idleDone.get_future();
+    idle.self().invoke(&Test::record, MailboxPriority::Idle, std::move(idleDone));
+
+    std::promise<void> prefetchDone;
+    auto prefetchFuture = prefetchDone.get_future();
+    prefetch.self().invoke(&Test::record, MailboxPriority::Prefetch, std::move(prefetchDone));
+
+    std::promise<void> visibleDone;
+    auto visibleFuture = visibleDone.get_future();
+    visible.self().invoke(&Test::record, MailboxPriority::Visible, std::move(visibleDone));
+
+    release.set_value();
+    idleFuture.wait();
+    prefetchFuture.wait();
+    visibleFuture.wait();
+
+    EXPECT_EQ((std::vector<MailboxPriority>{ MailboxPriority::Visible, MailboxPriority::Prefetch, MailboxPriority::Idle }), order);
+}
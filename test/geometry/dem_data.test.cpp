@@ -1,6 +1,7 @@
 #include <mbgl/test/util.hpp>
 
 #include <mbgl/util/image.hpp>
+#include <mbgl/util/io.hpp>
 #include <mbgl/util/tileset.hpp>
 #include <mbgl/geometry/dem_data.hpp>
 
@@ -145,3 +146,19 @@ TEST(DEMData, BackfillNeighbor) {
     // backfulls BottomLeft neighbor
     EXPECT_TRUE(dem0.get(4, -1) == dem1.get(0, 3));
 };
+
+TEST(DEMData, Decode) {
+    const std::string data = util::read_file("test/fixtures/image/tile.png");
+    const DEMData decoded = DEMData::decode(data, Tileset::DEMEncoding::Mapbox);
+    const DEMData reference(decodeImage(data), Tileset::DEMEncoding::Mapbox);
+
+    EXPECT_EQ(256, decoded.dim);
+    for (int32_t y = -1; y <= decoded.dim; y++) {
+        for (int32_t x = -1; x <= decoded.dim; x++) {
+            ASSERT_EQ(reference.get(x, y), decoded.get(x, y));
+        }
+    }
+
+    EXPECT_THROW(DEMData::decode(util::read_file("test/fixtures/image/no_profile.png").substr(0, 20),
+                                 Tileset::DEMEncoding::Mapbox), std::runtime_error);
+}
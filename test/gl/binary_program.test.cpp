@@ -0,0 +1,61 @@
+#include <mbgl/test/util.hpp>
+
+#include <mbgl/gl/binary_program.hpp>
+#include <mbgl/gl/context.hpp>
+#include <mbgl/gl/headless_backend.hpp>
+#include <mbgl/gfx/backend_scope.hpp>
+#include <mbgl/util/io.hpp>
+
+using namespace mbgl;
+
+TEST(BinaryProgram, RoundTrip) {
+    const gl::BinaryProgram program(0x1234, std::string("\0binary\xff", 8), "identifier", "vendor|renderer|version");
+    const gl::BinaryProgram parsed(program.serialize());
+
+    EXPECT_EQ(0x1234u, parsed.format());
+    EXPECT_EQ(std::string("\0binary\xff", 8), parsed.code());
+    EXPECT_EQ("identifier", parsed.identifier());
+    EXPECT_EQ("vendor|renderer|version", parsed.driver());
+}
+
+TEST(BinaryProgram, Malformed) {
+    EXPECT_THROW(gl::BinaryProgram { std::string() }, std::runtime_error);
+
+    // Truncated within the binary code.
+    const gl::BinaryProgram program(1, std::string(64, 'x'), "identifier", "driver");
+    EXPECT_ANY_THROW(gl::BinaryProgram(program.serialize().substr(0, 10)));
+}
+
+TEST(BinaryProgram, Cache) {
+    gl::HeadlessBackend backend;
+    gfx::BackendScope scope { backend };
+    auto& context = static_cast<gl::Context&>(backend.getContext());
+    if (!context.supportsProgramBinaries()) {
+        // The driver doesn't provide any binary format.
+        return;
+    }
+
+    const std::string path = "test/fixtures/binary_program.pbf";
+    {
+        const auto program = context.createProgram(
+            context.createShader(gl::ShaderType::Vertex, {
+                "attribute vec2 a_pos;\nvoid main() { gl_Position = vec4(a_pos, 0, 1); }\n" }),
+            context.createShader(gl::ShaderType::Fragment, {
+                "#ifdef GL_ES\nprecision mediump float;\n#endif\nvoid main() { gl_FragColor = vec4(0, 1, 0, 1); }\n" }),
+            "a_pos");
+        gl::writeBinaryProgram(context, program, path, "identifier");
+    }
+
+    // Programs built from other sources or defines aren't loaded.
+    EXPECT_FALSE(gl::readBinaryProgram(context, path, "other"));
+
+    const auto binaryProgram = gl::readBinaryProgram(context, path, "identifier");
+    ASSERT_TRUE(binaryProgram);
+    EXPECT_EQ(context.getDriverIdentifier(), binaryProgram->driver());
+    EXPECT_NE(0u, context.createProgram(binaryProgram->format(), binaryProgram->code()).get());
+
+    // Binaries the driver rejects fail to link instead of producing a broken program.
+    EXPECT_THROW(context.createProgram(binaryProgram->format(), "garbage"), std::runtime_error);
+
+    util::deleteFile(path);
+}
@@ -0,0 +1,65 @@
+#include <mbgl/test/util.hpp>
+
+#include <mbgl/gfx/backend_scope.hpp>
+#include <mbgl/gl/headless_backend.hpp>
+#include <mbgl/gl/context.hpp>
+
+#include <array>
+#include <vector>
+
+using namespace mbgl;
+
+TEST(BufferArena, SharesBuffers) {
+    gl::HeadlessBackend backend { { 256, 256 } };
+    gfx::BackendScope scope { backend };
+
+    gl::Context context{ backend };
+    auto& arena = context.vertexBufferArena;
+
+    const std::array<uint8_t, 100> data {};
+    std::vector<gl::BufferArena::Allocation> allocations;
+    for (int i = 0; i < 10; ++i) {
+        allocations.push_back(arena.allocate(data.data(), data.size(), gfx::BufferUsageType::StaticDraw));
+    }
+
+    EXPECT_EQ(1u, arena.getPageCount());
+    for (std::size_t i = 0; i < allocations.size(); ++i) {
+        EXPECT_EQ(allocations[0].getBuffer(), allocations[i].getBuffer());
+        EXPECT_EQ(0u, allocations[i].getOffset() % gl::BufferArena::alignment);
+        EXPECT_EQ(112u, allocations[i].getSize());
+        if (i > 0) {
+            EXPECT_EQ(allocations[i - 1].getOffset() + allocations[i - 1].getSize(), allocations[i].getOffset());
+        }
+    }
+    EXPECT_EQ(1120u, arena.getBytesUsed());
+
+    // Large and dynamic buffers get buffer objects of their own.
+    std::vector<uint8_t> large(gl::BufferArena::maxSharedSize + 1);
+    {
+        auto own = arena.allocate(large.data(), large.size(), gfx::BufferUsageType::StaticDraw);
+        auto dynamic = arena.allocate(data.data(), data.size(), gfx::BufferUsageType::DynamicDraw);
+        EXPECT_EQ(3u, arena.getPageCount());
+        EXPECT_EQ(0u, own.getOffset());
+        EXPECT_NE(allocations[0].getBuffer(), own.getBuffer());
+        EXPECT_NE(allocations[0].getBuffer(), dynamic.getBuffer());
+    }
+    EXPECT_EQ(1u, arena.getPageCount());
+
+    // Released ranges are merged and reused.
+    const std::size_t offset = allocations[3].getOffset();
+    allocations.erase(allocations.begin() + 3, allocations.begin() + 5);
+    {
+        auto reused = arena.allocate(data.data(), 200, gfx::BufferUsageType::StaticDraw);
+        EXPECT_EQ(offset, reused.getOffset());
+        EXPECT_EQ(allocations[0].getBuffer(), reused.getBuffer());
+    }
+
+    // The last page stays around until the context is reset.
+    allocations.clear();
+    EXPECT_EQ(1u, arena.getPageCount());
+    EXPECT_EQ(0u, arena.getBytesUsed());
+
+    context.reset();
+    EXPECT_EQ(0u, arena.getPageCount());
+    EXPECT_TRUE(context.empty());
+}
@@ -0,0 +1,89 @@
+#include <mbgl/test/util.hpp>
+
+#include <mbgl/gl/draw_list.hpp>
+
+#include <array>
+#include <memory>
+#include <vector>
+
+using namespace mbgl;
+
+TEST(DrawList, GroupsByDepthRangeThenProgram) {
+    gl::DrawList list;
+    std::vector<int> order;
+    auto record = [&](Range<float> depthRange, gl::ProgramID program, int draw) {
+        list.record(depthRange, program, [&order, draw] { order.push_back(draw); });
+    };
+
+    // Two tiles each drawing a fill and then an outline, in sublayers that the tiles share.
+    const Range<float> fills { 0.5f, 0.5f };
+    const Range<float> outlines { 0.4f, 0.4f };
+    record(fills, 2, 1);
+    record(outlines, 1, 2);
+    record(fills, 2, 3);
+    record(outlines, 1, 4);
+    record(fills, 3, 5);
+    record(fills, 2, 6);
+    EXPECT_EQ(6u, list.size());
+
+    // Depth ranges keep the order they were first used in, even though the outline program sorts
+    // before the fill program; draws that share both keep their order.
+    list.replay();
+    EXPECT_EQ((std::vector<int>{ 1, 3, 6, 5, 2, 4 }), order);
+    EXPECT_EQ(0u, list.size());
+
+    order.clear();
+    list.replay();
+    EXPECT_TRUE(order.empty());
+}
+
+TEST(DrawList, DestroysDraws) {
+    auto state = std::make_shared<int>(0);
+    int draws = 0;
+    {
+        gl::DrawList list;
+        list.record({ 0.0f, 1.0f }, 1, [state, &draws] { draws++; });
+        EXPECT_EQ(2, state.use_count());
+        list.replay();
+        EXPECT_EQ(1, draws);
+        EXPECT_EQ(1, state.use_count());
+
+        // Draws that are cleared, or still recorded when the list is destroyed, aren't issued.
+        list.record({ 0.0f, 1.0f }, 1, [state, &draws] { draws++; });
+        list.clear();
+        EXPECT_EQ(1, state.use_count());
+        list.record({ 0.0f, 1.0f }, 1, [state, &draws] { draws++; });
+        EXPECT_EQ(2, state.use_count());
+    }
+    EXPECT_EQ(1, draws);
+    EXPECT_EQ(1, state.use_count());
+}
+
+TEST(DrawList, SpansBlocks) {
+    gl::DrawList list;
+    std::vector<std::size_t> order;
+
+    // Draws that hold more state than fits in one block keep their state intact.
+    const std::size_t count = 3 * gl::DrawList::blockSize / 512;
+    for (std::size_t round = 0; round < 2; ++round) {
+        order.clear();
+        for (std::size_t i = 0; i < count; ++i) {
+            std::array<std::size_t, 64> state;
+            state.fill(i);
+            list.record({ 0.0f, 1.0f }, 1, [&order, state] {
+                for (std::size_t value : state) {
+                    if (value != state[0]) {
+                        ADD_FAILURE() << "corrupted draw state";
+                    }
+                }
+                order.push_back(state[0]);
+            });
+        }
+        list.replay();
+
+        ASSERT_EQ(count, order.size());
+        for (std::size_t i = 0; i < count; ++i) {
+            EXPECT_EQ(i, order[i]);
+        }
+    }
+}
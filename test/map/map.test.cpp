@@ -8,7 +8,9 @@
 #include <mbgl/map/map_options.hpp>
 #include <mbgl/gfx/backend_scope.hpp>
 #include <mbgl/gl/context.hpp>
+#include <mbgl/gl/headless_backend.hpp>
 #include <mbgl/gfx/headless_frontend.hpp>
+#include <mbgl/renderer/renderer.hpp>
 #include <mbgl/storage/resource_options.hpp>
 #include <mbgl/storage/network_status.hpp>
 #include <mbgl/storage/default_file_source.hpp>
@@ -22,8 +24,14 @@
 #include <mbgl/style/layers/background_layer.hpp>
 #include <mbgl/style/layers/symbol_layer.hpp>
 #include <mbgl/style/sources/geojson_source.hpp>
+#include <mbgl/renderer/tile_pyramid.hpp>
+#include <mbgl/tile/geometry_tile_worker.hpp>
 #include <mbgl/util/color.hpp>
 
+#include <array>
+#include <limits>
+#include <vector>
+
 using namespace mbgl;
 using namespace mbgl::style;
 using namespace std::literals::string_literals;
@@ -609,6 +617,278 @@ TEST(Map, AddLayer) {
     test::checkImage("test/fixtures/map/add_layer", test.frontend.render(test.map));
 }
 
+TEST(Map, RenderingStats) {
+    MapTest<> test;
+
+    test.map.getStyle().loadJSON(R"STYLE({
+      "version": 8,
+      "sources": {
+        "world": {
+          "type": "geojson",
+          "data": {
+            "type": "Polygon",
+            "coordinates": [[[-180, -80], [180, -80], [180, 80], [-180, 80], [-180, -80]]]
+          }
+        }
+      },
+      "layers": [{
+        "id": "fill",
+        "type": "fill",
+        "source": "world",
+        "paint": {
+          "fill-color": "red",
+          "fill-opacity": 0.5
+        }
+      }]
+    })STYLE");
+    test.map.jumpTo(CameraOptions().withCenter(LatLng { 0, 0 }).withZoom(1));
+
+    auto& renderer = *test.frontend.getRenderer();
+
+    // Four tiles, each drawing a clipping mask, a fill and an outline. The clipping masks share
+    // a program; drawn tile by tile, each tile then binds the fill and the outline program.
+    renderer.setDrawReordering(false);
+    test.frontend.render(test.map);
+    EXPECT_EQ(12u, renderer.getRenderingStats().numDrawCalls);
+    EXPECT_EQ(9u, renderer.getRenderingStats().numProgramBinds);
+
+    // Drawing the fills of all tiles before their outlines binds each program once.
+    renderer.setDrawReordering(true);
+    test.frontend.render(test.map);
+    EXPECT_EQ(12u, renderer.getRenderingStats().numDrawCalls);
+    EXPECT_EQ(3u, renderer.getRenderingStats().numProgramBinds);
+}
+
+TEST(Map, TileCacheStats) {
+    MapTest<> test;
+
+    test.map.getStyle().loadJSON(R"STYLE({
+      "version": 8,
+      "sources": {
+        "world": {
+          "type": "geojson",
+          "data": {
+            "type": "Polygon",
+            "coordinates": [[[-180, -80], [180, -80], [180, 80], [-180, 80], [-180, -80]]]
+          }
+        }
+      },
+      "layers": [{
+        "id": "fill",
+        "type": "fill",
+        "source": "world"
+      }]
+    })STYLE");
+    auto& renderer = *test.frontend.getRenderer();
+
+    // Zooming in caches the tiles of zoom 1, and zooming out again takes them from the cache.
+    test.map.jumpTo(CameraOptions().withCenter(LatLng { 0, 0 }).withZoom(1));
+    test.frontend.render(test.map);
+    test.map.jumpTo(CameraOptions().withCenter(LatLng { 0, 0 }).withZoom(3));
+    test.frontend.render(test.map);
+
+    auto stats = renderer.getTileCacheStats();
+    EXPECT_GT(stats.misses, 0u);
+    EXPECT_EQ(0u, stats.hits);
+    EXPECT_GT(stats.bytes, 0u);
+
+    test.map.jumpTo(CameraOptions().withCenter(LatLng { 0, 0 }).withZoom(1));
+    test.frontend.render(test.map);
+
+    stats = renderer.getTileCacheStats();
+    EXPECT_GT(stats.hits, 0u);
+    EXPECT_EQ(0u, stats.evictions);
+
+    // A budget smaller than any tile leaves the cache empty.
+    renderer.setTileCacheMaxBytes(1);
+    test.map.jumpTo(CameraOptions().withCenter(LatLng { 0, 0 }).withZoom(3));
+    test.frontend.render(test.map);
+
+    stats = renderer.getTileCacheStats();
+    EXPECT_GT(stats.evictions, 0u);
+    EXPECT_EQ(0u, stats.bytes);
+}
+
+// Loads four icons at (±20, ±20), each of which ends up in a different tile at zoom 1.
+static void loadMarkers(Map& map) {
+    map.getStyle().loadJSON(R"STYLE({
+      "version": 8,
+      "sources": {
+        "points": {
+          "type": "geojson",
+          "data": {
+            "type": "FeatureCollection",
+            "features": [
+              { "type": "Feature", "properties": {}, "geometry": { "type": "Point", "coordinates": [-20, -20] } },
+              { "type": "Feature", "properties": {}, "geometry": { "type": "Point", "coordinates": [-20, 20] } },
+              { "type": "Feature", "properties": {}, "geometry": { "type": "Point", "coordinates": [20, -20] } },
+              { "type": "Feature", "properties": {}, "geometry": { "type": "Point", "coordinates": [20, 20] } }
+            ]
+          }
+        }
+      },
+      "layers": [{
+        "id": "symbols",
+        "type": "symbol",
+        "source": "points",
+        "layout": {
+          "icon-image": "marker",
+          "icon-allow-overlap": true
+        }
+      }]
+    })STYLE");
+    map.getStyle().addImage(std::make_unique<style::Image>("marker",
+        decodeImage(util::read_file("test/fixtures/sprites/default_marker.png")), 1.0));
+    map.jumpTo(CameraOptions().withCenter(LatLng { 0, 0 }).withZoom(1));
+}
+
+TEST(Map, IncrementalPlacement) {
+    MapTest<> test { 1, MapMode::Continuous };
+
+    // Place a single tile per frame.
+    test.frontend.getRenderer()->setBackgroundPlacement(false);
+    test.frontend.getRenderer()->setPlacementTimeBudget(Duration(1));
+    loadMarkers(test.map);
+
+    std::size_t frames = 0;
+    test.observer.didFinishRenderingFrameCallback = [&] (MapObserver::RenderMode) {
+        frames++;
+        test.runLoop.stop();
+    };
+
+    // Each point is in a different tile, so they can only all be placed after several frames.
+    std::vector<Feature> features;
+    const RenderedQueryOptions options { std::vector<std::string> { "symbols" } };
+    while (features.size() < 4 && frames < 100) {
+        test.runLoop.run();
+        features = test.frontend.getRenderer()->queryRenderedFeatures(
+            ScreenBox { { 0, 0 }, { 256, 256 } }, options);
+    }
+
+    EXPECT_EQ(4u, features.size());
+    EXPECT_GE(frames, 4u);
+}
+
+TEST(Map, BackgroundPlacement) {
+    MapTest<> test { 1, MapMode::Continuous };
+    loadMarkers(test.map);
+
+    std::size_t frames = 0;
+    test.observer.didFinishRenderingFrameCallback = [&] (MapObserver::RenderMode) {
+        frames++;
+        test.runLoop.stop();
+    };
+
+    // The placement worker invalidates the renderer once the placement is finished.
+    std::vector<Feature> features;
+    const RenderedQueryOptions options { std::vector<std::string> { "symbols" } };
+    while (features.size() < 4 && frames < 1000) {
+        test.runLoop.run();
+        features = test.frontend.getRenderer()->queryRenderedFeatures(
+            ScreenBox { { 0, 0 }, { 256, 256 } }, options);
+    }
+
+    EXPECT_EQ(4u, features.size());
+}
+
+TEST(Map, PlacementDiscardedOnLayerChange) {
+    MapTest<> test { 1, MapMode::Continuous };
+
+    test.frontend.getRenderer()->setBackgroundPlacement(false);
+    test.frontend.getRenderer()->setPlacementTimeBudget(Duration(1));
+    loadMarkers(test.map);
+
+    // Placed below the markers, so that it collides with them.
+    auto below = std::make_unique<style::SymbolLayer>("below", "points");
+    below->setIconImage(std::string("marker"));
+    test.map.getStyle().addLayer(std::move(below), std::string("symbols"));
+
+    std::size_t frames = 0;
+    test.observer.didFinishRenderingFrameCallback = [&] (MapObserver::RenderMode) {
+        frames++;
+        test.runLoop.stop();
+    };
+
+    const RenderedQueryOptions symbolsOptions { std::vector<std::string> { "symbols" } };
+    const RenderedQueryOptions belowOptions { std::vector<std::string> { "below" } };
+    auto query = [&] (const RenderedQueryOptions& options) {
+        return test.frontend.getRenderer()->queryRenderedFeatures(
+            ScreenBox { { 0, 0 }, { 256, 256 } }, options);
+    };
+
+    // Remove the markers before a placement that includes them is committed.
+    while (!test.map.isFullyLoaded() && frames < 100) {
+        test.runLoop.run();
+    }
+    ASSERT_TRUE(test.map.isFullyLoaded());
+    ASSERT_EQ(0u, query(symbolsOptions).size());
+    test.map.getStyle().removeLayer("symbols");
+
+    // The placement in progress is discarded instead of being committed, so the next one to be
+    // committed no longer has the markers hide the symbols below them. A stale placement would be
+    // committed first, and would only be replaced once it is no longer recent.
+    const std::size_t removedAt = frames;
+    std::vector<Feature> features;
+    while (features.size() < 4 && frames < removedAt + 100) {
+        test.runLoop.run();
+        features = query(belowOptions);
+    }
+
+    EXPECT_EQ(4u, features.size());
+    EXPECT_LE(frames, removedAt + 10);
+}
+
+TEST(Map, RenderAsync) {
+    // Reads go through pixel buffer objects, or are done synchronously when they are disabled.
+    for (const bool pixelBuffers : { true, false }) {
+        MapTest<> test;
+
+        gfx::BackendScope scope { *test.frontend.getBackend() };
+        auto& context = static_cast<gl::Context&>(test.frontend.getBackend()->getContext());
+        auto& backend = static_cast<gl::HeadlessBackend&>(*test.frontend.getBackend());
+        context.disablePixelBufferExtension = !pixelBuffers;
+        ASSERT_EQ(pixelBuffers, context.supportsPixelBuffers());
+
+        auto setBackground = [&](const char* color) {
+            test.map.getStyle().loadJSON(std::string(R"STYLE({
+              "version": 8,
+              "sources": {},
+              "layers": [{ "id": "background", "type": "background", "paint": { "background-color": ")STYLE") +
+                                         color + R"STYLE(" } }]
+            })STYLE");
+        };
+
+        std::vector<PremultipliedImage> images;
+        auto callback = [&](PremultipliedImage image) { images.push_back(std::move(image)); };
+
+        setBackground("red");
+        test.frontend.renderAsync(test.map, callback);
+        EXPECT_EQ(pixelBuffers ? 1u : 0u, backend.pendingPixelBufferReadCount());
+        setBackground("blue");
+        test.frontend.renderAsync(test.map, callback);
+        setBackground("lime");
+        test.frontend.renderAsync(test.map, callback);
+
+        // The last frame is still being read back.
+        EXPECT_EQ(2u, images.size());
+        EXPECT_EQ(pixelBuffers ? 1u : 0u, backend.pendingPixelBufferReadCount());
+        test.frontend.finishRendering();
+        ASSERT_EQ(3u, images.size());
+        EXPECT_EQ(0u, backend.pendingReadCount());
+
+        const std::vector<std::array<uint8_t, 4>> expected { { 255, 0, 0, 255 }, { 0, 0, 255, 255 }, { 0, 255, 0, 255 } };
+        for (size_t i = 0; i < images.size(); ++i) {
+            ASSERT_TRUE(images[i].valid());
+            const auto* pixel = images[i].data.get();
+            EXPECT_EQ(expected[i], (std::array<uint8_t, 4> { pixel[0], pixel[1], pixel[2], pixel[3] }));
+        }
+
+        // The images match the ones read synchronously.
+        setBackground("red");
+        EXPECT_TRUE(images[0] == test.frontend.render(test.map));
+    }
+}
+
 TEST(Map, WithoutVAOExtension) {
     MapTest<DefaultFileSource> test { ":memory:", "test/fixtures/api/assets" };
 
@@ -693,6 +973,100 @@ TEST(Map, DisabledSources) {
     test::checkImage("test/fixtures/map/disabled_layers/second", test.frontend.render(test.map));
 }
 
+TEST(Map, ParallelParsing) {
+    // Renders and queries a vector tile with several non-symbol layers, which are parsed in
+    // parallel or one after another.
+    auto renderAndQuery = [](bool parallel) {
+        GeometryTileWorker::setParallelParsing(parallel);
+        const std::size_t parallelGroups = GeometryTileWorker::getParallelParsedGroupCount();
+
+        MapTest<> test;
+        test.fileSource->tileResponse = [](const Resource&) {
+            Response res;
+            res.data = std::make_shared<std::string>(util::read_file("test/fixtures/api/assets/streets/10-163-395.vector.pbf"));
+            return res;
+        };
+        test.map.getStyle().loadJSON(R"STYLE({
+          "version": 8,
+          "sources": {
+            "streets": { "type": "vector", "tiles": [ "a/{z}/{x}/{y}" ], "minzoom": 10, "maxzoom": 10 }
+          },
+          "layers": [
+            { "id": "landuse", "type": "fill", "source": "streets", "source-layer": "landuse", "paint": { "fill-color": "green" } },
+            { "id": "landcover", "type": "fill", "source": "streets", "source-layer": "landcover", "paint": { "fill-color": "olive" } },
+            { "id": "water", "type": "fill", "source": "streets", "source-layer": "water", "paint": { "fill-color": "blue" } },
+            { "id": "waterway", "type": "line", "source": "streets", "source-layer": "waterway", "paint": { "line-color": "navy" } },
+            { "id": "road", "type": "line", "source": "streets", "source-layer": "road", "paint": { "line-color": "red" } },
+            { "id": "poi", "type": "circle", "source": "streets", "source-layer": "poi_label", "paint": { "circle-color": "black" } },
+            { "id": "places", "type": "heatmap", "source": "streets", "source-layer": "place_label" }
+          ]
+        })STYLE");
+        test.map.jumpTo(CameraOptions().withCenter(LatLng { 37.8575, -122.5195 }).withZoom(10));
+
+        PremultipliedImage image = test.frontend.render(test.map);
+        std::vector<Feature> features = test.frontend.getRenderer()->queryRenderedFeatures(
+            ScreenBox { { 0, 0 }, { 256, 256 } }, {});
+
+        // The fill and line groups go through a pattern layout, the circle and heatmap groups
+        // don't; either way they're parsed concurrently only if that is enabled.
+        if (parallel) {
+            EXPECT_LT(parallelGroups, GeometryTileWorker::getParallelParsedGroupCount());
+        } else {
+            EXPECT_EQ(parallelGroups, GeometryTileWorker::getParallelParsedGroupCount());
+        }
+        return std::make_pair(std::move(image), std::move(features));
+    };
+
+    const auto serial = renderAndQuery(false);
+    const auto parallel = renderAndQuery(true);
+
+    // The buckets draw the same image, and the feature indexes return the same features in the
+    // same order.
+    EXPECT_EQ(serial.first, parallel.first);
+    ASSERT_FALSE(serial.second.empty());
+    EXPECT_EQ(serial.second, parallel.second);
+}
+
+TEST(Map, ParallelQuery) {
+    // Queries four tiles that share their data, concurrently or one after another, with a box
+    // covering them and with a small box around their shared corner, like a hover query. The
+    // features only differ in their geometry, so a different tile order shows up.
+    auto query = [](std::size_t threshold) {
+        TilePyramid::setParallelQueryThreshold(threshold);
+
+        MapTest<> test;
+        test.fileSource->tileResponse = [](const Resource&) {
+            Response res;
+            res.data = std::make_shared<std::string>(util::read_file("test/fixtures/api/assets/streets/10-163-395.vector.pbf"));
+            return res;
+        };
+        test.map.getStyle().loadJSON(R"STYLE({
+          "version": 8,
+          "sources": {
+            "streets": { "type": "vector", "tiles": [ "a/{z}/{x}/{y}" ], "minzoom": 10, "maxzoom": 10 }
+          },
+          "layers": [
+            { "id": "water", "type": "fill", "source": "streets", "source-layer": "water", "paint": { "fill-color": "blue" } },
+            { "id": "road", "type": "line", "source": "streets", "source-layer": "road", "paint": { "line-color": "red" } }
+          ]
+        })STYLE");
+        test.map.jumpTo(CameraOptions().withCenter(LatLng { CanonicalTileID(10, 164, 396) }).withZoom(10));
+
+        test.frontend.render(test.map);
+        return std::make_pair(test.frontend.getRenderer()->queryRenderedFeatures(ScreenBox { { 0, 0 }, { 256, 256 } }, {}),
+                              test.frontend.getRenderer()->queryRenderedFeatures(ScreenBox { { 96, 96 }, { 160, 160 } }, {}));
+    };
+
+    const auto serial = query(std::numeric_limits<std::size_t>::max());
+    const auto parallel = query(TilePyramid::defaultParallelQueryThreshold);
+    TilePyramid::setParallelQueryThreshold(TilePyramid::defaultParallelQueryThreshold);
+
+    ASSERT_FALSE(serial.first.empty());
+    EXPECT_EQ(serial.first, parallel.first);
+    ASSERT_FALSE(serial.second.empty());
+    EXPECT_EQ(serial.second, parallel.second);
+}
+
 TEST(Map, DontLoadUnneededTiles) {
     MapTest<> test;
 
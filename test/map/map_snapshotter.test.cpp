@@ -0,0 +1,76 @@
+#ifndef __QT__ // The Qt port doesn't build the map snapshotter.
+
+#include <mbgl/test/util.hpp>
+
+#include <mbgl/actor/actor.hpp>
+#include <mbgl/actor/scheduler.hpp>
+#include <mbgl/map/camera.hpp>
+#include <mbgl/map/map_snapshotter.hpp>
+#include <mbgl/storage/resource_options.hpp>
+#include <mbgl/util/image.hpp>
+#include <mbgl/util/run_loop.hpp>
+#include <mbgl/util/string.hpp>
+
+using namespace mbgl;
+
+namespace {
+
+const std::string style = R"STYLE({
+  "version": 8,
+  "sources": {},
+  "layers": [{
+    "id": "background",
+    "type": "background",
+    "paint": { "background-color": "rgba(255, 0, 0, 0.5)" }
+  }]
+})STYLE";
+
+} // namespace
+
+TEST(MapSnapshotter, SnapshotPNG) {
+    util::RunLoop loop;
+
+    MapSnapshotter snapshotter({ true, style }, Size { 64, 32 }, 1, CameraOptions().withZoom(0), {}, {}, {},
+                               ResourceOptions().withCachePath(":memory:").withAssetPath("."));
+
+    PremultipliedImage expected;
+    std::size_t pending = 2;
+    std::unique_ptr<Actor<MapSnapshotter::PNGCallback>> pngCallback;
+
+    // The PNG decodes to the image that snapshot() returns, whether it is encoded as a single
+    // band or in parallel bands.
+    Actor<MapSnapshotter::Callback> callback(*Scheduler::GetCurrent(),
+        [&](std::exception_ptr error, PremultipliedImage image, MapSnapshotter::Attributions,
+            MapSnapshotter::PointForFn, MapSnapshotter::LatLngForFn) {
+            if (error) {
+                ADD_FAILURE() << util::toString(error);
+                loop.stop();
+                return;
+            }
+            EXPECT_EQ((Size { 64, 32 }), image.size);
+            expected = std::move(image);
+
+            pngCallback = std::make_unique<Actor<MapSnapshotter::PNGCallback>>(*Scheduler::GetCurrent(),
+                [&](std::exception_ptr pngError, std::string png, MapSnapshotter::Attributions,
+                     MapSnapshotter::PointForFn, MapSnapshotter::LatLngForFn) {
+                    if (pngError) {
+                        ADD_FAILURE() << util::toString(pngError);
+                    } else {
+                        EXPECT_EQ(expected, decodeImage(png));
+                    }
+                    if (--pending == 0) {
+                        loop.stop();
+                    }
+                });
+
+            PNGEncodeOptions bands;
+            bands.bandSize = 1024;
+            snapshotter.snapshotPNG(pngCallback->self());
+            snapshotter.snapshotPNG(pngCallback->self(), bands);
+        });
+
+    snapshotter.snapshot(callback.self());
+    loop.run();
+}
+
+#endif // __QT__
@@ -2,7 +2,10 @@
 #include <mbgl/test/util.hpp>
 #include <mbgl/storage/default_file_source.hpp>
 #include <mbgl/storage/resource_transform.hpp>
+#include <mbgl/storage/sqlite3.hpp>
+#include <mbgl/util/io.hpp>
 #include <mbgl/util/run_loop.hpp>
+#include <mbgl/util/timer.hpp>
 
 using namespace mbgl;
 
@@ -307,6 +310,86 @@ TEST(DefaultFileSource, OptionalExpired) {
     loop.run();
 }
 
+TEST(DefaultFileSource, TEST_REQUIRES_WRITE(OptionalFromCacheReader)) {
+    using namespace std::string_literals;
+    const std::string path = "test/fixtures/offline_database/cache_readers.db";
+    util::deleteFile(path);
+    util::deleteFile(path + "-wal"s);
+    util::deleteFile(path + "-shm"s);
+
+    util::RunLoop loop;
+    DefaultFileSource fs(path, ".");
+    fs.setCacheReaderCount(2);
+
+    const Resource optionalResource { Resource::Unknown, "http://127.0.0.1:3000/test", Resource::Priority::Regular, {}, Resource::LoadingMethod::CacheOnly };
+
+    using namespace std::chrono_literals;
+
+    Response response;
+    response.data = std::make_shared<std::string>("Cached value");
+    response.expires = util::now() + 1h;
+    fs.put(optionalResource, response);
+
+    std::unique_ptr<AsyncRequest> req;
+    req = fs.request(optionalResource, [&](Response res) {
+        req.reset();
+        EXPECT_EQ(nullptr, res.error);
+        ASSERT_TRUE(res.data.get());
+        EXPECT_EQ("Cached value", *res.data);
+        ASSERT_TRUE(bool(res.expires));
+        EXPECT_EQ(*response.expires, *res.expires);
+        loop.stop();
+    });
+
+    loop.run();
+}
+
+TEST(DefaultFileSource, TEST_REQUIRES_WRITE(FlushAccessedAfterRead)) {
+    const std::string path = "test/fixtures/offline_database/flush_accessed.db";
+    util::deleteFile(path);
+
+    util::RunLoop loop;
+    DefaultFileSource fs(path, ".");
+
+    const Resource optionalResource { Resource::Unknown, "http://127.0.0.1:3000/test", Resource::Priority::Regular, {}, Resource::LoadingMethod::CacheOnly };
+
+    using namespace std::chrono_literals;
+
+    Response response;
+    response.data = std::make_shared<std::string>("Cached value");
+    response.expires = util::now() + 1h;
+    fs.put(optionalResource, response);
+
+    auto accessed = [&] {
+        mapbox::sqlite::Database db = mapbox::sqlite::Database::open(path, mapbox::sqlite::ReadOnly);
+        mapbox::sqlite::Statement stmt{ db, "SELECT accessed FROM resources" };
+        mapbox::sqlite::Query query{ stmt };
+        query.run();
+        return query.get<int64_t>(0);
+    };
+
+    util::Timer timer;
+    std::unique_ptr<AsyncRequest> req;
+    req = fs.request(optionalResource, [&](Response) {
+        req.reset();
+        {
+            mapbox::sqlite::Database db = mapbox::sqlite::Database::open(path, mapbox::sqlite::ReadWriteCreate);
+            db.exec("UPDATE resources SET accessed = 0");
+        }
+        req = fs.request(optionalResource, [&](Response) {
+            req.reset();
+            // The reads only buffered their timestamps. They are written shortly afterwards,
+            // without waiting for another read.
+            timer.start(1500ms, Duration::zero(), [&] {
+                EXPECT_LT(0, accessed());
+                loop.stop();
+            });
+        });
+    });
+
+    loop.run();
+}
+
 TEST(DefaultFileSource, GetBaseURLAndAccessTokenWhilePaused) {
     util::RunLoop loop;
     DefaultFileSource fs(":memory:", ".");
@@ -127,7 +127,6 @@ TEST(OfflineDatabase, TEST_REQUIRES_WRITE(CreateFail)) {
     // We can also still "query" the database even though it is not open, and we will always get an empty result.
     for (const auto& res : { fixture::resource, fixture::tile }) {
         EXPECT_FALSE(bool(db.get(res)));
-        EXPECT_EQ(1u, log.count(warning(ResultCode::CantOpen, "Can't update timestamp: unable to open database file")));
         EXPECT_EQ(1u, log.count(warning(ResultCode::CantOpen, "Can't read resource: unable to open database file")));
         EXPECT_EQ(0u, log.uncheckedCount());
     }
@@ -144,12 +143,14 @@ TEST(OfflineDatabase, TEST_REQUIRES_WRITE(CreateFail)) {
     }
 
     // Next, set the file system to read only mode and try to read the data again. While we can't
-    // write anymore, we should still be able to read, and the query that tries to update the last
-    // accessed timestamp may fail without crashing.
+    // write anymore, we should still be able to read, and writing the buffered last accessed
+    // timestamps may fail without crashing.
     fs.allowFileCreate(false);
     fs.setWriteLimit(0);
     for (const auto& res : { fixture::resource, fixture::tile }) {
         auto result = db.get(res);
+        EXPECT_EQ(0u, log.uncheckedCount());
+        db.flushAccessed();
         EXPECT_EQ(1u, log.count(warning(ResultCode::CantOpen, "Can't update timestamp: unable to open database file")));
         EXPECT_EQ(0u, log.uncheckedCount());
 
@@ -165,6 +166,7 @@ TEST(OfflineDatabase, TEST_REQUIRES_WRITE(CreateFail)) {
     fs.setWriteLimit(8192);
     for (const auto& res : { fixture::resource, fixture::tile }) {
         auto result = db.get(res);
+        db.flushAccessed();
         EXPECT_EQ(1u, log.count(warning(ResultCode::Full, "Can't update timestamp: database or disk is full")));
         EXPECT_EQ(0u, log.uncheckedCount());
         ASSERT_TRUE(result && result->data);
@@ -178,7 +180,6 @@ TEST(OfflineDatabase, TEST_REQUIRES_WRITE(CreateFail)) {
     for (const auto& res : { fixture::resource, fixture::tile }) {
         // First, try reading.
         auto result = db.get(res);
-        EXPECT_EQ(1u, log.count(warning(ResultCode::Auth, "Can't update timestamp: authorization denied")));
         EXPECT_EQ(1u, log.count(warning(ResultCode::Auth, "Can't read resource: authorization denied")));
         EXPECT_EQ(0u, log.uncheckedCount());
         EXPECT_FALSE(result);
@@ -208,7 +209,7 @@ TEST(OfflineDatabase, TEST_REQUIRES_WRITE(SchemaVersion)) {
         OfflineDatabase db(filename);
     }
 
-    EXPECT_EQ(6, databaseUserVersion(filename));
+    EXPECT_EQ(7, databaseUserVersion(filename));
 
     OfflineDatabase db(filename);
     // Now try inserting and reading back to make sure we have a valid database.
@@ -668,20 +669,199 @@ TEST(OfflineDatabase, PutReturnsSize) {
     EXPECT_EQ(0u, log.uncheckedCount());
 }
 
-TEST(OfflineDatabase, PutEvictsLeastRecentlyUsedResources) {
+TEST(OfflineDatabase, PutDoesNotEvict) {
     FixtureLog log;
-    OfflineDatabase db(":memory:", 1024 * 100);
+    OfflineDatabase db(":memory:", 1024 * 150);
 
     Response response;
     response.data = randomString(1024);
 
-    for (uint32_t i = 1; i <= 100; i++) {
+    for (uint32_t i = 1; i <= 200; i++) {
         Resource resource = Resource::style("http://example.com/"s + util::toString(i));
-        db.put(resource, response);
+        EXPECT_TRUE(db.put(resource, response).first) << i;
         EXPECT_TRUE(bool(db.get(resource))) << i;
     }
 
+    // The cache exceeds its maximum size until maintenance evicts the least recently used resources.
+    EXPECT_TRUE(bool(db.get(Resource::style("http://example.com/1"))));
+    EXPECT_FALSE(db.runMaintenance(Seconds(10)));
+    EXPECT_FALSE(bool(db.get(Resource::style("http://example.com/2"))));
+    EXPECT_TRUE(bool(db.get(Resource::style("http://example.com/200"))));
+
+    EXPECT_EQ(0u, log.uncheckedCount());
+}
+
+TEST(OfflineDatabase, PutEvictsWhenFarOverBudget) {
+    FixtureLog log;
+    OfflineDatabase db(":memory:", 1024 * 100);
+
+    Response response;
+    response.data = randomString(1024);
+
+    // Without maintenance, puts evict once the cache exceeds its maximum size by half.
+    for (uint32_t i = 1; i <= 400; i++) {
+        EXPECT_TRUE(db.put(Resource::style("http://example.com/"s + util::toString(i)), response).first) << i;
+    }
+
+    uint32_t stored = 0;
+    for (uint32_t i = 1; i <= 400; i++) {
+        if (db.get(Resource::style("http://example.com/"s + util::toString(i)))) {
+            stored++;
+        }
+    }
+    EXPECT_LE(stored, 150u);
     EXPECT_FALSE(bool(db.get(Resource::style("http://example.com/1"))));
+    EXPECT_TRUE(bool(db.get(Resource::style("http://example.com/400"))));
+
+    EXPECT_EQ(0u, log.uncheckedCount());
+}
+
+static int64_t databaseTileAccessed(const std::string& path) {
+    mapbox::sqlite::Database db = mapbox::sqlite::Database::open(path, mapbox::sqlite::ReadOnly);
+    mapbox::sqlite::Statement stmt{ db, "SELECT accessed FROM tiles" };
+    mapbox::sqlite::Query query{ stmt };
+    query.run();
+    return query.get<int64_t>(0);
+}
+
+TEST(OfflineDatabase, TEST_REQUIRES_WRITE(GetBuffersAccessedTimestamps)) {
+    FixtureLog log;
+    deleteDatabaseFiles();
+
+    OfflineDatabase db(filename);
+    EXPECT_TRUE(db.put(fixture::tile, fixture::response).first);
+
+    {
+        mapbox::sqlite::Database other = mapbox::sqlite::Database::open(filename, mapbox::sqlite::ReadWriteCreate);
+        other.exec("UPDATE tiles SET accessed = 0");
+    }
+
+    // Reading the tile doesn't write to the database...
+    ASSERT_TRUE(bool(db.get(fixture::tile)));
+    EXPECT_EQ(0, databaseTileAccessed(filename));
+
+    // ...until the buffered timestamps are flushed.
+    db.flushAccessed();
+    EXPECT_LT(0, databaseTileAccessed(filename));
+
+    EXPECT_EQ(0u, log.uncheckedCount());
+}
+
+TEST(OfflineDatabase, TEST_REQUIRES_WRITE(CloseFlushesAccessedTimestamps)) {
+    FixtureLog log;
+    deleteDatabaseFiles();
+
+    {
+        OfflineDatabase db(filename);
+        EXPECT_TRUE(db.put(fixture::tile, fixture::response).first);
+
+        {
+            mapbox::sqlite::Database other = mapbox::sqlite::Database::open(filename, mapbox::sqlite::ReadWriteCreate);
+            other.exec("UPDATE tiles SET accessed = 0");
+        }
+
+        ASSERT_TRUE(bool(db.get(fixture::tile)));
+        EXPECT_EQ(0, databaseTileAccessed(filename));
+    }
+
+    EXPECT_LT(0, databaseTileAccessed(filename));
+
+    EXPECT_EQ(0u, log.uncheckedCount());
+}
+
+TEST(OfflineDatabase, GetTilesAcrossAntimeridian) {
+    FixtureLog log;
+    OfflineDatabase db(":memory:");
+
+    auto tile = [](int32_t x, int32_t y) {
+        return Resource::tile("mapbox://tile", 1, x, y, 3, Tileset::Scheme::XYZ);
+    };
+
+    for (int32_t x = 0; x < 8; ++x) {
+        Response response;
+        response.data = std::make_shared<std::string>(util::toString(x));
+        db.put(tile(x, 2), response);
+    }
+
+    // A cover around the antimeridian, read as two ranges of columns.
+    auto responses = db.getTiles({ tile(7, 2), tile(0, 2), tile(6, 2), tile(1, 2), tile(7, 3) });
+
+    ASSERT_EQ(5u, responses.size());
+    ASSERT_TRUE(responses[0] && responses[0]->data);
+    EXPECT_EQ("7", *responses[0]->data);
+    ASSERT_TRUE(responses[1] && responses[1]->data);
+    EXPECT_EQ("0", *responses[1]->data);
+    ASSERT_TRUE(responses[2] && responses[2]->data);
+    EXPECT_EQ("6", *responses[2]->data);
+    ASSERT_TRUE(responses[3] && responses[3]->data);
+    EXPECT_EQ("1", *responses[3]->data);
+    EXPECT_FALSE(bool(responses[4]));
+
+    EXPECT_EQ(0u, log.uncheckedCount());
+}
+
+TEST(OfflineDatabase, TEST_REQUIRES_WRITE(ReadOnlyConcurrentReads)) {
+    FixtureLog log;
+    deleteDatabaseFiles();
+
+    OfflineDatabase db(filename);
+    db.setConcurrentReads(true);
+    EXPECT_EQ("wal", databaseJournalMode(filename));
+
+    OfflineDatabase reader(filename, 0, OfflineDatabase::Mode::ReadOnly);
+    EXPECT_FALSE(bool(reader.get(fixture::resource)));
+
+    // The reader sees what the writer committed.
+    EXPECT_TRUE(db.put(fixture::resource, fixture::response).first);
+    auto result = reader.get(fixture::resource);
+    ASSERT_TRUE(result && result->data);
+    EXPECT_EQ("first", *result->data);
+
+    EXPECT_EQ(0u, log.uncheckedCount());
+}
+
+TEST(OfflineDatabase, GetTiles) {
+    FixtureLog log;
+    OfflineDatabase db(":memory:");
+
+    auto tile = [](int32_t x, int32_t y, int8_t z, const std::string& urlTemplate = "mapbox://tile") {
+        return Resource::tile(urlTemplate, 1, x, y, z, Tileset::Scheme::XYZ);
+    };
+
+    for (int32_t x = 0; x < 4; ++x) {
+        for (int32_t y = 0; y < 4; ++y) {
+            Response response;
+            response.data = std::make_shared<std::string>(util::toString(x) + "/" + util::toString(y));
+            db.put(tile(x, y, 2), response);
+        }
+    }
+
+    Response other;
+    other.data = std::make_shared<std::string>("other");
+    db.put(tile(0, 0, 2, "mapbox://other"), other);
+    db.put(fixture::resource, fixture::response);
+
+    auto responses = db.getTiles({
+        tile(3, 1, 2),
+        tile(0, 0, 2, "mapbox://other"),
+        tile(1, 2, 2),
+        tile(0, 0, 3),
+        fixture::resource,
+        tile(3, 1, 2),
+    });
+
+    ASSERT_EQ(6u, responses.size());
+    ASSERT_TRUE(responses[0] && responses[0]->data);
+    EXPECT_EQ("3/1", *responses[0]->data);
+    ASSERT_TRUE(responses[1] && responses[1]->data);
+    EXPECT_EQ("other", *responses[1]->data);
+    ASSERT_TRUE(responses[2] && responses[2]->data);
+    EXPECT_EQ("1/2", *responses[2]->data);
+    EXPECT_FALSE(bool(responses[3]));
+    ASSERT_TRUE(responses[4] && responses[4]->data);
+    EXPECT_EQ("first", *responses[4]->data);
+    ASSERT_TRUE(responses[5] && responses[5]->data);
+    EXPECT_EQ("3/1", *responses[5]->data);
 
     EXPECT_EQ(0u, log.uncheckedCount());
 }
@@ -711,7 +891,7 @@ TEST(OfflineDatabase, PutFailsWhenEvictionInsuffices) {
     OfflineDatabase db(":memory:", 1024 * 100);
 
     Response big;
-    big.data = randomString(1024 * 100);
+    big.data = randomString(1024 * 100 + 1);
 
     EXPECT_FALSE(db.put(Resource::style("http://example.com/big"), big).first);
 
@@ -723,6 +903,39 @@ TEST(OfflineDatabase, PutFailsWhenEvictionInsuffices) {
     EXPECT_EQ(0u, log.uncheckedCount());
 }
 
+TEST(OfflineDatabase, MaintenanceEvictsLeastRecentlyUsedResources) {
+    FixtureLog log;
+    OfflineDatabase db(":memory:", 1024 * 150);
+    OfflineTilePyramidRegionDefinition definition { "", LatLngBounds::world(), 0, INFINITY, 1.0, true };
+    auto region = db.createRegion(definition, OfflineRegionMetadata());
+    ASSERT_TRUE(region);
+
+    Response response;
+    response.data = randomString(1024);
+
+    db.putRegionResource(region->getID(), Resource::style("http://example.com/region"), response);
+
+    for (uint32_t i = 1; i <= 200; i++) {
+        EXPECT_TRUE(db.put(Resource::style("http://example.com/"s + util::toString(i)), response).first) << i;
+    }
+
+    EXPECT_FALSE(db.runMaintenance(Seconds(10)));
+
+    EXPECT_FALSE(bool(db.get(Resource::style("http://example.com/1"))));
+    EXPECT_TRUE(bool(db.get(Resource::style("http://example.com/200"))));
+    EXPECT_TRUE(bool(db.get(Resource::style("http://example.com/region"))));
+
+    // The region's resource becomes evictable once the region is deleted.
+    db.deleteRegion(std::move(*region));
+    for (uint32_t i = 201; i <= 260; i++) {
+        db.put(Resource::style("http://example.com/"s + util::toString(i)), response);
+    }
+    EXPECT_FALSE(db.runMaintenance(Seconds(10)));
+    EXPECT_FALSE(bool(db.get(Resource::style("http://example.com/region"))));
+
+    EXPECT_EQ(0u, log.uncheckedCount());
+}
+
 TEST(OfflineDatabase, GetRegionCompletedStatus) {
     FixtureLog log;
     OfflineDatabase db(":memory:");
@@ -954,7 +1167,7 @@ TEST(OfflineDatabase, MigrateFromV2Schema) {
         }
     }
 
-    EXPECT_EQ(6, databaseUserVersion(filename));
+    EXPECT_EQ(7, databaseUserVersion(filename));
     EXPECT_LT(databasePageCount(filename),
               databasePageCount("test/fixtures/offline_database/v2.db"));
 
@@ -975,7 +1188,7 @@ TEST(OfflineDatabase, MigrateFromV3Schema) {
         }
     }
 
-    EXPECT_EQ(6, databaseUserVersion(filename));
+    EXPECT_EQ(7, databaseUserVersion(filename));
 
     EXPECT_EQ(0u, log.uncheckedCount());
 }
@@ -994,7 +1207,7 @@ TEST(OfflineDatabase, MigrateFromV4Schema) {
         }
     }
 
-    EXPECT_EQ(6, databaseUserVersion(filename));
+    EXPECT_EQ(7, databaseUserVersion(filename));
 
     // Journal mode should be DELETE after migration to v5.
     EXPECT_EQ("delete", databaseJournalMode(filename));
@@ -1020,15 +1233,16 @@ TEST(OfflineDatabase, MigrateFromV5Schema) {
         }
     }
 
-    EXPECT_EQ(6, databaseUserVersion(filename));
+    EXPECT_EQ(7, databaseUserVersion(filename));
 
     EXPECT_EQ((std::vector<std::string>{ "id", "url_template", "pixel_ratio", "z", "x", "y",
                                          "expires", "modified", "etag", "data", "compressed",
-                                         "accessed", "must_revalidate" }),
+                                         "accessed", "must_revalidate", "evictable" }),
               databaseTableColumns(filename, "tiles"));
     EXPECT_EQ((std::vector<std::string>{ "id", "url", "kind", "expires", "modified", "etag", "data",
-                                         "compressed", "accessed", "must_revalidate" }),
+                                         "compressed", "accessed", "must_revalidate", "evictable" }),
               databaseTableColumns(filename, "resources"));
+    EXPECT_EQ((std::vector<std::string>{ "key", "value" }), databaseTableColumns(filename, "metadata"));
 
     EXPECT_EQ(0u, log.uncheckedCount());
 }
@@ -1044,14 +1258,14 @@ TEST(OfflineDatabase, DowngradeSchema) {
         OfflineDatabase db(filename, 0);
     }
 
-    EXPECT_EQ(6, databaseUserVersion(filename));
+    EXPECT_EQ(7, databaseUserVersion(filename));
 
     EXPECT_EQ((std::vector<std::string>{ "id", "url_template", "pixel_ratio", "z", "x", "y",
                                          "expires", "modified", "etag", "data", "compressed",
-                                         "accessed", "must_revalidate" }),
+                                         "accessed", "must_revalidate", "evictable" }),
               databaseTableColumns(filename, "tiles"));
     EXPECT_EQ((std::vector<std::string>{ "id", "url", "kind", "expires", "modified", "etag", "data",
-                                         "compressed", "accessed", "must_revalidate" }),
+                                         "compressed", "accessed", "must_revalidate", "evictable" }),
               databaseTableColumns(filename, "resources"));
 
     EXPECT_EQ(1u, log.count({ EventSeverity::Warning, Event::Database, -1, "Removing existing incompatible offline database" }));
@@ -1129,7 +1343,6 @@ TEST(OfflineDatabase, TEST_REQUIRES_WRITE(DisallowedIO)) {
     fs.allowIO(false);
 
     EXPECT_EQ(nullopt, db.get(fixture::resource));
-    EXPECT_EQ(1u, log.count(warning(ResultCode::Auth, "Can't update timestamp: authorization denied")));
     EXPECT_EQ(1u, log.count(warning(ResultCode::Auth, "Can't read resource: authorization denied")));
     EXPECT_EQ(0u, log.uncheckedCount());
 
@@ -1150,7 +1363,6 @@ TEST(OfflineDatabase, TEST_REQUIRES_WRITE(DisallowedIO)) {
     EXPECT_EQ(0u, log.uncheckedCount());
 
     EXPECT_EQ(nullopt, db.getRegionResource(region->getID(), fixture::resource));
-    EXPECT_EQ(1u, log.count(warning(ResultCode::Auth, "Can't update timestamp: authorization denied")));
     EXPECT_EQ(1u, log.count(warning(ResultCode::Auth, "Can't read region resource: authorization denied")));
     EXPECT_EQ(0u, log.uncheckedCount());
 
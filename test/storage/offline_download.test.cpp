@@ -641,6 +641,57 @@ TEST(OfflineDownload, WithPreviouslyExistingTile) {
     test.loop.run();
 }
 
+TEST(OfflineDownload, WithPreviouslyExistingTileFromCacheLookup) {
+    OfflineTest test;
+    auto region = test.createRegion();
+    ASSERT_TRUE(region);
+    OfflineDownload download(
+        region->getID(),
+        OfflineTilePyramidRegionDefinition("http://127.0.0.1:3000/style.json", LatLngBounds::world(), 0.0, 0.0, 1.0, false),
+        test.db, test.fileSource);
+
+    test.fileSource.styleResponse = [&] (const Resource& resource) {
+        EXPECT_EQ("http://127.0.0.1:3000/style.json", resource.url);
+        return test.response("inline_source.style.json");
+    };
+
+    test.db.put(
+        Resource::tile("http://127.0.0.1:3000/{z}-{x}-{y}.vector.pbf", 1, 0, 0, 0, Tileset::Scheme::XYZ),
+        test.response("0-0-0.vector.pbf"));
+
+    // The tile is looked up through the cache lookup, which answers asynchronously.
+    std::size_t lookups = 0;
+    download.setCacheLookup([&] (const Resource& resource, std::function<void (optional<int64_t>)> callback) {
+        lookups++;
+        return util::RunLoop::Get()->invokeCancellable([&test, resource, callback] {
+            callback(test.db.has(resource));
+        });
+    });
+
+    auto observer = std::make_unique<MockObserver>();
+
+    observer->statusChangedFn = [&] (OfflineRegionStatus status) {
+        if (status.complete()) {
+            EXPECT_EQ(2u, status.completedResourceCount);
+            EXPECT_EQ(1u, status.completedTileCount);
+            EXPECT_EQ(test.size, status.completedResourceSize);
+            test.loop.stop();
+        }
+    };
+
+    download.setObserver(std::move(observer));
+    download.setState(OfflineRegionDownloadState::Active);
+
+    test.loop.run();
+
+    EXPECT_EQ(1u, lookups);
+
+    // The tile that the lookup found is now part of the region.
+    auto completedStatus = test.db.getRegionCompletedStatus(region->getID());
+    ASSERT_TRUE(completedStatus);
+    EXPECT_EQ(1u, completedStatus->completedTileCount);
+}
+
 TEST(OfflineDownload, ReactivatePreviouslyCompletedDownload) {
     OfflineTest test;
     auto region = test.createRegion();
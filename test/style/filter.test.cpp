@@ -32,8 +32,14 @@ bool filter(const char * json,
     
     StubGeometryTileFeature feature { featureId, featureType, featureGeometry, featureProperties };
     expression::EvaluationContext context = { zoom, &feature };
-    
-    return (*filter)(context);
+
+    // Filters may be evaluated by a compiled form; it must agree with the expression tree.
+    const bool result = (*filter)(context);
+    if (filter->expression) {
+        const expression::EvaluationResult tree = (**filter->expression).evaluate(context);
+        EXPECT_EQ(tree && tree->is<bool>() && tree->get<bool>(), result) << json;
+    }
+    return result;
 }
 
 void invalidFilter(const char * json) {
@@ -209,6 +215,38 @@ TEST(Filter, PropertyExpression) {
     ASSERT_FALSE(filter("[\"==\", [\"get\", \"two\"], 4]", {{"two", int64_t(2)}}));
 }
 
+TEST(Filter, NotEqualsExpression) {
+    ASSERT_FALSE(filter(R"(["!=", ["get", "foo"], "bar"])", {{ "foo", std::string("bar") }}));
+    ASSERT_TRUE(filter(R"(["!=", ["get", "foo"], "bar"])", {{ "foo", std::string("baz") }}));
+    ASSERT_TRUE(filter(R"(["!=", ["get", "foo"], "bar"])"));
+    ASSERT_TRUE(filter(R"(["==", ["get", "foo"], null])"));
+    ASSERT_FALSE(filter(R"(["!=", "bar", ["get", "foo"]])", {{ "foo", std::string("bar") }}));
+}
+
+TEST(Filter, MatchExpression) {
+    auto f = R"(["match", ["get", "class"], ["wood", "grass"], true, "scrub", true, false])";
+    ASSERT_TRUE(filter(f, {{ "class", std::string("wood") }}));
+    ASSERT_TRUE(filter(f, {{ "class", std::string("scrub") }}));
+    ASSERT_FALSE(filter(f, {{ "class", std::string("sand") }}));
+    ASSERT_FALSE(filter(f, {{ "class", int64_t(1) }}));
+    ASSERT_FALSE(filter(f));
+
+    f = R"(["match", ["get", "rank"], [1, 2], false, true])";
+    ASSERT_FALSE(filter(f, {{ "rank", int64_t(1) }}));
+    ASSERT_FALSE(filter(f, {{ "rank", double(2) }}));
+    ASSERT_TRUE(filter(f, {{ "rank", double(1.5) }}));
+    ASSERT_TRUE(filter(f, {{ "rank", std::string("1") }}));
+    ASSERT_TRUE(filter(f));
+}
+
+TEST(Filter, ZoomComparison) {
+    ASSERT_TRUE(filter(R"([">=", ["zoom"], 10])", {{}}, {}, FeatureType::Point, {}, 10.0f));
+    ASSERT_FALSE(filter(R"([">=", ["zoom"], 10])", {{}}, {}, FeatureType::Point, {}, 9.5f));
+    ASSERT_TRUE(filter(R"([">", 10, ["zoom"]])", {{}}, {}, FeatureType::Point, {}, 9.5f));
+    ASSERT_TRUE(filter(R"(["all", ["<", ["zoom"], 12], ["has", "foo"]])", {{ "foo", int64_t(1) }}, {}, FeatureType::Point, {}, 11.0f));
+    ASSERT_FALSE(filter(R"(["all", ["<", ["zoom"], 12], ["has", "foo"]])", {{ "foo", int64_t(1) }}, {}, FeatureType::Point, {}, 12.0f));
+}
+
 TEST(Filter, LegacyProperty) {
     ASSERT_TRUE(filter("[\"<=\", \"two\", 2]", {{"two", int64_t(2)}}));
     ASSERT_FALSE(filter("[\"==\", \"two\", 4]", {{"two", int64_t(2)}}));
@@ -68,6 +68,7 @@ public:
         annotationManager,
         imageManager,
         glyphManager,
+        0,
         0
     };
 
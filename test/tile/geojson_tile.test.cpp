@@ -39,6 +39,7 @@ public:
         annotationManager,
         imageManager,
         glyphManager,
+        0,
         0
     };
 };
@@ -34,6 +34,7 @@ public:
         annotationManager,
         imageManager,
         glyphManager,
+        0,
         0
     };
 };
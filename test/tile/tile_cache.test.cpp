@@ -0,0 +1,140 @@
+#include <mbgl/test/util.hpp>
+
+#include <mbgl/tile/tile_cache.hpp>
+
+using namespace mbgl;
+
+namespace {
+
+class FakeTile : public Tile {
+public:
+    FakeTile(const OverscaledTileID& id_, std::size_t tileBytes_ = 0)
+        : Tile(Kind::Geometry, id_), tileBytes(tileBytes_) {
+        renderable = true;
+    }
+
+    void upload(gfx::UploadPass&) override {}
+    Bucket* getBucket(const style::Layer::Impl&) const override { return nullptr; }
+    std::size_t bytes() const override { return tileBytes; }
+
+    std::size_t tileBytes;
+};
+
+std::unique_ptr<Tile> makeTile(uint32_t x, std::size_t bytes = 0) {
+    return std::make_unique<FakeTile>(OverscaledTileID { 4, x, 0 }, bytes);
+}
+
+} // namespace
+
+TEST(TileCache, EvictsLeastRecentlyAdded) {
+    TileCache cache(2);
+    cache.add({ 4, 0, 0 }, makeTile(0));
+    cache.add({ 4, 1, 0 }, makeTile(1));
+    cache.add({ 4, 2, 0 }, makeTile(2));
+
+    EXPECT_FALSE(cache.has({ 4, 0, 0 }));
+    EXPECT_TRUE(cache.has({ 4, 1, 0 }));
+    EXPECT_TRUE(cache.has({ 4, 2, 0 }));
+    EXPECT_EQ(1u, cache.getStats().evictions);
+
+    // Re-adding a tile makes it the newest.
+    cache.add({ 4, 1, 0 }, makeTile(1));
+    cache.add({ 4, 3, 0 }, makeTile(3));
+    EXPECT_TRUE(cache.has({ 4, 1, 0 }));
+    EXPECT_FALSE(cache.has({ 4, 2, 0 }));
+    EXPECT_TRUE(cache.has({ 4, 3, 0 }));
+
+    cache.setSize(1);
+    EXPECT_FALSE(cache.has({ 4, 1, 0 }));
+    EXPECT_TRUE(cache.has({ 4, 3, 0 }));
+    EXPECT_EQ(3u, cache.getStats().evictions);
+}
+
+TEST(TileCache, PopCountsHitsAndMisses) {
+    TileCache cache(4);
+    cache.add({ 4, 0, 0 }, makeTile(0));
+
+    EXPECT_TRUE(cache.pop({ 4, 0, 0 }));
+    EXPECT_FALSE(cache.pop({ 4, 0, 0 }));
+    EXPECT_FALSE(cache.has({ 4, 0, 0 }));
+    EXPECT_EQ(1u, cache.getStats().hits);
+    EXPECT_EQ(1u, cache.getStats().misses);
+    EXPECT_EQ(0u, cache.getStats().evictions);
+}
+
+TEST(TileCache, ByteBudget) {
+    TileCache cache(10);
+    cache.setMaxBytes(100);
+
+    cache.add({ 4, 0, 0 }, makeTile(0, 40));
+    cache.add({ 4, 1, 0 }, makeTile(1, 40));
+    EXPECT_EQ(80u, cache.getBytes());
+
+    // A large tile pushes out the oldest ones until the cache fits the budget again.
+    cache.add({ 4, 2, 0 }, makeTile(2, 50));
+    EXPECT_FALSE(cache.has({ 4, 0, 0 }));
+    EXPECT_TRUE(cache.has({ 4, 1, 0 }));
+    EXPECT_TRUE(cache.has({ 4, 2, 0 }));
+    EXPECT_EQ(90u, cache.getBytes());
+
+    cache.pop({ 4, 1, 0 });
+    EXPECT_EQ(50u, cache.getBytes());
+
+    cache.setMaxBytes(10);
+    EXPECT_FALSE(cache.has({ 4, 2, 0 }));
+    EXPECT_EQ(0u, cache.getBytes());
+
+    cache.setMaxBytes(0);
+    cache.add({ 4, 3, 0 }, makeTile(3, 1000));
+    EXPECT_TRUE(cache.has({ 4, 3, 0 }));
+
+    cache.clear();
+    EXPECT_EQ(0u, cache.getBytes());
+}
+
+TEST(TileCache, UpdateBytes) {
+    TileCache cache(10);
+    cache.setMaxBytes(100);
+
+    auto tile = std::make_unique<FakeTile>(OverscaledTileID { 4, 0, 0 }, 40);
+    FakeTile& cached = *tile;
+    cache.add({ 4, 0, 0 }, std::move(tile));
+    cache.add({ 4, 1, 0 }, makeTile(1, 40));
+    EXPECT_EQ(80u, cache.getStats().bytes);
+
+    // A cached tile that grew is only accounted for once it's measured again.
+    cached.tileBytes = 70;
+    EXPECT_EQ(80u, cache.getBytes());
+    cache.updateBytes(cached);
+    EXPECT_EQ(110u, cache.getBytes());
+
+    // Tiles that aren't cached don't count.
+    FakeTile uncached(OverscaledTileID { 4, 0, 0 }, 1000);
+    cache.updateBytes(uncached);
+    EXPECT_EQ(110u, cache.getBytes());
+
+    // Measuring doesn't evict; the next change to the cache does.
+    EXPECT_TRUE(cache.has({ 4, 0, 0 }));
+    cache.setMaxBytes(100);
+    EXPECT_FALSE(cache.has({ 4, 0, 0 }));
+    EXPECT_TRUE(cache.has({ 4, 1, 0 }));
+    EXPECT_EQ(40u, cache.getBytes());
+    EXPECT_EQ(1u, cache.getStats().evictions);
+}
+
+TEST(TileCache, AddKeepsExistingTile) {
+    TileCache cache(2);
+    auto tile = makeTile(0, 10);
+    Tile* existing = tile.get();
+    cache.add({ 4, 0, 0 }, std::move(tile));
+    cache.add({ 4, 1, 0 }, makeTile(1, 10));
+
+    // The tile that is already cached stays, but counts as the most recently added.
+    cache.add({ 4, 0, 0 }, makeTile(0, 20));
+    EXPECT_EQ(existing, cache.get({ 4, 0, 0 }));
+    EXPECT_EQ(20u, cache.getBytes());
+
+    cache.add({ 4, 2, 0 }, makeTile(2));
+    EXPECT_TRUE(cache.has({ 4, 0, 0 }));
+    EXPECT_FALSE(cache.has({ 4, 1, 0 }));
+}
@@ -4,6 +4,7 @@
 #include <mbgl/tile/vector_tile_data.hpp>
 #include <mbgl/tile/tile_loader_impl.hpp>
 
+#include <mbgl/util/constants.hpp>
 #include <mbgl/util/run_loop.hpp>
 #include <mbgl/map/transform.hpp>
 #include <mbgl/style/style.hpp>
@@ -40,6 +41,7 @@ public:
         annotationManager,
         imageManager,
         glyphManager,
+        0,
         0
     };
 };
@@ -104,3 +106,98 @@ TEST(VectorTileData, ParseResults) {
 
     ASSERT_EQ(feature->getValue("invalid"), nullopt);
 }
+
+TEST(VectorTileData, ForEachFeature) {
+    VectorTileData data(std::make_shared<std::string>(util::read_file("test/fixtures/map/issue12432/0-0-0.mvt")));
+
+    for (const auto& name : data.layerNames()) {
+        std::unique_ptr<GeometryTileLayer> layer = data.getLayer(name);
+        ASSERT_TRUE(layer);
+
+        // Decoding into a reused collection yields the same geometry as getGeometries().
+        std::size_t count = 0;
+        GeometryCollection geometries;
+        layer->forEachFeature([&](std::size_t i, const GeometryTileFeature& feature) {
+            EXPECT_EQ(count++, i);
+            EXPECT_EQ(layer->getFeature(i)->getType(), feature.getType());
+
+            feature.decodeGeometries(geometries);
+            EXPECT_EQ(feature.getGeometries(), geometries);
+            return true;
+        });
+        EXPECT_EQ(layer->featureCount(), count);
+
+        // Returning false stops the iteration.
+        count = 0;
+        layer->forEachFeature([&](std::size_t, const GeometryTileFeature&) {
+            return ++count < 10;
+        });
+        EXPECT_EQ(10u, count);
+    }
+}
+
+TEST(VectorTileData, Features) {
+    for (const char* path : { "test/fixtures/api/assets/streets/10-163-395.vector.pbf", "test/fixtures/map/issue12432/0-0-0.mvt" }) {
+        auto data = std::make_shared<std::string>(util::read_file(path));
+        VectorTileData tile(data);
+        const auto layers = mapbox::vector_tile::buffer(*data).getLayers();
+
+        for (const auto& name : tile.layerNames()) {
+            std::unique_ptr<GeometryTileLayer> layer = tile.getLayer(name);
+            ASSERT_TRUE(layer);
+            EXPECT_EQ(name, layer->getName());
+
+            // Features read the same as through the vector tile library.
+            const mapbox::vector_tile::layer expected(layers.at(name));
+            ASSERT_EQ(expected.featureCount(), layer->featureCount());
+            GeometryCollection geometries;
+            layer->forEachFeature([&](std::size_t i, const GeometryTileFeature& feature) {
+                const mapbox::vector_tile::feature expectedFeature(expected.getFeature(i), expected);
+                EXPECT_EQ(FeatureType(expectedFeature.getType()), feature.getType());
+                EXPECT_EQ(expectedFeature.getID(), feature.getID());
+                EXPECT_EQ(expectedFeature.getProperties(), feature.getProperties());
+
+                // Keys are resolved once per layer, and looked up by index afterwards.
+                for (const auto& property : expectedFeature.getProperties()) {
+                    EXPECT_EQ(property.second, *feature.getValue(property.first));
+                }
+                EXPECT_FALSE(feature.getValue("no such key"));
+
+                // Geometries are scaled to the tile extent, and version 1 polygons are fixed up.
+                const float scale = float(util::EXTENT) / expectedFeature.getExtent();
+                GeometryCollection expectedGeometries = expectedFeature.getGeometries<GeometryCollection>(scale);
+                if (expectedFeature.getVersion() < 2 && expectedFeature.getType() == mapbox::vector_tile::GeomType::POLYGON) {
+                    expectedGeometries = fixupPolygons(expectedGeometries);
+                }
+                feature.decodeGeometries(geometries);
+                EXPECT_EQ(expectedGeometries, geometries);
+                return true;
+            });
+        }
+    }
+}
+
+TEST(VectorTileData, RequiredLayerFields) {
+    // Like the vector tile library, layers without a version or extent are rejected. Layers
+    // without a name aren't listed in the first place.
+    auto tile = [](const std::string& layer) {
+        return std::make_shared<std::string>(std::string("\x1a", 1) + char(layer.size()) + layer);
+    };
+    auto error = [](std::shared_ptr<std::string> data) -> std::string {
+        try {
+            VectorTileData(data).getLayer("a");
+        } catch (const std::runtime_error& e) {
+            return e.what();
+        }
+        return "";
+    };
+
+    const std::string name("\x0a\x01" "a", 3);
+    const std::string extent("\x28\x80\x20", 3);
+    const std::string version("\x78\x02", 2);
+
+    EXPECT_TRUE(VectorTileData(tile(name + extent + version)).getLayer("a"));
+    EXPECT_EQ("missing required field: version", error(tile(name + extent)));
+    EXPECT_EQ("missing required field: extent", error(tile(name + version)));
+    EXPECT_FALSE(VectorTileData(tile(extent + version)).getLayer("a"));
+}
@@ -3,6 +3,8 @@
 
 #include <mbgl/test/util.hpp>
 
+#include <algorithm>
+
 using namespace mbgl;
 
 TEST(GridIndex, IndexesFeatures) {
@@ -51,3 +53,49 @@ TEST(GridIndex, CircleBox) {
     EXPECT_EQ(grid.query({{0, 80}, {20, 100}}), (std::vector<int16_t>{2}));
 }
 
+TEST(GridIndex, HitTestPredicate) {
+    GridIndex<int16_t> grid(100, 100, 10);
+    grid.insert(0, {{10, 10}, {20, 20}});
+    grid.insert(1, {{50, 50}, 10});
+
+    auto isOne = [](int16_t key) { return key == 1; };
+    EXPECT_FALSE(grid.hitTest({{15, 15}, {16, 16}}, isOne));
+    EXPECT_TRUE(grid.hitTest({{15, 15}, {16, 16}}));
+    EXPECT_TRUE(grid.hitTest({{45, 45}, {55, 55}}, isOne));
+    EXPECT_FALSE(grid.hitTest({{15, 15}, 2}, isOne));
+    EXPECT_TRUE(grid.hitTest({{55, 55}, 2}, isOne));
+}
+
+TEST(GridIndex, InterleavedInsertAndQuery) {
+    // Enough items to be merged into the flat cell arrays a few times, with queries in between.
+    GridIndex<int16_t> grid(100, 100, 10);
+    std::vector<int16_t> all;
+    for (int16_t i = 0; i < 500; ++i) {
+        const float x = (i * 37) % 100;
+        const float y = (i * 61) % 100;
+        if (i % 2) {
+            grid.insert(int16_t(i), {{x, y}, {x + 15, y + 5}});
+        } else {
+            grid.insert(int16_t(i), {{x, y}, 4});
+        }
+
+        // Every item is reported once, boxes before circles, each in insertion order.
+        std::vector<int16_t> boxes;
+        std::vector<int16_t> circles;
+        for (int16_t j = 0; j <= i; ++j) {
+            (j % 2 ? boxes : circles).push_back(j);
+        }
+        all = boxes;
+        all.insert(all.end(), circles.begin(), circles.end());
+        ASSERT_EQ(grid.query({{-1, -1}, {101, 101}}), all);
+
+        std::vector<int16_t> found = grid.query({{0, 0}, {99, 99}});
+        ASSERT_EQ(found.size(), all.size());
+        std::sort(found.begin(), found.end());
+        ASSERT_TRUE(std::adjacent_find(found.begin(), found.end()) == found.end());
+    }
+
+    grid.compact();
+    EXPECT_EQ(grid.query({{-1, -1}, {101, 101}}), all);
+    EXPECT_EQ(grid.query({{0, 0}, {99, 99}}).size(), all.size());
+}
@@ -4,6 +4,9 @@
 #include <mbgl/util/image.hpp>
 #include <mbgl/util/io.hpp>
 
+#include <algorithm>
+#include <vector>
+
 using namespace mbgl;
 
 TEST(Image, PNGRoundTrip) {
@@ -34,6 +37,29 @@ TEST(Image, PNGRoundTripAlpha) {
     EXPECT_EQ(128, image.data[3]);
 }
 
+TEST(Image, PNGRoundTripOptions) {
+    // Tall enough to be split into several bands, and opaque so that unpremultiplying is lossless.
+    PremultipliedImage rgba({ 67, 301 });
+    for (size_t i = 0; i < rgba.bytes(); i += 4) {
+        const size_t pixel = i / 4;
+        rgba.data[i + 0] = pixel % 251;
+        rgba.data[i + 1] = (pixel / 7) % 256;
+        rgba.data[i + 2] = (pixel * 13) % 200;
+        rgba.data[i + 3] = 255;
+    }
+
+    using Filter = PNGEncodeOptions::Filter;
+    for (const auto filter : { Filter::None, Filter::Sub, Filter::Up, Filter::Average, Filter::Paeth, Filter::Adaptive }) {
+        for (const size_t bandSize : { size_t(0), size_t(1000), size_t(128 * 1024) }) {
+            PNGEncodeOptions options;
+            options.filter = filter;
+            options.bandSize = bandSize;
+            options.compressionLevel = 9;
+            EXPECT_TRUE(rgba == decodeImage(encodePNG(rgba, options)));
+        }
+    }
+}
+
 TEST(Image, PNGReadNoProfile) {
     PremultipliedImage image = decodeImage(util::read_file("test/fixtures/image/no_profile.png"));
     EXPECT_EQ(128, image.data[0]);
@@ -78,6 +104,42 @@ TEST(Image, JPEGTile) {
     EXPECT_EQ(256u, image.size.height);
 }
 
+TEST(Image, DecodeRows) {
+    // Hands out one reused row and collects the rows as they are finished.
+    class RowTarget : public ImageDecodeTarget {
+    public:
+        void begin(Size size_) override {
+            size = size_;
+            current.resize(size.width * 4);
+        }
+
+        uint8_t* row(uint32_t y) override {
+            EXPECT_EQ(rows.size() / (size.width * 4), y);
+            return current.data();
+        }
+
+        void endRow(uint32_t) override {
+            rows.insert(rows.end(), current.begin(), current.end());
+        }
+
+        Size size;
+        std::vector<uint8_t> current;
+        std::vector<uint8_t> rows;
+    };
+
+    for (const auto& path : { "test/fixtures/image/tile.png", "test/fixtures/image/tile.jpeg",
+                              "test/fixtures/image/profile_alpha.png" }) {
+        const std::string data = util::read_file(path);
+        const PremultipliedImage image = decodeImage(data);
+
+        RowTarget target;
+        decodeImage(data, target);
+        EXPECT_EQ(image.size, target.size) << path;
+        ASSERT_EQ(image.bytes(), target.rows.size()) << path;
+        EXPECT_TRUE(std::equal(target.rows.begin(), target.rows.end(), image.data.get())) << path;
+    }
+}
+
 TEST(Image, Resize) {
     AlphaImage image({0, 0});
 
@@ -155,3 +217,30 @@ TEST(Image, Premultiply) {
     EXPECT_EQ(0u, rgba.size.width);
     EXPECT_EQ(0u, rgba.size.height);
 }
+
+TEST(Image, SwapRedBlue) {
+    PremultipliedImage image({ 1, 1 });
+    image.data[0] = 1;
+    image.data[1] = 2;
+    image.data[2] = 3;
+    image.data[3] = 4;
+
+    util::swapRedBlue(image);
+    EXPECT_EQ(3, image.data[0]);
+    EXPECT_EQ(2, image.data[1]);
+    EXPECT_EQ(1, image.data[2]);
+    EXPECT_EQ(4, image.data[3]);
+}
+
+TEST(Image, ExpandAlpha) {
+    AlphaImage alpha({ 2, 1 });
+    alpha.data[0] = 0;
+    alpha.data[1] = 200;
+
+    PremultipliedImage image = util::expandAlpha(alpha);
+    EXPECT_EQ(Size(2, 1), image.size);
+    for (size_t i = 0; i < 4; ++i) {
+        EXPECT_EQ(0, image.data[i]);
+        EXPECT_EQ(200, image.data[4 + i]);
+    }
+}
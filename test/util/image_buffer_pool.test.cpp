@@ -0,0 +1,109 @@
+#include <mbgl/test/util.hpp>
+
+#include <mbgl/util/image.hpp>
+#include <mbgl/util/image_buffer_pool.hpp>
+
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+using namespace mbgl;
+using namespace mbgl::util;
+
+TEST(ImageBufferPool, SizeClass) {
+    EXPECT_EQ(0u, ImageBufferPool::sizeClass(0));
+    EXPECT_EQ(0u, ImageBufferPool::sizeClass(4096));
+    EXPECT_EQ(5120u, ImageBufferPool::sizeClass(4097));
+    EXPECT_EQ(8192u, ImageBufferPool::sizeClass(8192));
+    EXPECT_EQ(256u * 1024, ImageBufferPool::sizeClass(256 * 256 * 4));
+    // A 256px DEM tile with its border lands in the first class above 256 KiB.
+    EXPECT_EQ(320u * 1024, ImageBufferPool::sizeClass(258 * 258 * 4));
+    EXPECT_EQ(64u * 1024 * 1024, ImageBufferPool::sizeClass(64 * 1024 * 1024));
+    EXPECT_EQ(0u, ImageBufferPool::sizeClass(64 * 1024 * 1024 + 1));
+}
+
+TEST(ImageBufferPool, Reuse) {
+    ImageBufferPool pool;
+
+    uint8_t* first;
+    {
+        auto buffer = pool.allocate(100000);
+        first = buffer.get();
+        std::fill(first, first + 100000, 0xFF);
+    }
+    EXPECT_EQ(1u, pool.getStats().pooledBuffers);
+    EXPECT_EQ(ImageBufferPool::sizeClass(100000), pool.getStats().pooledBytes);
+
+    // A similar size reuses the buffer, and zeroes the requested range.
+    auto buffer = pool.allocate(99000);
+    EXPECT_EQ(first, buffer.get());
+    EXPECT_TRUE(std::all_of(buffer.get(), buffer.get() + 99000, [](uint8_t v) { return v == 0; }));
+
+    const auto stats = pool.getStats();
+    EXPECT_EQ(1u, stats.hits);
+    EXPECT_EQ(1u, stats.misses);
+    EXPECT_EQ(0u, stats.pooledBuffers);
+    EXPECT_EQ(0u, stats.pooledBytes);
+}
+
+TEST(ImageBufferPool, Unpooled) {
+    ImageBufferPool pool;
+    pool.allocate(1024);
+    pool.allocate(128 * 1024 * 1024, false);
+
+    const auto stats = pool.getStats();
+    EXPECT_EQ(0u, stats.hits);
+    EXPECT_EQ(0u, stats.misses);
+    EXPECT_EQ(0u, stats.pooledBuffers);
+}
+
+TEST(ImageBufferPool, MaximumSize) {
+    ImageBufferPool pool(512 * 1024);
+    {
+        auto a = pool.allocate(256 * 1024);
+        auto b = pool.allocate(256 * 1024);
+        auto c = pool.allocate(256 * 1024);
+    }
+
+    auto stats = pool.getStats();
+    EXPECT_EQ(2u, stats.pooledBuffers);
+    EXPECT_EQ(512u * 1024, stats.pooledBytes);
+    EXPECT_EQ(1u, stats.discards);
+
+    pool.setMaximumSize(256 * 1024);
+    EXPECT_EQ(256u * 1024, pool.getStats().pooledBytes);
+
+    pool.shrink();
+    stats = pool.getStats();
+    EXPECT_EQ(0u, stats.pooledBuffers);
+    EXPECT_EQ(0u, stats.pooledBytes);
+}
+
+TEST(ImageBufferPool, Threads) {
+    ImageBufferPool pool;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&] {
+            for (std::size_t i = 0; i < 1000; ++i) {
+                auto buffer = pool.allocate(8192 + (i % 7) * 4096);
+                buffer[0] = 1;
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    const auto stats = pool.getStats();
+    EXPECT_EQ(4000u, stats.hits + stats.misses);
+    EXPECT_LE(stats.pooledBuffers, 4u * 7);
+}
+
+TEST(ImageBufferPool, Image) {
+    PremultipliedImage image({ 256, 256 });
+    EXPECT_TRUE(std::all_of(image.data.get(), image.data.get() + image.bytes(), [](uint8_t v) { return v == 0; }));
+
+    // Images that take over foreign buffers delete them with delete[].
+    PremultipliedImage adopted({ 2, 2 }, std::make_unique<uint8_t[]>(16));
+    EXPECT_TRUE(adopted.valid());
+}
@@ -0,0 +1,136 @@
+#include <mbgl/test/util.hpp>
+
+#include <mbgl/actor/actor.hpp>
+#include <mbgl/util/parallel_for.hpp>
+#include <mbgl/util/thread_pool.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace mbgl;
+
+TEST(ParallelFor, VisitsEveryIndexOnce) {
+    ThreadPool pool(4);
+    std::vector<std::atomic<int>> visits(1000);
+
+    util::parallelFor(pool, MailboxPriority::Visible, visits.size(), [&](std::size_t i) {
+        ++visits[i];
+    });
+
+    for (const auto& count : visits) {
+        EXPECT_EQ(1, count.load());
+    }
+}
+
+TEST(ParallelFor, Empty) {
+    ThreadPool pool(1);
+    util::parallelFor(pool, MailboxPriority::Visible, 0, [](std::size_t) {
+        ADD_FAILURE() << "Should never happen";
+    });
+}
+
+TEST(ParallelFor, RethrowsOnCaller) {
+    ThreadPool pool(2);
+    std::atomic<std::size_t> calls(0);
+
+    EXPECT_THROW(util::parallelFor(pool, MailboxPriority::Visible, 100, [&](std::size_t i) {
+        ++calls;
+        if (i == 42) {
+            throw std::runtime_error("test");
+        }
+    }), std::runtime_error);
+
+    // All other indices still ran.
+    EXPECT_EQ(100u, calls.load());
+}
+
+TEST(ParallelFor, CalledFromPoolThread) {
+    // Every thread of the pool waits in parallelFor at the same time; since
+    // callers do their own work, this must not deadlock.
+    struct Summer {
+        Summer(ActorRef<Summer>, ThreadPool& pool_) : pool(pool_) {}
+
+        void run(std::promise<std::size_t> promise) {
+            std::atomic<std::size_t> sum(0);
+            util::parallelFor(pool, MailboxPriority::Visible, 64, [&](std::size_t i) { sum += i; });
+            promise.set_value(sum);
+        }
+
+        ThreadPool& pool;
+    };
+
+    ThreadPool pool(2);
+    std::vector<std::unique_ptr<Actor<Summer>>> actors;
+    std::vector<std::future<std::size_t>> results;
+
+    for (std::size_t i = 0; i < 4; ++i) {
+        actors.emplace_back(std::make_unique<Actor<Summer>>(pool, std::ref(pool)));
+        std::promise<std::size_t> promise;
+        results.push_back(promise.get_future());
+        actors.back()->self().invoke(&Summer::run, std::move(promise));
+    }
+
+    for (auto& result : results) {
+        EXPECT_EQ(64u * 63u / 2u, result.get());
+    }
+}
+
+TEST(ParallelFor, HelpsAtGivenPriority) {
+    // parallelFor asks the pool for help at Idle priority while the pool's only thread is
+    // busy. Visible work that is queued afterwards still runs before the helper.
+    struct Blocker {
+        Blocker(ActorRef<Blocker>) {}
+        void block(std::shared_future<void> released) { released.wait(); }
+    };
+
+    struct Recorder {
+        Recorder(ActorRef<Recorder>, std::mutex& mutex_, std::vector<std::string>& order_)
+            : mutex(mutex_), order(order_) {}
+
+        void record() {
+            std::lock_guard<std::mutex> lock(mutex);
+            order.push_back("visible");
+        }
+
+        std::mutex& mutex;
+        std::vector<std::string>& order;
+    };
+
+    ThreadPool pool(1);
+    std::mutex mutex;
+    std::vector<std::string> order;
+
+    std::promise<void> release;
+    Actor<Blocker> blocker(pool);
+    blocker.self().invoke(&Blocker::block, release.get_future().share());
+
+    Actor<Recorder> recorder(pool, std::ref(mutex), std::ref(order));
+    std::promise<void> helped;
+    auto helpedFuture = helped.get_future();
+    const auto caller = std::this_thread::get_id();
+
+    util::parallelFor(pool, MailboxPriority::Idle, 2, [&](std::size_t) {
+        if (std::this_thread::get_id() != caller) {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                order.push_back("helper");
+            }
+            helped.set_value();
+            return;
+        }
+
+        // The caller queues visible work behind the helper, unblocks the pool and leaves
+        // the second index to the helper.
+        recorder.self().invoke(&Recorder::record);
+        release.set_value();
+        ASSERT_EQ(std::future_status::ready, helpedFuture.wait_for(std::chrono::seconds(10)));
+    });
+
+    EXPECT_EQ((std::vector<std::string> { "visible", "helper" }), order);
+}
@@ -0,0 +1,66 @@
+#include <mbgl/test/util.hpp>
+
+#include <mbgl/util/pixel_kernels.hpp>
+
+#include <vector>
+
+using namespace mbgl;
+using namespace mbgl::util;
+
+namespace {
+
+// Every combination of color and alpha in each color channel, including colors above their alpha.
+std::vector<uint8_t> allPixels() {
+    std::vector<uint8_t> pixels;
+    for (int a = 0; a < 256; ++a) {
+        for (int c = 0; c < 256; ++c) {
+            pixels.insert(pixels.end(), { uint8_t(c), uint8_t(255 - c), uint8_t(c * 7), uint8_t(a) });
+        }
+    }
+    return pixels;
+}
+
+} // namespace
+
+TEST(PixelKernels, MatchScalar) {
+    const auto& scalar = *PixelKernels::get(PixelKernels::ISA::Scalar);
+    const auto source = allPixels();
+    const std::size_t total = source.size() / 4;
+
+    for (const auto isa : { PixelKernels::ISA::SSE2, PixelKernels::ISA::AVX2, PixelKernels::ISA::NEON }) {
+        const PixelKernels* kernels = PixelKernels::get(isa);
+        if (!kernels) {
+            continue;
+        }
+        SCOPED_TRACE(int(isa));
+
+        // Counts that aren't multiples of the vector width exercise the scalar tails.
+        for (const std::size_t count : { total, total - 3, std::size_t(5), std::size_t(0) }) {
+            auto expected = source;
+            auto actual = source;
+            scalar.premultiply(expected.data(), count);
+            kernels->premultiply(actual.data(), count);
+            EXPECT_EQ(expected, actual);
+
+            expected = actual = source;
+            scalar.unpremultiply(expected.data(), count);
+            kernels->unpremultiply(actual.data(), count);
+            EXPECT_EQ(expected, actual);
+
+            expected = actual = source;
+            scalar.swapRedBlue(expected.data(), count);
+            kernels->swapRedBlue(actual.data(), count);
+            EXPECT_EQ(expected, actual);
+
+            std::vector<uint8_t> expectedRGBA(count * 4);
+            std::vector<uint8_t> actualRGBA(count * 4);
+            scalar.expandAlpha(source.data(), expectedRGBA.data(), count);
+            kernels->expandAlpha(source.data(), actualRGBA.data(), count);
+            EXPECT_EQ(expectedRGBA, actualRGBA);
+        }
+    }
+}
+
+TEST(PixelKernels, Best) {
+    EXPECT_EQ(&PixelKernels::get(), PixelKernels::get(PixelKernels::get().isa));
+}
@@ -0,0 +1,240 @@
+#include <mbgl/test/util.hpp>
+
+#include <mbgl/actor/actor.hpp>
+#include <mbgl/util/work_stealing_thread_pool.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace mbgl;
+
+namespace {
+
+class Counter {
+public:
+    Counter(ActorRef<Counter>, std::atomic<std::size_t>& remaining_, std::promise<void>& done_)
+        : remaining(remaining_), done(done_) {}
+
+    void receive(std::size_t sequence) {
+        // Messages sent by a single thread must arrive in the order they were sent.
+        EXPECT_EQ(expected++, sequence);
+        if (--remaining == 0) {
+            done.set_value();
+        }
+    }
+
+private:
+    std::size_t expected = 0;
+    std::atomic<std::size_t>& remaining;
+    std::promise<void>& done;
+};
+
+class Relay {
+public:
+    Relay(ActorRef<Relay> self_, std::atomic<std::size_t>& remaining_, std::promise<void>& done_)
+        : self(std::move(self_)), remaining(remaining_), done(done_) {}
+
+    // Self-sends are scheduled from the pool's own threads and end up on the local queues.
+    void relay(std::size_t hops) {
+        if (hops > 0) {
+            self.invoke(&Relay::relay, hops - 1);
+        } else if (--remaining == 0) {
+            done.set_value();
+        }
+    }
+
+private:
+    ActorRef<Relay> self;
+    std::atomic<std::size_t>& remaining;
+    std::promise<void>& done;
+};
+
+} // namespace
+
+TEST(WorkStealingThreadPool, PreservesMailboxOrder) {
+    const std::size_t actorCount = 32;
+    const std::size_t messageCount = 1000;
+
+    std::atomic<std::size_t> remaining(actorCount * messageCount);
+    std::promise<void> done;
+
+    WorkStealingThreadPool pool(4);
+    std::vector<std::unique_ptr<Actor<Counter>>> actors;
+    for (std::size_t i = 0; i < actorCount; ++i) {
+        actors.emplace_back(std::make_unique<Actor<Counter>>(pool, std::ref(remaining), std::ref(done)));
+    }
+
+    for (std::size_t message = 0; message < messageCount; ++message) {
+        for (auto& actor : actors) {
+            actor->self().invoke(&Counter::receive, message);
+        }
+    }
+
+    done.get_future().get();
+    EXPECT_EQ(0u, remaining.load());
+}
+
+TEST(WorkStealingThreadPool, SchedulesFromWorkerThreads) {
+    const std::size_t actorCount = 16;
+
+    std::atomic<std::size_t> remaining(actorCount);
+    std::promise<void> done;
+
+    WorkStealingThreadPool pool(4);
+    std::vector<std::unique_ptr<Actor<Relay>>> actors;
+    for (std::size_t i = 0; i < actorCount; ++i) {
+        actors.emplace_back(std::make_unique<Actor<Relay>>(pool, std::ref(remaining), std::ref(done)));
+        actors.back()->self().invoke(&Relay::relay, 1000u);
+    }
+
+    done.get_future().get();
+    EXPECT_EQ(0u, remaining.load());
+}
+
+TEST(WorkStealingThreadPool, LocalQueueOrder) {
+    // Mailboxes scheduled from a pool thread go to that thread's own queue. It takes them by
+    // priority, and in the order they were scheduled within a priority.
+    struct Recorder {
+        Recorder(ActorRef<Recorder>, std::vector<std::size_t>& order_, std::promise<void>& done_)
+            : order(order_), done(done_) {}
+
+        void record(std::size_t id) {
+            order.push_back(id);
+            if (order.size() == 5) {
+                done.set_value();
+            }
+        }
+
+        std::vector<std::size_t>& order;
+        std::promise<void>& done;
+    };
+
+    struct Spawner {
+        Spawner(ActorRef<Spawner>) {}
+
+        void spawn(std::vector<ActorRef<Recorder>> recorders) {
+            for (std::size_t id = 0; id < recorders.size(); ++id) {
+                recorders[id].invoke(&Recorder::record, id);
+            }
+        }
+    };
+
+    WorkStealingThreadPool pool(1);
+    std::vector<std::size_t> order;
+    std::promise<void> done;
+
+    const MailboxPriority priorities[] = { MailboxPriority::Idle, MailboxPriority::Prefetch, MailboxPriority::Visible,
+                                           MailboxPriority::Idle, MailboxPriority::Visible };
+    std::vector<std::unique_ptr<Actor<Recorder>>> recorders;
+    std::vector<ActorRef<Recorder>> refs;
+    for (const MailboxPriority priority : priorities) {
+        recorders.emplace_back(std::make_unique<Actor<Recorder>>(pool, std::ref(order), std::ref(done)));
+        recorders.back()->setPriority(priority);
+        refs.push_back(recorders.back()->self());
+    }
+
+    Actor<Spawner> spawner(pool);
+    spawner.self().invoke(&Spawner::spawn, refs);
+
+    done.get_future().wait();
+    EXPECT_EQ((std::vector<std::size_t>{ 2, 4, 1, 0, 3 }), order);
+}
+
+TEST(WorkStealingThreadPool, StealsByPriority) {
+    // A thread whose own queue is empty takes mailboxes from a busy sibling's queue, the ones
+    // with the highest priority first.
+    struct Record {
+        MailboxPriority priority;
+        std::thread::id thread;
+    };
+
+    struct Recorder {
+        Recorder(ActorRef<Recorder>, std::mutex& mutex_, std::vector<Record>& records_)
+            : mutex(mutex_), records(records_) {}
+
+        void record(MailboxPriority priority, std::promise<void> done) {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                records.push_back({ priority, std::this_thread::get_id() });
+            }
+            done.set_value();
+        }
+
+        std::mutex& mutex;
+        std::vector<Record>& records;
+    };
+
+    struct Worker {
+        Worker(ActorRef<Worker>) {}
+
+        void block(std::promise<void> entered, std::shared_future<void> release) {
+            entered.set_value();
+            release.wait();
+        }
+
+        // Queues the recorders on this thread, and keeps it busy until a sibling ran them.
+        void spawn(ActorRef<Recorder> idle, ActorRef<Recorder> visible,
+                   std::promise<std::thread::id> spawned, std::promise<bool> stolen) {
+            std::promise<void> idleDone;
+            auto idleFuture = idleDone.get_future();
+            idle.invoke(&Recorder::record, MailboxPriority::Idle, std::move(idleDone));
+            std::promise<void> visibleDone;
+            auto visibleFuture = visibleDone.get_future();
+            visible.invoke(&Recorder::record, MailboxPriority::Visible, std::move(visibleDone));
+            spawned.set_value(std::this_thread::get_id());
+
+            const auto timeout = std::chrono::seconds(10);
+            stolen.set_value(idleFuture.wait_for(timeout) == std::future_status::ready &&
+                             visibleFuture.wait_for(timeout) == std::future_status::ready);
+        }
+    };
+
+    WorkStealingThreadPool pool(2);
+    std::mutex mutex;
+    std::vector<Record> records;
+
+    Actor<Recorder> idle(pool, std::ref(mutex), std::ref(records));
+    Actor<Recorder> visible(pool, std::ref(mutex), std::ref(records));
+    idle.setPriority(MailboxPriority::Idle);
+    visible.setPriority(MailboxPriority::Visible);
+
+    // Occupy one thread, so that the spawner runs on the other one.
+    Actor<Worker> blocker(pool);
+    std::promise<void> entered;
+    auto enteredFuture = entered.get_future();
+    std::promise<void> release;
+    blocker.self().invoke(&Worker::block, std::move(entered), release.get_future().share());
+    enteredFuture.wait();
+
+    Actor<Worker> spawner(pool);
+    std::promise<std::thread::id> spawned;
+    auto spawnedFuture = spawned.get_future();
+    std::promise<bool> stolen;
+    auto stolenFuture = stolen.get_future();
+    spawner.self().invoke(&Worker::spawn, idle.self(), visible.self(), std::move(spawned), std::move(stolen));
+
+    // Both recorders are queued on the spawner's thread before the blocked thread is released.
+    const std::thread::id spawnerThread = spawnedFuture.get();
+    release.set_value();
+
+    ASSERT_TRUE(stolenFuture.get());
+    ASSERT_EQ(2u, records.size());
+    EXPECT_EQ(MailboxPriority::Visible, records[0].priority);
+    EXPECT_EQ(MailboxPriority::Idle, records[1].priority);
+    EXPECT_NE(spawnerThread, records[0].thread);
+    EXPECT_NE(spawnerThread, records[1].thread);
+}
+
+TEST(WorkStealingThreadPool, SelectableAsBackground) {
+    Scheduler::SetBackgroundType(Scheduler::BackgroundType::WorkStealing);
+    {
+        auto scheduler = Scheduler::GetBackground();
+        EXPECT_NE(nullptr, dynamic_cast<WorkStealingThreadPool*>(scheduler.get()));
+    }
+    Scheduler::SetBackgroundType(Scheduler::BackgroundType::ThreadPool);
+}